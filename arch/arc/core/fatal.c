@@ -35,6 +35,8 @@
  */
 void _NanoFatalErrorHandler(unsigned int reason, const NANO_ESF *pEsf)
 {
+	printk_panic();
+
 	switch (reason) {
 	case _NANO_ERR_HW_EXCEPTION:
 		break;
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief ARMv7-M memcpy() and memset() for the minimal libc
+ *
+ * Word aligned blocks of 16 bytes are moved with LDM/STM, which transfer
+ * four registers per instruction. ARMv7-M also supports unaligned single
+ * word accesses, so buffers with different alignments are copied a word
+ * at a time rather than bytewise.
+ */
+
+#include <zephyr/types.h>
+#include <toolchain.h>
+#include <string.h>
+
+void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
+{
+	u8_t *d_byte = d;
+	const u8_t *s_byte = s;
+	size_t blocks;
+
+	/* align the destination, the source may remain unaligned */
+	while (((u32_t)d_byte & 0x3) && n) {
+		*(d_byte++) = *(s_byte++);
+		n--;
+	}
+
+	if (!((u32_t)s_byte & 0x3) && n >= 16) {
+		blocks = n >> 4;
+		n &= 0xf;
+
+		__asm__ volatile("1:\n\t"
+				 "ldmia %[s]!, {r3, r4, r5, r12}\n\t"
+				 "stmia %[d]!, {r3, r4, r5, r12}\n\t"
+				 "subs %[blocks], %[blocks], #1\n\t"
+				 "bne 1b"
+				 : [d] "+r" (d_byte), [s] "+r" (s_byte),
+				   [blocks] "+r" (blocks)
+				 :
+				 : "r3", "r4", "r5", "r12", "cc", "memory");
+	}
+
+	while (n >= 4) {
+		*(u32_t *)d_byte = UNALIGNED_GET((const u32_t *)s_byte);
+		d_byte += 4;
+		s_byte += 4;
+		n -= 4;
+	}
+
+	while (n > 0) {
+		*(d_byte++) = *(s_byte++);
+		n--;
+	}
+
+	return d;
+}
+
+void *memset(void *buf, int c, size_t n)
+{
+	u8_t *d_byte = buf;
+	u32_t c_word = (u8_t)c * 0x01010101;
+	size_t blocks;
+
+	while (((u32_t)d_byte & 0x3) && n) {
+		*(d_byte++) = c;
+		n--;
+	}
+
+	if (n >= 16) {
+		blocks = n >> 4;
+		n &= 0xf;
+
+		__asm__ volatile("mov r3, %[c]\n\t"
+				 "mov r4, %[c]\n\t"
+				 "mov r5, %[c]\n\t"
+				 "mov r12, %[c]\n\t"
+				 "1:\n\t"
+				 "stmia %[d]!, {r3, r4, r5, r12}\n\t"
+				 "subs %[blocks], %[blocks], #1\n\t"
+				 "bne 1b"
+				 : [d] "+r" (d_byte), [blocks] "+r" (blocks)
+				 : [c] "r" (c_word)
+				 : "r3", "r4", "r5", "r12", "cc", "memory");
+	}
+
+	while (n >= 4) {
+		*(u32_t *)d_byte = c_word;
+		d_byte += 4;
+		n -= 4;
+	}
+
+	while (n > 0) {
+		*(d_byte++) = c;
+		n--;
+	}
+
+	return buf;
+}
@@ -82,6 +82,8 @@ static void unwind_stack(u32_t base_ptr)
 FUNC_NORETURN void _NanoFatalErrorHandler(unsigned int reason,
 					  const NANO_ESF *pEsf)
 {
+	printk_panic();
+
 	_debug_fatal_hook(pEsf);
 
 #ifdef CONFIG_PRINTK
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief IA-32 memcpy() and memset() for the minimal libc
+ *
+ * The bulk of the buffer is moved with the dword string instructions and
+ * the remaining bytes with their byte variants. The direction flag is
+ * clear on function entry, as required by the ABI.
+ */
+
+#include <string.h>
+
+void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
+{
+	void *dest = d;
+	size_t words = n >> 2;
+
+	__asm__ volatile("rep movsl\n\t"
+			 "movl %[rem], %%ecx\n\t"
+			 "rep movsb"
+			 : "+D" (d), "+S" (s), "+c" (words)
+			 : [rem] "r" (n & 0x3)
+			 : "memory");
+
+	return dest;
+}
+
+void *memset(void *buf, int c, size_t n)
+{
+	void *dest = buf;
+	size_t words = n >> 2;
+	unsigned int c_word = (unsigned char)c * 0x01010101;
+
+	__asm__ volatile("rep stosl\n\t"
+			 "movl %[rem], %%ecx\n\t"
+			 "rep stosb"
+			 : "+D" (buf), "+c" (words)
+			 : "a" (c_word), [rem] "r" (n & 0x3)
+			 : "memory");
+
+	return dest;
+}
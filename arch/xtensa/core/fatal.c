@@ -51,6 +51,8 @@ const NANO_ESF _default_esf = {
 XTENSA_ERR_NORET void _NanoFatalErrorHandler(unsigned int reason,
 					     const NANO_ESF *pEsf)
 {
+	printk_panic();
+
 	switch (reason) {
 	case _NANO_ERR_HW_EXCEPTION:
 	case _NANO_ERR_RESERVED_IRQ:
@@ -174,7 +174,7 @@ static void update_gptp(struct net_if *iface, struct net_pkt *pkt,
 #define update_gptp(iface, pkt, send)
 #endif /* CONFIG_NET_GPTP */
 
-static int eth_send(struct net_if *iface, struct net_pkt *pkt)
+static int eth_write_pkt(struct net_if *iface, struct net_pkt *pkt)
 {
 	struct eth_context *ctx = get_context(iface);
 	struct net_buf *frag;
@@ -215,11 +215,43 @@ static int eth_send(struct net_if *iface, struct net_pkt *pkt)
 	ret = eth_write_data(ctx->dev_fd, ctx->send, count);
 	if (ret < 0) {
 		SYS_LOG_DBG("Cannot send pkt %p (%d)", pkt, ret);
-	} else {
-		net_pkt_unref(pkt);
+		return ret;
+	}
+
+	return 0;
+}
+
+static int eth_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	int ret;
+
+	ret = eth_write_pkt(iface, pkt);
+	if (ret < 0) {
+		return ret;
+	}
+
+	net_pkt_unref(pkt);
+
+	return 0;
+}
+
+/* A TAP device takes one frame per write(), so the frames are written
+ * back to back, stopping at the first one that cannot be written.
+ */
+static int eth_send_batch(struct net_if *iface, struct net_pkt *pkts[],
+			  int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if (eth_write_pkt(iface, pkts[i]) < 0) {
+			break;
+		}
+
+		net_pkt_unref(pkts[i]);
 	}
 
-	return ret < 0 ? ret : 0;
+	return i;
 }
 
 static int eth_init(struct device *dev)
@@ -276,7 +308,7 @@ static int read_data(struct eth_context *ctx, int fd)
 	}
 
 	do {
-		frag = net_pkt_get_frag(pkt, NET_BUF_TIMEOUT);
+		frag = net_pkt_get_frag_len(pkt, ret, NET_BUF_TIMEOUT);
 		if (!frag) {
 			net_pkt_unref(pkt);
 			return -ENOMEM;
@@ -492,6 +524,7 @@ static int set_config(struct device *dev,
 static const struct ethernet_api eth_if_api = {
 	.iface_api.init = eth_iface_init,
 	.iface_api.send = eth_send,
+	.iface_api.send_batch = eth_send_batch,
 
 	.get_capabilities = eth_posix_native_get_capabilities,
 	.set_config = set_config,
@@ -52,20 +52,17 @@ zephyr_stat_mgmt_walk_cb(struct stats_hdr *hdr, void *arg,
 {
     struct zephyr_stat_mgmt_walk_arg *walk_arg;
     struct stat_mgmt_entry entry;
-    void *stat_val;
 
     walk_arg = arg;
 
-    stat_val = (uint8_t *)hdr + off;
     switch (hdr->s_size) {
     case sizeof (uint16_t):
-        entry.value = *(uint16_t *) stat_val;
-        break;
     case sizeof (uint32_t):
-        entry.value = *(uint32_t *) stat_val;
-        break;
     case sizeof (uint64_t):
-        entry.value = *(uint64_t *) stat_val;
+        /* Per-CPU counters are summed, histogram buckets are separate
+         * entries.
+         */
+        entry.value = stats_value_get(hdr, off);
         break;
     default:
         return MGMT_ERR_EUNKNOWN;
@@ -25,6 +25,7 @@
 #define __BASE64_H__
 
 #include <stddef.h>
+#include <stdbool.h>
 #include <zephyr/types.h>
 
 #ifdef __cplusplus
@@ -72,6 +73,140 @@ int base64_encode(u8_t *dst, size_t dlen, size_t *olen, const u8_t *src,
 int base64_decode(u8_t *dst, size_t dlen, size_t *olen, const u8_t *src,
 		  size_t slen);
 
+/**
+ * @brief          State of a streaming base64 encoder
+ *
+ * Input is fed in chunks of any size, bytes which do not complete a group
+ * of three are kept until the next chunk.
+ */
+struct base64_enc_ctx {
+	u8_t buf[2];
+	u8_t len;
+};
+
+/**
+ * @brief          State of a streaming base64 decoder
+ */
+struct base64_dec_ctx {
+	u32_t word;
+	u8_t len;
+	u8_t pad;
+};
+
+/**
+ * @brief          Initialize a streaming base64 encoder
+ *
+ * @param ctx      encoder state
+ */
+static inline void base64_enc_init(struct base64_enc_ctx *ctx)
+{
+	ctx->len = 0;
+}
+
+/**
+ * @brief          Encode a chunk of data
+ *
+ * Only complete groups of four characters are written, the output is not
+ * NUL terminated.
+ *
+ * @param ctx      encoder state
+ * @param dst      destination buffer
+ * @param dlen     size of the destination buffer
+ * @param olen     number of bytes written
+ * @param src      source buffer
+ * @param slen     amount of data to be encoded
+ *
+ * @return         0 if successful, or -ENOMEM if the buffer is too small,
+ *                 in which case nothing is consumed and *olen is set to the
+ *                 required size.
+ */
+int base64_enc_update(struct base64_enc_ctx *ctx, u8_t *dst, size_t dlen,
+		      size_t *olen, const u8_t *src, size_t slen);
+
+/**
+ * @brief          Finish encoding, writing the last, padded, group
+ *
+ * @param ctx      encoder state, initialized again on success
+ * @param dst      destination buffer
+ * @param dlen     size of the destination buffer, 4 bytes are enough
+ * @param olen     number of bytes written, 0 or 4
+ *
+ * @return         0 if successful, or -ENOMEM if the buffer is too small.
+ */
+int base64_enc_finish(struct base64_enc_ctx *ctx, u8_t *dst, size_t dlen,
+		      size_t *olen);
+
+/**
+ * @brief          Initialize a streaming base64 decoder
+ *
+ * @param ctx      decoder state
+ */
+static inline void base64_dec_init(struct base64_dec_ctx *ctx)
+{
+	ctx->word = 0;
+	ctx->len = 0;
+	ctx->pad = 0;
+}
+
+/**
+ * @brief          Decode a chunk of base64-formatted data
+ *
+ * Groups of characters may be split across chunks. Spaces, carriage returns
+ * and line feeds are skipped.
+ *
+ * @param ctx      decoder state
+ * @param dst      destination buffer
+ * @param dlen     size of the destination buffer
+ * @param olen     number of bytes written
+ * @param src      source buffer
+ * @param slen     amount of data to be decoded
+ *
+ * @return         0 if successful, -EINVAL if the input data is not
+ *                 correct, or -ENOMEM if the buffer may be too small, in
+ *                 which case nothing is consumed and *olen is set to the
+ *                 largest possible output size.
+ */
+int base64_dec_update(struct base64_dec_ctx *ctx, u8_t *dst, size_t dlen,
+		      size_t *olen, const u8_t *src, size_t slen);
+
+/**
+ * @brief          Finish decoding
+ *
+ * @param ctx      decoder state, initialized again
+ *
+ * @return         0 if successful, or -EINVAL if the input ended inside a
+ *                 group of four characters.
+ */
+int base64_dec_finish(struct base64_dec_ctx *ctx);
+
+struct net_buf;
+struct net_buf_pool;
+
+/**
+ * @brief          Encode a chunk of data at the end of a network buffer
+ *
+ * The output is written straight into the tailroom of the last fragment of
+ * @a buf. Further fragments are allocated from @a pool as needed and added
+ * to the chain. With @a finish set, the last group is written too. Only
+ * available if CONFIG_NET_BUF is enabled.
+ *
+ * @param ctx      encoder state
+ * @param buf      network buffer, or fragment chain, to append the output to
+ * @param pool     pool to allocate fragments from, NULL to only use the
+ *                 tailroom of @a buf
+ * @param timeout  timeout to allocate each fragment, in milliseconds, or
+ *                 K_NO_WAIT or K_FOREVER
+ * @param src      source buffer
+ * @param slen     amount of data to be encoded
+ * @param finish   true to finish the encoding
+ *
+ * @return         0 if successful, or -ENOMEM if the output does not fit.
+ *                 The fragments hold the output written before the error.
+ */
+int base64_enc_net_buf(struct base64_enc_ctx *ctx, struct net_buf *buf,
+		       struct net_buf_pool *pool, s32_t timeout,
+		       const u8_t *src, size_t slen, bool finish);
+
 #ifdef __cplusplus
 }
 #endif
@@ -106,10 +106,7 @@ u16_t crc16_itu_t(u16_t seed, const u8_t *src, size_t len);
  *
  * @return The computed CRC16 value
  */
-static inline u16_t crc16_ansi(const u8_t *src, size_t len)
-{
-	return crc16(src, len, 0x8005, 0xffff, true);
-}
+u16_t crc16_ansi(const u8_t *src, size_t len);
 
 /**
  * @}
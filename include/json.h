@@ -41,6 +41,9 @@ enum json_tokens {
 	JSON_TOK_COLON = ':',
 	JSON_TOK_COMMA = ',',
 	JSON_TOK_NUMBER = '0',
+	JSON_TOK_INT64 = 'I',
+	JSON_TOK_FIXED_POINT = 'P',
+	JSON_TOK_FLOAT = 'F',
 	JSON_TOK_TRUE = 't',
 	JSON_TOK_FALSE = 'f',
 	JSON_TOK_NULL = 'n',
@@ -51,11 +54,12 @@ enum json_tokens {
 struct json_obj_descr {
 	const char *field_name;
 
-	/* Alignment can never be 0 or more than 4.  The macros to create a
-	 * struct json_obj_descr will subtract 1 from the result of
+	/* Alignment can never be 0 or more than 8.  The macros to create a
+	 * struct json_obj_descr store the base 2 logarithm of the result of
 	 * __alignof__() calls in order to keep this value in the 0-3 range
-	 * and thus use only 2 bits.  1 is added back when rounding it up to
-	 * calculate the struct size while parsing an array or object.
+	 * and thus use only 2 bits.  It is turned back into a power of 2
+	 * when rounding up to calculate the struct size while parsing an
+	 * array or object.
 	 */
 	u32_t alignment : 2;
 
@@ -63,7 +67,8 @@ struct json_obj_descr {
 	u32_t field_name_len : 7;
 
 	/* Valid values here (enum json_tokens): JSON_TOK_STRING,
-	 * JSON_TOK_NUMBER, JSON_TOK_TRUE, JSON_TOK_FALSE,
+	 * JSON_TOK_NUMBER, JSON_TOK_INT64, JSON_TOK_FIXED_POINT,
+	 * JSON_TOK_FLOAT, JSON_TOK_TRUE, JSON_TOK_FALSE,
 	 * JSON_TOK_OBJECT_START, JSON_TOK_LIST_START.  (All others
 	 * ignored.) Maximum value is '}' (125), so this has to be 7 bits
 	 * long.
@@ -73,18 +78,72 @@ struct json_obj_descr {
 	/* 65535 bytes is more than enough for many JSON payloads. */
 	u32_t offset : 16;
 
+	/* Hash of the field name computed at build time by the macros to
+	 * create a struct json_obj_descr, so that decoding only compares
+	 * the names of fields whose hash matches the key. Descriptors
+	 * built by hand may leave it at 0, their names are then always
+	 * compared.
+	 */
+	u32_t field_name_hash;
+
 	union {
 		struct {
 			const struct json_obj_descr *sub_descr;
 			size_t sub_descr_len;
+			/* sizeof() the struct described by sub_descr, set
+			 * by the macros so that arrays of objects are
+			 * walked with the stride of the C array.  When 0,
+			 * it is computed from the offsets of sub_descr.
+			 */
+			size_t struct_size;
 		} object;
 		struct {
 			const struct json_obj_descr *element_descr;
 			size_t n_elements;
 		} array;
+		struct {
+			u32_t decimals;
+		} fixed_point;
 	};
 };
 
+/* Number of leading characters of a field name taken into its hash */
+#define _JSON_HASH_CHARS 16
+
+#define _JSON_HASH_CHAR(str_, i_, mul_) \
+	((sizeof(str_) - 1 > (i_)) ? (u32_t)(u8_t)(str_)[i_] * (mul_) : 0)
+
+/*
+ * Hash of a string literal, see struct json_obj_descr: its length and the
+ * sum of its first _JSON_HASH_CHARS characters multiplied by powers
+ * of 31. It folds to a constant and must match json_key_hash() in
+ * lib/json/json.c.
+ */
+#define _JSON_HASH(str_) \
+	((u32_t)(sizeof(str_) - 1) * 0x9e3779b1u + \
+	 _JSON_HASH_CHAR(str_, 0, 0x00000001u) + \
+	 _JSON_HASH_CHAR(str_, 1, 0x0000001fu) + \
+	 _JSON_HASH_CHAR(str_, 2, 0x000003c1u) + \
+	 _JSON_HASH_CHAR(str_, 3, 0x0000745fu) + \
+	 _JSON_HASH_CHAR(str_, 4, 0x000e1781u) + \
+	 _JSON_HASH_CHAR(str_, 5, 0x01b4d89fu) + \
+	 _JSON_HASH_CHAR(str_, 6, 0x34e63b41u) + \
+	 _JSON_HASH_CHAR(str_, 7, 0x67e12cdfu) + \
+	 _JSON_HASH_CHAR(str_, 8, 0x94446f01u) + \
+	 _JSON_HASH_CHAR(str_, 9, 0xf449711fu) + \
+	 _JSON_HASH_CHAR(str_, 10, 0x94e4b2c1u) + \
+	 _JSON_HASH_CHAR(str_, 11, 0x07b1a55fu) + \
+	 _JSON_HASH_CHAR(str_, 12, 0xee830681u) + \
+	 _JSON_HASH_CHAR(str_, 13, 0xe1ddc99fu) + \
+	 _JSON_HASH_CHAR(str_, 14, 0x59db6a41u) + \
+	 _JSON_HASH_CHAR(str_, 15, 0xe191dddfu))
+
+/* Base 2 logarithm of the alignment of a type, see struct json_obj_descr */
+#define _JSON_ALIGN(type_) \
+	(__alignof__(type_) >= 8 ? 3 : \
+	 __alignof__(type_) >= 4 ? 2 : \
+	 __alignof__(type_) >= 2 ? 1 : 0)
+
 /**
  * @brief Function pointer type to append bytes to a buffer while
  * encoding JSON data.
@@ -111,7 +170,10 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
  *
  * @param type_ Token type for JSON value corresponding to a primitive
  * type. Must be one of: JSON_TOK_STRING for strings, JSON_TOK_NUMBER
- * for numbers, JSON_TOK_TRUE (or JSON_TOK_FALSE) for booleans.
+ * for 32-bit integers (int), JSON_TOK_INT64 for 64-bit integers
+ * (s64_t), JSON_TOK_FLOAT for floating point numbers (double, decoding
+ * only), JSON_TOK_TRUE (or JSON_TOK_FALSE) for booleans. Fixed-point
+ * numbers are declared with JSON_OBJ_DESCR_FIXED_POINT().
  *
  * Here's an example of use:
  *
@@ -127,11 +189,48 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
 	{ \
 		.field_name = (#field_name_), \
 		.field_name_len = sizeof(#field_name_) - 1, \
+		.field_name_hash = _JSON_HASH(#field_name_), \
 		.offset = offsetof(struct_, field_name_), \
-		.alignment = __alignof__(struct_) - 1, \
+		.alignment = _JSON_ALIGN(struct_), \
 		.type = type_, \
 	}
 
+/**
+ * @brief Helper macro to declare a descriptor for a fixed-point number
+ *
+ * The value is stored in an s64_t scaled by 10 to the power of
+ * @a decimals_, so with 3 decimals "-1.5" is decoded as -1500 and 2500
+ * is encoded as "2.500". Digits beyond the last decimal are truncated.
+ *
+ * @param struct_ Struct packing the values
+ *
+ * @param field_name_ Field name in the struct, of type s64_t
+ *
+ * @param decimals_ Number of decimal digits after the point, at most 18
+ *
+ * Here's an example of use:
+ *
+ *     struct reading {
+ *         s64_t celsius;
+ *     };
+ *
+ *     struct json_obj_descr reading[] = {
+ *         JSON_OBJ_DESCR_FIXED_POINT(struct reading, celsius, 2),
+ *     };
+ */
+#define JSON_OBJ_DESCR_FIXED_POINT(struct_, field_name_, decimals_) \
+	{ \
+		.field_name = (#field_name_), \
+		.field_name_len = sizeof(#field_name_) - 1, \
+		.field_name_hash = _JSON_HASH(#field_name_), \
+		.offset = offsetof(struct_, field_name_), \
+		.alignment = _JSON_ALIGN(struct_), \
+		.type = JSON_TOK_FIXED_POINT, \
+		.fixed_point = { \
+			.decimals = (decimals_), \
+		}, \
+	}
+
 /**
  * @brief Helper macro to declare a descriptor for an object value
  *
@@ -161,12 +260,14 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
 	{ \
 		.field_name = (#field_name_), \
 		.field_name_len = (sizeof(#field_name_) - 1), \
+		.field_name_hash = _JSON_HASH(#field_name_), \
 		.offset = offsetof(struct_, field_name_), \
-		.alignment = __alignof__(struct_) - 1, \
+		.alignment = _JSON_ALIGN(struct_), \
 		.type = JSON_TOK_OBJECT_START, \
 		.object = { \
 			.sub_descr = sub_descr_, \
 			.sub_descr_len = ARRAY_SIZE(sub_descr_), \
+			.struct_size = sizeof(((struct_ *)0)->field_name_), \
 		}, \
 	}
 
@@ -200,14 +301,15 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
 	{ \
 		.field_name = (#field_name_), \
 		.field_name_len = sizeof(#field_name_) - 1, \
+		.field_name_hash = _JSON_HASH(#field_name_), \
 		.offset = offsetof(struct_, field_name_), \
-		.alignment = __alignof__(struct_) - 1, \
+		.alignment = _JSON_ALIGN(struct_), \
 		.type = JSON_TOK_LIST_START, \
 		.array = { \
 			.element_descr = &(struct json_obj_descr) { \
 				.type = elem_type_, \
 				.offset = offsetof(struct_, len_field_), \
-				.alignment = __alignof__(struct_) - 1, \
+				.alignment = _JSON_ALIGN(struct_), \
 			}, \
 			.n_elements = (max_len_), \
 		}, \
@@ -257,8 +359,9 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
 	{ \
 		.field_name = (#field_name_), \
 		.field_name_len = sizeof(#field_name_) - 1, \
+		.field_name_hash = _JSON_HASH(#field_name_), \
 		.offset = offsetof(struct_, field_name_), \
-		.alignment = __alignof__(struct_) - 1, \
+		.alignment = _JSON_ALIGN(struct_), \
 		.type = JSON_TOK_LIST_START, \
 		.array = { \
 			.element_descr = &(struct json_obj_descr) { \
@@ -266,9 +369,11 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
 				.object = { \
 					.sub_descr = elem_descr_, \
 					.sub_descr_len = elem_descr_len_, \
+					.struct_size = sizeof( \
+					  ((struct_ *)0)->field_name_[0]), \
 				}, \
 				.offset = offsetof(struct_, len_field_), \
-				.alignment = __alignof__(struct_) - 1, \
+				.alignment = _JSON_ALIGN(struct_), \
 			}, \
 			.n_elements = (max_len_), \
 		}, \
@@ -327,8 +432,9 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
 	{ \
 		.field_name = (#field_name_), \
 			.field_name_len = sizeof(#field_name_) - 1, \
+			.field_name_hash = _JSON_HASH(#field_name_), \
 			.offset = offsetof(struct_, field_name_), \
-			.alignment = __alignof__(struct_) - 1, \
+			.alignment = _JSON_ALIGN(struct_), \
 			.type = JSON_TOK_LIST_START, \
 			.array = { \
 			.element_descr = &(struct json_obj_descr) { \
@@ -338,7 +444,7 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
 					.sub_descr_len = elem_descr_len_, \
 				}, \
 				.offset = offsetof(struct_, len_field_), \
-				.alignment = __alignof__(struct_) - 1, \
+				.alignment = _JSON_ALIGN(struct_), \
 			}, \
 			.n_elements = (max_len_), \
 		}, \
@@ -366,11 +472,40 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
 	{ \
 		.field_name = (json_field_name_), \
 		.field_name_len = sizeof(json_field_name_) - 1, \
+		.field_name_hash = _JSON_HASH(json_field_name_), \
 		.offset = offsetof(struct_, struct_field_name_), \
-		.alignment = __alignof__(struct_) - 1, \
+		.alignment = _JSON_ALIGN(struct_), \
 		.type = type_, \
 	}
 
+/**
+ * @brief Variant of JSON_OBJ_DESCR_FIXED_POINT that can be used when the
+ *        structure and JSON field names differ.
+ *
+ * @param struct_ Struct packing the values
+ *
+ * @param json_field_name_ String, field name in JSON strings
+ *
+ * @param struct_field_name_ Field name in the struct, of type s64_t
+ *
+ * @param decimals_ Number of decimal digits after the point, at most 18
+ *
+ * @see JSON_OBJ_DESCR_FIXED_POINT
+ */
+#define JSON_OBJ_DESCR_FIXED_POINT_NAMED(struct_, json_field_name_, \
+					 struct_field_name_, decimals_) \
+	{ \
+		.field_name = (json_field_name_), \
+		.field_name_len = sizeof(json_field_name_) - 1, \
+		.field_name_hash = _JSON_HASH(json_field_name_), \
+		.offset = offsetof(struct_, struct_field_name_), \
+		.alignment = _JSON_ALIGN(struct_), \
+		.type = JSON_TOK_FIXED_POINT, \
+		.fixed_point = { \
+			.decimals = (decimals_), \
+		}, \
+	}
+
 /**
  * @brief Variant of JSON_OBJ_DESCR_OBJECT that can be used when the
  *        structure and JSON field names differ.
@@ -392,12 +527,15 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
 	{ \
 		.field_name = (json_field_name_), \
 		.field_name_len = (sizeof(json_field_name_) - 1), \
+		.field_name_hash = _JSON_HASH(json_field_name_), \
 		.offset = offsetof(struct_, struct_field_name_), \
-		.alignment = __alignof__(struct_) - 1, \
+		.alignment = _JSON_ALIGN(struct_), \
 		.type = JSON_TOK_OBJECT_START, \
 		.object = { \
 			.sub_descr = sub_descr_, \
 			.sub_descr_len = ARRAY_SIZE(sub_descr_), \
+			.struct_size = \
+				sizeof(((struct_ *)0)->struct_field_name_), \
 		}, \
 	}
 
@@ -428,14 +566,15 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
 	{ \
 		.field_name = (json_field_name_), \
 		.field_name_len = sizeof(json_field_name_) - 1, \
+		.field_name_hash = _JSON_HASH(json_field_name_), \
 		.offset = offsetof(struct_, struct_field_name_), \
-		.alignment = __alignof__(struct_) - 1, \
+		.alignment = _JSON_ALIGN(struct_), \
 		.type = JSON_TOK_LIST_START, \
 		.array = { \
 			.element_descr = &(struct json_obj_descr) { \
 				.type = elem_type_, \
 				.offset = offsetof(struct_, len_field_), \
-				.alignment = __alignof__(struct_) - 1, \
+				.alignment = _JSON_ALIGN(struct_), \
 			}, \
 			.n_elements = (max_len_), \
 		}, \
@@ -494,17 +633,20 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
 	{ \
 		.field_name = json_field_name_, \
 		.field_name_len = sizeof(json_field_name_) - 1, \
+		.field_name_hash = _JSON_HASH(json_field_name_), \
 		.offset = offsetof(struct_, struct_field_name_), \
-		.alignment = __alignof__(struct_) - 1, \
+		.alignment = _JSON_ALIGN(struct_), \
 		.type = JSON_TOK_LIST_START, \
 		.element_descr = &(struct json_obj_descr) { \
 			.type = JSON_TOK_OBJECT_START, \
 			.object = { \
 				.sub_descr = elem_descr_, \
 				.sub_descr_len = elem_descr_len_, \
+				.struct_size = sizeof( \
+				  ((struct_ *)0)->struct_field_name_[0]), \
 			}, \
 			.offset = offsetof(struct_, len_field_), \
-			.alignment = __alignof__(struct_) - 1, \
+			.alignment = _JSON_ALIGN(struct_), \
 		}, \
 		.n_elements = (max_len_), \
 	}
@@ -526,7 +668,9 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
  * (1) strings are not unescaped (but only valid escape sequences are
  * accepted);
  * (2) no UTF-8 validation is performed; and
- * (3) only integer numbers are supported (no strtod() in the minimal libc).
+ * (3) floating point numbers are converted without strtod(), which is
+ * not in the minimal libc, and may be off by a few units in the last
+ * place.
  *
  * @param json Pointer to JSON-encoded value to be parsed
  *
@@ -534,19 +678,230 @@ typedef int (*json_append_bytes_t)(const char *bytes, size_t len,
  *
  * @param descr Pointer to the descriptor array
  *
- * @param descr_len Number of elements in the descriptor array. Must be less
- * than 31 due to implementation detail reasons (if more fields are
- * necessary, use two descriptors)
+ * @param descr_len Number of elements in the descriptor array, at most
+ * CONFIG_JSON_MAX_FIELDS
  *
  * @param val Pointer to the struct to hold the decoded values
  *
  * @return < 0 if error, bitmap of decoded fields on success (bit 0
  * is set if first field in the descriptor has been properly decoded, etc).
+ * Only the first 31 fields are represented, use json_obj_parse_fields()
+ * for descriptors with more fields.
  */
 int json_obj_parse(char *json, size_t len,
 	const struct json_obj_descr *descr, size_t descr_len,
 	void *val);
 
+/**
+ * @brief Number of words of the bitmap of decoded fields of an object
+ *
+ * @param descr_len_ Number of elements in the descriptor array
+ */
+#define JSON_FIELDS_WORDS(descr_len_) (((descr_len_) + 31) / 32)
+
+/**
+ * @brief Parses a JSON-encoded object like json_obj_parse(), and stores
+ * the bitmap of all decoded fields in @a fields
+ *
+ * Bit (i % 32) of fields[i / 32] is set if field i of the descriptor
+ * has been decoded.
+ *
+ * @param json Pointer to JSON-encoded value to be parsed
+ *
+ * @param len Length of JSON-encoded value
+ *
+ * @param descr Pointer to the descriptor array
+ *
+ * @param descr_len Number of elements in the descriptor array, at most
+ * CONFIG_JSON_MAX_FIELDS
+ *
+ * @param val Pointer to the struct to hold the decoded values
+ *
+ * @param fields Bitmap of JSON_FIELDS_WORDS(descr_len) words, set if
+ * the object has been decoded
+ *
+ * @return < 0 if error, otherwise the value returned by json_obj_parse()
+ */
+int json_obj_parse_fields(char *json, size_t len,
+			  const struct json_obj_descr *descr, size_t descr_len,
+			  void *val, u32_t *fields);
+
+/**
+ * @brief Number being decoded by the incremental parser
+ *
+ * Private to the parser.
+ */
+struct json_num {
+	u64_t mantissa;
+	/* Decimal exponent of the mantissa, without the exponent part */
+	s32_t exp;
+	/* Absolute value of the exponent part */
+	s32_t exp_part;
+	u8_t flags;
+};
+
+/* Number of words of a bitmap of the fields of an object */
+#define _JSON_FIELDS_WORDS JSON_FIELDS_WORDS(CONFIG_JSON_MAX_FIELDS)
+
+/**
+ * @brief Object or array being decoded by the incremental parser
+ *
+ * Private to the parser.
+ */
+struct json_parser_frame {
+	/* Member descriptors of an object, element descriptor of an array,
+	 * NULL if the value is skipped.
+	 */
+	const struct json_obj_descr *descr;
+	/* Struct holding an object, first element of an array */
+	void *base;
+	/* Struct holding the element count of an array */
+	void *val;
+	/* Number of member descriptors or maximum number of elements */
+	size_t len;
+	/* Size of an array element */
+	size_t elem_size;
+	/* Bitmap of decoded members */
+	u32_t fields[_JSON_FIELDS_WORDS];
+	/* Number of decoded elements */
+	u32_t count;
+	/* Descriptor index of the member being decoded, UINT8_MAX if the
+	 * key did not match any descriptor.
+	 */
+	u8_t member;
+	/* Descriptor index where the next key is looked up first */
+	u8_t next;
+	/* JSON_TOK_OBJECT_START or JSON_TOK_LIST_START */
+	u8_t type;
+};
+
+/**
+ * @brief Incremental JSON object parser
+ *
+ * Decodes a JSON object fed in arbitrary pieces, e.g. the fragments of a
+ * network buffer, into a struct described by an array of struct
+ * json_obj_descr, like json_obj_parse() but without needing the whole
+ * payload in one contiguous buffer. The parser only keeps a small state
+ * machine between pieces.
+ *
+ * As the input does not outlive json_parser_feed(), strings are copied to
+ * a buffer provided to json_parser_init() and the char pointers in the
+ * decoded struct point there. As with json_obj_parse() they are not
+ * unescaped. Unlike json_obj_parse(), members missing a separating comma
+ * are rejected, and values of unknown keys are skipped whatever their
+ * type, including null.
+ *
+ * All members are private.
+ */
+struct json_parser {
+	struct json_parser_frame stack[CONFIG_JSON_PARSER_MAX_DEPTH];
+	/* Descriptor and location of the value being decoded, NULL
+	 * descriptor if it is skipped.
+	 */
+	const struct json_obj_descr *value_descr;
+	void *value_field;
+	union {
+		struct json_num num;
+		/* Remaining characters of true, false or null */
+		const char *literal;
+		/* Offset of the string being decoded in str_buf */
+		size_t str_start;
+	};
+	char *str_buf;
+	size_t str_size;
+	size_t str_used;
+	int result;
+	u8_t depth;
+	u8_t state;
+	u8_t expect;
+	/* Escape sequence characters still expected in a string or key */
+	u8_t escape;
+	u8_t key_len;
+	char key[CONFIG_JSON_PARSER_KEY_LEN];
+};
+
+/**
+ * @brief Initialize an incremental parser for a JSON object
+ *
+ * @param parser Parser to initialize
+ *
+ * @param descr Pointer to the descriptor array
+ *
+ * @param descr_len Number of elements in the descriptor array, with the
+ * same limit as for json_obj_parse()
+ *
+ * @param val Pointer to the struct to hold the decoded values
+ *
+ * @param str_buf Buffer holding the decoded strings, may be NULL if the
+ * descriptors contain no strings
+ *
+ * @param str_size Size of @a str_buf
+ */
+void json_parser_init(struct json_parser *parser,
+		      const struct json_obj_descr *descr, size_t descr_len,
+		      void *val, char *str_buf, size_t str_size);
+
+/**
+ * @brief Feed the next piece of a JSON object to a parser
+ *
+ * Here's an example decoding a JSON object received in a net_buf chain:
+ *
+ *    struct json_parser parser;
+ *    char strings[64];
+ *
+ *    json_parser_init(&parser, descr, ARRAY_SIZE(descr), &val,
+ *                     strings, sizeof(strings));
+ *
+ *    for (frag = buf; frag; frag = frag->frags) {
+ *        ret = json_parser_feed(&parser, frag->data, frag->len);
+ *        if (ret != 0) {
+ *            break;
+ *        }
+ *    }
+ *
+ *    ret = json_parser_finish(&parser);
+ *
+ * @param parser Parser to feed
+ *
+ * @param data Next piece of the JSON-encoded object
+ *
+ * @param len Length of @a data
+ *
+ * @return 0 if more input is needed, 1 if the object is complete (any
+ * further input is ignored), or a negative error code, which all later
+ * calls return as well: -EINVAL for malformed input or values not
+ * matching their descriptor, -ERANGE for numbers out of range, -ENOSPC
+ * for too many array elements and -ENOMEM if the string buffer or the
+ * nesting depth is exhausted.
+ */
+int json_parser_feed(struct json_parser *parser, const char *data,
+		     size_t len);
+
+/**
+ * @brief Complete decoding with an incremental parser
+ *
+ * @param parser Parser fed the whole object
+ *
+ * @return < 0 if error, including -EINVAL if the object is not
+ * complete, bitmap of decoded fields on success, as for json_obj_parse().
+ */
+int json_parser_finish(struct json_parser *parser);
+
+/**
+ * @brief Complete decoding with an incremental parser, storing the
+ * bitmap of all decoded fields
+ *
+ * @param parser Parser fed the whole object
+ *
+ * @param fields Bitmap of JSON_FIELDS_WORDS() words of the descriptor
+ * array passed to json_parser_init(), laid out as for
+ * json_obj_parse_fields() and set if the object is complete
+ *
+ * @return < 0 if error, otherwise the value returned by
+ * json_parser_finish()
+ */
+int json_parser_finish_fields(struct json_parser *parser, u32_t *fields);
+
 /**
  * @brief Escapes the string so it can be used to encode JSON objects
  *
@@ -630,6 +985,69 @@ int json_obj_encode(const struct json_obj_descr *descr, size_t descr_len,
 		    const void *val, json_append_bytes_t append_bytes,
 		    void *data);
 
+/**
+ * @brief Encodes an object, emitting it in chunks of a fixed size
+ *
+ * The encoder output is gathered in @a chunk, and @a flush is called
+ * each time it is full and once with the remainder at the end, so the
+ * output can be sent piecewise, e.g. as HTTP chunks, without knowing its
+ * total size up front.
+ *
+ * @param descr Pointer to the descriptor array
+ *
+ * @param descr_len Number of elements in the descriptor array
+ *
+ * @param val Struct holding the values
+ *
+ * @param chunk Buffer gathering the output
+ *
+ * @param chunk_size Size of @a chunk, in bytes, not 0
+ *
+ * @param flush Function called with each chunk
+ *
+ * @param data Data pointer to be passed to the flush callback function.
+ *
+ * @return 0 if object has been successfully encoded. A negative value
+ * indicates an error, -EINVAL if @a chunk_size is 0.
+ */
+int json_obj_encode_chunked(const struct json_obj_descr *descr,
+			    size_t descr_len, const void *val,
+			    char *chunk, size_t chunk_size,
+			    json_append_bytes_t flush, void *data);
+
+struct net_buf;
+struct net_buf_pool;
+
+/**
+ * @brief Encodes an object at the end of a network buffer
+ *
+ * The output is written straight into the tailroom of the last fragment
+ * of @a buf. Further fragments are allocated from @a pool as needed and
+ * added to the chain. Only available if CONFIG_NET_BUF is enabled.
+ *
+ * @param descr Pointer to the descriptor array
+ *
+ * @param descr_len Number of elements in the descriptor array
+ *
+ * @param val Struct holding the values
+ *
+ * @param buf Network buffer, or fragment chain, to append the output to
+ *
+ * @param pool Pool to allocate fragments from, NULL to only use the
+ * tailroom of @a buf
+ *
+ * @param timeout Timeout to allocate each fragment, in milliseconds, or
+ * K_NO_WAIT or K_FOREVER
+ *
+ * @return 0 if object has been successfully encoded. A negative value
+ * indicates an error, -ENOMEM if the output does not fit. The fragments
+ * hold the part of the output encoded before the error.
+ */
+int json_obj_encode_net_buf(const struct json_obj_descr *descr,
+			    size_t descr_len, const void *val,
+			    struct net_buf *buf, struct net_buf_pool *pool,
+			    s32_t timeout);
+
 /**
  * @}
  */
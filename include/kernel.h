@@ -1243,6 +1243,188 @@ __syscall void *k_thread_custom_data_get(void);
  * @}
  */
 
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+struct k_thread_pool_req {
+	k_thread_entry_t entry;
+	void *p1;
+	void *p2;
+	void *p3;
+	int prio;
+};
+
+struct k_thread_pool_slot {
+	/* request the slot's thread is currently running */
+	struct k_thread_pool_req req;
+	u8_t flags;
+};
+
+struct k_thread_pool {
+	/* thread objects, each one starting with a struct k_thread */
+	char *threads;
+	size_t thread_size;
+	/* thread stacks, stack_stride bytes apart */
+	char *stacks;
+	size_t stack_stride;
+	size_t stack_size;
+	struct k_thread_pool_slot *slots;
+	u32_t num_threads;
+	u32_t options;
+	/* ring buffer of spawn requests waiting for a free thread */
+	struct k_thread_pool_req *reqs;
+	u32_t max_reqs;
+	u32_t req_head;
+	u32_t num_reqs;
+};
+
+/*
+ * Define a thread pool whose thread objects are of type @a thread_type,
+ * which must have a struct k_thread as its first member. This allows
+ * subsystems to embed per-thread state next to the kernel thread object.
+ */
+#define _K_THREAD_POOL_DEFINE(name, thread_type, pool_num_threads,	\
+			      pool_stack_size, pool_options,		\
+			      pool_max_queued)				\
+	static K_THREAD_STACK_ARRAY_DEFINE(_k_thread_pool_stacks_##name, \
+					   pool_num_threads,		\
+					   pool_stack_size);		\
+	static thread_type _k_thread_pool_threads_##name[pool_num_threads]; \
+	static struct k_thread_pool_slot				\
+		_k_thread_pool_slots_##name[pool_num_threads];		\
+	static struct k_thread_pool_req					\
+		_k_thread_pool_reqs_##name[(pool_max_queued) ?		\
+					   (pool_max_queued) : 1];	\
+	struct k_thread_pool name = {					\
+		.threads = (char *)_k_thread_pool_threads_##name,	\
+		.thread_size = sizeof(thread_type),			\
+		.stacks = (char *)_k_thread_pool_stacks_##name,		\
+		.stack_stride = sizeof(_k_thread_pool_stacks_##name[0]), \
+		.stack_size = K_THREAD_STACK_SIZEOF(			\
+			_k_thread_pool_stacks_##name[0]),		\
+		.slots = _k_thread_pool_slots_##name,			\
+		.num_threads = pool_num_threads,			\
+		.options = pool_options,				\
+		.reqs = _k_thread_pool_reqs_##name,			\
+		.max_reqs = pool_max_queued,				\
+	}
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @defgroup thread_pool_apis Thread Pool APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @brief Statically define a thread pool.
+ *
+ * The pool owns @a num_threads thread objects and stacks of @a stack_size
+ * bytes each, which are handed out to short-lived threads spawned with
+ * k_thread_pool_spawn(). Up to @a max_queued spawn requests are queued
+ * while all of the pool's threads are busy; they are run by the first pool
+ * thread that finishes, which avoids tearing down and setting up a thread
+ * (and, with CONFIG_INIT_STACKS, re-filling its whole stack).
+ *
+ * The thread pool can be accessed outside the module where it is defined
+ * using:
+ *
+ * @code extern struct k_thread_pool <name>; @endcode
+ *
+ * @param name Name of the thread pool.
+ * @param num_threads Number of threads in the pool.
+ * @param stack_size Stack size of each thread (in bytes).
+ * @param options Thread options applied to all of the pool's threads.
+ * @param max_queued Maximum number of queued spawn requests, may be 0.
+ */
+#define K_THREAD_POOL_DEFINE(name, num_threads, stack_size, options,	\
+			     max_queued)				\
+	_K_THREAD_POOL_DEFINE(name, struct k_thread, num_threads,	\
+			      stack_size, options, max_queued)
+
+/**
+ * @brief Spawn a thread from a thread pool.
+ *
+ * This routine runs @a entry on one of the pool's free threads. When all
+ * of them are busy, the request is queued and run, in order, as soon as a
+ * pool thread returns from its entry point. The thread is released back
+ * to the pool when its entry point returns or when it is aborted.
+ *
+ * This routine must not be called from an ISR.
+ *
+ * @param pool Address of the thread pool.
+ * @param entry Thread entry function.
+ * @param p1 1st entry point parameter.
+ * @param p2 2nd entry point parameter.
+ * @param p3 3rd entry point parameter.
+ * @param prio Thread priority.
+ * @param tid Address where the ID of the started thread is stored, or NULL.
+ *
+ * @retval 0 Thread started.
+ * @retval -EINPROGRESS No free thread, the request has been queued.
+ * @retval -ENOMEM No free thread and the request queue is full.
+ */
+extern int k_thread_pool_spawn(struct k_thread_pool *pool,
+			       k_thread_entry_t entry,
+			       void *p1, void *p2, void *p3,
+			       int prio, k_tid_t *tid);
+
+/**
+ * @brief Reserve a thread object from a thread pool.
+ *
+ * This routine hands a free thread object of the pool to the caller, which
+ * starts it with k_thread_pool_start() and owns it until it calls
+ * k_thread_pool_free(), even after the thread has exited. This lets the
+ * caller keep per-thread state (such as an exit status) around after the
+ * thread is gone.
+ *
+ * @param pool Address of the thread pool.
+ *
+ * @return Address of the thread object, or NULL if none is free.
+ */
+extern struct k_thread *k_thread_pool_alloc(struct k_thread_pool *pool);
+
+/**
+ * @brief Start a thread reserved with k_thread_pool_alloc().
+ *
+ * @param pool Address of the thread pool.
+ * @param thread Thread object returned by k_thread_pool_alloc().
+ * @param entry Thread entry function.
+ * @param p1 1st entry point parameter.
+ * @param p2 2nd entry point parameter.
+ * @param p3 3rd entry point parameter.
+ * @param prio Thread priority.
+ * @param delay Scheduling delay (in milliseconds), or K_NO_WAIT (for no delay).
+ *
+ * @return ID of the thread.
+ */
+extern k_tid_t k_thread_pool_start(struct k_thread_pool *pool,
+				   struct k_thread *thread,
+				   k_thread_entry_t entry,
+				   void *p1, void *p2, void *p3,
+				   int prio, s32_t delay);
+
+/**
+ * @brief Return a thread reserved with k_thread_pool_alloc() to its pool.
+ *
+ * If the thread is still running, its thread object becomes available
+ * again once it has exited or been aborted.
+ *
+ * @param pool Address of the thread pool.
+ * @param thread Thread object returned by k_thread_pool_alloc().
+ *
+ * @retval 0 Thread object released.
+ * @retval -EINVAL @a thread does not belong to @a pool.
+ */
+extern int k_thread_pool_free(struct k_thread_pool *pool,
+			      struct k_thread *thread);
+
+/** @} */
+
 #include <sys_clock.h>
 
 /**
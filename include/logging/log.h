@@ -257,7 +257,7 @@ int log_printk(const char *fmt, va_list ap);
 
 #define _LOG_RUNTIME_MODULE_REGISTER(_name)				\
 	_LOG_EVAL(							\
-		CONFIG_LOG_RUNTIME_FILTERING,				\
+		CONFIG_LOG_DYNAMIC_DATA,				\
 		(; __DYNAMIC_MODULE_REGISTER(_name)),			\
 		()							\
 	)
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#ifndef LOG_BACKEND_FLASH_H
+#define LOG_BACKEND_FLASH_H
+
+#include <logging/log_backend.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const struct log_backend_api log_backend_flash_api;
+
+/**
+ * @brief Flash backend definition
+ *
+ * @param _name Name of the instance.
+ */
+#define LOG_BACKEND_FLASH_DEFINE(_name) \
+	LOG_BACKEND_DEFINE(_name, log_backend_flash_api)
+
+/**
+ * @brief Callback receiving stored log data.
+ *
+ * Data is a stream of binary dictionary packets, see
+ * log_output_msg_dict_process(). A packet may be split between calls.
+ *
+ * @param data   Data.
+ * @param length Data length.
+ * @param ctx    User context.
+ *
+ * @return 0 to continue reading, non-zero value to stop.
+ */
+typedef int (*log_backend_flash_read_cb)(const u8_t *data, size_t length,
+					 void *ctx);
+
+/**
+ * @brief Open the flash circular buffer holding the logs.
+ *
+ * The flash area is erased if it does not hold logs yet. Messages not
+ * written to flash yet are dropped.
+ *
+ * @return 0 on success or negative error code.
+ */
+int log_backend_flash_init(void);
+
+/**
+ * @brief Read stored logs, oldest first.
+ *
+ * Logs which are not written to flash yet are reported last. Messages
+ * are not stored while reading, so the callback must not wait for the
+ * logging thread.
+ *
+ * @param cb  Callback receiving the data.
+ * @param ctx User context passed to the callback.
+ *
+ * @return 0 on success, value returned by the callback when it stopped
+ *	   reading or negative error code.
+ */
+int log_backend_flash_read(log_backend_flash_read_cb cb, void *ctx);
+
+/**
+ * @brief Erase stored logs.
+ *
+ * @return 0 on success or negative error code.
+ */
+int log_backend_flash_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LOG_BACKEND_FLASH_H */
@@ -108,6 +108,18 @@ u32_t log_src_cnt_get(u32_t domain_id);
  */
 const char *log_source_name_get(u32_t domain_id, u32_t src_id);
 
+/** @brief Get number of messages of the source dropped for lack of space.
+ *
+ * Messages are counted only with CONFIG_LOG_LOCKLESS, otherwise 0 is
+ * returned.
+ *
+ * @param domain_id Domain ID.
+ * @param src_id    Source ID.
+ *
+ * @return Number of dropped messages.
+ */
+u32_t log_source_dropped_get(u32_t domain_id, u32_t src_id);
+
 /** @brief Get name of the domain.
  *
  * @param domain_id Domain ID.
@@ -7,6 +7,7 @@
 #define LOG_INSTANCE_H
 
 #include <zephyr/types.h>
+#include <atomic.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -21,6 +22,10 @@ struct log_source_const_data {
 /** @brief Dynamic data associated with the source of log messages. */
 struct log_source_dynamic_data {
 	u32_t filters;
+#ifdef CONFIG_LOG_LOCKLESS
+	atomic_t dropped;	/*!< Messages dropped for lack of space. */
+	u32_t dropped_reported;	/*!< Dropped messages already reported. */
+#endif
 };
 
 /** @brief Creates name of variable and section for constant log data.
@@ -59,10 +64,7 @@ struct log_source_dynamic_data {
 #define LOG_INSTANCE_FULL_NAME(_module_name, _inst_name) \
 	UTIL_CAT(_module_name, UTIL_CAT(_, _inst_name))
 
-#if CONFIG_LOG_RUNTIME_FILTERING
-#define LOG_INSTANCE_PTR_DECLARE(_name)	\
-	struct log_source_dynamic_data *_name
-
+#ifdef CONFIG_LOG_DYNAMIC_DATA
 #define LOG_INSTANCE_REGISTER(_module_name, _inst_name, _level)		   \
 	_LOG_CONST_ITEM_REGISTER(					   \
 		LOG_INSTANCE_FULL_NAME(_module_name, _inst_name),	   \
@@ -75,6 +77,17 @@ struct log_source_dynamic_data {
 						       _inst_name)	   \
 				)					   \
 		))) __attribute__((used))
+#else
+#define LOG_INSTANCE_REGISTER(_module_name, _inst_name, _level)	  \
+	_LOG_CONST_ITEM_REGISTER(				  \
+		LOG_INSTANCE_FULL_NAME(_module_name, _inst_name), \
+		STRINGIFY(_module_name._inst_name),		  \
+		_level)
+#endif /* CONFIG_LOG_DYNAMIC_DATA */
+
+#if CONFIG_LOG_RUNTIME_FILTERING
+#define LOG_INSTANCE_PTR_DECLARE(_name)	\
+	struct log_source_dynamic_data *_name
 
 #define LOG_INSTANCE_PTR_INIT(_name, _module_name, _inst_name)	   \
 	._name = &LOG_ITEM_DYNAMIC_DATA(			   \
@@ -84,13 +97,6 @@ struct log_source_dynamic_data {
 #define LOG_INSTANCE_PTR_DECLARE(_name)	\
 	const struct log_source_const_data *_name
 
-#define LOG_INSTANCE_REGISTER(_module_name, _inst_name, _level)	  \
-	_LOG_CONST_ITEM_REGISTER(				  \
-		LOG_INSTANCE_FULL_NAME(_module_name, _inst_name), \
-		STRINGIFY(_module_name._inst_name),		  \
-		_level)
-
-
 #define LOG_INSTANCE_PTR_INIT(_name, _module_name, _inst_name) \
 	._name = &LOG_ITEM_CONST_DATA(			       \
 		LOG_INSTANCE_FULL_NAME(_module_name, _inst_name)),
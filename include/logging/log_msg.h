@@ -340,11 +340,28 @@ void log_msg_hexdump_data_get(struct log_msg *msg,
 
 union log_msg_chunk *log_msg_no_space_handle(void);
 
+/** @brief Allocate chunk from the lock-free pool (see CONFIG_LOG_LOCKLESS).
+ *
+ *  @return Allocated chunk or NULL.
+ */
+union log_msg_chunk *log_msg_chunk_lf_alloc(void);
+
+/** @brief Free message chunk.
+ *
+ *  @param chunk Chunk.
+ */
+void log_msg_chunk_free(void *chunk);
+
 static inline union log_msg_chunk *log_msg_chunk_alloc(void)
 {
 	union log_msg_chunk *msg = NULL;
-	int err = k_mem_slab_alloc(&log_msg_pool, (void **)&msg, K_NO_WAIT);
+	int err;
+
+	if (IS_ENABLED(CONFIG_LOG_LOCKLESS)) {
+		return log_msg_chunk_lf_alloc();
+	}
 
+	err = k_mem_slab_alloc(&log_msg_pool, (void **)&msg, K_NO_WAIT);
 	if (err != 0) {
 		msg = log_msg_no_space_handle();
 	}
@@ -388,7 +405,7 @@ static inline struct log_msg *_log_msg_ext_std_alloc(void)
 	if (msg != NULL) {
 		cont = (struct log_msg_cont *)log_msg_chunk_alloc();
 		if (cont == NULL) {
-			k_mem_slab_free(&log_msg_pool, (void **)&msg);
+			log_msg_chunk_free(msg);
 			return NULL;
 		}
 
@@ -59,6 +59,42 @@ void log_output_msg_process(struct log_msg *msg,
 			    struct log_output_ctx *ctx,
 			    u32_t flags);
 
+/** @brief Start of every dictionary log packet. */
+#define LOG_OUTPUT_DICT_SYNC 0xA5
+
+/** @brief Dictionary packet carrying a standard log message. */
+#define LOG_OUTPUT_DICT_TYPE_STD 0
+
+/** @brief Dictionary packet carrying a hexdump log message. */
+#define LOG_OUTPUT_DICT_TYPE_HEXDUMP 1
+
+/** @brief Dictionary packet carrying a raw string (see CONFIG_LOG_PRINTK). */
+#define LOG_OUTPUT_DICT_TYPE_RAW_STRING 2
+
+/** @brief Function for processing log messages to binary dictionary packets.
+ *
+ * Instead of formatting the message, the packet carries the address of the
+ * format string and the raw arguments, leaving the formatting to a host tool
+ * (scripts/log_dict_decode.py) which looks the strings up in the ELF file of
+ * the application. A packet consists of:
+ *
+ * - @ref LOG_OUTPUT_DICT_SYNC
+ * - header byte: packet type (bits 0-1), level (bits 2-4), domain ID
+ *   (bits 5-7)
+ * - source ID and timestamp
+ * - standard messages: format string address, a byte with the number of
+ *   arguments and the arguments
+ * - hexdump messages and raw strings: data length and data
+ *
+ * All numbers except the header, the argument count and the data are
+ * unsigned LEB128 encoded, so small values take a single byte.
+ *
+ * @param msg Log message.
+ * @param ctx Context.
+ */
+void log_output_msg_dict_process(struct log_msg *msg,
+				 struct log_output_ctx *ctx);
+
 /** @brief Function for setting timestamp frequency.
  *
  * @param freq Frequency in Hz.
@@ -29,6 +29,8 @@ extern "C" {
  *   - unsigned decimal: \%u
  *   - unsigned hexadecimal: \%x (\%X is treated as \%x)
  *   - pointer: \%p
+ *   - IPv4, IPv6 and MAC address: \%pI4, \%pI6, \%pM, taking a pointer
+ *     to the address bytes in network byte order, padded to a field width
  *   - string: \%s
  *   - character: \%c
  *   - percent: \%\%
@@ -86,6 +88,22 @@ static inline __printf_like(3, 0) int vsnprintk(char *str, size_t size,
 }
 #endif
 
+/**
+ * @brief Flush deferred printk() output and stop deferring it.
+ *
+ * With CONFIG_PRINTK_DEFERRED, output buffered so far is sent to the console
+ * in the context of the call and later printk() output is sent immediately.
+ * Called by the fatal error handlers, so that the error report follows the
+ * output which preceded it.
+ */
+#ifdef CONFIG_PRINTK_DEFERRED
+extern void printk_panic(void);
+#else
+static inline void printk_panic(void)
+{
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
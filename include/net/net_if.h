@@ -306,16 +306,16 @@ struct net_if_config {
  *
  * Traffic classes are used when sending or receiving data that is classified
  * with different priorities. So some traffic can be marked as high priority
- * and it will be sent or received first. There is always at least one work
- * queue in the system for Rx and Tx. Each network packet that is transmitted
- * or received goes through a work queue thread that will transmit it.
+ * and it will be sent or received first. There is always at least one queue
+ * in the system for Rx and Tx. Each network packet that is transmitted
+ * or received goes through a queue whose thread will process it.
  */
 struct net_traffic_class {
-	/** Work queue for handling this Tx or Rx packet */
-	struct k_work_q work_q;
+	/** Queue of the Tx or Rx packets of this traffic class */
+	struct k_fifo fifo;
 
-	/** Stack for this work queue */
-	k_thread_stack_t *stack;
+	/** Thread handling the queue */
+	struct k_thread thread;
 
 	/** Traffic class value */
 	int tc;
@@ -1702,6 +1702,16 @@ bool net_if_is_promisc(struct net_if *iface);
 struct net_if_api {
 	void (*init)(struct net_if *iface);
 	int (*send)(struct net_if *iface, struct net_pkt *pkt);
+
+	/** Optional function to send several packets of the interface in
+	 * one go, which the network stack uses when the TX thread has
+	 * more than one packet queued. It returns how many packets, from
+	 * the start of the array, were sent and so released as with
+	 * send(). The packets that were not sent are then passed to
+	 * send() one at a time.
+	 */
+	int (*send_batch)(struct net_if *iface, struct net_pkt *pkts[],
+			  int count);
 };
 
 #if defined(CONFIG_NET_DHCPV4)
@@ -120,7 +120,10 @@ struct net_pkt {
 				 * Used only if defined(CONFIG_NET_ROUTE)
 				 */
 	u8_t family     : 4;	/* IPv4 vs IPv6 */
-	u8_t _unused    : 1;
+	u8_t sacked     : 1;	/* For outgoing packet: the peer has
+				 * selectively acknowledged it (SACK).
+				 * Used only if defined(CONFIG_NET_TCP)
+				 */
 
 	union {
 		/* IPv6 hop limit or IPv4 ttl for this network packet.
@@ -290,6 +293,16 @@ static inline void net_pkt_set_queued(struct net_pkt *pkt, bool send)
 	pkt->pkt_queued = send;
 }
 
+static inline u8_t net_pkt_sacked(struct net_pkt *pkt)
+{
+	return pkt->sacked;
+}
+
+static inline void net_pkt_set_sacked(struct net_pkt *pkt, bool sacked)
+{
+	pkt->sacked = sacked;
+}
+
 #if defined(CONFIG_NET_SOCKETS)
 static inline u8_t net_pkt_eof(struct net_pkt *pkt)
 {
@@ -688,6 +701,64 @@ static inline void net_pkt_set_src_ipv6_addr(struct net_pkt *pkt)
 	NET_BUF_POOL_DEFINE(name, count, CONFIG_NET_BUF_DATA_SIZE,	\
 			    CONFIG_NET_BUF_USER_DATA_SIZE, NULL)
 
+/** Largest fragment of a variable size data pool, a VLAN tagged frame */
+#define NET_PKT_DATA_VAR_MAX_LEN 1518
+
+/** Bytes a variable size data fragment pool uses per fragment for itself */
+#define NET_PKT_DATA_VAR_OVERHEAD (sizeof(struct k_mem_block_id) + 1)
+
+/** Memory pool block used by a fragment of CONFIG_NET_BUF_DATA_SIZE bytes.
+ * It is a multiple of 16 bytes so that its quarter is a whole number of
+ * 4 byte words, and the quarters of each level tile their parent.
+ */
+#define NET_PKT_DATA_VAR_FRAG_SIZE					\
+	ROUND_UP(CONFIG_NET_BUF_DATA_SIZE + NET_PKT_DATA_VAR_OVERHEAD, 16)
+
+/** Smallest memory pool block of a variable size data fragment pool */
+#define NET_PKT_DATA_VAR_MIN_SIZE (NET_PKT_DATA_VAR_FRAG_SIZE / 4)
+
+#define _NET_PKT_DATA_VAR_FITS(n)					\
+	(NET_PKT_DATA_VAR_FRAG_SIZE * (n) >=				\
+	 NET_PKT_DATA_VAR_MAX_LEN + NET_PKT_DATA_VAR_OVERHEAD)
+
+/** Size of the memory pool blocks of a variable size data fragment pool */
+#define NET_PKT_DATA_VAR_BLOCK_SIZE					\
+	(_NET_PKT_DATA_VAR_FITS(4) ? NET_PKT_DATA_VAR_FRAG_SIZE * 4 :	\
+	 _NET_PKT_DATA_VAR_FITS(16) ? NET_PKT_DATA_VAR_FRAG_SIZE * 16 :	\
+	 NET_PKT_DATA_VAR_FRAG_SIZE * 64)
+
+/**
+ * @brief Create a variable size data fragment net_buf pool
+ *
+ * Like :c:macro:`NET_PKT_DATA_POOL_DEFINE`, but the data of the
+ * fragments is allocated from a memory pool, in the size given to
+ * :c:func:`net_pkt_get_frag_len`. A block of the memory pool holds one
+ * Ethernet frame and is split in quarters down to one block of
+ * NET_PKT_DATA_VAR_FRAG_SIZE bytes, so that an unsized fragment of
+ * CONFIG_NET_BUF_DATA_SIZE bytes does not take more memory than in a
+ * fixed size pool, and once more for short fragments.
+ *
+ * @param name Name of the pool.
+ * @param count Number of net_buf in this pool.
+ * @param size Total size of the data in bytes, rounded up to a multiple
+ *        of NET_PKT_DATA_VAR_BLOCK_SIZE.
+ */
+#define NET_PKT_DATA_VAR_POOL_DEFINE(name, count, size)			\
+	static struct net_buf _net_buf_##name[count] __noinit;		\
+	K_MEM_POOL_DEFINE(net_pkt_mem_pool_##name,			\
+			  NET_PKT_DATA_VAR_MIN_SIZE,			\
+			  NET_PKT_DATA_VAR_BLOCK_SIZE,			\
+			  (((size) + NET_PKT_DATA_VAR_BLOCK_SIZE - 1) /	\
+			   NET_PKT_DATA_VAR_BLOCK_SIZE), 4);		\
+	static const struct net_buf_data_alloc net_pkt_data_alloc_##name = { \
+		.cb = &net_buf_var_cb,					\
+		.alloc_data = &net_pkt_mem_pool_##name,			\
+	};								\
+	struct net_buf_pool name __net_buf_align			\
+			__in_section(_net_buf_pool, static, name) =	\
+		NET_BUF_POOL_INITIALIZER(name, &net_pkt_data_alloc_##name, \
+					 _net_buf_##name, count, NULL)
+
 #if defined(CONFIG_NET_DEBUG_NET_PKT)
 
 /* Debug versions of the net_pkt functions that are used when tracking
@@ -763,6 +834,12 @@ struct net_buf *net_pkt_get_frag_debug(struct net_pkt *pkt,
 #define net_pkt_get_frag(pkt, timeout)					\
 	net_pkt_get_frag_debug(pkt, timeout, __func__, __LINE__)
 
+struct net_buf *net_pkt_get_frag_len_debug(struct net_pkt *pkt, u16_t len,
+					   s32_t timeout,
+					   const char *caller, int line);
+#define net_pkt_get_frag_len(pkt, len, timeout)				\
+	net_pkt_get_frag_len_debug(pkt, len, timeout, __func__, __LINE__)
+
 void net_pkt_unref_debug(struct net_pkt *pkt, const char *caller, int line);
 #define net_pkt_unref(pkt) net_pkt_unref_debug(pkt, __func__, __LINE__)
 
@@ -966,6 +1043,28 @@ struct net_buf *net_pkt_get_reserve_tx_data(u16_t reserve_head,
  */
 struct net_buf *net_pkt_get_frag(struct net_pkt *pkt, s32_t timeout);
 
+/**
+ * @brief Get a data fragment for len bytes of data that might be from
+ * user specific buffer pool or from global DATA pool.
+ *
+ * @details With CONFIG_NET_BUF_VARIABLE_DATA_SIZE, the data of the
+ * fragment is allocated for len bytes after the link layer reserve of
+ * the packet, up to what a block of the pool holds. Fixed size pools
+ * give a fragment of their own size, so the caller must check
+ * net_buf_tailroom() of the fragment.
+ *
+ * @param pkt Network packet.
+ * @param len Amount of data to be placed in the fragment.
+ * @param timeout Affects the action taken should the net buf pool be empty.
+ *        If K_NO_WAIT, then return immediately. If K_FOREVER, then
+ *        wait as long as necessary. Otherwise, wait up to the specified
+ *        number of milliseconds before timing out.
+ *
+ * @return Network buffer if successful, NULL otherwise.
+ */
+struct net_buf *net_pkt_get_frag_len(struct net_pkt *pkt, u16_t len,
+				     s32_t timeout);
+
 /**
  * @brief Place packet back into the available packets slab
  *
@@ -1455,6 +1554,369 @@ static inline struct net_buf *net_pkt_write_be32(struct net_pkt *pkt,
 			     (u8_t *)&value, K_FOREVER);
 }
 
+/**
+ * @brief Position in the data of a network packet.
+ *
+ * @details A cursor remembers the fragment and the position in it where
+ * the previous read or write ended, so that consecutive accesses do not
+ * walk the fragment list from the start of the packet every time as
+ * net_frag_read() and net_pkt_write() with a packet offset do.
+ *
+ * The position can be at the end of the data of a fragment, the cursor
+ * then moves to the next fragment with the next access.
+ */
+struct net_pkt_cursor {
+	/** Packet the fragments belong to, new ones are added to it */
+	struct net_pkt *pkt;
+
+	/** Current fragment, NULL if the packet has none */
+	struct net_buf *frag;
+
+	/** Position in the data of the current fragment */
+	u16_t pos;
+
+	/** Offset of the position from the start of the packet data */
+	u16_t offset;
+};
+
+/**
+ * @brief Initialize a cursor at an offset in packet data.
+ *
+ * @param cursor Cursor to initialize.
+ * @param pkt Network packet.
+ * @param offset Offset from the start of the data of the first fragment.
+ *
+ * @return 0 on success, -ENODATA if the packet has less data than offset.
+ */
+int net_pkt_cursor_init(struct net_pkt_cursor *cursor, struct net_pkt *pkt,
+			u16_t offset);
+
+/**
+ * @brief Initialize a cursor at a position in a fragment of a packet.
+ *
+ * @details This is for code holding a fragment and position from the
+ * net_frag_read() family of functions. The fragment must belong to pkt.
+ *
+ * @param cursor Cursor to initialize.
+ * @param pkt Network packet.
+ * @param frag Fragment of pkt.
+ * @param pos Position in the data of frag.
+ */
+void net_pkt_cursor_init_frag(struct net_pkt_cursor *cursor,
+			      struct net_pkt *pkt, struct net_buf *frag,
+			      u16_t pos);
+
+/**
+ * @brief Read data at a cursor and move the cursor after it.
+ *
+ * @details The data can span several fragments. Caller has to take care
+ * of endianness if needed.
+ *
+ * @param cursor Cursor.
+ * @param data Data will be copied here, NULL to skip the data.
+ * @param len Length of the data.
+ *
+ * @return 0 on success, -ENODATA if there are less than len bytes of data
+ *         left, in which case the cursor is not moved.
+ */
+int net_pkt_cursor_read(struct net_pkt_cursor *cursor, void *data,
+			u16_t len);
+
+/**
+ * @brief Write data at a cursor and move the cursor after it.
+ *
+ * @details Existing data is overwritten. Past the end of the packet data,
+ * the tailroom of the last fragment is used and new fragments are added
+ * to the packet as needed.
+ *
+ * @param cursor Cursor.
+ * @param data Data to be written.
+ * @param len Length of the data.
+ * @param timeout Affects the action taken should the net buf pool be empty.
+ *        If K_NO_WAIT, then return immediately. If K_FOREVER, then
+ *        wait as long as necessary. Otherwise, wait up to the specified
+ *        number of milliseconds before timing out.
+ *
+ * @return 0 on success, -ENOMEM if no fragment could be allocated, in which
+ *         case part of the data may have been written and the cursor is
+ *         not moved.
+ */
+int net_pkt_cursor_write(struct net_pkt_cursor *cursor, const void *data,
+			 u16_t len, s32_t timeout);
+
+/**
+ * @brief Skip data at a cursor.
+ *
+ * @param cursor Cursor.
+ * @param len Length of the data to skip.
+ *
+ * @return 0 on success, -ENODATA if there is not enough data left, in
+ *         which case the cursor is not moved.
+ */
+static inline int net_pkt_cursor_skip(struct net_pkt_cursor *cursor,
+				      u16_t len)
+{
+	return net_pkt_cursor_read(cursor, NULL, len);
+}
+
+/**
+ * @brief Check whether there is no data left at a cursor.
+ *
+ * @param cursor Cursor.
+ *
+ * @return True if the cursor is at the end of the packet data.
+ */
+static inline bool net_pkt_cursor_is_end(const struct net_pkt_cursor *cursor)
+{
+	struct net_buf *frag = cursor->frag;
+	u16_t pos = cursor->pos;
+
+	while (frag && pos >= frag->len) {
+		frag = frag->frags;
+		pos = 0;
+	}
+
+	return !frag;
+}
+
+/**
+ * @brief Get the length of the data left in the current fragment.
+ *
+ * @param cursor Cursor.
+ *
+ * @return Number of bytes from the cursor to the end of the data of the
+ *         current fragment, 0 if there is no fragment.
+ */
+static inline u16_t net_pkt_cursor_frag_left(struct net_pkt_cursor *cursor)
+{
+	return cursor->frag ? cursor->frag->len - cursor->pos : 0;
+}
+
+/**
+ * @brief Move a cursor forward within the current fragment.
+ *
+ * @details The caller has to make sure with net_pkt_cursor_frag_left()
+ * that the current fragment holds len more bytes.
+ *
+ * @param cursor Cursor.
+ * @param len Number of bytes to move the cursor by.
+ */
+static inline void net_pkt_cursor_advance(struct net_pkt_cursor *cursor,
+					  u16_t len)
+{
+	cursor->pos += len;
+	cursor->offset += len;
+}
+
+/**
+ * @brief Read a byte at a cursor and move the cursor after it.
+ *
+ * @param cursor Cursor.
+ * @param value Value is returned.
+ *
+ * @return 0 on success, -ENODATA if there is not enough data left, in
+ *         which case the cursor is not moved.
+ */
+static inline int net_pkt_cursor_read_u8(struct net_pkt_cursor *cursor,
+					 u8_t *value)
+{
+	if (net_pkt_cursor_frag_left(cursor) >= sizeof(u8_t)) {
+		*value = cursor->frag->data[cursor->pos];
+		net_pkt_cursor_advance(cursor, sizeof(u8_t));
+
+		return 0;
+	}
+
+	return net_pkt_cursor_read(cursor, value, sizeof(u8_t));
+}
+
+/**
+ * @brief Read a big endian u16_t value at a cursor and move the cursor
+ * after it.
+ *
+ * @param cursor Cursor.
+ * @param value Value is returned in host byte order.
+ *
+ * @return 0 on success, -ENODATA if there is not enough data left, in
+ *         which case the cursor is not moved.
+ */
+static inline int net_pkt_cursor_read_be16(struct net_pkt_cursor *cursor,
+					   u16_t *value)
+{
+	u8_t v16[2];
+	int ret;
+
+	if (net_pkt_cursor_frag_left(cursor) >= sizeof(u16_t)) {
+		*value = sys_get_be16(cursor->frag->data + cursor->pos);
+		net_pkt_cursor_advance(cursor, sizeof(u16_t));
+
+		return 0;
+	}
+
+	ret = net_pkt_cursor_read(cursor, v16, sizeof(u16_t));
+	if (ret < 0) {
+		return ret;
+	}
+
+	*value = sys_get_be16(v16);
+
+	return 0;
+}
+
+/**
+ * @brief Read a big endian u32_t value at a cursor and move the cursor
+ * after it.
+ *
+ * @param cursor Cursor.
+ * @param value Value is returned in host byte order.
+ *
+ * @return 0 on success, -ENODATA if there is not enough data left, in
+ *         which case the cursor is not moved.
+ */
+static inline int net_pkt_cursor_read_be32(struct net_pkt_cursor *cursor,
+					   u32_t *value)
+{
+	u8_t v32[4];
+	int ret;
+
+	if (net_pkt_cursor_frag_left(cursor) >= sizeof(u32_t)) {
+		*value = sys_get_be32(cursor->frag->data + cursor->pos);
+		net_pkt_cursor_advance(cursor, sizeof(u32_t));
+
+		return 0;
+	}
+
+	ret = net_pkt_cursor_read(cursor, v32, sizeof(u32_t));
+	if (ret < 0) {
+		return ret;
+	}
+
+	*value = sys_get_be32(v32);
+
+	return 0;
+}
+
+/**
+ * @brief Read data at a cursor without moving the cursor.
+ *
+ * @param cursor Cursor.
+ * @param data Data will be copied here.
+ * @param len Length of the data.
+ *
+ * @return 0 on success, -ENODATA if there is not enough data left.
+ */
+static inline int net_pkt_cursor_peek(const struct net_pkt_cursor *cursor,
+				      void *data, u16_t len)
+{
+	struct net_pkt_cursor tmp = *cursor;
+
+	return net_pkt_cursor_read(&tmp, data, len);
+}
+
+/**
+ * @brief Read a byte at a cursor without moving the cursor.
+ *
+ * @param cursor Cursor.
+ * @param value Value is returned.
+ *
+ * @return 0 on success, -ENODATA if there is not enough data left.
+ */
+static inline int net_pkt_cursor_peek_u8(const struct net_pkt_cursor *cursor,
+					 u8_t *value)
+{
+	struct net_pkt_cursor tmp = *cursor;
+
+	return net_pkt_cursor_read_u8(&tmp, value);
+}
+
+/**
+ * @brief Read a big endian u16_t value at a cursor without moving the
+ * cursor.
+ *
+ * @param cursor Cursor.
+ * @param value Value is returned in host byte order.
+ *
+ * @return 0 on success, -ENODATA if there is not enough data left.
+ */
+static inline int net_pkt_cursor_peek_be16(const struct net_pkt_cursor *cursor,
+					   u16_t *value)
+{
+	struct net_pkt_cursor tmp = *cursor;
+
+	return net_pkt_cursor_read_be16(&tmp, value);
+}
+
+/**
+ * @brief Read a big endian u32_t value at a cursor without moving the
+ * cursor.
+ *
+ * @param cursor Cursor.
+ * @param value Value is returned in host byte order.
+ *
+ * @return 0 on success, -ENODATA if there is not enough data left.
+ */
+static inline int net_pkt_cursor_peek_be32(const struct net_pkt_cursor *cursor,
+					   u32_t *value)
+{
+	struct net_pkt_cursor tmp = *cursor;
+
+	return net_pkt_cursor_read_be32(&tmp, value);
+}
+
+/**
+ * @brief Write a byte at a cursor and move the cursor after it.
+ *
+ * @details Waits for a fragment if one has to be added.
+ *
+ * @param cursor Cursor.
+ * @param data Byte to be written.
+ *
+ * @return 0 on success, -ENOMEM if no fragment could be allocated.
+ */
+static inline int net_pkt_cursor_write_u8(struct net_pkt_cursor *cursor,
+					  u8_t data)
+{
+	return net_pkt_cursor_write(cursor, &data, sizeof(u8_t), K_FOREVER);
+}
+
+/**
+ * @brief Write a u16_t value in big endian at a cursor and move the
+ * cursor after it.
+ *
+ * @details Waits for a fragment if one has to be added.
+ *
+ * @param cursor Cursor.
+ * @param data Value to be written, in host byte order.
+ *
+ * @return 0 on success, -ENOMEM if no fragment could be allocated.
+ */
+static inline int net_pkt_cursor_write_be16(struct net_pkt_cursor *cursor,
+					    u16_t data)
+{
+	u16_t value = htons(data);
+
+	return net_pkt_cursor_write(cursor, &value, sizeof(u16_t), K_FOREVER);
+}
+
+/**
+ * @brief Write a u32_t value in big endian at a cursor and move the
+ * cursor after it.
+ *
+ * @details Waits for a fragment if one has to be added.
+ *
+ * @param cursor Cursor.
+ * @param data Value to be written, in host byte order.
+ *
+ * @return 0 on success, -ENOMEM if no fragment could be allocated.
+ */
+static inline int net_pkt_cursor_write_be32(struct net_pkt_cursor *cursor,
+					    u32_t data)
+{
+	u32_t value = htonl(data);
+
+	return net_pkt_cursor_write(cursor, &value, sizeof(u32_t), K_FOREVER);
+}
+
 /**
  * @brief Insert data at an arbitrary offset in a series of fragments.
  *
@@ -36,6 +36,20 @@
  *
  * - STATS_SECT_ENTRY64(): 64-bits.  Useful for storing chunks of data.
  *
+ * Two more kinds of groups hold 32-bit entries which are updated atomically,
+ * so they can be used from any context without locking.  As with the entry
+ * size, all entries of such a group must be of the same kind.
+ *
+ * - STATS_SECT_ENTRY_PCPU(): a counter with one slot per CPU, incremented
+ *   with STATS_PCPU_INC() and summed when read.  CPUs do not contend for the
+ *   same counter.  The group is registered with STATS_PCPU_INIT_AND_REG().
+ *
+ * - STATS_SECT_ENTRY_HIST(): a histogram with log2 buckets, updated with
+ *   STATS_HIST_ADD().  Bucket 0 counts the value 0 and bucket n counts
+ *   values from 2^(n-1) to 2^n - 1, the last bucket also counts all larger
+ *   values.  The group is registered with STATS_HIST_INIT_AND_REG().  Each
+ *   bucket is reported as a separate entry, named "<entry>.<bucket>".
+ *
  * Following the static entry declaration is the statistic names declaration.
  * This is compiled out when the CONFIGURE_STATS_NAME setting is undefined.
  *
@@ -53,6 +67,9 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <atomic.h>
+#include <arch/cpu.h>
+#include <misc/util.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -63,11 +80,24 @@ struct stats_name_map {
 	const char *snm_name;
 } __packed;
 
+/** Kinds of statistics groups */
+enum stats_type {
+	/** Counters of 16, 32 or 64 bits */
+	STATS_TYPE_COUNTER,
+	/** Per-CPU 32-bit counters */
+	STATS_TYPE_PCPU,
+	/** Histograms of 32-bit buckets */
+	STATS_TYPE_HIST,
+};
+
 struct stats_hdr {
 	const char *s_name;
 	u8_t s_size;
-	u8_t s_cnt;
-	u16_t s_pad1;
+	u8_t s_type;
+	/** Number of values of s_size bytes, which may be several per entry */
+	u16_t s_cnt;
+	/** Number of buckets of each histogram */
+	u8_t s_buckets;
 #ifdef CONFIG_STATS_NAMES
 	const struct stats_name_map *s_map;
 	int s_map_cnt;
@@ -130,6 +160,28 @@ struct stats_hdr {
  */
 #define STATS_SECT_ENTRY64(var__) u64_t var__;
 
+#ifdef CONFIG_SMP
+#define STATS_NUM_CPUS CONFIG_MP_NUM_CPUS
+#else
+#define STATS_NUM_CPUS 1
+#endif
+
+/**
+ * @brief Declares a per-CPU stat entry inside a group struct.
+ *
+ * @param var__                 The name to assign to the entry.
+ */
+#define STATS_SECT_ENTRY_PCPU(var__) u32_t var__[STATS_NUM_CPUS];
+
+/**
+ * @brief Declares a log2 histogram stat entry inside a group struct.
+ *
+ * @param var__                 The name to assign to the entry.
+ * @param buckets__             The number of buckets, at most 33.  Must be
+ *                                  the same for all entries of the group.
+ */
+#define STATS_SECT_ENTRY_HIST(var__, buckets__) u32_t var__[buckets__];
+
 /**
  * @brief Increases a statistic entry by the specified amount.
  *
@@ -167,6 +219,63 @@ struct stats_hdr {
 #define STATS_CLEAR(group__, var__) \
 	((group__).var__ = 0)
 
+#ifdef CONFIG_SMP
+void stats_pcpu_incn(u32_t *slots, u32_t n);
+#else
+static inline void stats_pcpu_incn(u32_t *slots, u32_t n)
+{
+	atomic_add((atomic_t *)slots, n);
+}
+#endif
+
+/**
+ * @brief Adds a value to a log2 histogram.
+ *
+ * @param buckets               The buckets of the histogram.
+ * @param cnt                   The number of buckets.
+ * @param value                 The value to count.
+ */
+static inline void stats_hist_add(u32_t *buckets, u8_t cnt, u32_t value)
+{
+	atomic_inc((atomic_t *)&buckets[min(find_msb_set(value), cnt - 1U)]);
+}
+
+/**
+ * @brief Increases a per-CPU statistic entry by the specified amount.
+ *
+ * The slot of the current CPU is increased atomically.  Compiled out if
+ * CONFIG_STATS is not defined.
+ *
+ * @param group__               The group containing the entry to increase.
+ * @param var__                 The statistic entry to increase.
+ * @param n__                   The amount to increase the statistic entry by.
+ */
+#define STATS_PCPU_INCN(group__, var__, n__) \
+	stats_pcpu_incn((group__).var__, (n__))
+
+/**
+ * @brief Increments a per-CPU statistic entry.
+ *
+ * @param group__               The group containing the entry to increase.
+ * @param var__                 The statistic entry to increase.
+ */
+#define STATS_PCPU_INC(group__, var__) \
+	STATS_PCPU_INCN(group__, var__, 1)
+
+/**
+ * @brief Counts a value in a histogram statistic entry.
+ *
+ * The bucket of the value is incremented atomically.  Compiled out if
+ * CONFIG_STATS is not defined.
+ *
+ * @param group__               The group containing the histogram.
+ * @param var__                 The histogram entry.
+ * @param value__               The value to count, e.g. a packet size or a
+ *                                  latency in cycles.
+ */
+#define STATS_HIST_ADD(group__, var__, value__) \
+	stats_hist_add((group__).var__, ARRAY_SIZE((group__).var__), (value__))
+
 #define STATS_SIZE_16 (sizeof(u16_t))
 #define STATS_SIZE_32 (sizeof(u32_t))
 #define STATS_SIZE_64 (sizeof(u64_t))
@@ -197,6 +306,41 @@ struct stats_hdr {
 		STATS_NAME_INIT_PARMS(group__),				 \
 		(name__))
 
+/**
+ * @brief Initializes and registers a group of per-CPU counters.
+ *
+ * @param group__               The statistics group to initialize and
+ *                                  register.
+ * @param name__                The name of the statistics group to register.
+ *
+ * @return                      0 on success; negative error code on failure.
+ */
+#define STATS_PCPU_INIT_AND_REG(group__, name__)			\
+	stats_init_and_reg_type(&(group__).s_hdr, STATS_TYPE_PCPU,	\
+				STATS_NUM_CPUS,				\
+				(sizeof(group__) -			\
+				 sizeof(struct stats_hdr)) / sizeof(u32_t), \
+				STATS_NAME_INIT_PARMS(group__),		\
+				(name__))
+
+/**
+ * @brief Initializes and registers a group of histograms.
+ *
+ * @param group__               The statistics group to initialize and
+ *                                  register.
+ * @param buckets__             The number of buckets of each histogram.
+ * @param name__                The name of the statistics group to register.
+ *
+ * @return                      0 on success; negative error code on failure.
+ */
+#define STATS_HIST_INIT_AND_REG(group__, buckets__, name__)		\
+	stats_init_and_reg_type(&(group__).s_hdr, STATS_TYPE_HIST,	\
+				(buckets__),				\
+				(sizeof(group__) -			\
+				 sizeof(struct stats_hdr)) / sizeof(u32_t), \
+				STATS_NAME_INIT_PARMS(group__),		\
+				(name__))
+
 /**
  * @brief Initializes a statistics group.
  *
@@ -214,7 +358,7 @@ struct stats_hdr {
  * @param group__               The group containing the entry to clear.
  * @param var__                 The statistic entry to clear.
  */
-void stats_init(struct stats_hdr *shdr, uint8_t size, uint8_t cnt,
+void stats_init(struct stats_hdr *shdr, uint8_t size, u16_t cnt,
 		const struct stats_name_map *map, uint8_t map_cnt);
 
 /**
@@ -255,10 +399,47 @@ int stats_register(const char *name, struct stats_hdr *shdr);
  *
  * @see STATS_INIT_AND_REG
  */
-int stats_init_and_reg(struct stats_hdr *hdr, uint8_t size, uint8_t cnt,
+int stats_init_and_reg(struct stats_hdr *hdr, uint8_t size, u16_t cnt,
 		       const struct stats_name_map *map, uint8_t map_cnt,
 		       const char *name);
 
+/**
+ * @brief Initializes and registers a group of per-CPU counters or
+ * histograms.
+ *
+ * Note: it is recommended to use the STATS_PCPU_INIT_AND_REG and
+ * STATS_HIST_INIT_AND_REG macros instead of this function.
+ *
+ * @param hdr                   The header of the statistics group to
+ *                                  initialize and register.
+ * @param type                  STATS_TYPE_PCPU or STATS_TYPE_HIST.
+ * @param stride                The number of 32-bit values of each entry:
+ *                                  the number of CPUs or of buckets.
+ * @param cnt                   The number of 32-bit values in the group.
+ * @param map                   The mapping of stat offset to name.
+ * @param map_cnt               The number of items in the statistics map
+ * @param name                  The name of the statistics group to register.
+ *
+ * @return                      0 on success; negative error code on failure.
+ */
+int stats_init_and_reg_type(struct stats_hdr *hdr, enum stats_type type,
+			    u8_t stride, u16_t cnt,
+			    const struct stats_name_map *map, u8_t map_cnt,
+			    const char *name);
+
+/**
+ * @brief Reads a statistic entry.
+ *
+ * Per-CPU counters are summed over all CPUs.
+ *
+ * @param hdr                   The group containing the entry.
+ * @param off                   The offset of the entry, from `hdr`, as
+ *                                  passed to a stats_walk_fn.
+ *
+ * @return                      The value of the entry.
+ */
+u64_t stats_value_get(const struct stats_hdr *hdr, u16_t off);
+
 /**
  * Zeroes the specified statistics group.
  *
@@ -284,6 +465,9 @@ typedef int stats_walk_fn(struct stats_hdr *hdr, void *arg,
 /**
  * @brief Applies a function to every stat entry in a group.
  *
+ * The function is applied once to each per-CPU counter and to each bucket
+ * of a histogram.  Values should be read with stats_value_get().
+ *
  * @param hdr                   The stats group to operate on.
  * @param walk_cb               The function to apply to each stat entry.
  * @param arg                   Optional argument to pass to the callback.
@@ -345,12 +529,19 @@ struct stats_hdr *stats_group_find(const char *name);
 #define STATS_SECT_ENTRY16(var__)
 #define STATS_SECT_ENTRY32(var__)
 #define STATS_SECT_ENTRY64(var__)
+#define STATS_SECT_ENTRY_PCPU(var__)
+#define STATS_SECT_ENTRY_HIST(var__, buckets__)
 #define STATS_RESET(var__)
 #define STATS_SIZE_INIT_PARMS(group__, size__)
 #define STATS_INCN(group__, var__, n__)
 #define STATS_INC(group__, var__)
 #define STATS_CLEAR(group__, var__)
+#define STATS_PCPU_INCN(group__, var__, n__)
+#define STATS_PCPU_INC(group__, var__)
+#define STATS_HIST_ADD(group__, var__, value__)
 #define STATS_INIT_AND_REG(group__, size__, name__) (0)
+#define STATS_PCPU_INIT_AND_REG(group__, name__) (0)
+#define STATS_HIST_INIT_AND_REG(group__, buckets__, name__) (0)
 
 #endif /* !CONFIG_STATS */
 
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Thread pools
+ *
+ * A thread pool owns a fixed set of thread objects and stacks. Slots are
+ * either spawned, in which case they go back to the pool as soon as their
+ * thread is dead, or reserved by k_thread_pool_alloc() until the owner
+ * calls k_thread_pool_free(). Thread death is detected lazily from the
+ * thread state, so threads that are aborted rather than returning from
+ * their entry point are recycled as well.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <ksched.h>
+#include <misc/__assert.h>
+#include <errno.h>
+
+/* Slot reserved by k_thread_pool_alloc() */
+#define SLOT_BUSY BIT(0)
+/* A thread has been created on the slot, it is in use unless dead */
+#define SLOT_STARTED BIT(1)
+
+static inline struct k_thread *slot_thread(struct k_thread_pool *pool,
+					   u32_t i)
+{
+	return (struct k_thread *)(pool->threads + i * pool->thread_size);
+}
+
+static inline k_thread_stack_t *slot_stack(struct k_thread_pool *pool,
+					   u32_t i)
+{
+	return (k_thread_stack_t *)(pool->stacks + i * pool->stack_stride);
+}
+
+static int slot_index(struct k_thread_pool *pool, struct k_thread *thread)
+{
+	char *p = (char *)thread;
+
+	if (p < pool->threads ||
+	    p >= pool->threads + pool->num_threads * pool->thread_size ||
+	    (p - pool->threads) % pool->thread_size) {
+		return -1;
+	}
+
+	return (p - pool->threads) / pool->thread_size;
+}
+
+/* Must be called with interrupts locked */
+static int slot_claim(struct k_thread_pool *pool)
+{
+	u32_t i;
+
+	for (i = 0; i < pool->num_threads; i++) {
+		u8_t flags = pool->slots[i].flags;
+
+		if (flags & SLOT_BUSY) {
+			continue;
+		}
+
+		if ((flags & SLOT_STARTED) &&
+		    !_is_thread_state_set(slot_thread(pool, i), _THREAD_DEAD)) {
+			continue;
+		}
+
+		pool->slots[i].flags = SLOT_BUSY;
+		return i;
+	}
+
+	return -1;
+}
+
+/* Must be called with interrupts locked */
+static bool req_dequeue(struct k_thread_pool *pool,
+			struct k_thread_pool_req *req)
+{
+	if (!pool->num_reqs) {
+		return false;
+	}
+
+	*req = pool->reqs[pool->req_head];
+	pool->req_head = (pool->req_head + 1) % pool->max_reqs;
+	pool->num_reqs--;
+
+	return true;
+}
+
+/* Must be called with interrupts locked */
+static bool req_enqueue(struct k_thread_pool *pool,
+			const struct k_thread_pool_req *req)
+{
+	if (pool->num_reqs == pool->max_reqs) {
+		return false;
+	}
+
+	pool->reqs[(pool->req_head + pool->num_reqs) % pool->max_reqs] = *req;
+	pool->num_reqs++;
+
+	return true;
+}
+
+static void thread_pool_entry(void *p1, void *p2, void *p3)
+{
+	struct k_thread_pool *pool = p1;
+	struct k_thread_pool_slot *slot = p2;
+	unsigned int key;
+
+	ARG_UNUSED(p3);
+
+	while (1) {
+		slot->req.entry(slot->req.p1, slot->req.p2, slot->req.p3);
+
+		key = irq_lock();
+
+		if (!req_dequeue(pool, &slot->req)) {
+			break;
+		}
+
+		irq_unlock(key);
+
+		/* Recycle this thread, stack and all, for the queued request */
+		k_thread_priority_set(_current, slot->req.prio);
+	}
+
+	/*
+	 * Exit with interrupts still locked: no request can be queued
+	 * between finding the queue empty and this thread being dead,
+	 * which is what makes its slot claimable again.
+	 */
+	k_thread_abort(_current);
+
+	CODE_UNREACHABLE;
+}
+
+/*
+ * Start @a req on the claimed slot @a i. The thread is created inactive so
+ * the slot can be handed over to the kernel's thread state before the
+ * thread gets a chance to run and exit.
+ */
+static k_tid_t slot_spawn(struct k_thread_pool *pool, int i,
+			  const struct k_thread_pool_req *req)
+{
+	struct k_thread_pool_slot *slot = &pool->slots[i];
+	struct k_thread *thread = slot_thread(pool, i);
+	unsigned int key;
+
+	slot->req = *req;
+
+	k_thread_create(thread, slot_stack(pool, i), pool->stack_size,
+			thread_pool_entry, pool, slot, NULL,
+			req->prio, pool->options, K_FOREVER);
+
+	key = irq_lock();
+	slot->flags = SLOT_STARTED;
+	irq_unlock(key);
+
+	k_thread_start(thread);
+
+	return thread;
+}
+
+/* Hand queued requests to the slots that have become free */
+static void thread_pool_dispatch(struct k_thread_pool *pool)
+{
+	struct k_thread_pool_req req;
+	unsigned int key;
+	int i;
+
+	while (1) {
+		key = irq_lock();
+
+		if (!pool->num_reqs) {
+			irq_unlock(key);
+			return;
+		}
+
+		i = slot_claim(pool);
+		if (i < 0) {
+			irq_unlock(key);
+			return;
+		}
+
+		req_dequeue(pool, &req);
+		irq_unlock(key);
+
+		slot_spawn(pool, i, &req);
+	}
+}
+
+int k_thread_pool_spawn(struct k_thread_pool *pool, k_thread_entry_t entry,
+			void *p1, void *p2, void *p3, int prio, k_tid_t *tid)
+{
+	struct k_thread_pool_req req = {
+		.entry = entry,
+		.p1 = p1,
+		.p2 = p2,
+		.p3 = p3,
+		.prio = prio,
+	};
+	unsigned int key;
+	k_tid_t new_thread;
+	int i;
+
+	__ASSERT(!_is_in_isr(), "Threads may not be spawned in ISRs");
+	__ASSERT(!(pool->options & K_ESSENTIAL),
+		 "pool threads may not be essential");
+
+	/* Earlier requests first */
+	thread_pool_dispatch(pool);
+
+	key = irq_lock();
+
+	if (pool->num_reqs) {
+		i = -1;
+	} else {
+		i = slot_claim(pool);
+	}
+
+	if (i < 0) {
+		bool queued = req_enqueue(pool, &req);
+
+		irq_unlock(key);
+		return queued ? -EINPROGRESS : -ENOMEM;
+	}
+
+	irq_unlock(key);
+
+	new_thread = slot_spawn(pool, i, &req);
+	if (tid) {
+		*tid = new_thread;
+	}
+
+	return 0;
+}
+
+struct k_thread *k_thread_pool_alloc(struct k_thread_pool *pool)
+{
+	unsigned int key;
+	int i;
+
+	key = irq_lock();
+	i = slot_claim(pool);
+	irq_unlock(key);
+
+	return (i < 0) ? NULL : slot_thread(pool, i);
+}
+
+k_tid_t k_thread_pool_start(struct k_thread_pool *pool,
+			    struct k_thread *thread, k_thread_entry_t entry,
+			    void *p1, void *p2, void *p3, int prio,
+			    s32_t delay)
+{
+	int i = slot_index(pool, thread);
+	unsigned int key;
+
+	__ASSERT(i >= 0 && (pool->slots[i].flags & SLOT_BUSY),
+		 "thread %p not allocated from pool %p", thread, pool);
+
+	/* The slot stays reserved, so it can be marked before creation */
+	key = irq_lock();
+	pool->slots[i].flags |= SLOT_STARTED;
+	irq_unlock(key);
+
+	return k_thread_create(thread, slot_stack(pool, i), pool->stack_size,
+			       entry, p1, p2, p3, prio, pool->options, delay);
+}
+
+int k_thread_pool_free(struct k_thread_pool *pool, struct k_thread *thread)
+{
+	int i = slot_index(pool, thread);
+	unsigned int key;
+
+	if (i < 0) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+	pool->slots[i].flags &= ~SLOT_BUSY;
+	irq_unlock(key);
+
+	if (!_is_in_isr()) {
+		thread_pool_dispatch(pool);
+	}
+
+	return 0;
+}
@@ -24,7 +24,12 @@
 
 #include <stdint.h>
 #include <errno.h>
+#include <string.h>
+#include <misc/util.h>
 #include <base64.h>
+#ifdef CONFIG_NET_BUF
+#include <net/buf.h>
+#endif
 
 static const u8_t base64_enc_map[64] = {
 	'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J',
@@ -54,14 +59,100 @@ static const u8_t base64_dec_map[128] = {
 
 #define BASE64_SIZE_T_MAX	((size_t) -1) /* SIZE_T_MAX is not standard */
 
+/* Decoded value of the padding character '=' */
+#define BASE64_PAD 64
+
+/* Decoded values of invalid characters and of '=' have bit 6 set */
+#define BASE64_NOT_SEXTET 0x40
+
+/*
+ * Encode groups of three bytes, each read as one 24-bit word and written as
+ * four characters.
+ */
+static u8_t *encode_groups(u8_t *p, const u8_t *src, size_t groups)
+{
+	u32_t w;
+
+	for (; groups > 0; groups--) {
+		w = ((u32_t)src[0] << 16) | ((u32_t)src[1] << 8) | src[2];
+		src += 3;
+
+		p[0] = base64_enc_map[w >> 18];
+		p[1] = base64_enc_map[(w >> 12) & 0x3F];
+		p[2] = base64_enc_map[(w >> 6) & 0x3F];
+		p[3] = base64_enc_map[w & 0x3F];
+		p += 4;
+	}
+
+	return p;
+}
+
+/* Encode the last one or two bytes as a group padded with '=' */
+static u8_t *encode_tail(u8_t *p, const u8_t *src, size_t len)
+{
+	u32_t w;
+
+	w = (u32_t)src[0] << 16;
+	if (len > 1) {
+		w |= (u32_t)src[1] << 8;
+	}
+
+	p[0] = base64_enc_map[w >> 18];
+	p[1] = base64_enc_map[(w >> 12) & 0x3F];
+	p[2] = len > 1 ? base64_enc_map[(w >> 6) & 0x3F] : '=';
+	p[3] = '=';
+
+	return p + 4;
+}
+
+/*
+ * Decode groups of four characters as long as they hold no padding, white
+ * space or invalid character. Returns the number of characters consumed.
+ */
+static size_t decode_groups(u8_t **pp, const u8_t *src, size_t slen)
+{
+	u8_t *p = *pp;
+	u32_t c0, c1, c2, c3;
+	size_t i;
+
+	for (i = 0; i + 4 <= slen; i += 4) {
+		c0 = src[i];
+		c1 = src[i + 1];
+		c2 = src[i + 2];
+		c3 = src[i + 3];
+
+		if ((c0 | c1 | c2 | c3) & 0x80) {
+			break;
+		}
+
+		c0 = base64_dec_map[c0];
+		c1 = base64_dec_map[c1];
+		c2 = base64_dec_map[c2];
+		c3 = base64_dec_map[c3];
+
+		if ((c0 | c1 | c2 | c3) & BASE64_NOT_SEXTET) {
+			break;
+		}
+
+		c0 = (c0 << 18) | (c1 << 12) | (c2 << 6) | c3;
+		p[0] = c0 >> 16;
+		p[1] = c0 >> 8;
+		p[2] = c0;
+		p += 3;
+	}
+
+	*pp = p;
+
+	return i;
+}
+
 /*
  * Encode a buffer into base64 format
  */
 int base64_encode(u8_t *dst, size_t dlen, size_t *olen, const u8_t *src,
 		  size_t slen)
 {
-	size_t i, n;
-	int C1, C2, C3;
+	size_t n;
 	u8_t *p;
 
 	if (slen == 0) {
@@ -83,33 +174,12 @@ int base64_encode(u8_t *dst, size_t dlen, size_t *olen, const u8_t *src,
 		return -ENOMEM;
 	}
 
-	n = (slen / 3) * 3;
+	n = slen / 3;
 
-	for (i = 0, p = dst; i < n; i += 3) {
-		C1 = *src++;
-		C2 = *src++;
-		C3 = *src++;
+	p = encode_groups(dst, src, n);
 
-		*p++ = base64_enc_map[(C1 >> 2) & 0x3F];
-		*p++ = base64_enc_map[(((C1 &  3) << 4) + (C2 >> 4)) & 0x3F];
-		*p++ = base64_enc_map[(((C2 & 15) << 2) + (C3 >> 6)) & 0x3F];
-		*p++ = base64_enc_map[C3 & 0x3F];
-	}
-
-	if (i < slen) {
-		C1 = *src++;
-		C2 = ((i + 1) < slen) ? *src++ : 0;
-
-		*p++ = base64_enc_map[(C1 >> 2) & 0x3F];
-		*p++ = base64_enc_map[(((C1 & 3) << 4) + (C2 >> 4)) & 0x3F];
-
-		if ((i + 1) < slen) {
-			*p++ = base64_enc_map[((C2 & 15) << 2) & 0x3F];
-		} else {
-			*p++ = '=';
-		}
-
-		*p++ = '=';
+	if (slen % 3) {
+		p = encode_tail(p, src + n * 3, slen % 3);
 	}
 
 	*olen = p - dst;
@@ -130,6 +200,19 @@ int base64_decode(u8_t *dst, size_t dlen, size_t *olen, const u8_t *src,
 
 	/* First pass: check for validity and get output length */
 	for (i = n = j = 0; i < slen; i++) {
+		/* Runs of data characters before any padding are valid */
+		if (j == 0) {
+			while (i < slen && src[i] < 128 &&
+			       !(base64_dec_map[src[i]] & BASE64_NOT_SEXTET)) {
+				i++;
+				n++;
+			}
+
+			if (i == slen) {
+				break;
+			}
+		}
+
 		/* Skip spaces before checking for EOL */
 		x = 0;
 		while (i < slen && src[i] == ' ') {
@@ -188,6 +271,15 @@ int base64_decode(u8_t *dst, size_t dlen, size_t *olen, const u8_t *src,
 	}
 
 	for (j = 3, n = x = 0, p = dst; i > 0; i--, src++) {
+		if (n == 0 && j == 3) {
+			size_t len = decode_groups(&p, src, i);
+
+			src += len;
+			i -= len;
+			if (i == 0) {
+				break;
+			}
+		}
 
 		if (*src == '\r' || *src == '\n' || *src == ' ') {
 			continue;
@@ -215,3 +307,197 @@ int base64_decode(u8_t *dst, size_t dlen, size_t *olen, const u8_t *src,
 	return 0;
 }
 
+
+int base64_enc_update(struct base64_enc_ctx *ctx, u8_t *dst, size_t dlen,
+		      size_t *olen, const u8_t *src, size_t slen)
+{
+	size_t groups, len;
+	u8_t group[3];
+	u8_t *p;
+
+	if (slen > BASE64_SIZE_T_MAX - ctx->len ||
+	    (ctx->len + slen) / 3 > BASE64_SIZE_T_MAX / 4) {
+		*olen = BASE64_SIZE_T_MAX;
+		return -ENOMEM;
+	}
+
+	groups = (ctx->len + slen) / 3;
+	if (groups > 0 && (dlen < groups * 4 || !dst)) {
+		*olen = groups * 4;
+		return -ENOMEM;
+	}
+
+	p = dst;
+
+	/* Complete the group left over from the previous chunk */
+	if (ctx->len > 0 && groups > 0) {
+		len = 3 - ctx->len;
+		memcpy(group, ctx->buf, ctx->len);
+		memcpy(group + ctx->len, src, len);
+		p = encode_groups(p, group, 1);
+		src += len;
+		slen -= len;
+		ctx->len = 0;
+	}
+
+	groups = slen / 3;
+	p = encode_groups(p, src, groups);
+	src += groups * 3;
+	slen -= groups * 3;
+
+	memcpy(ctx->buf + ctx->len, src, slen);
+	ctx->len += slen;
+
+	*olen = p - dst;
+
+	return 0;
+}
+
+int base64_enc_finish(struct base64_enc_ctx *ctx, u8_t *dst, size_t dlen,
+		      size_t *olen)
+{
+	if (ctx->len == 0) {
+		*olen = 0;
+		return 0;
+	}
+
+	if (dlen < 4 || !dst) {
+		*olen = 4;
+		return -ENOMEM;
+	}
+
+	encode_tail(dst, ctx->buf, ctx->len);
+	ctx->len = 0;
+	*olen = 4;
+
+	return 0;
+}
+
+int base64_dec_update(struct base64_dec_ctx *ctx, u8_t *dst, size_t dlen,
+		      size_t *olen, const u8_t *src, size_t slen)
+{
+	size_t len;
+	u32_t x;
+	u8_t *p;
+	u8_t c;
+
+	len = (ctx->len + slen) / 4 * 3;
+	if (len > 0 && (dlen < len || !dst)) {
+		*olen = len;
+		return -ENOMEM;
+	}
+
+	p = dst;
+
+	while (slen > 0) {
+		if (ctx->len == 0 && ctx->pad == 0) {
+			len = decode_groups(&p, src, slen);
+			src += len;
+			slen -= len;
+			if (slen == 0) {
+				break;
+			}
+		}
+
+		c = *src++;
+		slen--;
+
+		if (c == ' ' || c == '\r' || c == '\n') {
+			continue;
+		}
+
+		x = c > 127 ? 127 : base64_dec_map[c];
+		if (x == 127) {
+			goto invalid;
+		}
+
+		if (x == BASE64_PAD) {
+			/* Padding replaces the last one or two characters */
+			if (ctx->len < 2 || ++ctx->pad > 2) {
+				goto invalid;
+			}
+			x = 0;
+		} else if (ctx->pad) {
+			goto invalid;
+		}
+
+		ctx->word = (ctx->word << 6) | x;
+		if (++ctx->len < 4) {
+			continue;
+		}
+
+		*p++ = ctx->word >> 16;
+		if (ctx->pad < 2) {
+			*p++ = ctx->word >> 8;
+		}
+		if (ctx->pad < 1) {
+			*p++ = ctx->word;
+		}
+
+		ctx->word = 0;
+		ctx->len = 0;
+	}
+
+	*olen = p - dst;
+
+	return 0;
+
+invalid:
+	*olen = p - dst;
+
+	return -EINVAL;
+}
+
+int base64_dec_finish(struct base64_dec_ctx *ctx)
+{
+	int rc = ctx->len == 0 ? 0 : -EINVAL;
+
+	base64_dec_init(ctx);
+
+	return rc;
+}
+
+#ifdef CONFIG_NET_BUF
+int base64_enc_net_buf(struct base64_enc_ctx *ctx, struct net_buf *buf,
+		       struct net_buf_pool *pool, s32_t timeout,
+		       const u8_t *src, size_t slen, bool finish)
+{
+	struct net_buf *frag = net_buf_frag_last(buf);
+	struct net_buf *new_frag;
+	size_t groups, len, olen;
+
+	while (ctx->len + slen >= 3 || (finish && ctx->len + slen > 0)) {
+		/* Groups of four characters are not split across fragments */
+		groups = net_buf_tailroom(frag) / 4;
+		if (groups == 0) {
+			if (!pool) {
+				return -ENOMEM;
+			}
+
+			new_frag = net_buf_alloc(pool, timeout);
+			if (!new_frag) {
+				return -ENOMEM;
+			}
+
+			net_buf_frag_insert(frag, new_frag);
+			frag = new_frag;
+			continue;
+		}
+
+		len = min(slen, groups * 3 - ctx->len);
+		base64_enc_update(ctx, net_buf_tail(frag), groups * 4, &olen,
+				  src, len);
+		net_buf_add(frag, olen);
+		src += len;
+		slen -= len;
+
+		if (finish && slen == 0 && ctx->len > 0 &&
+		    olen < groups * 4) {
+			base64_enc_finish(ctx, net_buf_tail(frag), 4, &olen);
+			net_buf_add(frag, olen);
+		}
+	}
+
+	return 0;
+}
+#endif /* CONFIG_NET_BUF */
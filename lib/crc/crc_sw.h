@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ * @brief Implementation selection shared by the software CRC routines
+ */
+
+#ifndef __CRC_SW_H
+#define __CRC_SW_H
+
+#include <zephyr/types.h>
+
+/*
+ * Number of input bytes consumed per round of table lookups, with one
+ * 256 entry table per byte. 0 selects the table-less implementations.
+ */
+#if defined(CONFIG_CRC_SLICING_BY_8)
+#define CRC_SLICES 8
+#elif defined(CONFIG_CRC_SLICING_BY_4)
+#define CRC_SLICES 4
+#elif defined(CONFIG_CRC_TABLE)
+#define CRC_SLICES 1
+#else
+#define CRC_SLICES 0
+#endif
+
+/* Byte-wise little endian load, merged into a single load where possible */
+static inline u32_t crc_get_le32(const u8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((u32_t)p[3] << 24);
+}
+
+#endif /* __CRC_SW_H */
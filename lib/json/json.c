@@ -15,6 +15,10 @@
 #include <string.h>
 #include <zephyr/types.h>
 
+#if defined(CONFIG_NET_BUF)
+#include <net/buf.h>
+#endif
+
 #include "json.h"
 
 struct token {
@@ -219,7 +223,8 @@ static void *lexer_number(struct lexer *lexer)
 	while (true) {
 		int chr = next(lexer);
 
-		if (isdigit(chr) || chr == '.') {
+		if (isdigit(chr) || chr == '.' || chr == 'e' || chr == 'E' ||
+		    chr == '+' || chr == '-') {
 			continue;
 		}
 
@@ -388,45 +393,269 @@ static int arr_next(struct json_obj *json, struct token *value)
 	return element_token(value->type);
 }
 
-static int decode_num(const struct token *token, s32_t *num)
+/* Flags of struct json_num */
+#define NUM_NEG		BIT(0)
+#define NUM_DIGITS	BIT(1)
+#define NUM_FRAC	BIT(2)
+#define NUM_EXP		BIT(3)
+#define NUM_EXP_NEG	BIT(4)
+/* Sign or digit seen after the exponent marker */
+#define NUM_EXP_STARTED	BIT(5)
+/* A digit must follow */
+#define NUM_PENDING	BIT(6)
+
+/* Larger exponent parts make any non-zero number overflow a double */
+#define NUM_EXP_PART_MAX 100000
+
+/* Largest scale of a fixed-point number that fits in an s64_t */
+#define FIXED_POINT_DECIMALS_MAX 18
+
+/*
+ * Feed the next character of a number. Digits are accumulated in a u64_t
+ * mantissa and a decimal exponent, digits beyond its precision only
+ * scale the exponent. Returns 1 if @a chr cannot be part of a number.
+ */
+static int num_feed(struct json_num *num, int chr)
 {
-	/* FIXME: strtod() is not available in newlib/minimal libc,
-	 * so using strtol() here.
-	 */
-	char *endptr;
-	char prev_end;
+	if (chr >= '0' && chr <= '9') {
+		int digit = chr - '0';
+
+		num->flags &= ~NUM_PENDING;
 
-	prev_end = *token->end;
-	*token->end = '\0';
+		if (num->flags & NUM_EXP) {
+			if (num->exp_part < NUM_EXP_PART_MAX) {
+				num->exp_part = num->exp_part * 10 + digit;
+			}
+
+			num->flags |= NUM_EXP_STARTED;
+			return 0;
+		}
 
-	errno = 0;
-	*num = strtol(token->start, &endptr, 10);
+		if (num->mantissa <= (UINT64_MAX - 9) / 10) {
+			num->mantissa = num->mantissa * 10 + digit;
 
-	*token->end = prev_end;
+			if (num->flags & NUM_FRAC) {
+				num->exp--;
+			}
+		} else if (!(num->flags & NUM_FRAC)) {
+			num->exp++;
+		}
 
-	if (errno != 0) {
-		return -errno;
+		num->flags |= NUM_DIGITS;
+		return 0;
 	}
 
-	if (endptr != token->end) {
+	switch (chr) {
+	case '-':
+		if (!num->flags) {
+			num->flags = NUM_NEG | NUM_PENDING;
+			return 0;
+		}
+
+		/* fallthrough */
+	case '+':
+		if ((num->flags & (NUM_EXP | NUM_EXP_STARTED)) == NUM_EXP) {
+			num->flags |= NUM_EXP_STARTED;
+
+			if (chr == '-') {
+				num->flags |= NUM_EXP_NEG;
+			}
+
+			return 0;
+		}
+
+		return -EINVAL;
+	case '.':
+		if ((num->flags & (NUM_DIGITS | NUM_FRAC | NUM_EXP)) ==
+		    NUM_DIGITS) {
+			num->flags |= NUM_FRAC | NUM_PENDING;
+			return 0;
+		}
+
+		return -EINVAL;
+	case 'e':
+	case 'E':
+		if ((num->flags & (NUM_DIGITS | NUM_PENDING | NUM_EXP)) ==
+		    NUM_DIGITS) {
+			num->flags |= NUM_EXP | NUM_PENDING;
+			return 0;
+		}
+
 		return -EINVAL;
 	}
 
+	return 1;
+}
+
+static s32_t num_scale(const struct json_num *num)
+{
+	if (num->flags & NUM_EXP_NEG) {
+		return num->exp - num->exp_part;
+	}
+
+	return num->exp + num->exp_part;
+}
+
+/* Apply the sign of @a num to @a mag and check it fits in [min, max] */
+static int num_to_int(const struct json_num *num, u64_t mag,
+		      s64_t min, s64_t max, s64_t *out)
+{
+	if (num->flags & NUM_NEG) {
+		if (mag > (u64_t)-(min + 1) + 1) {
+			return -ERANGE;
+		}
+
+		*out = mag ? -(s64_t)(mag - 1) - 1 : 0;
+		return 0;
+	}
+
+	if (mag > (u64_t)max) {
+		return -ERANGE;
+	}
+
+	*out = (s64_t)mag;
+	return 0;
+}
+
+static int num_to_fixed(const struct json_num *num, u32_t decimals,
+			s64_t *out)
+{
+	s32_t scale = num_scale(num) + (s32_t)decimals;
+	u64_t mag = num->mantissa;
+
+	for (; scale > 0 && mag; scale--) {
+		if (mag > UINT64_MAX / 10) {
+			return -ERANGE;
+		}
+
+		mag *= 10;
+	}
+
+	/* Digits beyond the last decimal are truncated */
+	for (; scale < 0 && mag; scale++) {
+		mag /= 10;
+	}
+
+	return num_to_int(num, mag, LLONG_MIN, LLONG_MAX, out);
+}
+
+static double ipow10(u32_t exp)
+{
+	double result = 1.0;
+	double base = 10.0;
+
+	for (; exp; exp >>= 1) {
+		if (exp & 1) {
+			result *= base;
+		}
+
+		base *= base;
+	}
+
+	return result;
+}
+
+/*
+ * Dividing by an exact power of ten, rather than multiplying by an
+ * inexact negative one, keeps short decimals such as 0.1 correctly
+ * rounded.
+ */
+static int num_to_double(const struct json_num *num, double *out)
+{
+	s32_t scale = num_scale(num);
+	double result = (double)num->mantissa;
+
+	if (num->mantissa) {
+		if (scale < 0) {
+			result /= ipow10(-scale);
+		} else {
+			result *= ipow10(scale);
+		}
+
+		if (result > __DBL_MAX__) {
+			return -ERANGE;
+		}
+	}
+
+	*out = (num->flags & NUM_NEG) ? -result : result;
 	return 0;
 }
 
+/* Store a complete number in the field described by @a descr */
+static int num_store(const struct json_num *num,
+		     const struct json_obj_descr *descr, void *field)
+{
+	s64_t value;
+	int ret;
+
+	if ((num->flags & (NUM_DIGITS | NUM_PENDING)) != NUM_DIGITS) {
+		return -EINVAL;
+	}
+
+	switch (descr->type) {
+	case JSON_TOK_NUMBER:
+	case JSON_TOK_INT64:
+		if (num->flags & (NUM_FRAC | NUM_EXP)) {
+			return -EINVAL;
+		}
+
+		if (num->exp) {
+			return -ERANGE;
+		}
+
+		if (descr->type == JSON_TOK_INT64) {
+			return num_to_int(num, num->mantissa, LLONG_MIN,
+					  LLONG_MAX, field);
+		}
+
+		ret = num_to_int(num, num->mantissa, INT32_MIN, INT32_MAX,
+				 &value);
+		if (!ret) {
+			*(s32_t *)field = (s32_t)value;
+		}
+
+		return ret;
+	case JSON_TOK_FIXED_POINT:
+		return num_to_fixed(num, descr->fixed_point.decimals, field);
+	case JSON_TOK_FLOAT:
+		return num_to_double(num, field);
+	default:
+		return -EINVAL;
+	}
+}
+
+static int decode_num(const struct token *token,
+		      const struct json_obj_descr *descr, void *field)
+{
+	struct json_num num = { 0 };
+	const char *pos;
+
+	for (pos = token->start; pos != token->end; pos++) {
+		if (num_feed(&num, *pos)) {
+			return -EINVAL;
+		}
+	}
+
+	return num_store(&num, descr, field);
+}
+
 static bool equivalent_types(enum json_tokens type1, enum json_tokens type2)
 {
 	if (type1 == JSON_TOK_TRUE || type1 == JSON_TOK_FALSE) {
 		return type2 == JSON_TOK_TRUE || type2 == JSON_TOK_FALSE;
 	}
 
+	if (type1 == JSON_TOK_NUMBER) {
+		return type2 == JSON_TOK_NUMBER || type2 == JSON_TOK_INT64 ||
+		       type2 == JSON_TOK_FIXED_POINT || type2 == JSON_TOK_FLOAT;
+	}
+
 	return type1 == type2;
 }
 
 static int obj_parse(struct json_obj *obj,
 		     const struct json_obj_descr *descr, size_t descr_len,
-		     void *val);
+		     void *val, u32_t *fields);
 static int arr_parse(struct json_obj *obj,
 		     const struct json_obj_descr *elem_descr,
 		     size_t max_elements, void *field, void *val);
@@ -444,7 +673,7 @@ static int decode_value(struct json_obj *obj,
 	case JSON_TOK_OBJECT_START:
 		return obj_parse(obj, descr->object.sub_descr,
 				 descr->object.sub_descr_len,
-				 field);
+				 field, NULL);
 	case JSON_TOK_LIST_START:
 		return arr_parse(obj, descr->array.element_descr,
 				 descr->array.n_elements, field, val);
@@ -456,11 +685,11 @@ static int decode_value(struct json_obj *obj,
 
 		return 0;
 	}
-	case JSON_TOK_NUMBER: {
-		s32_t *num = field;
-
-		return decode_num(value, num);
-	}
+	case JSON_TOK_NUMBER:
+	case JSON_TOK_INT64:
+	case JSON_TOK_FIXED_POINT:
+	case JSON_TOK_FLOAT:
+		return decode_num(value, descr, field);
 	case JSON_TOK_STRING: {
 		char **str = field;
 
@@ -479,6 +708,11 @@ static ptrdiff_t get_elem_size(const struct json_obj_descr *descr)
 	switch (descr->type) {
 	case JSON_TOK_NUMBER:
 		return sizeof(s32_t);
+	case JSON_TOK_INT64:
+	case JSON_TOK_FIXED_POINT:
+		return sizeof(s64_t);
+	case JSON_TOK_FLOAT:
+		return sizeof(double);
 	case JSON_TOK_STRING:
 		return sizeof(char *);
 	case JSON_TOK_TRUE:
@@ -488,15 +722,31 @@ static ptrdiff_t get_elem_size(const struct json_obj_descr *descr)
 		return descr->array.n_elements * get_elem_size(descr->array.element_descr);
 	case JSON_TOK_OBJECT_START: {
 		ptrdiff_t total = 0;
+		u32_t align = 0;
 		size_t i;
 
+		if (descr->object.struct_size) {
+			return descr->object.struct_size;
+		}
+
+		/* Hand-built descriptor: the struct ends after its last
+		 * member, padded to the alignment of the struct its
+		 * members were described with.
+		 */
 		for (i = 0; i < descr->object.sub_descr_len; i++) {
-			ptrdiff_t s = get_elem_size(&descr->object.sub_descr[i]);
+			const struct json_obj_descr *sub =
+				&descr->object.sub_descr[i];
+			ptrdiff_t s = get_elem_size(sub);
+
+			if (s < 0) {
+				return s;
+			}
 
-			total += ROUND_UP(s, descr->alignment + 1);
+			total = max(total, (ptrdiff_t)sub->offset + s);
+			align = max(align, sub->alignment);
 		}
 
-		return total;
+		return ROUND_UP(total, BIT(align));
 	}
 	default:
 		return -EINVAL;
@@ -536,47 +786,114 @@ static int arr_parse(struct json_obj *obj,
 	return -EINVAL;
 }
 
-static int obj_parse(struct json_obj *obj, const struct json_obj_descr *descr,
-		     size_t descr_len, void *val)
+static inline bool field_is_set(const u32_t *fields, size_t i)
 {
-	struct json_obj_key_value kv;
-	s32_t decoded_fields = 0;
+	return fields[i / 32] & BIT(i % 32);
+}
+
+static inline void field_set(u32_t *fields, size_t i)
+{
+	fields[i / 32] |= BIT(i % 32);
+}
+
+/* Bitmap returned by the parsers, limited to the bits of a positive int.
+ * The *_fields() variants return the complete bitmap.
+ */
+static inline int fields_result(const u32_t *fields)
+{
+	return fields[0] & INT_MAX;
+}
+
+/* Must compute the same value as _JSON_HASH() in json.h */
+static u32_t json_key_hash(const char *key, size_t len)
+{
+	u32_t hash = (u32_t)len * 0x9e3779b1u;
+	u32_t mul = 1;
 	size_t i;
-	int ret;
 
-	while (!obj_next(obj, &kv)) {
-		if (kv.value.type == JSON_TOK_OBJECT_END) {
-			return decoded_fields;
+	for (i = 0; i < min(len, _JSON_HASH_CHARS); i++) {
+		hash += (u8_t)key[i] * mul;
+		mul *= 31;
+	}
+
+	return hash;
+}
+
+/*
+ * Find the descriptor of a key among the fields not decoded yet. Keys
+ * usually come in the order of the descriptors, so the search starts at
+ * @a next, after the previous match, and only compares the names of
+ * fields whose hash matches.
+ */
+static int descr_find(const struct json_obj_descr *descr, size_t descr_len,
+		      size_t next, const u32_t *fields,
+		      const char *key, size_t key_len)
+{
+	u32_t hash = json_key_hash(key, key_len);
+	size_t i = next;
+	size_t n;
+
+	for (n = 0; n < descr_len; n++, i++) {
+		if (i == descr_len) {
+			i = 0;
 		}
 
-		for (i = 0; i < descr_len; i++) {
-			void *decode_field = (char *)val + descr[i].offset;
+		if (descr[i].field_name_len != key_len ||
+		    (descr[i].field_name_hash &&
+		     descr[i].field_name_hash != hash)) {
+			continue;
+		}
 
-			/* Field has been decoded already, skip */
-			if (decoded_fields & (1 << i)) {
-				continue;
-			}
+		/* Field has been decoded already, skip */
+		if (field_is_set(fields, i)) {
+			continue;
+		}
 
-			/* Check if it's the i-th field */
-			if (kv.key_len != descr[i].field_name_len) {
-				continue;
-			}
+		if (!memcmp(key, descr[i].field_name, key_len)) {
+			return i;
+		}
+	}
 
-			if (memcmp(kv.key, descr[i].field_name,
-				   descr[i].field_name_len)) {
-				continue;
-			}
+	return -1;
+}
 
-			/* Store the decoded value */
-			ret = decode_value(obj, &descr[i], &kv.value,
-					   decode_field, val);
-			if (ret < 0) {
-				return ret;
+static int obj_parse(struct json_obj *obj, const struct json_obj_descr *descr,
+		     size_t descr_len, void *val, u32_t *fields)
+{
+	u32_t decoded_fields[_JSON_FIELDS_WORDS] = { 0 };
+	struct json_obj_key_value kv;
+	size_t next = 0;
+	int ret;
+	int i;
+
+	assert(descr_len <= CONFIG_JSON_MAX_FIELDS);
+
+	while (!obj_next(obj, &kv)) {
+		if (kv.value.type == JSON_TOK_OBJECT_END) {
+			if (fields) {
+				memcpy(fields, decoded_fields,
+				       JSON_FIELDS_WORDS(descr_len) *
+				       sizeof(u32_t));
 			}
 
-			decoded_fields |= 1<<i;
-			break;
+			return fields_result(decoded_fields);
 		}
+
+		i = descr_find(descr, descr_len, next, decoded_fields,
+			       kv.key, kv.key_len);
+		if (i < 0) {
+			continue;
+		}
+
+		/* Store the decoded value */
+		ret = decode_value(obj, &descr[i], &kv.value,
+				   (char *)val + descr[i].offset, val);
+		if (ret < 0) {
+			return ret;
+		}
+
+		field_set(decoded_fields, i);
+		next = i + 1;
 	}
 
 	return -EINVAL;
@@ -589,116 +906,704 @@ int json_obj_parse(char *payload, size_t len,
 	struct json_obj obj;
 	int ret;
 
-	assert(descr_len < (sizeof(ret) * CHAR_BIT - 1));
-
 	ret = obj_init(&obj, payload, len);
 	if (ret < 0) {
 		return ret;
 	}
 
-	return obj_parse(&obj, descr, descr_len, val);
+	return obj_parse(&obj, descr, descr_len, val, NULL);
 }
 
-static char escape_as(char chr)
+int json_obj_parse_fields(char *payload, size_t len,
+			  const struct json_obj_descr *descr, size_t descr_len,
+			  void *val, u32_t *fields)
 {
-	switch (chr) {
-	case '"':
-		return '"';
-	case '\\':
-		return '\\';
-	case '\b':
-		return 'b';
-	case '\f':
-		return 'f';
-	case '\n':
-		return 'n';
-	case '\r':
-		return 'r';
-	case '\t':
-		return 't';
+	struct json_obj obj;
+	int ret;
+
+	ret = obj_init(&obj, payload, len);
+	if (ret < 0) {
+		return ret;
 	}
 
-	return 0;
+	return obj_parse(&obj, descr, descr_len, val, fields);
 }
 
-static int json_escape_internal(const char *str,
-				json_append_bytes_t append_bytes,
-				void *data)
-{
-	const char *cur;
-	int ret = 0;
+/* Lexer states of struct json_parser */
+enum {
+	PARSER_TOKEN,
+	PARSER_STRING,
+	PARSER_NUMBER,
+	PARSER_LITERAL,
+};
 
-	for (cur = str; ret == 0 && *cur; cur++) {
-		char escaped = escape_as(*cur);
+/* What struct json_parser accepts next */
+enum {
+	EXPECT_ROOT,
+	EXPECT_KEY_OR_END,
+	EXPECT_KEY,
+	EXPECT_COLON,
+	EXPECT_VALUE_OR_END,
+	EXPECT_VALUE,
+	EXPECT_COMMA_OR_END,
+	EXPECT_DONE,
+};
 
-		if (escaped) {
-			char bytes[2] = { '\\', escaped };
+/* Backslash seen, any other non-zero escape is a count of hex digits */
+#define ESCAPE_START 5
 
-			ret = append_bytes(bytes, 2, data);
-		} else {
-			ret = append_bytes(cur, 1, data);
-		}
-	}
+#define MEMBER_NONE UINT8_MAX
 
-	return ret;
+static inline struct json_parser_frame *parser_top(struct json_parser *parser)
+{
+	return &parser->stack[parser->depth - 1];
 }
 
-size_t json_calc_escaped_len(const char *str, size_t len)
+void json_parser_init(struct json_parser *parser,
+		      const struct json_obj_descr *descr, size_t descr_len,
+		      void *val, char *str_buf, size_t str_size)
 {
-	size_t escaped_len = len;
-	size_t pos;
+	assert(descr_len <= CONFIG_JSON_MAX_FIELDS);
 
-	for (pos = 0; pos < len; pos++) {
-		if (escape_as(str[pos])) {
-			escaped_len++;
-		}
-	}
+	memset(parser, 0, sizeof(*parser));
 
-	return escaped_len;
+	parser->stack[0].type = JSON_TOK_OBJECT_START;
+	parser->stack[0].descr = descr;
+	parser->stack[0].len = descr_len;
+	parser->stack[0].base = val;
+	parser->stack[0].val = val;
+
+	parser->str_buf = str_buf;
+	parser->str_size = str_size;
+	parser->state = PARSER_TOKEN;
+	parser->expect = EXPECT_ROOT;
 }
 
-ssize_t json_escape(char *str, size_t *len, size_t buf_size)
+static int parser_push(struct json_parser *parser, enum json_tokens type)
 {
-	char *next; /* Points after next character to escape. */
-	char *dest; /* Points after next place to write escaped character. */
-	size_t escaped_len = json_calc_escaped_len(str, *len);
-
-	if (escaped_len == *len) {
-		/*
-		 * If no escape is necessary, there is nothing to do.
-		 */
-		return 0;
-	}
+	const struct json_obj_descr *descr = parser->value_descr;
+	struct json_parser_frame *frame;
+	void *val;
 
-	if (escaped_len >= buf_size) {
+	if (parser->depth == CONFIG_JSON_PARSER_MAX_DEPTH) {
 		return -ENOMEM;
 	}
 
-	/*
-	 * By walking backwards in the buffer from the end positions
-	 * of both the original and escaped strings, we avoid using
-	 * extra space. Characters in the original string are
-	 * overwritten only after they have already been escaped.
-	 */
-	str[escaped_len] = '\0';
-	for (next = &str[*len], dest = &str[escaped_len]; next != str;) {
-		char next_c = *(--next);
-		char escape = escape_as(next_c);
+	val = parser_top(parser)->val;
+	frame = &parser->stack[parser->depth++];
+	frame->type = type;
+	frame->count = 0;
+	frame->next = 0;
+	memset(frame->fields, 0, sizeof(frame->fields));
+
+	if (!descr) {
+		frame->descr = NULL;
+	} else if (type == JSON_TOK_OBJECT_START) {
+		frame->descr = descr->object.sub_descr;
+		frame->len = descr->object.sub_descr_len;
+		assert(frame->len <= CONFIG_JSON_MAX_FIELDS);
+		frame->base = parser->value_field;
+		frame->val = parser->value_field;
+	} else {
+		/* Same element count location as arr_parse() */
+		frame->descr = descr->array.element_descr;
+		frame->len = descr->array.n_elements;
+		frame->elem_size = get_elem_size(frame->descr);
+		frame->base = parser->value_field;
+		frame->val = val;
+
+		*(size_t *)((char *)val + frame->descr->offset) = 0;
+	}
 
-		if (escape) {
-			*(--dest) = escape;
-			*(--dest) = '\\';
-		} else {
-			*(--dest) = next_c;
-		}
+	if (type == JSON_TOK_OBJECT_START) {
+		parser->expect = EXPECT_KEY_OR_END;
+	} else {
+		parser->expect = EXPECT_VALUE_OR_END;
 	}
-	*len = escaped_len;
 
 	return 0;
 }
 
-static int encode(const struct json_obj_descr *descr, const void *val,
-		  json_append_bytes_t append_bytes, void *data);
+/* Account for the value just decoded in the enclosing object or array */
+static void parser_value_end(struct json_parser *parser)
+{
+	struct json_parser_frame *frame;
+
+	if (!parser->depth) {
+		parser->expect = EXPECT_DONE;
+		return;
+	}
+
+	frame = parser_top(parser);
+	parser->expect = EXPECT_COMMA_OR_END;
+
+	if (!frame->descr) {
+		return;
+	}
+
+	if (frame->type == JSON_TOK_LIST_START) {
+		frame->count++;
+		*(size_t *)((char *)frame->val + frame->descr->offset) =
+			frame->count;
+	} else if (frame->member != MEMBER_NONE) {
+		field_set(frame->fields, frame->member);
+		frame->next = frame->member + 1;
+	}
+}
+
+static void parser_key_match(struct json_parser *parser)
+{
+	struct json_parser_frame *frame = parser_top(parser);
+	int i;
+
+	frame->member = MEMBER_NONE;
+	parser->value_descr = NULL;
+
+	if (!frame->descr || parser->key_len > sizeof(parser->key)) {
+		return;
+	}
+
+	i = descr_find(frame->descr, frame->len, frame->next, frame->fields,
+		       parser->key, parser->key_len);
+	if (i < 0) {
+		return;
+	}
+
+	frame->member = i;
+	parser->value_descr = &frame->descr[i];
+	parser->value_field = (char *)frame->base + frame->descr[i].offset;
+}
+
+static int parser_value_begin(struct json_parser *parser,
+			      enum json_tokens type)
+{
+	struct json_parser_frame *frame = parser_top(parser);
+
+	/* Object members were resolved when their key was matched */
+	if (frame->type == JSON_TOK_LIST_START) {
+		parser->value_descr = frame->descr;
+
+		if (frame->descr) {
+			if (frame->count == frame->len) {
+				return -ENOSPC;
+			}
+
+			parser->value_field = (char *)frame->base +
+					      frame->count * frame->elem_size;
+		}
+	}
+
+	if (parser->value_descr &&
+	    !equivalent_types(type, parser->value_descr->type)) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int parser_literal_begin(struct json_parser *parser, char chr)
+{
+	enum json_tokens type;
+	int ret;
+
+	switch (chr) {
+	case 't':
+		type = JSON_TOK_TRUE;
+		parser->literal = "rue";
+		break;
+	case 'f':
+		type = JSON_TOK_FALSE;
+		parser->literal = "alse";
+		break;
+	default:
+		type = JSON_TOK_NULL;
+		parser->literal = "ull";
+		break;
+	}
+
+	ret = parser_value_begin(parser, type);
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* The value is known from its first character */
+	if (parser->value_descr) {
+		*(bool *)parser->value_field = type == JSON_TOK_TRUE;
+	}
+
+	parser->state = PARSER_LITERAL;
+
+	return 0;
+}
+
+static int parser_token(struct json_parser *parser, const char **pos,
+			const char *end)
+{
+	struct json_parser_frame *frame;
+	char chr;
+	int ret;
+
+	while (isspace((unsigned char)**pos)) {
+		if (++*pos == end) {
+			return 0;
+		}
+	}
+
+	chr = *(*pos)++;
+
+	switch (chr) {
+	case '{':
+	case '[':
+		if (parser->expect == EXPECT_ROOT && chr == '{') {
+			parser->depth = 1;
+			parser->expect = EXPECT_KEY_OR_END;
+			return 0;
+		}
+
+		if (parser->expect != EXPECT_VALUE &&
+		    parser->expect != EXPECT_VALUE_OR_END) {
+			return -EINVAL;
+		}
+
+		ret = parser_value_begin(parser, (enum json_tokens)chr);
+		if (ret < 0) {
+			return ret;
+		}
+
+		return parser_push(parser, (enum json_tokens)chr);
+	case '}':
+	case ']':
+		if (parser->expect != EXPECT_COMMA_OR_END &&
+		    parser->expect != (chr == '}' ? EXPECT_KEY_OR_END :
+						    EXPECT_VALUE_OR_END)) {
+			return -EINVAL;
+		}
+
+		if (parser_top(parser)->type != (chr == '}' ?
+						 JSON_TOK_OBJECT_START :
+						 JSON_TOK_LIST_START)) {
+			return -EINVAL;
+		}
+
+		parser->depth--;
+		parser_value_end(parser);
+		return 0;
+	case ',':
+		if (parser->expect != EXPECT_COMMA_OR_END) {
+			return -EINVAL;
+		}
+
+		frame = parser_top(parser);
+		if (frame->type == JSON_TOK_OBJECT_START) {
+			parser->expect = EXPECT_KEY;
+		} else {
+			parser->expect = EXPECT_VALUE;
+		}
+
+		return 0;
+	case ':':
+		if (parser->expect != EXPECT_COLON) {
+			return -EINVAL;
+		}
+
+		parser->expect = EXPECT_VALUE;
+		return 0;
+	case '"':
+		if (parser->expect == EXPECT_KEY ||
+		    parser->expect == EXPECT_KEY_OR_END) {
+			parser->expect = EXPECT_KEY;
+			parser->key_len = 0;
+		} else if (parser->expect == EXPECT_VALUE ||
+			   parser->expect == EXPECT_VALUE_OR_END) {
+			ret = parser_value_begin(parser, JSON_TOK_STRING);
+			if (ret < 0) {
+				return ret;
+			}
+
+			parser->str_start = parser->str_used;
+		} else {
+			return -EINVAL;
+		}
+
+		parser->escape = 0;
+		parser->state = PARSER_STRING;
+		return 0;
+	case 't':
+	case 'f':
+	case 'n':
+		if (parser->expect != EXPECT_VALUE &&
+		    parser->expect != EXPECT_VALUE_OR_END) {
+			return -EINVAL;
+		}
+
+		return parser_literal_begin(parser, chr);
+	default:
+		if (chr != '-' && !isdigit((unsigned char)chr)) {
+			return -EINVAL;
+		}
+
+		if (parser->expect != EXPECT_VALUE &&
+		    parser->expect != EXPECT_VALUE_OR_END) {
+			return -EINVAL;
+		}
+
+		ret = parser_value_begin(parser, JSON_TOK_NUMBER);
+		if (ret < 0) {
+			return ret;
+		}
+
+		memset(&parser->num, 0, sizeof(parser->num));
+		num_feed(&parser->num, chr);
+		parser->state = PARSER_NUMBER;
+		return 0;
+	}
+}
+
+/* Append raw string characters to the key or the string buffer */
+static int parser_string_append(struct json_parser *parser, const char *str,
+				size_t len)
+{
+	if (parser->expect == EXPECT_KEY) {
+		size_t room = sizeof(parser->key) - parser->key_len;
+
+		if (parser->key_len > sizeof(parser->key)) {
+			return 0;
+		}
+
+		if (len > room) {
+			/* Too long to match any field name */
+			parser->key_len = sizeof(parser->key) + 1;
+			return 0;
+		}
+
+		memcpy(parser->key + parser->key_len, str, len);
+		parser->key_len += len;
+		return 0;
+	}
+
+	if (!parser->value_descr) {
+		return 0;
+	}
+
+	/* Keep room for the NUL terminator */
+	if (len >= parser->str_size - parser->str_used) {
+		return -ENOMEM;
+	}
+
+	memcpy(parser->str_buf + parser->str_used, str, len);
+	parser->str_used += len;
+	return 0;
+}
+
+static int parser_string(struct json_parser *parser, const char **pos,
+			 const char *end)
+{
+	const char *run = *pos;
+	const char *cur;
+	int ret;
+
+	for (cur = run; cur != end; cur++) {
+		char chr = *cur;
+
+		if (parser->escape == ESCAPE_START) {
+			switch (chr) {
+			case '"':
+			case '\\':
+			case '/':
+			case 'b':
+			case 'f':
+			case 'n':
+			case 'r':
+			case 't':
+				parser->escape = 0;
+				break;
+			case 'u':
+				parser->escape = 4;
+				break;
+			default:
+				return -EINVAL;
+			}
+		} else if (parser->escape) {
+			if (!isxdigit((unsigned char)chr)) {
+				return -EINVAL;
+			}
+
+			parser->escape--;
+		} else if (chr == '\\') {
+			parser->escape = ESCAPE_START;
+		} else if (chr == '"') {
+			break;
+		}
+	}
+
+	ret = parser_string_append(parser, run, cur - run);
+	if (ret < 0 || cur == end) {
+		*pos = cur;
+		return ret;
+	}
+
+	/* Skip the closing quote */
+	*pos = cur + 1;
+	parser->state = PARSER_TOKEN;
+
+	if (parser->expect == EXPECT_KEY) {
+		parser_key_match(parser);
+		parser->expect = EXPECT_COLON;
+		return 0;
+	}
+
+	if (parser->value_descr) {
+		parser->str_buf[parser->str_used++] = '\0';
+		*(char **)parser->value_field =
+			parser->str_buf + parser->str_start;
+	}
+
+	parser_value_end(parser);
+	return 0;
+}
+
+static int parser_number(struct json_parser *parser, const char **pos,
+			 const char *end)
+{
+	int ret;
+
+	for (; *pos != end; (*pos)++) {
+		ret = num_feed(&parser->num, **pos);
+		if (ret < 0) {
+			return ret;
+		}
+
+		if (ret > 0) {
+			break;
+		}
+	}
+
+	if (*pos == end) {
+		return 0;
+	}
+
+	/* The terminating character is left for the next token */
+	parser->state = PARSER_TOKEN;
+
+	if (parser->value_descr) {
+		ret = num_store(&parser->num, parser->value_descr,
+				parser->value_field);
+		if (ret < 0) {
+			return ret;
+		}
+	} else if ((parser->num.flags & (NUM_DIGITS | NUM_PENDING)) !=
+		   NUM_DIGITS) {
+		return -EINVAL;
+	}
+
+	parser_value_end(parser);
+	return 0;
+}
+
+static int parser_literal(struct json_parser *parser, const char **pos,
+			  const char *end)
+{
+	for (; *pos != end && *parser->literal; (*pos)++, parser->literal++) {
+		if (**pos != *parser->literal) {
+			return -EINVAL;
+		}
+	}
+
+	if (!*parser->literal) {
+		parser->state = PARSER_TOKEN;
+		parser_value_end(parser);
+	}
+
+	return 0;
+}
+
+int json_parser_feed(struct json_parser *parser, const char *data,
+		     size_t len)
+{
+	const char *end = data + len;
+	int ret = 0;
+
+	while (!parser->result && data != end) {
+		switch (parser->state) {
+		case PARSER_STRING:
+			ret = parser_string(parser, &data, end);
+			break;
+		case PARSER_NUMBER:
+			ret = parser_number(parser, &data, end);
+			break;
+		case PARSER_LITERAL:
+			ret = parser_literal(parser, &data, end);
+			break;
+		default:
+			ret = parser_token(parser, &data, end);
+			break;
+		}
+
+		if (ret < 0) {
+			parser->result = ret;
+		} else if (parser->expect == EXPECT_DONE) {
+			parser->result = 1;
+		}
+	}
+
+	return parser->result;
+}
+
+int json_parser_finish(struct json_parser *parser)
+{
+	if (parser->result < 0) {
+		return parser->result;
+	}
+
+	if (parser->expect != EXPECT_DONE) {
+		return -EINVAL;
+	}
+
+	return fields_result(parser->stack[0].fields);
+}
+
+int json_parser_finish_fields(struct json_parser *parser, u32_t *fields)
+{
+	int ret;
+
+	ret = json_parser_finish(parser);
+	if (ret < 0) {
+		return ret;
+	}
+
+	memcpy(fields, parser->stack[0].fields,
+	       JSON_FIELDS_WORDS(parser->stack[0].len) * sizeof(u32_t));
+
+	return ret;
+}
+
+static char escape_as(char chr)
+{
+	switch (chr) {
+	case '"':
+		return '"';
+	case '\\':
+		return '\\';
+	case '\b':
+		return 'b';
+	case '\f':
+		return 'f';
+	case '\n':
+		return 'n';
+	case '\r':
+		return 'r';
+	case '\t':
+		return 't';
+	}
+
+	return 0;
+}
+
+/* Only these characters can have an escape sequence, see escape_as() */
+static inline bool may_escape(char chr)
+{
+	return chr == '"' || chr == '\\' || (unsigned char)chr < ' ';
+}
+
+/* Appends runs of characters that need no escaping in one call */
+static int json_escape_internal(const char *str,
+				json_append_bytes_t append_bytes,
+				void *data)
+{
+	const char *run = str;
+	const char *cur;
+	int ret;
+
+	for (cur = str; *cur; cur++) {
+		char escaped;
+
+		if (!may_escape(*cur)) {
+			continue;
+		}
+
+		escaped = escape_as(*cur);
+		if (!escaped) {
+			continue;
+		}
+
+		if (cur != run) {
+			ret = append_bytes(run, cur - run, data);
+			if (ret) {
+				return ret;
+			}
+		}
+
+		ret = append_bytes((char []){ '\\', escaped }, 2, data);
+		if (ret) {
+			return ret;
+		}
+
+		run = cur + 1;
+	}
+
+	if (cur != run) {
+		return append_bytes(run, cur - run, data);
+	}
+
+	return 0;
+}
+
+size_t json_calc_escaped_len(const char *str, size_t len)
+{
+	size_t escaped_len = len;
+	size_t pos;
+
+	for (pos = 0; pos < len; pos++) {
+		if (escape_as(str[pos])) {
+			escaped_len++;
+		}
+	}
+
+	return escaped_len;
+}
+
+ssize_t json_escape(char *str, size_t *len, size_t buf_size)
+{
+	char *next; /* Points after next character to escape. */
+	char *dest; /* Points after next place to write escaped character. */
+	size_t escaped_len = json_calc_escaped_len(str, *len);
+
+	if (escaped_len == *len) {
+		/*
+		 * If no escape is necessary, there is nothing to do.
+		 */
+		return 0;
+	}
+
+	if (escaped_len >= buf_size) {
+		return -ENOMEM;
+	}
+
+	/*
+	 * By walking backwards in the buffer from the end positions
+	 * of both the original and escaped strings, we avoid using
+	 * extra space. Characters in the original string are
+	 * overwritten only after they have already been escaped.
+	 */
+	str[escaped_len] = '\0';
+	for (next = &str[*len], dest = &str[escaped_len]; next != str;) {
+		char next_c = *(--next);
+		char escape = escape_as(next_c);
+
+		if (escape) {
+			*(--dest) = escape;
+			*(--dest) = '\\';
+		} else {
+			*(--dest) = next_c;
+		}
+	}
+	*len = escaped_len;
+
+	return 0;
+}
+
+static int encode(const struct json_obj_descr *descr, const void *val,
+		  json_append_bytes_t append_bytes, void *data);
 
 static int arr_encode(const struct json_obj_descr *elem_descr,
 		      const void *field, const void *val,
@@ -773,21 +1678,50 @@ static int str_encode(const char **str, json_append_bytes_t append_bytes,
 	return ret;
 }
 
-static int num_encode(const s32_t *num, json_append_bytes_t append_bytes,
-		      void *data)
+/*
+ * Digits are extracted here rather than with snprintk(), which is slower
+ * and cannot format 64-bit numbers on all architectures, inserting the
+ * decimal point of fixed-point values. 64-bit divisions are only used
+ * while the value does not fit in 32 bits.
+ */
+static int int_encode(s64_t num, u32_t decimals,
+		      json_append_bytes_t append_bytes, void *data)
 {
-	char buf[3 * sizeof(s32_t)];
-	int ret;
+	char buf[sizeof("-0.") + FIXED_POINT_DECIMALS_MAX + 1];
+	char *pos = buf + sizeof(buf);
+	u64_t mag = (num < 0) ? -(u64_t)num : (u64_t)num;
+	u32_t mag32;
+	u32_t digits = 0;
 
-	ret = snprintk(buf, sizeof(buf), "%d", *num);
-	if (ret < 0) {
-		return ret;
+	if (decimals > FIXED_POINT_DECIMALS_MAX) {
+		return -EINVAL;
 	}
-	if (ret >= (int)sizeof(buf)) {
-		return -ENOMEM;
+
+	for (; mag > UINT32_MAX; mag /= 10, digits++) {
+		if (decimals && digits == decimals) {
+			*--pos = '.';
+		}
+
+		*--pos = '0' + mag % 10;
+	}
+
+	mag32 = mag;
+
+	do {
+		if (decimals && digits == decimals) {
+			*--pos = '.';
+		}
+
+		*--pos = '0' + mag32 % 10;
+		mag32 /= 10;
+		digits++;
+	} while (mag32 || digits <= decimals);
+
+	if (num < 0) {
+		*--pos = '-';
 	}
 
-	return append_bytes(buf, (size_t)ret, data);
+	return append_bytes(pos, buf + sizeof(buf) - pos, data);
 }
 
 static int bool_encode(const bool *value, json_append_bytes_t append_bytes,
@@ -819,12 +1753,52 @@ static int encode(const struct json_obj_descr *descr, const void *val,
 				       descr->object.sub_descr_len,
 				       ptr, append_bytes, data);
 	case JSON_TOK_NUMBER:
-		return num_encode(ptr, append_bytes, data);
+		return int_encode(*(s32_t *)ptr, 0, append_bytes, data);
+	case JSON_TOK_INT64:
+		return int_encode(*(s64_t *)ptr, 0, append_bytes, data);
+	case JSON_TOK_FIXED_POINT:
+		return int_encode(*(s64_t *)ptr, descr->fixed_point.decimals,
+				  append_bytes, data);
 	default:
 		return -EINVAL;
 	}
 }
 
+/*
+ * Append the separator before a member and its key, '{"name":' for the
+ * first one and ',"name":' for the others, in one call.
+ */
+static int key_encode(const struct json_obj_descr *descr, bool first,
+		      json_append_bytes_t append_bytes, void *data)
+{
+	char buf[sizeof("{\"\":") - 1 + BIT(7)];
+	size_t len = descr->field_name_len;
+	int ret;
+
+	if (json_calc_escaped_len(descr->field_name, len) != len) {
+		ret = append_bytes(first ? "{" : ",", 1, data);
+		if (ret < 0) {
+			return ret;
+		}
+
+		ret = str_encode((const char **)&descr->field_name,
+				 append_bytes, data);
+		if (ret < 0) {
+			return ret;
+		}
+
+		return append_bytes(":", 1, data);
+	}
+
+	buf[0] = first ? '{' : ',';
+	buf[1] = '"';
+	memcpy(&buf[2], descr->field_name, len);
+	buf[len + 2] = '"';
+	buf[len + 3] = ':';
+
+	return append_bytes(buf, len + 4, data);
+}
+
 int json_obj_encode(const struct json_obj_descr *descr, size_t descr_len,
 		    const void *val, json_append_bytes_t append_bytes,
 		    void *data)
@@ -832,19 +1806,12 @@ int json_obj_encode(const struct json_obj_descr *descr, size_t descr_len,
 	size_t i;
 	int ret;
 
-	ret = append_bytes("{", 1, data);
-	if (ret < 0) {
-		return ret;
+	if (!descr_len) {
+		return append_bytes("{}", 2, data);
 	}
 
 	for (i = 0; i < descr_len; i++) {
-		ret = str_encode((const char **)&descr[i].field_name,
-				 append_bytes, data);
-		if (ret < 0) {
-			return ret;
-		}
-
-		ret = append_bytes(":", 1, data);
+		ret = key_encode(&descr[i], i == 0, append_bytes, data);
 		if (ret < 0) {
 			return ret;
 		}
@@ -853,13 +1820,6 @@ int json_obj_encode(const struct json_obj_descr *descr, size_t descr_len,
 		if (ret < 0) {
 			return ret;
 		}
-
-		if (i < descr_len - 1) {
-			ret = append_bytes(",", 1, data);
-			if (ret < 0) {
-				return ret;
-			}
-		}
 	}
 
 	return append_bytes("}", 1, data);
@@ -895,6 +1855,133 @@ int json_obj_encode_buf(const struct json_obj_descr *descr, size_t descr_len,
 			       &appender);
 }
 
+struct chunker {
+	char *chunk;
+	size_t size;
+	size_t used;
+	json_append_bytes_t flush;
+	void *data;
+};
+
+static int append_bytes_to_chunk(const char *bytes, size_t len, void *data)
+{
+	struct chunker *chunker = data;
+	size_t n;
+	int ret;
+
+	while (len) {
+		if (chunker->used == chunker->size) {
+			ret = chunker->flush(chunker->chunk, chunker->used,
+					     chunker->data);
+			if (ret < 0) {
+				return ret;
+			}
+
+			chunker->used = 0;
+		}
+
+		/* Whole chunks are passed on without being copied */
+		if (!chunker->used && len >= chunker->size) {
+			n = len - len % chunker->size;
+
+			ret = chunker->flush(bytes, n, chunker->data);
+			if (ret < 0) {
+				return ret;
+			}
+		} else {
+			n = min(len, chunker->size - chunker->used);
+
+			memcpy(chunker->chunk + chunker->used, bytes, n);
+			chunker->used += n;
+		}
+
+		bytes += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+int json_obj_encode_chunked(const struct json_obj_descr *descr,
+			    size_t descr_len, const void *val,
+			    char *chunk, size_t chunk_size,
+			    json_append_bytes_t flush, void *data)
+{
+	struct chunker chunker = {
+		.chunk = chunk,
+		.size = chunk_size,
+		.flush = flush,
+		.data = data,
+	};
+	int ret;
+
+	if (!chunk_size) {
+		return -EINVAL;
+	}
+
+	ret = json_obj_encode(descr, descr_len, val, append_bytes_to_chunk,
+			      &chunker);
+	if (ret < 0 || !chunker.used) {
+		return ret;
+	}
+
+	return flush(chunker.chunk, chunker.used, data);
+}
+
+#if defined(CONFIG_NET_BUF)
+struct net_buf_appender {
+	struct net_buf *frag;
+	struct net_buf_pool *pool;
+	s32_t timeout;
+};
+
+static int append_bytes_to_net_buf(const char *bytes, size_t len, void *data)
+{
+	struct net_buf_appender *appender = data;
+	struct net_buf *frag;
+	size_t n;
+
+	while (len) {
+		n = min(len, net_buf_tailroom(appender->frag));
+		if (!n) {
+			if (!appender->pool) {
+				return -ENOMEM;
+			}
+
+			frag = net_buf_alloc(appender->pool, appender->timeout);
+			if (!frag) {
+				return -ENOMEM;
+			}
+
+			net_buf_frag_insert(appender->frag, frag);
+			appender->frag = frag;
+			continue;
+		}
+
+		net_buf_add_mem(appender->frag, bytes, n);
+		bytes += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+int json_obj_encode_net_buf(const struct json_obj_descr *descr,
+			    size_t descr_len, const void *val,
+			    struct net_buf *buf, struct net_buf_pool *pool,
+			    s32_t timeout)
+{
+	struct net_buf_appender appender = {
+		.frag = net_buf_frag_last(buf),
+		.pool = pool,
+		.timeout = timeout,
+	};
+
+	return json_obj_encode(descr, descr_len, val, append_bytes_to_net_buf,
+			       &appender);
+}
+#endif /* CONFIG_NET_BUF */
+
 static int measure_bytes(const char *bytes, size_t len, void *data)
 {
 	ssize_t *total = data;
@@ -7,6 +7,31 @@
  */
 
 #include <string.h>
+#include <stdint.h>
+
+/*
+ * Word-at-a-time helpers. Word accesses to byte buffers alias them, which
+ * the may_alias attribute lets the compiler know about.
+ *
+ * The string routines read whole aligned words and may therefore look at
+ * up to WORD_SIZE - 1 bytes past the terminating NUL. An aligned word never
+ * straddles a page or an MPU region, so these extra reads cannot fault.
+ */
+typedef unsigned long __attribute__((__may_alias__)) mem_word_t;
+
+#define WORD_SIZE sizeof(mem_word_t)
+#define WORD_MASK (WORD_SIZE - 1)
+
+/* 0x01 and 0x80 repeated in every byte of a word */
+#define LSB_ONES ((mem_word_t)-1 / 0xff)
+#define MSB_ONES (LSB_ONES << 7)
+
+/* Non-zero if and only if one of the bytes of @a w is zero */
+#define HAS_ZERO(w) (((w) - LSB_ONES) & ~(w) & MSB_ONES)
+
+#define WORD_ALIGNED(p) (((uintptr_t)(p) & WORD_MASK) == 0)
+#define SAME_ALIGNMENT(p1, p2) \
+	((((uintptr_t)(p1) ^ (uintptr_t)(p2)) & WORD_MASK) == 0)
 
 /**
  *
@@ -67,7 +92,23 @@ char *strncpy(char *_MLIBC_RESTRICT d, const char *_MLIBC_RESTRICT s, size_t n)
 char *strchr(const char *s, int c)
 {
 	char tmp = (char) c;
+	mem_word_t pattern = LSB_ONES * (unsigned char)c;
+	const mem_word_t *w;
+
+	while (!WORD_ALIGNED(s)) {
+		if ((*s == tmp) || (*s == '\0')) {
+			return (*s == tmp) ? (char *) s : NULL;
+		}
+		s++;
+	}
 
+	/* skip words holding neither the byte nor the terminator */
+	w = (const mem_word_t *)s;
+	while (!HAS_ZERO(*w) && !HAS_ZERO(*w ^ pattern)) {
+		w++;
+	}
+
+	s = (const char *)w;
 	while ((*s != tmp) && (*s != '\0'))
 		s++;
 
@@ -103,14 +144,27 @@ char *strrchr(const char *s, int c)
 
 size_t strlen(const char *s)
 {
-	size_t n = 0;
+	const char *p = s;
+	const mem_word_t *w;
 
-	while (*s != '\0') {
-		s++;
-		n++;
+	while (!WORD_ALIGNED(p)) {
+		if (*p == '\0') {
+			return p - s;
+		}
+		p++;
 	}
 
-	return n;
+	w = (const mem_word_t *)p;
+	while (!HAS_ZERO(*w)) {
+		w++;
+	}
+
+	p = (const char *)w;
+	while (*p != '\0') {
+		p++;
+	}
+
+	return p - s;
 }
 
 /**
@@ -122,6 +176,29 @@ size_t strlen(const char *s)
 
 int strcmp(const char *s1, const char *s2)
 {
+	if (SAME_ALIGNMENT(s1, s2)) {
+		const mem_word_t *w1, *w2;
+
+		while (!WORD_ALIGNED(s1)) {
+			if ((*s1 != *s2) || (*s1 == '\0')) {
+				return *s1 - *s2;
+			}
+			s1++;
+			s2++;
+		}
+
+		/* skip equal words until one of them holds the terminator */
+		w1 = (const mem_word_t *)s1;
+		w2 = (const mem_word_t *)s2;
+		while ((*w1 == *w2) && !HAS_ZERO(*w1)) {
+			w1++;
+			w2++;
+		}
+
+		s1 = (const char *)w1;
+		s2 = (const char *)w2;
+	}
+
 	while ((*s1 == *s2) && (*s1 != '\0')) {
 		s1++;
 		s2++;
@@ -177,18 +254,44 @@ char *strncat(char *_MLIBC_RESTRICT dest, const char *_MLIBC_RESTRICT src,
  */
 int memcmp(const void *m1, const void *m2, size_t n)
 {
-	const char *c1 = m1;
-	const char *c2 = m2;
+	const unsigned char *c1 = m1;
+	const unsigned char *c2 = m2;
+
+	if (SAME_ALIGNMENT(c1, c2)) {
+		const mem_word_t *w1, *w2;
+
+		while (!WORD_ALIGNED(c1) && (n > 0)) {
+			if (*c1 != *c2) {
+				return *c1 - *c2;
+			}
+			c1++;
+			c2++;
+			n--;
+		}
 
-	if (!n)
-		return 0;
+		/* skip equal words, the differing one is compared bytewise */
+		w1 = (const mem_word_t *)c1;
+		w2 = (const mem_word_t *)c2;
+		while ((n >= WORD_SIZE) && (*w1 == *w2)) {
+			w1++;
+			w2++;
+			n -= WORD_SIZE;
+		}
+
+		c1 = (const unsigned char *)w1;
+		c2 = (const unsigned char *)w2;
+	}
 
-	while ((--n > 0) && (*c1 == *c2)) {
+	while (n > 0) {
+		if (*c1 != *c2) {
+			return *c1 - *c2;
+		}
 		c1++;
 		c2++;
+		n--;
 	}
 
-	return *c1 - *c2;
+	return 0;
 }
 
 /**
@@ -226,6 +329,8 @@ void *memmove(void *d, const void *s, size_t n)
 	return d;
 }
 
+#ifndef CONFIG_MINIMAL_LIBC_ARCH_MEM_FUNCS
+
 /**
  *
  * @brief Copy bytes in memory
@@ -240,11 +345,11 @@ void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
 	unsigned char *d_byte = (unsigned char *)d;
 	const unsigned char *s_byte = (const unsigned char *)s;
 
-	if ((((unsigned int)d ^ (unsigned int)s_byte) & 0x3) == 0) {
+	if (SAME_ALIGNMENT(d_byte, s_byte)) {
 
 		/* do byte-sized copying until word-aligned or finished */
 
-		while (((unsigned int)d_byte) & 0x3) {
+		while (!WORD_ALIGNED(d_byte)) {
 			if (n == 0) {
 				return d;
 			}
@@ -252,18 +357,28 @@ void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
 			n--;
 		};
 
-		/* do word-sized copying as long as possible */
+		/* do word-sized copying, four words per iteration */
+
+		mem_word_t *d_word = (mem_word_t *)d_byte;
+		const mem_word_t *s_word = (const mem_word_t *)s_byte;
 
-		unsigned int *d_word = (unsigned int *)d_byte;
-		const unsigned int *s_word = (const unsigned int *)s_byte;
+		while (n >= 4 * WORD_SIZE) {
+			d_word[0] = s_word[0];
+			d_word[1] = s_word[1];
+			d_word[2] = s_word[2];
+			d_word[3] = s_word[3];
+			d_word += 4;
+			s_word += 4;
+			n -= 4 * WORD_SIZE;
+		}
 
-		while (n >= sizeof(unsigned int)) {
+		while (n >= WORD_SIZE) {
 			*(d_word++) = *(s_word++);
-			n -= sizeof(unsigned int);
+			n -= WORD_SIZE;
 		}
 
 		d_byte = (unsigned char *)d_word;
-		s_byte = (unsigned char *)s_word;
+		s_byte = (const unsigned char *)s_word;
 	}
 
 	/* do byte-sized copying until finished */
@@ -290,7 +405,7 @@ void *memset(void *buf, int c, size_t n)
 	unsigned char *d_byte = (unsigned char *)buf;
 	unsigned char c_byte = (unsigned char)c;
 
-	while (((unsigned int)d_byte) & 0x3) {
+	while (!WORD_ALIGNED(d_byte)) {
 		if (n == 0) {
 			return buf;
 		}
@@ -298,17 +413,23 @@ void *memset(void *buf, int c, size_t n)
 		n--;
 	};
 
-	/* do word-sized initialization as long as possible */
+	/* do word-sized initialization, four words per iteration */
 
-	unsigned int *d_word = (unsigned int *)d_byte;
-	unsigned int c_word = (unsigned int)(unsigned char)c;
+	mem_word_t *d_word = (mem_word_t *)d_byte;
+	mem_word_t c_word = LSB_ONES * c_byte;
 
-	c_word |= c_word << 8;
-	c_word |= c_word << 16;
+	while (n >= 4 * WORD_SIZE) {
+		d_word[0] = c_word;
+		d_word[1] = c_word;
+		d_word[2] = c_word;
+		d_word[3] = c_word;
+		d_word += 4;
+		n -= 4 * WORD_SIZE;
+	}
 
-	while (n >= sizeof(unsigned int)) {
+	while (n >= WORD_SIZE) {
 		*(d_word++) = c_word;
-		n -= sizeof(unsigned int);
+		n -= WORD_SIZE;
 	}
 
 	/* do byte-sized initialization until finished */
@@ -323,6 +444,8 @@ void *memset(void *buf, int c, size_t n)
 	return buf;
 }
 
+#endif /* CONFIG_MINIMAL_LIBC_ARCH_MEM_FUNCS */
+
 /**
  *
  * @brief Scan byte in memory
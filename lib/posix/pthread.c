@@ -37,6 +37,14 @@ static const pthread_attr_t init_pthread_attrs = {
 /* Memory pool for pthread space */
 K_MEM_POOL_DEFINE(posix_thread_pool, sizeof(struct posix_thread),
 		  sizeof(struct posix_thread), CONFIG_MAX_PTHREAD_COUNT, 4);
+
+#ifdef CONFIG_PTHREAD_POOL
+/* Thread objects and stacks for pthreads created without a stack */
+_K_THREAD_POOL_DEFINE(pthread_pool, struct posix_thread,
+		      CONFIG_MAX_PTHREAD_COUNT, CONFIG_PTHREAD_POOL_STACK_SIZE,
+		      0, 0);
+#endif
+
 static bool is_posix_prio_valid(u32_t priority, int policy)
 {
 	if (priority >= sched_get_priority_min(policy) &&
@@ -123,6 +131,63 @@ static void zephyr_thread_wrapper(void *arg1, void *arg2, void *arg3)
 	pthread_exit(NULL);
 }
 
+static void posix_thread_init(struct posix_thread *thread,
+			      const pthread_attr_t *attr)
+{
+	pthread_condattr_t cond_attr;
+
+	memset(thread, 0, sizeof(struct posix_thread));
+
+	thread->cancel_state = (1 << _PTHREAD_CANCEL_POS) & attr->flags;
+	thread->state = attr->detachstate;
+	thread->cancel_pending = 0;
+	pthread_mutex_init(&thread->state_lock, NULL);
+	pthread_mutex_init(&thread->cancel_lock, NULL);
+	pthread_cond_init(&thread->state_cond, &cond_attr);
+	sys_slist_init(&thread->key_list);
+}
+
+/*
+ * Give the thread object of a terminated pthread back to the thread pool.
+ * Threads running on caller provided stacks are not part of the pool.
+ */
+static inline void posix_thread_release(struct posix_thread *thread)
+{
+#ifdef CONFIG_PTHREAD_POOL
+	k_thread_pool_free(&pthread_pool, &thread->thread);
+#else
+	ARG_UNUSED(thread);
+#endif
+}
+
+#ifdef CONFIG_PTHREAD_POOL
+static int pthread_create_pooled(pthread_t *newthread,
+				 const pthread_attr_t *attr,
+				 void *(*threadroutine)(void *), void *arg)
+{
+	struct posix_thread *thread;
+	s32_t prio;
+
+	prio = posix_to_zephyr_priority(attr->priority, attr->schedpolicy);
+
+	thread = (struct posix_thread *)k_thread_pool_alloc(&pthread_pool);
+	if (!thread) {
+		return EAGAIN;
+	}
+
+	posix_thread_init(thread, attr);
+
+	*newthread = (pthread_t) k_thread_pool_start(&pthread_pool,
+						     &thread->thread,
+						     (k_thread_entry_t)
+						     zephyr_thread_wrapper,
+						     (void *)arg, NULL,
+						     threadroutine, prio,
+						     attr->delayedstart);
+	return 0;
+}
+#endif
+
 /**
  * @brief Create a new thread.
  *
@@ -135,14 +200,26 @@ int pthread_create(pthread_t *newthread, const pthread_attr_t *attr,
 		   void *(*threadroutine)(void *), void *arg)
 {
 	s32_t prio;
-	pthread_condattr_t cond_attr;
 	struct posix_thread *thread;
 	struct k_mem_block block;
 
+#ifdef CONFIG_PTHREAD_POOL
+	/* Without a stack, take both stack and thread from the pool */
+	if (!attr) {
+		attr = &init_pthread_attrs;
+	}
+
+	if (attr->initialized && !attr->stack) {
+		return pthread_create_pooled(newthread, attr, threadroutine,
+					     arg);
+	}
+#endif
+
 	/*
 	 * FIXME: Pthread attribute must be non-null and it provides stack
 	 * pointer and stack size. So even though POSIX 1003.1 spec accepts
-	 * attrib as NULL but zephyr needs it initialized with valid stack.
+	 * attrib as NULL but zephyr needs it initialized with valid stack,
+	 * unless CONFIG_PTHREAD_POOL is enabled.
 	 */
 	if (!attr || !attr->initialized || !attr->stack || !attr->stacksize) {
 		return EINVAL;
@@ -152,20 +229,13 @@ int pthread_create(pthread_t *newthread, const pthread_attr_t *attr,
 
 	if (k_mem_pool_alloc(&posix_thread_pool, &block,
 			     sizeof(struct posix_thread), 100) == 0) {
-		memset(block.data, 0, sizeof(struct posix_thread));
 		thread = block.data;
 	} else {
 		/* Insuffecient resource to create thread*/
 		return EAGAIN;
 	}
 
-	thread->cancel_state = (1 << _PTHREAD_CANCEL_POS) & attr->flags;
-	thread->state = attr->detachstate;
-	thread->cancel_pending = 0;
-	pthread_mutex_init(&thread->state_lock, NULL);
-	pthread_mutex_init(&thread->cancel_lock, NULL);
-	pthread_cond_init(&thread->state_cond, &cond_attr);
-	sys_slist_init(&thread->key_list);
+	posix_thread_init(thread, attr);
 
 	*newthread = (pthread_t) k_thread_create(&thread->thread, attr->stack,
 						 attr->stacksize,
@@ -237,6 +307,10 @@ int pthread_cancel(pthread_t pthread)
 		pthread_mutex_unlock(&thread->state_lock);
 
 		k_thread_abort((k_tid_t) thread);
+
+		if (thread->state == PTHREAD_TERMINATED) {
+			posix_thread_release(thread);
+		}
 	}
 
 	return 0;
@@ -364,6 +438,12 @@ void pthread_exit(void *retval)
 	}
 
 	pthread_mutex_unlock(&self->state_lock);
+
+	/* Reusable once this thread is dead */
+	if (self->state == PTHREAD_TERMINATED) {
+		posix_thread_release(self);
+	}
+
 	k_thread_abort((k_tid_t)self);
 }
 
@@ -398,6 +478,11 @@ int pthread_join(pthread_t thread, void **status)
 	}
 
 	pthread_mutex_unlock(&pthread->state_lock);
+
+	if (ret == 0) {
+		posix_thread_release(pthread);
+	}
+
 	return ret;
 }
 
@@ -440,6 +525,11 @@ int pthread_detach(pthread_t thread)
 	}
 
 	pthread_mutex_unlock(&pthread->state_lock);
+
+	if (pthread->state == PTHREAD_TERMINATED && ret == 0) {
+		posix_thread_release(pthread);
+	}
+
 	return ret;
 }
 
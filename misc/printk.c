@@ -19,6 +19,9 @@
 #include <linker/sections.h>
 #include <syscall_handler.h>
 #include <logging/log.h>
+#include <atomic.h>
+#include <string.h>
+#include <limits.h>
 
 typedef int (*out_func_t)(int c, void *ctx);
 
@@ -29,12 +32,67 @@ enum pad_type {
 	PAD_SPACE_AFTER,
 };
 
-static void _printk_dec_ulong(out_func_t out, void *ctx,
-			      const unsigned long num, enum pad_type padding,
-			      int min_width);
-static void _printk_hex_ulong(out_func_t out, void *ctx,
-			      const unsigned long num, enum pad_type padding,
-			      int min_width);
+static void _printk_dec_u64(out_func_t out, void *ctx, u64_t num,
+			    enum pad_type padding, int min_width);
+static void _printk_hex_u64(out_func_t out, void *ctx, u64_t num,
+			    enum pad_type padding, int min_width);
+static void _printk_addr(out_func_t out, void *ctx, char type,
+			 const u8_t *addr, enum pad_type padding,
+			 int min_width);
+
+struct str_context {
+	char *str;
+	int max;
+	int count;
+};
+
+static int str_out(int c, struct str_context *ctx);
+
+/* Decimal digit pairs "00" to "99", two digits are produced per division */
+static const char dec_pairs[200] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+static const char hex_digits[16] = "0123456789abcdef";
+
+/* Longest number output: 20 decimal digits of an unsigned 64-bit value */
+#define NUM_BUF_SIZE 20
+
+/*
+ * Output a string of known length. String contexts are filled with
+ * memcpy() instead of one call per character.
+ */
+static void _printk_out(out_func_t out, void *ctx, const char *s, int len)
+{
+	if (out == (out_func_t)str_out) {
+		struct str_context *str_ctx = ctx;
+		int room = str_ctx->max - 1 - str_ctx->count;
+
+		if (str_ctx->str && room >= 0) {
+			memcpy(str_ctx->str + str_ctx->count, s, min(len, room));
+			if (len > room) {
+				str_ctx->str[str_ctx->max - 1] = '\0';
+			}
+		}
+
+		str_ctx->count += len;
+		return;
+	}
+
+	while (len-- > 0) {
+		out((int)*s++, ctx);
+	}
+}
+
+static void _printk_pad(out_func_t out, void *ctx, char c, int count)
+{
+	while (count-- > 0) {
+		out((int)c, ctx);
+	}
+}
 
 /**
  * @brief Default character output routine that does nothing
@@ -100,7 +158,13 @@ void _vprintk(out_func_t out, void *ctx, const char *fmt, va_list ap)
 	while (*fmt) {
 		if (!might_format) {
 			if (*fmt != '%') {
-				out((int)*fmt, ctx);
+				const char *start = fmt;
+
+				/* Output text up to the next conversion at once */
+				while (fmt[1] && fmt[1] != '%') {
+					fmt++;
+				}
+				_printk_out(out, ctx, start, fmt - start + 1);
 			} else {
 				might_format = 1;
 				min_width = -1;
@@ -138,36 +202,57 @@ void _vprintk(out_func_t out, void *ctx, const char *fmt, va_list ap)
 				goto still_might_format;
 			case 'd':
 			case 'i': {
-				long d;
-				if (long_ctr < 2) {
+				s64_t d;
+				u64_t u;
+
+				if (long_ctr == 0) {
+					d = va_arg(ap, int);
+				} else if (long_ctr == 1) {
 					d = va_arg(ap, long);
 				} else {
-					d = (long)va_arg(ap, long long);
+					d = va_arg(ap, long long);
 				}
 
 				if (d < 0) {
 					out((int)'-', ctx);
-					d = -d;
+					u = -(u64_t)d;
 					min_width--;
+				} else {
+					u = d;
 				}
-				_printk_dec_ulong(out, ctx, d, padding,
-						  min_width);
+				_printk_dec_u64(out, ctx, u, padding,
+						min_width);
 				break;
 			}
 			case 'u': {
-				unsigned long u;
+				u64_t u;
 
-				if (long_ctr < 2) {
+				if (long_ctr == 0) {
+					u = va_arg(ap, unsigned int);
+				} else if (long_ctr == 1) {
 					u = va_arg(ap, unsigned long);
 				} else {
-					u = (unsigned long)va_arg(ap,
-							unsigned long long);
+					u = va_arg(ap, unsigned long long);
 				}
-				_printk_dec_ulong(out, ctx, u, padding,
-						  min_width);
+				_printk_dec_u64(out, ctx, u, padding,
+						min_width);
 				break;
 			}
 			case 'p':
+				/* %pI4, %pI6 and %pM: IPv4, IPv6, MAC address */
+				if ((fmt[1] == 'I' &&
+				     (fmt[2] == '4' || fmt[2] == '6')) ||
+				    fmt[1] == 'M') {
+					fmt++;
+					if (*fmt == 'I') {
+						fmt++;
+					}
+					_printk_addr(out, ctx, *fmt,
+						     va_arg(ap, const u8_t *),
+						     padding, min_width);
+					break;
+				}
+
 				  out('0', ctx);
 				  out('x', ctx);
 				  /* left-pad pointers with zeros */
@@ -176,31 +261,28 @@ void _vprintk(out_func_t out, void *ctx, const char *fmt, va_list ap)
 				  /* Fall through */
 			case 'x':
 			case 'X': {
-				unsigned long x;
+				u64_t x;
 
-				if (long_ctr < 2) {
+				if (long_ctr == 0 && *fmt != 'p') {
+					x = va_arg(ap, unsigned int);
+				} else if (long_ctr < 2) {
 					x = va_arg(ap, unsigned long);
 				} else {
-					x = (unsigned long)va_arg(ap,
-							unsigned long long);
+					x = va_arg(ap, unsigned long long);
 				}
 
-				_printk_hex_ulong(out, ctx, x, padding,
-						  min_width);
+				_printk_hex_u64(out, ctx, x, padding,
+						min_width);
 				break;
 			}
 			case 's': {
 				char *s = va_arg(ap, char *);
-				char *start = s;
+				int len = strlen(s);
 
-				while (*s)
-					out((int)(*s++), ctx);
+				_printk_out(out, ctx, s, len);
 
 				if (padding == PAD_SPACE_AFTER) {
-					int remaining = min_width - (s - start);
-					while (remaining-- > 0) {
-						out(' ', ctx);
-					}
+					_printk_pad(out, ctx, ' ', min_width - len);
 				}
 				break;
 			}
@@ -265,6 +347,194 @@ static int char_out(int c, void *ctx_p)
 	return _char_out(c);
 }
 
+#ifdef CONFIG_PRINTK_DEFERRED
+/*
+ * Deferred output is kept in a ring buffer of records, each starting with
+ * a header word holding the length and the type of the record. Producers
+ * reserve space by moving the head with a compare and swap and publish the
+ * record by writing its header. The consumer sends records to the console
+ * in order, zeroes them and moves the tail. A zero header is a record which
+ * is reserved but not written yet, the consumer stops there.
+ */
+#define DEFERRED_SIZE CONFIG_PRINTK_DEFERRED_BUFFER_SIZE
+#define DEFERRED_MASK (DEFERRED_SIZE - 1)
+
+#if (DEFERRED_SIZE & DEFERRED_MASK) != 0
+#error CONFIG_PRINTK_DEFERRED_BUFFER_SIZE must be power of 2
+#endif
+
+/* Maximal length of output in a record */
+#define DEFERRED_CHUNK 32
+
+#define DEFERRED_REC_DATA 1
+#define DEFERRED_REC_PAD 2
+
+#define DEFERRED_HDR(len, type) (((len) << 2) | (type))
+#define DEFERRED_REC_LEN(len) ROUND_UP(sizeof(atomic_t) + (len), \
+				       sizeof(atomic_t))
+
+static u8_t __aligned(sizeof(atomic_t)) deferred_buf[DEFERRED_SIZE];
+static atomic_t deferred_head;
+static atomic_t deferred_tail;
+static bool deferred_sync;
+
+static K_SEM_DEFINE(deferred_sem, 0, 1);
+
+static void deferred_put(const char *data, size_t len)
+{
+	u32_t rec_len = DEFERRED_REC_LEN(len);
+	u32_t head, off, need;
+	atomic_t *hdr;
+
+	do {
+		head = atomic_get(&deferred_head);
+		off = head & DEFERRED_MASK;
+		need = rec_len;
+
+		/* Records do not wrap, the end is padded instead. */
+		if (off + rec_len > DEFERRED_SIZE) {
+			need += DEFERRED_SIZE - off;
+		}
+
+		if (head + need - atomic_get(&deferred_tail) > DEFERRED_SIZE) {
+			/* No space, output is dropped. */
+			return;
+		}
+	} while (!atomic_cas(&deferred_head, head, head + need));
+
+	if (need != rec_len) {
+		hdr = (atomic_t *)&deferred_buf[off];
+		atomic_set(hdr, DEFERRED_HDR(DEFERRED_SIZE - off,
+					     DEFERRED_REC_PAD));
+		off = 0;
+	}
+
+	hdr = (atomic_t *)&deferred_buf[off];
+	memcpy(hdr + 1, data, len);
+	atomic_set(hdr, DEFERRED_HDR(len, DEFERRED_REC_DATA));
+
+	k_sem_give(&deferred_sem);
+}
+
+static void deferred_write(const char *data, size_t len)
+{
+	size_t chunk;
+
+	while (len > 0) {
+		chunk = min(len, DEFERRED_CHUNK);
+		deferred_put(data, chunk);
+		data += chunk;
+		len -= chunk;
+	}
+}
+
+/* Send the oldest record to the console, false if there is none. */
+static bool deferred_flush_one(void)
+{
+	u32_t tail = atomic_get(&deferred_tail);
+	atomic_val_t val;
+	atomic_t *hdr;
+	u32_t rec_len;
+	u32_t len;
+	char *data;
+
+	if (tail == atomic_get(&deferred_head)) {
+		return false;
+	}
+
+	hdr = (atomic_t *)&deferred_buf[tail & DEFERRED_MASK];
+	val = atomic_get(hdr);
+	if (val == 0) {
+		return false;
+	}
+
+	len = val >> 2;
+	if ((val & 0x3) == DEFERRED_REC_PAD) {
+		rec_len = len;
+	} else {
+		rec_len = DEFERRED_REC_LEN(len);
+		data = (char *)(hdr + 1);
+
+		for (u32_t i = 0; i < len; i++) {
+			_char_out(data[i]);
+		}
+	}
+
+	memset(hdr, 0, rec_len);
+	atomic_set(&deferred_tail, tail + rec_len);
+
+	return true;
+}
+
+void printk_panic(void)
+{
+	while (deferred_flush_one()) {
+	}
+
+	deferred_sync = true;
+}
+
+static void deferred_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		k_sem_take(&deferred_sem, K_FOREVER);
+
+		while (!deferred_sync && deferred_flush_one()) {
+		}
+	}
+}
+
+K_THREAD_DEFINE(printk_deferred_thread,
+		CONFIG_PRINTK_DEFERRED_THREAD_STACK_SIZE,
+		deferred_thread, NULL, NULL, NULL,
+		CONFIG_PRINTK_DEFERRED_THREAD_PRIO, 0, K_NO_WAIT);
+
+struct deferred_out_context {
+	int count;
+	unsigned int buf_count;
+	char buf[DEFERRED_CHUNK];
+};
+
+static int deferred_char_out(int c, void *ctx_p)
+{
+	struct deferred_out_context *ctx = ctx_p;
+
+	ctx->count++;
+	ctx->buf[ctx->buf_count++] = c;
+	if (ctx->buf_count == DEFERRED_CHUNK) {
+		deferred_put(ctx->buf, ctx->buf_count);
+		ctx->buf_count = 0;
+	}
+
+	return c;
+}
+#endif /* CONFIG_PRINTK_DEFERRED */
+
+static int kernel_vprintk(const char *fmt, va_list ap)
+{
+#ifdef CONFIG_PRINTK_DEFERRED
+	if (!deferred_sync) {
+		struct deferred_out_context ctx = { 0 };
+
+		_vprintk(deferred_char_out, &ctx, fmt, ap);
+
+		if (ctx.buf_count) {
+			deferred_put(ctx.buf, ctx.buf_count);
+		}
+		return ctx.count;
+	}
+#endif
+	struct out_context ctx = { 0 };
+
+	_vprintk(char_out, &ctx, fmt, ap);
+
+	return ctx.count;
+}
+
 #ifdef CONFIG_USERSPACE
 int vprintk(const char *fmt, va_list ap)
 {
@@ -278,21 +548,13 @@ int vprintk(const char *fmt, va_list ap)
 		}
 		return ctx.count;
 	} else {
-		struct out_context ctx = { 0 };
-
-		_vprintk(char_out, &ctx, fmt, ap);
-
-		return ctx.count;
+		return kernel_vprintk(fmt, ap);
 	}
 }
 #else
 int vprintk(const char *fmt, va_list ap)
 {
-	struct out_context ctx = { 0 };
-
-	_vprintk(char_out, &ctx, fmt, ap);
-
-	return ctx.count;
+	return kernel_vprintk(fmt, ap);
 }
 #endif
 
@@ -300,6 +562,13 @@ void _impl_k_str_out(char *c, size_t n)
 {
 	int i;
 
+#ifdef CONFIG_PRINTK_DEFERRED
+	if (!deferred_sync) {
+		deferred_write(c, n);
+		return;
+	}
+#endif
+
 	for (i = 0; i < n; i++) {
 		_char_out(c[i]);
 	}
@@ -322,12 +591,14 @@ Z_SYSCALL_HANDLER(k_str_out, c, n)
  * printf-like formatting is available.
  *
  * Available formatting:
- * - %x/%X:  outputs a 32-bit number in ABCDWXYZ format. All eight digits
- *	    are printed: if less than 8 characters are needed, leading zeroes
- *	    are displayed.
+ * - %x/%X:  outputs a number in hexadecimal format.
  * - %s:	    output a null-terminated string
- * - %p:     pointer, same as %x
- * - %d/%i/%u: outputs a 32-bit number in unsigned decimal format.
+ * - %p:     pointer, same as %x with eight digits
+ * - %pI4:   IPv4 address from a pointer to 4 bytes, as 192.0.2.1
+ * - %pI6:   IPv6 address from a pointer to 16 bytes, as 2001:db8::1
+ * - %pM:    MAC address from a pointer to 6 bytes, as 00:11:22:33:44:55
+ *           (addresses accept a minimum width, e.g. %-16pI6)
+ * - %d/%i/%u: outputs a number in decimal format, up to 64 bits with ll.
  *
  * @param fmt formatted string to output
  *
@@ -351,104 +622,204 @@ int printk(const char *fmt, ...)
 }
 
 /**
- * @brief Output an unsigned long in hex format
+ * @brief Output an unsigned 64-bit value in hex format
  *
- * Output an unsigned long on output installed by platform at init time. Should
- * be able to handle an unsigned long of any size, 32 or 64 bit.
+ * Digits are looked up in a table and written to a buffer, which is then
+ * output at once.
  * @param num Number to output
  *
  * @return N/A
  */
-static void _printk_hex_ulong(out_func_t out, void *ctx,
-			      const unsigned long num, enum pad_type padding,
-			      int min_width)
+static void _printk_hex_u64(out_func_t out, void *ctx, u64_t num,
+			    enum pad_type padding, int min_width)
 {
-	int size = sizeof(num) * 2;
-	int found_largest_digit = 0;
-	int remaining = 8; /* 8 digits max */
-	int digits = 0;
-
-	for (; size; size--) {
-		char nibble = (num >> ((size - 1) << 2) & 0xf);
-
-		if (nibble || found_largest_digit || size == 1) {
-			found_largest_digit = 1;
-			nibble += nibble > 9 ? 87 : 48;
-			out((int)nibble, ctx);
-			digits++;
-			continue;
-		}
-
-		if (remaining-- <= min_width) {
-			if (padding == PAD_ZERO_BEFORE) {
-				out('0', ctx);
-			} else if (padding == PAD_SPACE_BEFORE) {
-				out(' ', ctx);
-			}
-		}
+	char buf[NUM_BUF_SIZE];
+	char *end = buf + sizeof(buf);
+	char *ptr = end;
+	int digits;
+
+	do {
+		*--ptr = hex_digits[num & 0xf];
+		num >>= 4;
+	} while (num);
+
+	digits = end - ptr;
+
+	if (padding == PAD_ZERO_BEFORE) {
+		_printk_pad(out, ctx, '0', min_width - digits);
+	} else if (padding == PAD_SPACE_BEFORE) {
+		_printk_pad(out, ctx, ' ', min_width - digits);
 	}
 
+	_printk_out(out, ctx, ptr, digits);
+
 	if (padding == PAD_SPACE_AFTER) {
-		remaining = min_width * 2 - digits;
-		while (remaining-- > 0) {
-			out(' ', ctx);
-		}
+		_printk_pad(out, ctx, ' ', min_width * 2 - digits);
 	}
 }
 
+/*
+ * Write the decimal digits of a number backwards from @a end, two digits
+ * per division. 64-bit divisions are only done for the part of the value
+ * which does not fit in an unsigned long.
+ */
+static char *_printk_dec_fmt(char *end, u64_t num)
+{
+	unsigned long n;
+	u32_t r;
+
+	while (num > ULONG_MAX) {
+		r = num % 100;
+		num /= 100;
+		end -= 2;
+		memcpy(end, &dec_pairs[r * 2], 2);
+	}
+
+	n = num;
+	while (n >= 100) {
+		r = n % 100;
+		n /= 100;
+		end -= 2;
+		memcpy(end, &dec_pairs[r * 2], 2);
+	}
+
+	if (n >= 10) {
+		end -= 2;
+		memcpy(end, &dec_pairs[n * 2], 2);
+	} else {
+		*--end = '0' + n;
+	}
+
+	return end;
+}
+
 /**
- * @brief Output an unsigned long (32-bit) in decimal format
+ * @brief Output an unsigned 64-bit value in decimal format
  *
- * Output an unsigned long on output installed by platform at init time. Only
- * works with 32-bit values.
  * @param num Number to output
  *
  * @return N/A
  */
-static void _printk_dec_ulong(out_func_t out, void *ctx,
-			      const unsigned long num, enum pad_type padding,
-			      int min_width)
+static void _printk_dec_u64(out_func_t out, void *ctx, u64_t num,
+			    enum pad_type padding, int min_width)
 {
-	unsigned long pos = 999999999;
-	unsigned long remainder = num;
-	int found_largest_digit = 0;
-	int remaining = 10; /* 10 digits max */
-	int digits = 1;
-
-	/* make sure we don't skip if value is zero */
-	if (min_width <= 0) {
-		min_width = 1;
-	}
-
-	while (pos >= 9) {
-		if (found_largest_digit || remainder > pos) {
-			found_largest_digit = 1;
-			out((int)((remainder / (pos + 1)) + 48), ctx);
-			digits++;
-		} else if (remaining <= min_width
-				&& padding < PAD_SPACE_AFTER) {
-			out((int)(padding == PAD_ZERO_BEFORE ? '0' : ' '), ctx);
-			digits++;
-		}
-		remaining--;
-		remainder %= (pos + 1);
-		pos /= 10;
+	char buf[NUM_BUF_SIZE];
+	char *end = buf + sizeof(buf);
+	char *ptr = _printk_dec_fmt(end, num);
+	int digits = end - ptr;
+
+	if (padding == PAD_ZERO_BEFORE) {
+		_printk_pad(out, ctx, '0', min_width - digits);
+	} else if (padding == PAD_SPACE_BEFORE) {
+		_printk_pad(out, ctx, ' ', min_width - digits);
 	}
-	out((int)(remainder + 48), ctx);
+
+	_printk_out(out, ctx, ptr, digits);
 
 	if (padding == PAD_SPACE_AFTER) {
-		remaining = min_width - digits;
-		while (remaining-- > 0) {
-			out(' ', ctx);
-		}
+		_printk_pad(out, ctx, ' ', min_width - digits);
 	}
 }
 
-struct str_context {
-	char *str;
-	int max;
-	int count;
-};
+static char *_printk_hex_word(char *ptr, u16_t word)
+{
+	int shift = 12;
+
+	/* Leading zeros are skipped */
+	while (shift > 0 && !(word >> shift)) {
+		shift -= 4;
+	}
+
+	for (; shift >= 0; shift -= 4) {
+		*ptr++ = hex_digits[(word >> shift) & 0xf];
+	}
+
+	return ptr;
+}
+
+/**
+ * @brief Output a network address
+ *
+ * IPv4 addresses are output in dotted decimal form. IPv6 addresses are
+ * output as in RFC 5952, with the longest run of two or more zero words
+ * replaced by "::". MAC addresses are output as six colon separated bytes.
+ * @param type '4' for IPv4, '6' for IPv6, 'M' for MAC
+ * @param addr Address bytes, in network byte order
+ *
+ * @return N/A
+ */
+static void _printk_addr(out_func_t out, void *ctx, char type,
+			 const u8_t *addr, enum pad_type padding,
+			 int min_width)
+{
+	char buf[sizeof("xxxx:xxxx:xxxx:xxxx:xxxx:xxxx:xxxx:xxxx")];
+	char num[NUM_BUF_SIZE];
+	char *ptr = buf;
+	char *start;
+	int i;
+
+	if (type == '4') {
+		for (i = 0; i < 4; i++) {
+			start = _printk_dec_fmt(num + sizeof(num), addr[i]);
+			memcpy(ptr, start, num + sizeof(num) - start);
+			ptr += num + sizeof(num) - start;
+			*ptr++ = '.';
+		}
+		ptr--;
+	} else if (type == '6') {
+		int zero_pos = -1, zero_len = 1;
+		int run;
+		u16_t w[8];
+
+		for (i = 0; i < 8; i++) {
+			w[i] = (addr[2 * i] << 8) | addr[2 * i + 1];
+		}
+
+		for (i = 0; i < 8; i += run ? run : 1) {
+			for (run = 0; i + run < 8 && !w[i + run]; run++) {
+			}
+
+			if (run > zero_len) {
+				zero_pos = i;
+				zero_len = run;
+			}
+		}
+
+		for (i = 0; i < 8; i++) {
+			if (i == zero_pos) {
+				*ptr++ = ':';
+				if (i == 0) {
+					*ptr++ = ':';
+				}
+				i += zero_len - 1;
+				continue;
+			}
+
+			ptr = _printk_hex_word(ptr, w[i]);
+			if (i < 7) {
+				*ptr++ = ':';
+			}
+		}
+	} else {
+		for (i = 0; i < 6; i++) {
+			*ptr++ = hex_digits[addr[i] >> 4];
+			*ptr++ = hex_digits[addr[i] & 0xf];
+			*ptr++ = ':';
+		}
+		ptr--;
+	}
+
+	/* Pad with spaces, before the address unless '-' was given */
+	if (padding != PAD_SPACE_AFTER) {
+		_printk_pad(out, ctx, ' ', min_width - (ptr - buf));
+	}
+
+	_printk_out(out, ctx, buf, ptr - buf);
+
+	if (padding == PAD_SPACE_AFTER) {
+		_printk_pad(out, ctx, ' ', min_width - (ptr - buf));
+	}
+}
 
 static int str_out(int c, struct str_context *ctx)
 {
@@ -10,8 +10,14 @@
 #include <errno.h>
 #include <zephyr/types.h>
 #include <stats.h>
+#ifdef CONFIG_SMP
+#include <kernel_structs.h>
+#endif
+
+#define STATS_GEN_NAME_MAX_LEN  (sizeof("s65535"))
 
-#define STATS_GEN_NAME_MAX_LEN  (sizeof("s255"))
+/* Longest name of a histogram bucket, "<entry>.<bucket>" */
+#define STATS_HIST_NAME_MAX_LEN 32
 
 /* The global list of registered statistic groups. */
 static struct stats_hdr *stats_list;
@@ -47,6 +53,20 @@ stats_get_off(const struct stats_hdr *hdr, int idx)
 	return sizeof(*hdr) + idx * hdr->s_size;
 }
 
+/* Number of values of each entry */
+static int
+stats_get_stride(const struct stats_hdr *hdr)
+{
+	switch (hdr->s_type) {
+	case STATS_TYPE_PCPU:
+		return STATS_NUM_CPUS;
+	case STATS_TYPE_HIST:
+		return hdr->s_buckets;
+	default:
+		return 1;
+	}
+}
+
 /**
  * Creates a generic name for an unnamed stat.  The name has the form:
  *     s<idx>
@@ -78,6 +98,29 @@ stats_gen_name(int idx, char *dst)
 	dst[len] = '\0';
 }
 
+/**
+ * Names a histogram bucket "<name>.<bucket>", truncating the name if
+ * needed.
+ */
+static void
+stats_hist_name(const char *name, int bucket, char *dst)
+{
+	int len;
+
+	len = strlen(name);
+	if (len > STATS_HIST_NAME_MAX_LEN - sizeof(".99")) {
+		len = STATS_HIST_NAME_MAX_LEN - sizeof(".99");
+	}
+
+	memcpy(dst, name, len);
+	dst[len++] = '.';
+	if (bucket >= 10) {
+		dst[len++] = '0' + bucket / 10;
+	}
+	dst[len++] = '0' + bucket % 10;
+	dst[len] = '\0';
+}
+
 /**
  * Walk a specific statistic entry, and call walk_func with arg for
  * each field within that entry.
@@ -98,26 +141,79 @@ stats_walk(struct stats_hdr *hdr, stats_walk_fn *walk_func, void *arg)
 {
 	const char *name;
 	char name_buf[STATS_GEN_NAME_MAX_LEN];
+	char hist_buf[STATS_HIST_NAME_MAX_LEN];
+	int stride;
 	int rc;
 	int i;
+	int j;
+
+	stride = stats_get_stride(hdr);
 
-	for (i = 0; i < hdr->s_cnt; i++) {
+	for (i = 0; i < hdr->s_cnt; i += stride) {
 		name = stats_get_name(hdr, i);
 		if (name == NULL) {
 			/* No assigned name; generate a temporary s<#> name. */
-			stats_gen_name(i, name_buf);
+			stats_gen_name(i / stride, name_buf);
 			name = name_buf;
 		}
 
-		rc = walk_func(hdr, arg, name, stats_get_off(hdr, i));
-		if (rc != 0) {
-			return rc;
+		if (hdr->s_type != STATS_TYPE_HIST) {
+			rc = walk_func(hdr, arg, name, stats_get_off(hdr, i));
+			if (rc != 0) {
+				return rc;
+			}
+			continue;
+		}
+
+		for (j = 0; j < stride; j++) {
+			stats_hist_name(name, j, hist_buf);
+			rc = walk_func(hdr, arg, hist_buf,
+				       stats_get_off(hdr, i + j));
+			if (rc != 0) {
+				return rc;
+			}
 		}
 	}
 
 	return 0;
 }
 
+u64_t
+stats_value_get(const struct stats_hdr *hdr, u16_t off)
+{
+	const u8_t *val = (const u8_t *)hdr + off;
+	u64_t sum;
+	int i;
+
+	switch (hdr->s_size) {
+	case sizeof(u16_t):
+		return *(const u16_t *)val;
+	case sizeof(u64_t):
+		return *(const u64_t *)val;
+	default:
+		break;
+	}
+
+	if (hdr->s_type != STATS_TYPE_PCPU) {
+		return *(const u32_t *)val;
+	}
+
+	sum = 0;
+	for (i = 0; i < STATS_NUM_CPUS; i++) {
+		sum += ((const u32_t *)val)[i];
+	}
+
+	return sum;
+}
+
+#ifdef CONFIG_SMP
+void
+stats_pcpu_incn(u32_t *slots, u32_t n)
+{
+	atomic_add((atomic_t *)&slots[_current_cpu->id], n);
+}
+#endif
+
 /**
  * Initialize a statistics structure, pointed to by hdr.
  *
@@ -131,11 +227,13 @@ stats_walk(struct stats_hdr *hdr, stats_walk_fn *walk_func, void *arg)
  * @param map_cnt The number of items in the statistics map
  */
 void
-stats_init(struct stats_hdr *hdr, u8_t size, u8_t cnt,
+stats_init(struct stats_hdr *hdr, u8_t size, u16_t cnt,
 	   const struct stats_name_map *map, u8_t map_cnt)
 {
 	hdr->s_size = size;
 	hdr->s_cnt = cnt;
+	hdr->s_type = STATS_TYPE_COUNTER;
+	hdr->s_buckets = 0;
 #ifdef CONFIG_STATS_NAMES
 	hdr->s_map = map;
 	hdr->s_map_cnt = map_cnt;
@@ -257,7 +355,7 @@ stats_register(const char *name, struct stats_hdr *hdr)
  * @return 0 on success, non-zero error code on failure.
  */
 int
-stats_init_and_reg(struct stats_hdr *shdr, u8_t size, u8_t cnt,
+stats_init_and_reg(struct stats_hdr *shdr, u8_t size, u16_t cnt,
 		   const struct stats_name_map *map, u8_t map_cnt,
 		   const char *name)
 {
@@ -273,6 +371,39 @@ stats_init_and_reg(struct stats_hdr *shdr, u8_t size, u8_t cnt,
 	return 0;
 }
 
+/**
+ * Initializes and registers a statistics section of per-CPU counters or
+ * histograms, made of 32-bit values.
+ *
+ * @param shdr The statistics header to register
+ * @param type STATS_TYPE_PCPU or STATS_TYPE_HIST.
+ * @param stride The number of values of each entry.
+ * @param cnt  The number of values in the statistics structure.
+ * @param map  The map of statistics entry to statistics name, only used when
+ *             STATS_NAMES is enabled.
+ * @param map_cnt The number of elements in the statistics name map.
+ * @param name The name of the statistics element to register with the system.
+ *
+ * @return 0 on success, non-zero error code on failure.
+ */
+int
+stats_init_and_reg_type(struct stats_hdr *shdr, enum stats_type type,
+			u8_t stride, u16_t cnt,
+			const struct stats_name_map *map, u8_t map_cnt,
+			const char *name)
+{
+	if (stride == 0 || cnt % stride != 0) {
+		return -EINVAL;
+	}
+
+	stats_init(shdr, sizeof(u32_t), cnt, map, map_cnt);
+
+	shdr->s_type = type;
+	shdr->s_buckets = type == STATS_TYPE_HIST ? stride : 0;
+
+	return stats_register(name, shdr);
+}
+
 /**
  * Resets and zeroes the specified statistics section.
  *
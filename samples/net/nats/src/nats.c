@@ -126,12 +126,8 @@ static inline int transmit(struct net_context *conn, const char buffer[],
 	});
 }
 
-#define FIELD(struct_, member_, type_) { \
-	.field_name = #member_, \
-	.field_name_len = sizeof(#member_) - 1, \
-	.offset = offsetof(struct_, member_), \
-	.type = type_ \
-}
+#define FIELD(struct_, member_, type_) \
+	JSON_OBJ_DESCR_PRIM(struct_, member_, type_)
 static int handle_server_info(struct nats *nats, char *payload, size_t len,
 			      struct net_buf *buf, u16_t offset)
 {
@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2018 Intel Corporation.
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Compare two benchmark result files and flag regressions.
+
+The benchmarks in tests/benchmarks that use tests/include/bench_report.h
+print a JSON document between "--- BENCH_JSON_BEGIN ---" and
+"--- BENCH_JSON_END ---" lines. Each input file may either be such a
+console log or the bare JSON document.
+
+Results are matched by suite, name and params. A result regresses when
+the selected metric (cycles per operation, lower is better) grew by more
+than the threshold percentage. The script exits with status 1 if any
+regression was found, so it can gate CI jobs.
+
+Example:
+
+    scripts/bench_compare.py --threshold 5 --metric p90 base.log new.log
+"""
+
+import argparse
+import json
+import sys
+
+BEGIN_MARKER = "--- BENCH_JSON_BEGIN ---"
+END_MARKER = "--- BENCH_JSON_END ---"
+METRICS = ["mean", "min", "p50", "p90", "p99", "max"]
+
+
+def load_results(path):
+    with open(path, errors="replace") as f:
+        text = f.read()
+
+    documents = []
+    start = text.find(BEGIN_MARKER)
+    if start < 0:
+        documents.append(json.loads(text))
+    while start >= 0:
+        end = text.find(END_MARKER, start)
+        if end < 0:
+            sys.exit("%s: missing '%s'" % (path, END_MARKER))
+        documents.append(json.loads(text[start + len(BEGIN_MARKER):end]))
+        start = text.find(BEGIN_MARKER, end)
+
+    results = {}
+    for doc in documents:
+        for r in doc["results"]:
+            params = ", ".join("%s=%s" % (k, v)
+                               for k, v in sorted(r["params"].items()))
+            key = (doc["suite"], r["name"], params)
+            r["cycles_per_sec"] = doc.get("cycles_per_sec", 0)
+            results[key] = r
+
+    return results
+
+
+def to_value(result, metric, unit):
+    cycles = result[metric]
+    if unit == "ns":
+        if not result["cycles_per_sec"]:
+            sys.exit("no cycles_per_sec in results, cannot convert to ns")
+        return cycles * 1e9 / result["cycles_per_sec"]
+    return cycles
+
+
+def throughput(result, unit_value, unit):
+    if not result.get("bytes") or not unit_value:
+        return ""
+    if unit == "ns":
+        seconds = unit_value / 1e9
+    elif result["cycles_per_sec"]:
+        seconds = unit_value / result["cycles_per_sec"]
+    else:
+        return ""
+    return "%.2f MB/s" % (result["bytes"] / seconds / 1e6)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("base", help="baseline results")
+    parser.add_argument("new", help="results to check")
+    parser.add_argument("-t", "--threshold", type=float, default=5.0,
+                        help="regression threshold in percent (default 5)")
+    parser.add_argument("-m", "--metric", choices=METRICS, default="mean",
+                        help="metric to compare (default mean)")
+    parser.add_argument("-u", "--unit", choices=["cycles", "ns"],
+                        default="cycles",
+                        help="compare raw cycles or nanoseconds; use ns "
+                        "when the two runs have different clocks")
+    parser.add_argument("-a", "--all", action="store_true",
+                        help="print all results, not only changed ones")
+    return parser.parse_args()
+
+
+def main():
+    args = parse_args()
+    base = load_results(args.base)
+    new = load_results(args.new)
+
+    regressions = 0
+    improvements = 0
+    rows = []
+
+    for key in sorted(set(base) | set(new)):
+        name = "%s/%s(%s)" % key
+        if key not in base:
+            rows.append((name, "-", "new", "", ""))
+            continue
+        if key not in new:
+            rows.append((name, "missing", "-", "", ""))
+            continue
+
+        old_v = to_value(base[key], args.metric, args.unit)
+        new_v = to_value(new[key], args.metric, args.unit)
+        delta = ((new_v - old_v) * 100.0 / old_v) if old_v else 0.0
+
+        status = ""
+        if delta > args.threshold:
+            status = "REGRESSION"
+            regressions += 1
+        elif delta < -args.threshold:
+            status = "improved"
+            improvements += 1
+        elif not args.all:
+            continue
+
+        rows.append((name, "%.0f" % old_v, "%.0f" % new_v,
+                     "%+.1f%%" % delta,
+                     " ".join(filter(None, [
+                         status, throughput(new[key], new_v, args.unit)]))))
+
+    if rows:
+        width = max(len(r[0]) for r in rows)
+        print("%-*s %12s %12s %8s" % (width, "benchmark",
+                                      "base " + args.metric,
+                                      "new " + args.metric, "delta"))
+        for r in rows:
+            print(("%-*s %12s %12s %8s  %s" % (width, *r)).rstrip())
+
+    print("\n%d regressions, %d improvements over %.1f%% (%s, %s)" %
+          (regressions, improvements, args.threshold, args.metric,
+           args.unit))
+
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,340 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2018 Intel Corporation.
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Decode binary dictionary log output back into text.
+
+With CONFIG_LOG_BACKEND_UART_DICTIONARY=y the logger does not format
+messages on the target. Each message is sent as a packet holding the
+source ID, the address of the format string and the raw arguments, see
+log_output_msg_dict_process() in include/logging/log_output.h. This
+script looks the format strings and the source names up in the ELF file
+of the application and prints the messages the way the text output
+would.
+
+The input is a file holding the captured UART stream, or standard input:
+
+    scripts/log_dict_decode.py build/zephyr/zephyr.elf uart.bin
+    cat /dev/ttyACM0 | scripts/log_dict_decode.py zephyr.elf -
+
+Bytes which are not part of a valid packet are skipped.
+
+Logs stored by the flash backend are printed by the "log_flash dump" shell
+command as base64 lines, which are decoded with --base64:
+
+    scripts/log_dict_decode.py --base64 zephyr.elf console.txt
+"""
+
+import argparse
+import base64
+import binascii
+import re
+import struct
+import sys
+
+from elftools.elf.elffile import ELFFile
+from elftools.elf.sections import SymbolTableSection
+
+SYNC = 0xA5
+TYPE_STD = 0
+TYPE_HEXDUMP = 1
+TYPE_RAW_STRING = 2
+
+MAX_NARGS = 9
+HEXDUMP_BYTES_IN_LINE = 8
+
+SEVERITY = [None, "err", "wrn", "inf", "dbg"]
+
+FORMAT_RE = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?"
+                       r"(hh|h|ll|l|z|j|t)?([diouxXcsp%])")
+
+
+class Dictionary:
+    def __init__(self, path):
+        self.segments = []
+        self.symbols = {}
+
+        with open(path, "rb") as f:
+            elf = ELFFile(f)
+            self.little_endian = elf.little_endian
+            self.ptr_size = elf.elfclass // 8
+
+            for section in elf.iter_sections():
+                if isinstance(section, SymbolTableSection):
+                    for sym in section.iter_symbols():
+                        self.symbols[sym.name] = sym["st_value"]
+                elif (section["sh_flags"] & 0x2 and
+                      section["sh_type"] == "SHT_PROGBITS"):
+                    self.segments.append((section["sh_addr"],
+                                          section.data()))
+
+        self.sources = self.load_sources()
+
+    def read(self, addr, length):
+        for start, data in self.segments:
+            if start <= addr and addr + length <= start + len(data):
+                return data[addr - start:addr - start + length]
+        return None
+
+    def string(self, addr):
+        for start, data in self.segments:
+            if start <= addr < start + len(data):
+                end = data.find(b"\0", addr - start)
+                if end < 0:
+                    return None
+                return data[addr - start:end].decode(errors="replace")
+        return None
+
+    def load_sources(self):
+        start = self.symbols.get("__log_const_start")
+        end = self.symbols.get("__log_const_end")
+        if start is None or end is None:
+            return []
+
+        # struct log_source_const_data: name pointer and level, padded
+        entry = 2 * self.ptr_size
+        fmt = ("<" if self.little_endian else ">") + \
+            ("I" if self.ptr_size == 4 else "Q")
+        sources = []
+        for addr in range(start, end, entry):
+            raw = self.read(addr, self.ptr_size)
+            name = None
+            if raw is not None:
+                name = self.string(struct.unpack(fmt, raw)[0])
+            sources.append(name)
+
+        return sources
+
+    def source_name(self, source_id):
+        if source_id < len(self.sources) and self.sources[source_id]:
+            return self.sources[source_id]
+        return "<source %d>" % source_id
+
+
+def to_signed(value, bits=32):
+    if value & (1 << (bits - 1)):
+        return value - (1 << bits)
+    return value
+
+
+def format_message(dictionary, fmt, args):
+    args = list(args)
+
+    def next_arg():
+        return args.pop(0) if args else 0
+
+    def convert(m):
+        flags, width, precision, length, conv = m.groups()
+
+        if conv == "%":
+            return "%"
+        if width == "*":
+            width = str(to_signed(next_arg()))
+        if precision == "*":
+            precision = str(to_signed(next_arg()))
+
+        spec = "%" + flags + (width or "")
+        if precision is not None:
+            spec += "." + precision
+
+        value = next_arg()
+        if length == "h":
+            value &= 0xffff
+        elif length == "hh":
+            value &= 0xff
+
+        if conv in "di":
+            bits = {"h": 16, "hh": 8}.get(length, 32)
+            return (spec + "d") % to_signed(value, bits)
+        if conv in "ouxX":
+            return (spec + conv) % value
+        if conv == "c":
+            return (spec + "c") % chr(value & 0xff)
+        if conv == "p":
+            return (spec + "s") % ("0x%08x" % value)
+
+        string = dictionary.string(value)
+        if string is None:
+            string = "<string at 0x%08x>" % value
+        return (spec + "s") % string
+
+    return FORMAT_RE.sub(convert, fmt)
+
+
+def format_timestamp(timestamp, freq):
+    if not freq:
+        return "[%08u] " % timestamp
+
+    seconds, reminder = divmod(timestamp, freq)
+    hours, seconds = divmod(seconds, 3600)
+    mins, seconds = divmod(seconds, 60)
+    us = reminder * 1000000 // freq
+
+    return "[%02d:%02d:%02d.%03d,%03d] " % (hours, mins, seconds,
+                                            us // 1000, us % 1000)
+
+
+def hexdump(data, prefix_len):
+    lines = []
+    for i in range(0, max(len(data), 1), HEXDUMP_BYTES_IN_LINE):
+        line = data[i:i + HEXDUMP_BYTES_IN_LINE]
+        text = "".join(" %02x" % b for b in line)
+        text += "   " * (HEXDUMP_BYTES_IN_LINE - len(line)) + "|"
+        text += "".join(chr(b) if 32 <= b < 127 else "." for b in line)
+        lines.append(text)
+
+    return ("\n" + " " * prefix_len).join(lines)
+
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def byte(self):
+        if self.pos >= len(self.data):
+            raise IndexError
+        b = self.data[self.pos]
+        self.pos += 1
+        return b
+
+    def uint(self):
+        value = 0
+        for shift in range(0, 35, 7):
+            b = self.byte()
+            value |= (b & 0x7f) << shift
+            if not b & 0x80:
+                return value
+        raise ValueError("malformed number")
+
+    def bytes(self, length):
+        if self.pos + length > len(self.data):
+            raise IndexError
+        b = self.data[self.pos:self.pos + length]
+        self.pos += length
+        return b
+
+
+def decode_packet(dictionary, reader, args):
+    hdr = reader.byte()
+    ptype = hdr & 0x3
+    level = (hdr >> 2) & 0x7
+    source_id = reader.uint()
+    timestamp = reader.uint()
+
+    if ptype == TYPE_STD:
+        fmt_addr = reader.uint()
+        nargs = reader.byte()
+        if nargs > MAX_NARGS:
+            raise ValueError("too many arguments")
+        msg_args = [reader.uint() for i in range(nargs)]
+        fmt = dictionary.string(fmt_addr)
+        if fmt is None:
+            raise ValueError("unknown format string 0x%08x" % fmt_addr)
+    elif ptype in (TYPE_HEXDUMP, TYPE_RAW_STRING):
+        data = reader.bytes(reader.uint())
+    else:
+        raise ValueError("unknown packet type %d" % ptype)
+
+    if ptype == TYPE_RAW_STRING:
+        return data.decode(errors="replace").replace("\r", "")
+
+    if level >= len(SEVERITY) or not SEVERITY[level]:
+        raise ValueError("invalid level %d" % level)
+
+    prefix = format_timestamp(timestamp, args.timestamp_freq)
+    prefix += "<%s> %s: " % (SEVERITY[level],
+                             dictionary.source_name(source_id))
+
+    if ptype == TYPE_STD:
+        body = format_message(dictionary, fmt, msg_args)
+    else:
+        body = hexdump(data, len(prefix))
+
+    return prefix + body + "\n"
+
+
+def decode(dictionary, data, args, out):
+    """Decode all complete packets, return the number of bytes consumed"""
+    pos = 0
+
+    while True:
+        pos = data.find(bytes([SYNC]), pos)
+        if pos < 0:
+            return len(data)
+
+        reader = Reader(data)
+        reader.pos = pos + 1
+        try:
+            text = decode_packet(dictionary, reader, args)
+        except IndexError:
+            return pos
+        except ValueError as e:
+            if args.verbose:
+                sys.stderr.write("skipping byte at %d: %s\n" % (pos, e))
+            pos += 1
+            continue
+
+        out.write(text)
+        pos = reader.pos
+
+
+def base64_lines(stream):
+    """Decode the base64 lines of a shell dump, skip any other line"""
+    data = b""
+    for line in stream:
+        line = line.strip()
+        if not line:
+            continue
+        try:
+            data += base64.b64decode(line, validate=True)
+        except (binascii.Error, ValueError):
+            continue
+    return data
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("elf", help="ELF file of the application")
+    parser.add_argument("input", help="captured log stream, '-' for stdin")
+    parser.add_argument("--timestamp-freq", type=int, default=0,
+                        help="timestamp frequency in Hz, formats "
+                        "timestamps as hh:mm:ss.ms,us")
+    parser.add_argument("-v", "--verbose", action="store_true",
+                        help="report skipped bytes")
+    parser.add_argument("--base64", action="store_true",
+                        help="input is a 'log_flash dump' shell output")
+    args = parser.parse_args()
+
+    dictionary = Dictionary(args.elf)
+
+    if args.input == "-":
+        stream = sys.stdin.buffer
+    else:
+        stream = open(args.input, "rb")
+
+    if args.base64:
+        with stream:
+            decode(dictionary, base64_lines(stream), args, sys.stdout)
+        return
+
+    pending = b""
+    with stream:
+        while True:
+            chunk = stream.read1(4096) if hasattr(stream, "read1") \
+                else stream.read(4096)
+            if not chunk:
+                break
+            pending += chunk
+            pending = pending[decode(dictionary, pending, args,
+                                     sys.stdout):]
+            sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
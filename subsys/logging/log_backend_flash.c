@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <logging/log_backend_flash.h>
+#include <logging/log_core.h>
+#include <logging/log_msg.h>
+#include <logging/log_output.h>
+#include <kernel.h>
+#include <flash_map.h>
+#include <fcb.h>
+#include <errno.h>
+#include <string.h>
+
+#define LOG_FLASH_MAGIC 0x21474f4c /* "LOG!" */
+#define LOG_FLASH_VERSION 1
+
+static struct flash_sector sectors[CONFIG_LOG_BACKEND_FLASH_SECTORS];
+
+static struct fcb fcb = {
+	.f_magic = LOG_FLASH_MAGIC,
+	.f_version = LOG_FLASH_VERSION,
+	.f_sectors = sectors,
+};
+
+static bool initialized;
+
+/* Set once the system panicked, each message is then written to flash
+ * right away as nothing may run afterwards to complete the batch.
+ */
+static bool panic_mode;
+
+/* Output of consecutive messages is collected here and written to flash
+ * as a single FCB entry once full, so the flash is not written for every
+ * message.
+ */
+static u8_t batch[CONFIG_LOG_BACKEND_FLASH_BATCH_SIZE];
+static size_t batch_len;
+
+/* Serializes the logging thread writing the batch and the FCB with the
+ * threads reading or clearing them, e.g. the shell.
+ */
+static K_MUTEX_DEFINE(flash_lock);
+
+static int batch_write(void)
+{
+	struct fcb_entry loc;
+	int rc;
+
+	if (batch_len == 0) {
+		return 0;
+	}
+
+	rc = fcb_append(&fcb, batch_len, &loc);
+	if (rc == FCB_ERR_NOSPACE) {
+		/* Make space by erasing the oldest sector. */
+		rc = fcb_rotate(&fcb);
+		if (rc == 0) {
+			rc = fcb_append(&fcb, batch_len, &loc);
+		}
+	}
+
+	if (rc == 0) {
+		rc = flash_area_write(fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc),
+				      batch, batch_len);
+	}
+
+	if (rc == 0) {
+		rc = fcb_append_finish(&fcb, &loc);
+	}
+
+	/* On error the batch is dropped, the next one may succeed. */
+	batch_len = 0;
+
+	return rc;
+}
+
+static int flash_out(u8_t *data, size_t length, void *ctx)
+{
+	size_t left = length;
+	size_t len;
+
+	while (left > 0) {
+		len = min(left, sizeof(batch) - batch_len);
+		memcpy(&batch[batch_len], data, len);
+		batch_len += len;
+		data += len;
+		left -= len;
+
+		if (batch_len == sizeof(batch)) {
+			(void)batch_write();
+		}
+	}
+
+	return length;
+}
+
+static u8_t buf[16];
+
+static struct log_output_ctx ctx = {
+	.func = flash_out,
+	.data = buf,
+	.length = sizeof(buf),
+	.offset = 0
+};
+
+static void put(const struct log_backend *const backend,
+		struct log_msg *msg)
+{
+	log_msg_get(msg);
+
+	if (!initialized) {
+		log_msg_put(msg);
+		return;
+	}
+
+	/* In panic mode or from an interrupt the mutex cannot be waited
+	 * for.
+	 */
+	if (panic_mode || k_is_in_isr()) {
+		log_output_msg_dict_process(msg, &ctx);
+	} else {
+		k_mutex_lock(&flash_lock, K_FOREVER);
+		log_output_msg_dict_process(msg, &ctx);
+		k_mutex_unlock(&flash_lock);
+	}
+
+	if (panic_mode) {
+		(void)batch_write();
+	}
+
+	log_msg_put(msg);
+}
+
+static void panic(struct log_backend const *const backend)
+{
+	/* Not locked, the panic may come from any context. Messages still
+	 * pending in the logger are put afterwards and written one by one.
+	 */
+	panic_mode = true;
+
+	if (initialized) {
+		(void)batch_write();
+	}
+}
+
+int log_backend_flash_init(void)
+{
+	const struct flash_area *fap;
+	u32_t cnt = ARRAY_SIZE(sectors);
+	int rc;
+
+	rc = flash_area_get_sectors(CONFIG_LOG_BACKEND_FLASH_AREA, &cnt,
+				    sectors);
+	if (rc != 0 && rc != -ENOMEM) {
+		return rc;
+	}
+
+	fcb.f_sector_cnt = cnt;
+
+	rc = fcb_init(CONFIG_LOG_BACKEND_FLASH_AREA, &fcb);
+	if (rc != 0) {
+		/* Area holds something else, start from scratch. */
+		rc = flash_area_open(CONFIG_LOG_BACKEND_FLASH_AREA, &fap);
+		if (rc == 0) {
+			rc = flash_area_erase(fap, 0, fap->fa_size);
+			flash_area_close(fap);
+		}
+
+		if (rc == 0) {
+			rc = fcb_init(CONFIG_LOG_BACKEND_FLASH_AREA, &fcb);
+		}
+	}
+
+	if (rc != 0) {
+		return -EIO;
+	}
+
+	batch_len = 0;
+	initialized = true;
+
+	return 0;
+}
+
+struct read_arg {
+	log_backend_flash_read_cb cb;
+	void *ctx;
+};
+
+static int read_cb(struct fcb_entry_ctx *entry_ctx, void *arg)
+{
+	struct read_arg *read_arg = arg;
+	u8_t data[64];
+	u16_t off = 0;
+	u16_t len;
+	int rc;
+
+	while (off < entry_ctx->loc.fe_data_len) {
+		len = min(sizeof(data), entry_ctx->loc.fe_data_len - off);
+
+		rc = flash_area_read(entry_ctx->fap,
+				     FCB_ENTRY_FA_DATA_OFF(entry_ctx->loc) + off,
+				     data, len);
+		if (rc != 0) {
+			return -EIO;
+		}
+
+		rc = read_arg->cb(data, len, read_arg->ctx);
+		if (rc != 0) {
+			return rc;
+		}
+
+		off += len;
+	}
+
+	return 0;
+}
+
+int log_backend_flash_read(log_backend_flash_read_cb cb, void *ctx)
+{
+	struct read_arg arg = {
+		.cb = cb,
+		.ctx = ctx,
+	};
+	int rc;
+
+	if (!initialized) {
+		return -ENODEV;
+	}
+
+	k_mutex_lock(&flash_lock, K_FOREVER);
+
+	rc = fcb_walk(&fcb, NULL, read_cb, &arg);
+	if (rc == 0 && batch_len > 0) {
+		rc = cb(batch, batch_len, ctx);
+	}
+
+	k_mutex_unlock(&flash_lock);
+
+	return rc;
+}
+
+int log_backend_flash_clear(void)
+{
+	int rc;
+
+	if (!initialized) {
+		return -ENODEV;
+	}
+
+	k_mutex_lock(&flash_lock, K_FOREVER);
+
+	batch_len = 0;
+	rc = fcb_clear(&fcb);
+
+	k_mutex_unlock(&flash_lock);
+
+	return (rc == 0) ? 0 : -EIO;
+}
+
+const struct log_backend_api log_backend_flash_api = {
+	.put = put,
+	.panic = panic,
+};
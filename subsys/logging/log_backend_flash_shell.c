@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <logging/log_backend_flash.h>
+#include <misc/printk.h>
+#include <shell/shell.h>
+#include <base64.h>
+#include <string.h>
+
+#define LOG_FLASH_SHELL_MODULE "log_flash"
+
+/* Stored bytes per line, 64 characters once encoded */
+#define DUMP_LINE_BYTES 48
+
+struct dump_ctx {
+	u8_t line[DUMP_LINE_BYTES];
+	size_t len;
+};
+
+static void dump_line(struct dump_ctx *dump)
+{
+	u8_t out[DUMP_LINE_BYTES / 3 * 4 + 1];
+	size_t olen;
+
+	if (dump->len == 0) {
+		return;
+	}
+
+	base64_encode(out, sizeof(out), &olen, dump->line, dump->len);
+	printk("%s\n", out);
+
+	dump->len = 0;
+}
+
+static int dump_cb(const u8_t *data, size_t length, void *ctx)
+{
+	struct dump_ctx *dump = ctx;
+	size_t len;
+
+	while (length > 0) {
+		len = min(length, DUMP_LINE_BYTES - dump->len);
+		memcpy(&dump->line[dump->len], data, len);
+		dump->len += len;
+		data += len;
+		length -= len;
+
+		if (dump->len == DUMP_LINE_BYTES) {
+			dump_line(dump);
+		}
+	}
+
+	return 0;
+}
+
+static int shell_cmd_dump(int argc, char *argv[])
+{
+	struct dump_ctx dump = {
+		.len = 0,
+	};
+	int rc;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	printk("--- LOG FLASH BEGIN ---\n");
+	rc = log_backend_flash_read(dump_cb, &dump);
+	dump_line(&dump);
+	printk("--- LOG FLASH END ---\n");
+
+	if (rc != 0) {
+		printk("Reading logs failed (err %d)\n", rc);
+	}
+
+	return rc;
+}
+
+static int shell_cmd_clear(int argc, char *argv[])
+{
+	int rc;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	rc = log_backend_flash_clear();
+	if (rc != 0) {
+		printk("Erasing logs failed (err %d)\n", rc);
+	}
+
+	return rc;
+}
+
+static struct shell_cmd log_flash_commands[] = {
+	{ "dump", shell_cmd_dump,
+	  "Print stored logs, base64 encoded" },
+	{ "clear", shell_cmd_clear,
+	  "Erase stored logs" },
+	{ NULL, NULL, NULL }
+};
+
+SHELL_REGISTER(LOG_FLASH_SHELL_MODULE, log_flash_commands);
@@ -9,11 +9,128 @@
 #include <logging/log_output.h>
 #include <device.h>
 #include <uart.h>
+#include <string.h>
+
+#ifdef CONFIG_LOG_BACKEND_UART_ASYNC
+
+#define TX_BUF_SIZE CONFIG_LOG_BACKEND_UART_BUFFER_SIZE
+#define TX_BUF_MASK (TX_BUF_SIZE - 1)
+
+#if (TX_BUF_SIZE & TX_BUF_MASK) != 0
+#error CONFIG_LOG_BACKEND_UART_BUFFER_SIZE must be power of 2
+#endif
+
+/* Time to wait for the interrupt to make space before sending by polling */
+#define TX_TIMEOUT K_MSEC(100)
+
+/* Formatted output is staged in chunks of this size before being copied
+ * to the transmit buffer.
+ */
+#define OUT_BUF_SIZE 32
+
+static u8_t tx_buf[TX_BUF_SIZE];
+
+/* Free running indexes. tx_put is written only by the backend, tx_get by
+ * the interrupt or with interrupts locked.
+ */
+static volatile u32_t tx_put;
+static volatile u32_t tx_get;
+
+static K_SEM_DEFINE(tx_sem, 0, 1);
+
+static bool panic_mode;
+
+static void uart_isr(struct device *dev)
+{
+	u32_t get;
+	u32_t len;
+
+	uart_irq_update(dev);
+
+	if (!uart_irq_tx_ready(dev)) {
+		return;
+	}
+
+	get = tx_get;
+	len = tx_put - get;
+	if (len == 0) {
+		/* Output buffer empty, don't bother us with tx interrupts */
+		uart_irq_tx_disable(dev);
+		return;
+	}
+
+	/* Contiguous part only, the rest goes on the next interrupt. */
+	len = min(len, TX_BUF_SIZE - (get & TX_BUF_MASK));
+	tx_get = get + uart_fifo_fill(dev, &tx_buf[get & TX_BUF_MASK], len);
+
+	k_sem_give(&tx_sem);
+}
+
+/* Send pending bytes by polling until at least @p space bytes are free. */
+static void tx_poll(struct device *dev, u32_t space)
+{
+	unsigned int key = irq_lock();
+
+	while (TX_BUF_SIZE - (tx_put - tx_get) < space) {
+		uart_poll_out(dev, tx_buf[tx_get & TX_BUF_MASK]);
+		tx_get++;
+	}
+
+	irq_unlock(key);
+}
+
+static void tx_buf_put(struct device *dev, const u8_t *data, size_t length)
+{
+	u32_t put = tx_put;
+	u32_t space;
+	u32_t len;
+
+	while (length > 0) {
+		space = TX_BUF_SIZE - (put - tx_get);
+
+		if (space == 0) {
+			uart_irq_tx_enable(dev);
+
+			/* The interrupt cannot preempt an interrupt or
+			 * a context with interrupts locked.
+			 */
+			if (k_is_in_isr() ||
+			    k_sem_take(&tx_sem, TX_TIMEOUT) != 0) {
+				tx_poll(dev, min(length, TX_BUF_SIZE));
+			}
+			continue;
+		}
+
+		len = min(length, space);
+		len = min(len, TX_BUF_SIZE - (put & TX_BUF_MASK));
+		memcpy(&tx_buf[put & TX_BUF_MASK], data, len);
+
+		put += len;
+		tx_put = put;
+		data += len;
+		length -= len;
+	}
+
+	uart_irq_tx_enable(dev);
+}
+
+#else
+
+#define OUT_BUF_SIZE 1
+
+#endif /* CONFIG_LOG_BACKEND_UART_ASYNC */
 
 int char_out(u8_t *data, size_t length, void *ctx)
 {
 	struct device *dev = (struct device *)ctx;
 
+#ifdef CONFIG_LOG_BACKEND_UART_ASYNC
+	if (!panic_mode) {
+		tx_buf_put(dev, data, length);
+		return length;
+	}
+#endif
+
 	for (size_t i = 0; i < length; i++) {
 		uart_poll_out(dev, data[i]);
 	}
@@ -21,12 +138,12 @@ int char_out(u8_t *data, size_t length, void *ctx)
 	return length;
 }
 
-static u8_t buf;
+static u8_t buf[OUT_BUF_SIZE];
 
 static struct log_output_ctx ctx = {
 	.func = char_out,
-	.data = &buf,
-	.length = 1,
+	.data = buf,
+	.length = sizeof(buf),
 	.offset = 0
 };
 
@@ -35,6 +152,12 @@ static void put(const struct log_backend *const backend,
 {
 	log_msg_get(msg);
 
+	if (IS_ENABLED(CONFIG_LOG_BACKEND_UART_DICTIONARY)) {
+		log_output_msg_dict_process(msg, &ctx);
+		log_msg_put(msg);
+		return;
+	}
+
 	u32_t flags = 0;
 
 	if (IS_ENABLED(CONFIG_LOG_BACKEND_UART_SHOW_COLOR)) {
@@ -54,11 +177,20 @@ static void put(const struct log_backend *const backend,
 void log_backend_uart_init(void)
 {
 	ctx.ctx = device_get_binding(CONFIG_UART_CONSOLE_ON_DEV_NAME);
+
+#ifdef CONFIG_LOG_BACKEND_UART_ASYNC
+	uart_irq_tx_disable(ctx.ctx);
+	uart_irq_callback_set(ctx.ctx, uart_isr);
+#endif
 }
 
 static void panic(struct log_backend const *const backend)
 {
-
+#ifdef CONFIG_LOG_BACKEND_UART_ASYNC
+	uart_irq_tx_disable(ctx.ctx);
+	tx_poll(ctx.ctx, TX_BUF_SIZE);
+	panic_mode = true;
+#endif
 }
 
 const struct log_backend_api log_backend_uart_api = {
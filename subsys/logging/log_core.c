@@ -22,12 +22,26 @@
 LOG_BACKEND_UART_DEFINE(log_backend_uart);
 #endif
 
+#ifdef CONFIG_LOG_BACKEND_FLASH
+#include <logging/log_backend_flash.h>
+LOG_BACKEND_FLASH_DEFINE(log_backend_flash);
+#endif
+
 static struct log_list_t list;
 static atomic_t initialized;
 static bool panic_mode;
 static atomic_t buffered_cnt;
 static k_tid_t proc_tid;
 
+#ifdef CONFIG_LOG_LOCKLESS
+/* Messages pushed by each CPU and not yet seen by the processing side */
+static atomic_t cpu_pending[CONFIG_MP_NUM_CPUS];
+/* Messages taken from the pending stack, in order, per CPU */
+static struct log_list_t cpu_list[CONFIG_MP_NUM_CPUS];
+static atomic_t proc_busy;
+static atomic_t dropped_pending;
+#endif
+
 static u32_t dummy_timestamp(void);
 static timestamp_get_t timestamp_func = dummy_timestamp;
 
@@ -36,21 +50,36 @@ static u32_t dummy_timestamp(void)
 	return 0;
 }
 
+static inline void msg_queue(struct log_msg *msg)
+{
+#ifdef CONFIG_LOG_LOCKLESS
+	log_list_lf_push(&cpu_pending[log_cpu_id()], msg);
+#else
+	unsigned int key = irq_lock();
+
+	log_list_add_tail(&list, msg);
+
+	irq_unlock(key);
+#endif
+}
+
+static inline void msg_drop(struct log_msg_ids src_level)
+{
+#ifdef CONFIG_LOG_LOCKLESS
+	atomic_inc(&__log_dynamic_start[src_level.source_id].dropped);
+	atomic_set(&dropped_pending, 1);
+#endif
+}
+
 static inline void msg_finalize(struct log_msg *msg,
 				struct log_msg_ids src_level)
 {
-	unsigned int key;
-
 	msg->hdr.ids = src_level;
 	msg->hdr.timestamp = timestamp_func();
 
 	atomic_inc(&buffered_cnt);
 
-	key = irq_lock();
-
-	log_list_add_tail(&list, msg);
-
-	irq_unlock(key);
+	msg_queue(msg);
 
 	if (IS_ENABLED(CONFIG_LOG_INPLACE_PROCESS) || panic_mode) {
 		(void)log_process(false);
@@ -68,6 +97,7 @@ void log_0(const char *str, struct log_msg_ids src_level)
 	struct log_msg *msg = log_msg_create_0(str);
 
 	if (msg == NULL) {
+		msg_drop(src_level);
 		return;
 	}
 	msg_finalize(msg, src_level);
@@ -80,6 +110,7 @@ void log_1(const char *str,
 	struct log_msg *msg = log_msg_create_1(str, arg0);
 
 	if (msg == NULL) {
+		msg_drop(src_level);
 		return;
 	}
 	msg_finalize(msg, src_level);
@@ -93,6 +124,7 @@ void log_2(const char *str,
 	struct log_msg *msg = log_msg_create_2(str, arg0, arg1);
 
 	if (msg == NULL) {
+		msg_drop(src_level);
 		return;
 	}
 
@@ -108,6 +140,7 @@ void log_3(const char *str,
 	struct log_msg *msg = log_msg_create_3(str, arg0, arg1, arg2);
 
 	if (msg == NULL) {
+		msg_drop(src_level);
 		return;
 	}
 
@@ -122,6 +155,7 @@ void log_n(const char *str,
 	struct log_msg *msg = log_msg_create_n(str, args, narg);
 
 	if (msg == NULL) {
+		msg_drop(src_level);
 		return;
 	}
 
@@ -135,6 +169,7 @@ void log_hexdump(const u8_t *data,
 	struct log_msg *msg = log_msg_hexdump_create(data, length);
 
 	if (msg == NULL) {
+		msg_drop(src_level);
 		return;
 	}
 
@@ -193,6 +228,13 @@ void log_core_init(void)
 	log_msg_pool_init();
 	log_list_init(&list);
 
+#ifdef CONFIG_LOG_LOCKLESS
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		atomic_clear(&cpu_pending[i]);
+		log_list_init(&cpu_list[i]);
+	}
+#endif
+
 	/* No backends attached so far but set default level as a filter for
 	 * any source of logging in the system. When backends are attached later
 	 * logs will be filtered out during processing.
@@ -233,6 +275,14 @@ void log_init(void)
 			   NULL,
 			   CONFIG_LOG_DEFAULT_LEVEL);
 #endif
+
+#ifdef CONFIG_LOG_BACKEND_FLASH
+	if (log_backend_flash_init() == 0) {
+		log_backend_enable(&log_backend_flash,
+				   NULL,
+				   CONFIG_LOG_DEFAULT_LEVEL);
+	}
+#endif
 }
 
 static void thread_set(k_tid_t process_tid)
@@ -320,6 +370,108 @@ static void msg_process(struct log_msg *msg, bool bypass)
 	log_msg_put(msg);
 }
 
+#ifdef CONFIG_LOG_LOCKLESS
+/* Log a warning on behalf of every source which lost messages since the
+ * last report. Reporting is retried later if there is no space for it.
+ */
+static void dropped_report(void)
+{
+	struct log_source_dynamic_data *source;
+	struct log_msg_ids src_level = {
+		.level = LOG_LEVEL_WRN,
+		.domain_id = CONFIG_LOG_DOMAIN_ID,
+	};
+	struct log_msg *msg;
+	u32_t cnt;
+
+	if (!atomic_clear(&dropped_pending)) {
+		return;
+	}
+
+	for (int i = 0; i < log_sources_count(); i++) {
+		source = &__log_dynamic_start[i];
+		cnt = atomic_get(&source->dropped) - source->dropped_reported;
+		if (cnt == 0) {
+			continue;
+		}
+
+		msg = log_msg_create_1("--- %u messages dropped ---", cnt);
+		if (msg == NULL) {
+			atomic_set(&dropped_pending, 1);
+			return;
+		}
+
+		source->dropped_reported += cnt;
+		src_level.source_id = i;
+		msg_finalize(msg, src_level);
+	}
+}
+
+/* Take the oldest message of all CPUs. Messages of a single CPU are
+ * already in order, so only heads of the per CPU lists are compared.
+ */
+static struct log_msg *msg_oldest_get(void)
+{
+	struct log_msg *oldest = NULL;
+	struct log_msg *msg;
+	int cpu = 0;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (log_list_head_peek(&cpu_list[i]) == NULL) {
+			log_list_lf_take(&cpu_pending[i], &cpu_list[i]);
+		}
+
+		msg = log_list_head_peek(&cpu_list[i]);
+		if (msg != NULL &&
+		    (oldest == NULL ||
+		     (s32_t)(msg->hdr.timestamp - oldest->hdr.timestamp) < 0)) {
+			oldest = msg;
+			cpu = i;
+		}
+	}
+
+	return (oldest != NULL) ? log_list_head_get(&cpu_list[cpu]) : NULL;
+}
+
+static bool msg_pending(void)
+{
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (log_list_head_peek(&cpu_list[i]) != NULL ||
+		    atomic_get(&cpu_pending[i]) != 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool log_process(bool bypass)
+{
+	struct log_msg *msg;
+	bool more;
+
+	/* Only one context processes at a time. In panic mode the context
+	 * which was processing will not resume, so it is taken over.
+	 */
+	if (!atomic_cas(&proc_busy, 0, 1) && !panic_mode) {
+		return false;
+	}
+
+	msg = msg_oldest_get();
+	if (msg != NULL) {
+		atomic_dec(&buffered_cnt);
+		msg_process(msg, bypass);
+	}
+
+	dropped_report();
+
+	more = msg_pending();
+
+	atomic_clear(&proc_busy);
+
+	return more;
+}
+#else
 bool log_process(bool bypass)
 {
 	struct log_msg *msg;
@@ -336,6 +488,7 @@ bool log_process(bool bypass)
 
 	return (log_list_head_peek(&list) != NULL);
 }
+#endif /* CONFIG_LOG_LOCKLESS */
 
 u32_t log_buffered_cnt(void)
 {
@@ -354,6 +507,17 @@ const char *log_source_name_get(u32_t domain_id, u32_t src_id)
 	return log_name_get(src_id);
 }
 
+u32_t log_source_dropped_get(u32_t domain_id, u32_t src_id)
+{
+	assert(src_id < log_sources_count());
+
+#ifdef CONFIG_LOG_LOCKLESS
+	return atomic_get(&__log_dynamic_start[src_id].dropped);
+#else
+	return 0;
+#endif
+}
+
 static u32_t max_filter_get(u32_t filters)
 {
 	u32_t max_filter = LOG_LEVEL_NONE;
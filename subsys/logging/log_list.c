@@ -39,3 +39,46 @@ struct log_msg *log_list_head_get(struct log_list_t *list)
 
 	return msg;
 }
+
+#ifdef CONFIG_LOG_LOCKLESS
+BUILD_ASSERT_MSG(sizeof(atomic_val_t) == sizeof(struct log_msg *),
+		 "Message pointer must fit in an atomic variable");
+
+void log_list_lf_push(atomic_t *stack, struct log_msg *msg)
+{
+	atomic_val_t head;
+
+	do {
+		head = atomic_get(stack);
+		msg->next = (struct log_msg *)head;
+	} while (!atomic_cas(stack, head, (atomic_val_t)msg));
+}
+
+void log_list_lf_take(atomic_t *stack, struct log_list_t *list)
+{
+	struct log_msg *msg = (struct log_msg *)atomic_clear(stack);
+	struct log_msg *tail = msg;
+	struct log_msg *prev = NULL;
+	struct log_msg *next;
+
+	/* The stack holds the newest message first, reverse it. */
+	while (msg != NULL) {
+		next = msg->next;
+		msg->next = prev;
+		prev = msg;
+		msg = next;
+	}
+
+	if (prev == NULL) {
+		return;
+	}
+
+	if (list->head == NULL) {
+		list->head = prev;
+	} else {
+		list->tail->next = prev;
+	}
+
+	list->tail = tail;
+}
+#endif /* CONFIG_LOG_LOCKLESS */
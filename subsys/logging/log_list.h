@@ -7,6 +7,10 @@
 #define LOG_LIST_H_
 
 #include <logging/log_msg.h>
+#include <atomic.h>
+#ifdef CONFIG_SMP
+#include <kernel_structs.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -48,6 +52,36 @@ struct log_msg *log_list_head_get(struct log_list_t *list);
  */
 struct log_msg *log_list_head_peek(struct log_list_t *list);
 
+/** @brief Get index of the current CPU. */
+static inline u32_t log_cpu_id(void)
+{
+#ifdef CONFIG_SMP
+	return _current_cpu->id;
+#else
+	return 0;
+#endif
+}
+
+/** @brief Push item to a lock-free pending stack.
+ *
+ * Can be called from any context and CPU concurrently with other pushes
+ * and with @ref log_list_lf_take.
+ *
+ * @param stack Pending stack, 0 when empty.
+ * @param msg   Message.
+ */
+void log_list_lf_push(atomic_t *stack, struct log_msg *msg);
+
+/** @brief Move all items of a lock-free pending stack to the list.
+ *
+ * Items are added to the tail of the list in the order they were pushed.
+ * Only one context may take items from a given stack at a time.
+ *
+ * @param stack Pending stack.
+ * @param list  List instance.
+ */
+void log_list_lf_take(atomic_t *stack, struct log_list_t *list);
+
 #ifdef __cplusplus
 }
 #endif
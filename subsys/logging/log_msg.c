@@ -7,6 +7,7 @@
 #include <logging/log_msg.h>
 #include <logging/log_ctrl.h>
 #include <string.h>
+#include "log_list.h"
 
 #define MSG_SIZE sizeof(union log_msg_chunk)
 #define NUM_OF_MSGS (CONFIG_LOG_BUFFER_SIZE / MSG_SIZE)
@@ -15,9 +16,81 @@ struct k_mem_slab log_msg_pool;
 static u8_t __noinit __aligned(sizeof(u32_t))
 		log_msg_pool_buf[CONFIG_LOG_BUFFER_SIZE];
 
+#ifdef CONFIG_LOG_LOCKLESS
+/* Chunks in use, one bit each */
+static ATOMIC_DEFINE(log_msg_pool_map, NUM_OF_MSGS);
+
+#define POOL_MAP_WORDS ARRAY_SIZE(log_msg_pool_map)
+
+static void pool_lf_init(void)
+{
+	int i;
+
+	for (i = 0; i < POOL_MAP_WORDS; i++) {
+		atomic_clear(&log_msg_pool_map[i]);
+	}
+
+	/* Bits past the last chunk are never free */
+	for (i = NUM_OF_MSGS; i < POOL_MAP_WORDS * ATOMIC_BITS; i++) {
+		atomic_set_bit(log_msg_pool_map, i);
+	}
+}
+
+union log_msg_chunk *log_msg_chunk_lf_alloc(void)
+{
+	/* Each CPU starts searching in its own part of the pool, so that
+	 * CPUs logging concurrently rarely compete for the same word.
+	 */
+	u32_t start = log_cpu_id() * POOL_MAP_WORDS / CONFIG_MP_NUM_CPUS;
+	atomic_val_t val;
+	u32_t word;
+	u32_t bit;
+	int i;
+
+	for (i = 0; i < POOL_MAP_WORDS; i++) {
+		word = (start + i) % POOL_MAP_WORDS;
+		val = atomic_get(&log_msg_pool_map[word]);
+
+		while (~val) {
+			bit = find_lsb_set(~val) - 1;
+
+			if (atomic_cas(&log_msg_pool_map[word], val,
+				       val | BIT(bit))) {
+				return (union log_msg_chunk *)
+					&log_msg_pool_buf[(word * ATOMIC_BITS +
+							   bit) * MSG_SIZE];
+			}
+
+			val = atomic_get(&log_msg_pool_map[word]);
+		}
+	}
+
+	return NULL;
+}
+#else
+union log_msg_chunk *log_msg_chunk_lf_alloc(void)
+{
+	return NULL;
+}
+#endif /* CONFIG_LOG_LOCKLESS */
+
+void log_msg_chunk_free(void *chunk)
+{
+#ifdef CONFIG_LOG_LOCKLESS
+	atomic_clear_bit(log_msg_pool_map,
+			 ((u8_t *)chunk - log_msg_pool_buf) / MSG_SIZE);
+#else
+	k_mem_slab_free(&log_msg_pool, &chunk);
+#endif
+}
+
 void log_msg_pool_init(void)
 {
+#ifdef CONFIG_LOG_LOCKLESS
+	pool_lf_init();
+#else
 	k_mem_slab_init(&log_msg_pool, log_msg_pool_buf, MSG_SIZE, NUM_OF_MSGS);
+#endif
 }
 
 void log_msg_get(struct log_msg *msg)
@@ -31,7 +104,7 @@ static void cont_free(struct log_msg_cont *cont)
 
 	while (cont != NULL) {
 		next = cont->next;
-		k_mem_slab_free(&log_msg_pool, (void **)&cont);
+		log_msg_chunk_free(cont);
 		cont = next;
 	}
 }
@@ -41,7 +114,7 @@ static void msg_free(struct log_msg *msg)
 	if (msg->hdr.params.generic.ext == 1) {
 		cont_free(msg->data.ext.next);
 	}
-	k_mem_slab_free(&log_msg_pool, (void **)&msg);
+	log_msg_chunk_free(msg);
 }
 
 union log_msg_chunk *log_msg_no_space_handle(void)
@@ -114,7 +187,8 @@ struct log_msg *log_msg_create_n(const char *str,
 		if (msg != NULL) {
 			msg->hdr.params.std.nargs = nargs;
 			msg->data.data.std.str = str;
-			memcpy(msg->data.data.std.args, args, nargs);
+			memcpy(msg->data.data.std.args, args,
+			       nargs * sizeof(u32_t));
 		}
 	} else {
 		msg = _log_msg_ext_std_alloc();
@@ -232,6 +306,7 @@ static void log_msg_hexdump_data_op(struct log_msg *msg,
 	}
 
 	if (offset < chunk_len) {
+		chunk_len -= offset;
 		cpy_len = req_len > chunk_len ? chunk_len : req_len;
 
 		if (put_op) {
@@ -240,13 +315,14 @@ static void log_msg_hexdump_data_op(struct log_msg *msg,
 			memcpy(data, &head_data[offset], cpy_len);
 		}
 
+		offset = 0;
 		req_len -= cpy_len;
 		data += cpy_len;
 	} else {
 		offset -= chunk_len;
 		chunk_len = HEXDUMP_BYTES_CONT_MSG;
 
-		while (offset > chunk_len) {
+		while (offset >= chunk_len) {
 			cont = cont->next;
 			offset -= chunk_len;
 		}
@@ -79,6 +79,7 @@ static int print(struct log_output_ctx *ctx, const char *fmt, ...)
 static void flush(struct log_output_ctx *ctx)
 {
 	ctx->func(ctx->data, ctx->offset, ctx->ctx);
+	ctx->offset = 0;
 }
 
 static int timestamp_print(struct log_msg *msg,
@@ -374,6 +375,81 @@ void log_output_msg_process(struct log_msg *msg,
 	flush(ctx);
 }
 
+static void dict_uint(struct log_output_ctx *ctx, u32_t value)
+{
+	while (value > 0x7f) {
+		out_func((value & 0x7f) | 0x80, ctx);
+		value >>= 7;
+	}
+
+	out_func(value, ctx);
+}
+
+static void dict_data(struct log_msg *msg, struct log_output_ctx *ctx,
+		      size_t length)
+{
+	size_t offset = 0;
+	size_t chunk;
+
+	/* Copy straight into the output buffer, flushing it when full */
+	while (offset < length) {
+		chunk = ctx->length - ctx->offset;
+		log_msg_hexdump_data_get(msg, &ctx->data[ctx->offset],
+					 &chunk, offset);
+		if (chunk == 0) {
+			break;
+		}
+
+		offset += chunk;
+		ctx->offset += chunk;
+
+		if (ctx->offset == ctx->length) {
+			ctx->func(ctx->data, ctx->length, ctx->ctx);
+			ctx->offset = 0;
+		}
+	}
+}
+
+void log_output_msg_dict_process(struct log_msg *msg,
+				 struct log_output_ctx *ctx)
+{
+	u32_t type;
+	u32_t nargs;
+	u32_t i;
+
+	if (log_msg_is_std(msg)) {
+		type = LOG_OUTPUT_DICT_TYPE_STD;
+	} else if (log_msg_is_raw_string(msg)) {
+		type = LOG_OUTPUT_DICT_TYPE_RAW_STRING;
+	} else {
+		type = LOG_OUTPUT_DICT_TYPE_HEXDUMP;
+	}
+
+	out_func(LOG_OUTPUT_DICT_SYNC, ctx);
+	out_func(type | (log_msg_level_get(msg) << 2) |
+		 (log_msg_domain_id_get(msg) << 5), ctx);
+	dict_uint(ctx, log_msg_source_id_get(msg));
+	dict_uint(ctx, log_msg_timestamp_get(msg));
+
+	if (type == LOG_OUTPUT_DICT_TYPE_STD) {
+		nargs = log_msg_nargs_get(msg);
+
+		dict_uint(ctx, (u32_t)(uintptr_t)log_msg_str_get(msg));
+		out_func(nargs, ctx);
+
+		for (i = 0; i < nargs; i++) {
+			dict_uint(ctx, log_msg_arg_get(msg, i));
+		}
+	} else {
+		u32_t length = msg->hdr.params.hexdump.length;
+
+		dict_uint(ctx, length);
+		dict_data(msg, ctx, length);
+	}
+
+	flush(ctx);
+}
+
 void log_output_timestamp_freq_set(u32_t frequency)
 {
 	timestamp_div = 1;
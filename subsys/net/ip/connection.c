@@ -48,304 +48,116 @@
 
 static struct net_conn conns[CONFIG_NET_MAX_CONN];
 
-#if defined(CONFIG_NET_CONN_CACHE)
+/** Rank of a connection bound to both addresses and both ports */
+#define NET_RANK_EXACT (NET_RANK_LOCAL_PORT | NET_RANK_REMOTE_PORT | \
+			NET_RANK_LOCAL_SPEC_ADDR | NET_RANK_REMOTE_SPEC_ADDR)
 
-/* Cache the connection so that we do not have to go
- * through the full list of connections when receiving
- * a network packet. The cache contains an index to
- * corresponding entry in conns array.
- *
- * Hash value is constructed like this:
- *
- *   bit      description
- *   0  - 3   bits from remote port
- *   4  - 7   bits from local port
- *   8  - 18  bits from remote address
- *   19 - 29  bits from local address
- *   30       family
- *   31       protocol
- */
-struct conn_hash {
-	u32_t value;
-	s32_t idx;
-};
+#define CONN_HASH_SIZE BIT(CONFIG_NET_CONN_HASH_BITS)
 
-struct conn_hash_neg {
-	u32_t value;
-};
-
-/** Connection cache */
-static struct conn_hash conn_cache[CONFIG_NET_MAX_CONN];
-
-/** Negative cache, we definitely do not have a connection
- * to these hosts.
+/* Connections are demultiplexed through three kinds of lists, each one
+ * kept in conns[] index order so that the ranking done in
+ * net_conn_input() gives the same result as a scan of the whole array:
+ *
+ *   conn_exact    connections with a rank of NET_RANK_EXACT, hashed by
+ *                 protocol, addresses and ports
+ *   conn_port     other connections with a local port, hashed by it
+ *   conn_any_port connections without a local port
  */
-static struct conn_hash_neg conn_cache_neg[CONFIG_NET_MAX_CONN];
+static sys_slist_t conn_exact[CONN_HASH_SIZE];
+static sys_slist_t conn_port[CONN_HASH_SIZE];
+static sys_slist_t conn_any_port;
 
-#define TAKE_BIT(val, bit, max, used)				\
-	(((val & BIT(bit)) >> bit) << (max - used))
-
-static inline u8_t ports_to_hash(u16_t remote_port,
-				    u16_t local_port)
+static inline u32_t conn_hash_addr(u32_t hash, sa_family_t family,
+				   const void *addr)
 {
-	/* Note that we do not convert port value to network byte order */
-	return (remote_port & BIT(0)) |
-		((remote_port & BIT(4)) >> 3) |
-		((remote_port & BIT(8)) >> 6) |
-		((remote_port & BIT(15)) >> 12) |
-		(((local_port & BIT(0)) |
-		  ((local_port & BIT(4)) >> 3) |
-		  ((local_port & BIT(8)) >> 6) |
-		  ((local_port & BIT(15)) >> 12)) << 4);
+	if (IS_ENABLED(CONFIG_NET_IPV6) && family == AF_INET6) {
+		return net_hash_words(hash, addr, 4);
+	}
+
+	return net_hash_words(hash, addr, 1);
 }
 
-static inline u16_t ipv6_to_hash(struct in6_addr *addr)
+/* Ports are given in network byte order */
+static inline u32_t conn_hash_exact(u8_t proto, sa_family_t family,
+				    const void *remote_addr,
+				    const void *local_addr,
+				    u16_t remote_port, u16_t local_port)
 {
-	/* There is 11 bits available for IPv6 address */
-	/* Use more bits from the lower part of address space */
-	return
-		/* Take 3 bits from higher values */
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[0]), 31, 11, 1) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[0]), 15, 11, 2) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[0]), 7, 11, 3) |
-
-		/* Take 2 bits from higher middle values */
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[1]), 31, 11, 4) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[1]), 15, 11, 5) |
-
-		/* Take 2 bits from lower middle values */
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[2]), 31, 11, 6) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[2]), 15, 11, 7) |
-
-		/* Take 4 bits from lower values */
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[3]), 31, 11, 8) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[3]), 15, 11, 9) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[3]), 7, 11, 10) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[3]), 0, 11, 11);
+	u32_t hash;
+
+	hash = net_hash_u32(proto, ((u32_t)remote_port << 16) | local_port);
+	hash = conn_hash_addr(hash, family, remote_addr);
+	hash = conn_hash_addr(hash, family, local_addr);
+
+	return net_hash_bucket(hash, CONFIG_NET_CONN_HASH_BITS);
 }
 
-static inline u16_t ipv4_to_hash(struct in_addr *addr)
+static inline u32_t conn_hash_port(u16_t local_port)
 {
-	/* There is 11 bits available for IPv4 address */
-	/* Use more bits from the lower part of address space */
-	return
-		TAKE_BIT(addr->s_addr, 31, 11, 1) |
-		TAKE_BIT(addr->s_addr, 27, 11, 2) |
-		TAKE_BIT(addr->s_addr, 21, 11, 3) |
-		TAKE_BIT(addr->s_addr, 17, 11, 4) |
-		TAKE_BIT(addr->s_addr, 14, 11, 5) |
-		TAKE_BIT(addr->s_addr, 11, 11, 6) |
-		TAKE_BIT(addr->s_addr, 8, 11, 7) |
-		TAKE_BIT(addr->s_addr, 5, 11, 8) |
-		TAKE_BIT(addr->s_addr, 3, 11, 9) |
-		TAKE_BIT(addr->s_addr, 2, 11, 10) |
-		TAKE_BIT(addr->s_addr, 0, 11, 11);
+	return net_hash_bucket(net_hash_u32(0, local_port),
+			       CONFIG_NET_CONN_HASH_BITS);
 }
 
-/* Return either the first free position in the cache (idx < 0) or
- * the existing cached position (idx >= 0)
- */
-static s32_t check_hash(enum net_ip_protocol proto,
-			  sa_family_t family,
-			  void *remote_addr,
-			  void *local_addr,
-			  u16_t remote_port,
-			  u16_t local_port,
-			  u32_t *cache_value)
+static inline const void *conn_addr(struct sockaddr *addr)
 {
-	int i, free_pos = -1;
-	u32_t value = 0;
-
-	value = ports_to_hash(remote_port, local_port);
-
-#if defined(CONFIG_NET_UDP)
-	if (proto == IPPROTO_UDP) {
-		value |= BIT(31);
-	}
-#endif
-
-#if defined(CONFIG_NET_TCP)
-	if (proto == IPPROTO_TCP) {
-		value &= ~BIT(31);
-	}
-#endif
-
-#if defined(CONFIG_NET_IPV6)
-	if (family == AF_INET6) {
-		value |= BIT(30);
-		value |= ipv6_to_hash((struct in6_addr *)remote_addr) << 8;
-		value |= ipv6_to_hash((struct in6_addr *)local_addr) << 19;
-	}
-#endif
-
-#if defined(CONFIG_NET_IPV4)
-	if (family == AF_INET) {
-		value &= ~BIT(30);
-		value |= ipv4_to_hash((struct in_addr *)remote_addr) << 8;
-		value |= ipv4_to_hash((struct in_addr *)local_addr) << 19;
-	}
-#endif
-
-	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-		if (conn_cache[i].value == value) {
-			return i;
-		}
-
-		if (conn_cache[i].idx < 0 && free_pos < 0) {
-			free_pos = i;
-		}
-	}
-
-	if (free_pos >= 0) {
-		conn_cache[free_pos].value = value;
-		return free_pos;
+	if (IS_ENABLED(CONFIG_NET_IPV6) && addr->sa_family == AF_INET6) {
+		return &net_sin6(addr)->sin6_addr;
 	}
 
-	*cache_value = value;
-
-	return -ENOENT;
+	return &net_sin(addr)->sin_addr;
 }
 
-static inline s32_t get_conn(enum net_ip_protocol proto,
-			     sa_family_t family,
-			     struct net_pkt *pkt,
-			     u32_t *cache_value)
+static sys_slist_t *conn_list(struct net_conn *conn)
 {
-	struct net_udp_hdr hdr, *udp_hdr;
+	u16_t local_port = net_sin(&conn->local_addr)->sin_port;
 
-	udp_hdr = net_udp_get_hdr(pkt, &hdr);
-	if (!udp_hdr) {
-		return NET_DROP;
-	}
-
-#if defined(CONFIG_NET_IPV4)
-	if (family == AF_INET) {
-		return check_hash(proto, family,
-				  &NET_IPV4_HDR(pkt)->src,
-				  &NET_IPV4_HDR(pkt)->dst,
-				  udp_hdr->src_port,
-				  udp_hdr->dst_port,
-				  cache_value);
+	if (conn->rank == NET_RANK_EXACT) {
+		return &conn_exact[conn_hash_exact(
+			conn->proto, conn->local_addr.sa_family,
+			conn_addr(&conn->remote_addr),
+			conn_addr(&conn->local_addr),
+			net_sin(&conn->remote_addr)->sin_port,
+			local_port)];
 	}
-#endif
 
-#if defined(CONFIG_NET_IPV6)
-	if (family == AF_INET6) {
-		return check_hash(proto, family,
-				  &NET_IPV6_HDR(pkt)->src,
-				  &NET_IPV6_HDR(pkt)->dst,
-				  udp_hdr->src_port,
-				  udp_hdr->dst_port,
-				  cache_value);
+	if (local_port) {
+		return &conn_port[conn_hash_port(local_port)];
 	}
-#endif
 
-	return -1;
+	return &conn_any_port;
 }
 
-static inline void cache_add_neg(u32_t cache_value)
+static void conn_list_add(struct net_conn *conn)
 {
-	int i;
+	sys_slist_t *list = conn_list(conn);
+	sys_snode_t *prev = NULL;
+	sys_snode_t *node;
 
-	for (i = 0; i < CONFIG_NET_MAX_CONN && cache_value > 0; i++) {
-		if (conn_cache_neg[i].value) {
-			continue;
+	SYS_SLIST_FOR_EACH_NODE(list, node) {
+		if (CONTAINER_OF(node, struct net_conn, node) > conn) {
+			break;
 		}
 
-		NET_DBG("Add to neg cache value 0x%x", cache_value);
-
-		conn_cache_neg[i].value = cache_value;
-		break;
-	}
-}
-
-static inline bool cache_check_neg(u32_t cache_value)
-{
-	int i;
-
-	for (i = 0; i < CONFIG_NET_MAX_CONN && cache_value > 0; i++) {
-		if (conn_cache_neg[i].value == cache_value) {
-			NET_DBG("Cache neg [%d] value 0x%x found",
-				i, cache_value);
-			return true;
-		}
+		prev = node;
 	}
 
-	return false;
+	sys_slist_insert(list, prev, &conn->node);
 }
 
-static void cache_clear(void)
+static inline struct net_conn *conn_list_head(sys_slist_t *list)
 {
-	int i;
+	sys_snode_t *node = sys_slist_peek_head(list);
 
-	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-		conn_cache[i].idx = -1;
-		conn_cache_neg[i].value = 0;
-	}
+	return node ? CONTAINER_OF(node, struct net_conn, node) : NULL;
 }
 
-static inline enum net_verdict cache_check(enum net_ip_protocol proto,
-					   struct net_pkt *pkt,
-					   u32_t *cache_value,
-					   s32_t *pos)
+static inline struct net_conn *conn_list_next(struct net_conn *conn)
 {
-	*pos = get_conn(proto, net_pkt_family(pkt), pkt, cache_value);
-	if (*pos >= 0) {
-		if (conn_cache[*pos].idx >= 0) {
-			/* Connection is in the cache */
-			struct net_conn *conn;
-			struct net_udp_hdr hdr, *udp_hdr;
-
-			udp_hdr = net_udp_get_hdr(pkt, &hdr);
-			if (!udp_hdr) {
-				return NET_CONTINUE;
-			}
-
-			conn = &conns[conn_cache[*pos].idx];
+	sys_snode_t *node = sys_slist_peek_next(&conn->node);
 
-			NET_DBG("Cache %s listener for pkt %p src port %u "
-				"dst port %u family %d cache[%d] 0x%x",
-				net_proto2str(proto), pkt,
-				ntohs(udp_hdr->src_port),
-				ntohs(udp_hdr->dst_port),
-				net_pkt_family(pkt), *pos,
-				conn_cache[*pos].value);
-
-			return conn->cb(conn, pkt, conn->user_data);
-		}
-	} else if (*cache_value > 0) {
-		if (cache_check_neg(*cache_value)) {
-			NET_DBG("Drop by cache");
-			return NET_DROP;
-		}
-	}
-
-	return NET_CONTINUE;
+	return node ? CONTAINER_OF(node, struct net_conn, node) : NULL;
 }
 
-static inline void cache_remove(struct net_conn *conn)
-{
-	int i;
-
-	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-		if (conn_cache[i].idx < 0 ||
-		    conn_cache[i].idx >= CONFIG_NET_MAX_CONN) {
-			continue;
-		}
-
-		if (&conns[conn_cache[i].idx] == conn) {
-			conn_cache[i].idx = -1;
-			break;
-		}
-	}
-}
-#else
-#define cache_clear(...)
-#define cache_add_neg(...)
-#define cache_check(...) NET_CONTINUE
-#define cache_remove(...)
-#endif /* CONFIG_NET_CONN_CACHE */
-
 int net_conn_unregister(struct net_conn_handle *handle)
 {
 	struct net_conn *conn = (struct net_conn *)handle;
@@ -358,7 +170,7 @@ int net_conn_unregister(struct net_conn_handle *handle)
 		return -ENOENT;
 	}
 
-	cache_remove(conn);
+	sys_slist_find_and_remove(conn_list(conn), &conn->node);
 
 	NET_DBG("[%zu] connection handler %p removed",
 		(conn - conns) / sizeof(*conn), conn);
@@ -676,8 +488,7 @@ int net_conn_register(enum net_ip_protocol proto,
 		conns[i].rank = rank;
 		conns[i].proto = proto;
 
-		/* Cache needs to be cleared if new entries are added. */
-		cache_clear();
+		conn_list_add(&conns[i]);
 
 #if defined(CONFIG_NET_DEBUG_CONN)
 		do {
@@ -803,25 +614,143 @@ static bool is_invalid_packet(struct net_pkt *pkt,
 	return my_src_addr && (src_port == dst_port);
 }
 
-enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
+static bool conn_match(struct net_conn *conn, struct net_pkt *pkt,
+		       u16_t src_port, u16_t dst_port)
 {
-	int i, best_match = -1;
-	s16_t best_rank = -1;
-	u16_t src_port, dst_port;
-	u16_t chksum;
-	struct net_if *pkt_iface = net_pkt_iface(pkt);
+	if (net_sin(&conn->remote_addr)->sin_port) {
+		if (net_sin(&conn->remote_addr)->sin_port != src_port) {
+			return false;
+		}
+	}
 
-#if defined(CONFIG_NET_CONN_CACHE)
-	enum net_verdict verdict;
-	u32_t cache_value = 0;
-	s32_t pos;
+	if (net_sin(&conn->local_addr)->sin_port) {
+		if (net_sin(&conn->local_addr)->sin_port != dst_port) {
+			return false;
+		}
+	}
+
+	if (conn->flags & NET_CONN_REMOTE_ADDR_SET) {
+		if (!check_addr(pkt, &conn->remote_addr, true)) {
+			return false;
+		}
+	}
 
-	verdict = cache_check(proto, pkt, &cache_value, &pos);
-	if (verdict != NET_CONTINUE) {
-		return verdict;
+	if (conn->flags & NET_CONN_LOCAL_ADDR_SET) {
+		if (!check_addr(pkt, &conn->local_addr, false)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Return the exact match bucket of a packet, or NULL if the packet
+ * family is not supported.
+ */
+static sys_slist_t *pkt_exact_list(enum net_ip_protocol proto,
+				   struct net_pkt *pkt,
+				   u16_t src_port, u16_t dst_port)
+{
+#if defined(CONFIG_NET_IPV6)
+	if (net_pkt_family(pkt) == AF_INET6) {
+		return &conn_exact[conn_hash_exact(proto, AF_INET6,
+						   &NET_IPV6_HDR(pkt)->src,
+						   &NET_IPV6_HDR(pkt)->dst,
+						   src_port, dst_port)];
+	}
+#endif
+
+#if defined(CONFIG_NET_IPV4)
+	if (net_pkt_family(pkt) == AF_INET) {
+		return &conn_exact[conn_hash_exact(proto, AF_INET,
+						   &NET_IPV4_HDR(pkt)->src,
+						   &NET_IPV4_HDR(pkt)->dst,
+						   src_port, dst_port)];
 	}
 #endif
 
+	return NULL;
+}
+
+/* The candidates of the three lists a packet can match in are ranked in
+ * conns[] order, the same order in which a full scan would see them.
+ */
+static struct net_conn *conn_find(enum net_ip_protocol proto,
+				  struct net_pkt *pkt,
+				  u16_t src_port, u16_t dst_port)
+{
+	struct net_conn *best_match = NULL;
+	struct net_conn *exact, *port, *any, *conn;
+	sys_slist_t *list;
+
+	list = pkt_exact_list(proto, pkt, src_port, dst_port);
+	exact = list ? conn_list_head(list) : NULL;
+	port = conn_list_head(&conn_port[conn_hash_port(dst_port)]);
+	any = conn_list_head(&conn_any_port);
+
+	while (exact || port || any) {
+		conn = exact;
+
+		if (port && (!conn || port < conn)) {
+			conn = port;
+		}
+
+		if (any && (!conn || any < conn)) {
+			conn = any;
+		}
+
+		if (conn == exact) {
+			exact = conn_list_next(exact);
+		} else if (conn == port) {
+			port = conn_list_next(port);
+		} else {
+			any = conn_list_next(any);
+		}
+
+		if (conn->proto != proto) {
+			continue;
+		}
+
+		if (!conn_match(conn, pkt, src_port, dst_port)) {
+			continue;
+		}
+
+		if (best_match && best_match->rank >= conn->rank) {
+			continue;
+		}
+
+		best_match = conn;
+
+		/* A match that specifies a remote port is a connection
+		 * to that peer, and is not overridden by any later entry.
+		 */
+		if (net_sin(&conn->remote_addr)->sin_port) {
+			break;
+		}
+	}
+
+	return best_match;
+}
+
+/* Checksum field of a packet in network byte order, only read for
+ * debugging
+ */
+static inline u16_t conn_pkt_chksum(enum net_ip_protocol proto,
+				    struct net_pkt *pkt)
+{
+	if (IS_ENABLED(CONFIG_NET_UDP) && proto == IPPROTO_UDP) {
+		return net_udp_get_chksum(pkt, pkt->frags);
+	}
+
+	return net_tcp_get_chksum(pkt, pkt->frags);
+}
+
+enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
+{
+	struct net_conn *best_match;
+	u16_t src_port, dst_port;
+	struct net_if *pkt_iface = net_pkt_iface(pkt);
+
 	/* This is only used for getting source and destination ports.
 	 * Because both TCP and UDP header have these in the same
 	 * location, we can check them both using the UDP struct.
@@ -838,7 +767,6 @@ enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
 
 		src_port = udp_hdr->src_port;
 		dst_port = udp_hdr->dst_port;
-		chksum = udp_hdr->chksum;
 	} else if (IS_ENABLED(CONFIG_NET_TCP) && proto == IPPROTO_TCP) {
 		struct net_tcp_hdr hdr, *tcp_hdr;
 
@@ -851,7 +779,6 @@ enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
 
 		src_port = tcp_hdr->src_port;
 		dst_port = tcp_hdr->dst_port;
-		chksum = tcp_hdr->chksum;
 	} else {
 		NET_DBG("No UDP or TCP configured, dropping packet.");
 		return NET_DROP;
@@ -880,120 +807,57 @@ enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
 			pkt,
 			ntohs(src_port),
 			ntohs(dst_port),
-			net_pkt_family(pkt), ntohs(chksum), data_len);
+			net_pkt_family(pkt), ntohs(conn_pkt_chksum(proto, pkt)),
+			data_len);
 	}
 
-	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-		if (!(conns[i].flags & NET_CONN_IN_USE)) {
-			continue;
-		}
-
-		if (conns[i].proto != proto) {
-			continue;
-		}
-
-		if (net_sin(&conns[i].remote_addr)->sin_port) {
-			if (net_sin(&conns[i].remote_addr)->sin_port !=
-			    src_port) {
-				continue;
-			}
-		}
-
-		if (net_sin(&conns[i].local_addr)->sin_port) {
-			if (net_sin(&conns[i].local_addr)->sin_port !=
-			    dst_port) {
-				continue;
-			}
-		}
-
-		if (conns[i].flags & NET_CONN_REMOTE_ADDR_SET) {
-			if (!check_addr(pkt, &conns[i].remote_addr, true)) {
-				continue;
-			}
-		}
-
-		if (conns[i].flags & NET_CONN_LOCAL_ADDR_SET) {
-			if (!check_addr(pkt, &conns[i].local_addr, false)) {
-				continue;
-			}
-		}
-
-		/* If we have an existing best_match, and that one
-		 * specifies a remote port, then we've matched to a
-		 * LISTENING connection that should not override.
-		 */
-		if (best_match >= 0 &&
-		    net_sin(&conns[best_match].remote_addr)->sin_port) {
-			continue;
-		}
-
-		if (best_rank < conns[i].rank) {
-			best_rank = conns[i].rank;
-			best_match = i;
-		}
-	}
-
-	if (best_match >= 0) {
+	best_match = conn_find(proto, pkt, src_port, dst_port);
+	if (best_match) {
 
 		/* If packet has a listener configured, then check also the
 		 * protocol checksum if that checking is enabled.
 		 * If the checksum calculation fails, then discard the message.
+		 * The sum of the data including a valid checksum is 0xffff,
+		 * so the packet does not need to be modified for the check.
 		 */
 		if (IS_ENABLED(CONFIG_NET_UDP_CHECKSUM) &&
 		    proto == IPPROTO_UDP &&
 		    net_if_need_calc_rx_checksum(net_pkt_iface(pkt))) {
-			u16_t chksum_calc;
+			u16_t sum = net_calc_chksum_udp(pkt);
 
-			net_udp_set_chksum(pkt, pkt->frags);
-			chksum_calc = net_udp_get_chksum(pkt, pkt->frags);
-
-			if (chksum != chksum_calc) {
+			if (sum != 0xffff) {
 				net_stats_update_udp_chkerr(net_pkt_iface(pkt));
-				NET_DBG("UDP checksum mismatch "
-					"expected 0x%04x got 0x%04x, dropping packet.",
-					ntohs(chksum_calc), ntohs(chksum));
+				NET_DBG("UDP checksum 0x%04x mismatch "
+					"(sum 0x%04x), dropping packet.",
+					ntohs(conn_pkt_chksum(proto, pkt)),
+					ntohs(sum));
 				goto drop;
 			}
 
 		} else if (IS_ENABLED(CONFIG_NET_TCP_CHECKSUM) &&
 			   proto == IPPROTO_TCP &&
 			   net_if_need_calc_rx_checksum(net_pkt_iface(pkt))) {
-			u16_t chksum_calc;
-
-			net_tcp_set_chksum(pkt, pkt->frags);
-			chksum_calc = net_tcp_get_chksum(pkt, pkt->frags);
+			u16_t sum = net_calc_chksum_tcp(pkt);
 
-			if (chksum != chksum_calc) {
+			if (sum != 0xffff) {
 				net_stats_update_tcp_seg_chkerr(
 							net_pkt_iface(pkt));
-				NET_DBG("TCP checksum mismatch "
-					"expected 0x%04x got 0x%04x, dropping packet.",
-					ntohs(chksum_calc), ntohs(chksum));
+				NET_DBG("TCP checksum 0x%04x mismatch "
+					"(sum 0x%04x), dropping packet.",
+					ntohs(conn_pkt_chksum(proto, pkt)),
+					ntohs(sum));
 				goto drop;
 			}
 		}
 
-#if defined(CONFIG_NET_CONN_CACHE)
-		NET_DBG("[%d] match found cb %p ud %p rank 0x%02x cache 0x%x",
-			best_match,
-			conns[best_match].cb,
-			conns[best_match].user_data,
-			conns[best_match].rank,
-			pos < 0 ? 0 : conn_cache[pos].value);
-
-		if (pos >= 0) {
-			conn_cache[pos].idx = best_match;
-		}
-#else
 		NET_DBG("[%d] match found cb %p ud %p rank 0x%02x",
-			best_match,
-			conns[best_match].cb,
-			conns[best_match].user_data,
-			conns[best_match].rank);
-#endif /* CONFIG_NET_CONN_CACHE */
-
-		if (conns[best_match].cb(&conns[best_match], pkt,
-			     conns[best_match].user_data) == NET_DROP) {
+			(int)(best_match - conns),
+			best_match->cb,
+			best_match->user_data,
+			best_match->rank);
+
+		if (best_match->cb(best_match, pkt,
+				   best_match->user_data) == NET_DROP) {
 			goto drop;
 		}
 
@@ -1004,8 +868,6 @@ enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
 
 	NET_DBG("No match found.");
 
-	cache_add_neg(cache_value);
-
 #if defined(CONFIG_NET_IPV6)
 	/* If the destination address is multicast address,
 	 * we do not send ICMP error as that makes no sense.
@@ -1050,13 +912,12 @@ void net_conn_foreach(net_conn_foreach_cb_t cb, void *user_data)
 
 void net_conn_init(void)
 {
-#if defined(CONFIG_NET_CONN_CACHE)
-	do {
-		int i;
+	int i;
 
-		for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-			conn_cache[i].idx = -1;
-		}
-	} while (0);
-#endif /* CONFIG_NET_CONN_CACHE */
+	for (i = 0; i < CONN_HASH_SIZE; i++) {
+		sys_slist_init(&conn_exact[i]);
+		sys_slist_init(&conn_port[i]);
+	}
+
+	sys_slist_init(&conn_any_port);
 }
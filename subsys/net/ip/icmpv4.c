@@ -99,6 +99,7 @@ static inline enum net_verdict icmpv4_handle_echo_request(struct net_pkt *pkt)
 	 */
 	struct net_icmp_hdr hdr, *icmp_hdr;
 	struct in_addr addr;
+	u16_t chksum;
 
 #if defined(CONFIG_NET_DEBUG_ICMPV4)
 	char out[sizeof("xxx.xxx.xxx.xxx")];
@@ -114,12 +115,18 @@ static inline enum net_verdict icmpv4_handle_echo_request(struct net_pkt *pkt)
 			&NET_IPV4_HDR(pkt)->dst);
 	net_ipaddr_copy(&NET_IPV4_HDR(pkt)->dst, &addr);
 
+	/* Only the type and code change, so the checksum of the request
+	 * is updated for them (RFC 1624) instead of summing the data again.
+	 */
 	icmp_hdr = net_icmpv4_get_hdr(pkt, &hdr);
+	chksum = net_chksum_update_16(ntohs(icmp_hdr->chksum),
+				      (icmp_hdr->type << 8) | icmp_hdr->code,
+				      NET_ICMPV4_ECHO_REPLY << 8);
 	icmp_hdr->type = NET_ICMPV4_ECHO_REPLY;
 	icmp_hdr->code = 0;
+	icmp_hdr->chksum = htons(chksum);
 
 	net_icmpv4_set_hdr(pkt, icmp_hdr);
-	net_icmpv4_set_chksum(pkt, pkt->frags);
 
 #if defined(CONFIG_NET_DEBUG_ICMPV4)
 	snprintk(out, sizeof(out), "%s",
@@ -82,6 +82,14 @@ NET_NBR_TABLE_INIT(NET_NBR_GLOBAL,
 		   net_neighbor_pool,
 		   net_neighbor_table_clear);
 
+#define NBR_HASH_SIZE BIT(CONFIG_NET_IPV6_NBR_HASH_BITS)
+
+/* Neighbors in use, hashed by IPv6 address. The interface is not part of
+ * the key, as lookups may be done for any interface and nbr->iface is
+ * cleared when the link layer address is unlinked.
+ */
+static sys_slist_t nbr_hash[NBR_HASH_SIZE];
+
 const char *net_ipv6_nbr_state2str(enum net_ipv6_nbr_state state)
 {
 	switch (state) {
@@ -241,24 +249,56 @@ void nbr_print(void)
 #define nbr_print(...)
 #endif
 
+static inline sys_slist_t *nbr_hash_list(const struct in6_addr *addr)
+{
+	u32_t hash = net_hash_words(0, addr, 4);
+
+	return &nbr_hash[net_hash_bucket(hash, CONFIG_NET_IPV6_NBR_HASH_BITS)];
+}
+
+/* The pool is an array, so data of lower neighbor indexes is at lower
+ * addresses.
+ */
+static void nbr_hash_add(struct net_nbr *nbr)
+{
+	struct net_ipv6_nbr_data *data = net_ipv6_nbr_data(nbr);
+	sys_slist_t *list = nbr_hash_list(&data->addr);
+	sys_snode_t *prev = NULL;
+	sys_snode_t *node;
+
+	SYS_SLIST_FOR_EACH_NODE(list, node) {
+		if (node > &data->node) {
+			break;
+		}
+
+		prev = node;
+	}
+
+	sys_slist_insert(list, prev, &data->node);
+}
+
+static void nbr_hash_remove(struct net_nbr *nbr)
+{
+	struct net_ipv6_nbr_data *data = net_ipv6_nbr_data(nbr);
+
+	sys_slist_find_and_remove(nbr_hash_list(&data->addr), &data->node);
+}
+
 static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 				  struct net_if *iface,
 				  struct in6_addr *addr)
 {
-	int i;
-
-	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
-		struct net_nbr *nbr = get_nbr(i);
+	struct net_ipv6_nbr_data *data;
 
-		if (!nbr->ref) {
-			continue;
-		}
+	SYS_SLIST_FOR_EACH_CONTAINER(nbr_hash_list(addr), data, node) {
+		struct net_nbr *nbr = CONTAINER_OF((u8_t *)data,
+						   struct net_nbr, __nbr);
 
 		if (iface && nbr->iface != iface) {
 			continue;
 		}
 
-		if (net_ipv6_addr_cmp(&net_ipv6_nbr_data(nbr)->addr, addr)) {
+		if (net_ipv6_addr_cmp(&data->addr, addr)) {
 			return nbr;
 		}
 	}
@@ -386,6 +426,7 @@ static struct net_nbr *nbr_new(struct net_if *iface,
 	}
 
 	nbr_init(nbr, iface, addr, true, state);
+	nbr_hash_add(nbr);
 
 	NET_DBG("nbr %p iface %p state %d IPv6 %s",
 		nbr, iface, state, net_sprint_ipv6_addr(addr));
@@ -556,7 +597,7 @@ void net_neighbor_data_remove(struct net_nbr *nbr)
 {
 	NET_DBG("Neighbor %p removed", nbr);
 
-	return;
+	nbr_hash_remove(nbr);
 }
 
 void net_neighbor_table_clear(struct net_nbr_table *table)
@@ -601,14 +642,11 @@ const char *net_ipv6_nbr_state2str(enum net_ipv6_nbr_state state)
 int net_ipv6_find_last_ext_hdr(struct net_pkt *pkt, u16_t *next_hdr_idx,
 			       u16_t *last_hdr_idx)
 {
-	struct net_buf *next_hdr_frag;
-	struct net_buf *last_hdr_frag;
-	struct net_buf *frag;
-	u16_t pkt_offset;
-	u16_t offset;
+	struct net_pkt_cursor cursor;
 	u16_t length;
 	u8_t next_hdr;
 	u8_t next;
+	u8_t len;
 
 	if (!pkt || !pkt->frags || !next_hdr_idx || !last_hdr_idx) {
 		return -EINVAL;
@@ -629,38 +667,33 @@ int net_ipv6_find_last_ext_hdr(struct net_pkt *pkt, u16_t *next_hdr_idx,
 		return 0;
 	}
 
-	frag = pkt->frags;
-	offset = *last_hdr_idx;
+	if (net_pkt_cursor_init(&cursor, pkt, *last_hdr_idx) < 0) {
+		goto fail;
+	}
+
 	*next_hdr_idx = *last_hdr_idx;
-	next_hdr_frag = last_hdr_frag = frag;
 
-	while (frag) {
-		frag = net_frag_read_u8(frag, offset, &offset, &next_hdr);
-		if (!frag) {
+	while (1) {
+		if (net_pkt_cursor_read_u8(&cursor, &next_hdr) < 0) {
 			goto fail;
 		}
 
 		switch (next) {
 		case NET_IPV6_NEXTHDR_FRAG:
-			frag = net_frag_skip(frag, offset, &offset, 7);
-			if (!frag) {
+			if (net_pkt_cursor_skip(&cursor, 7) < 0) {
 				goto fail;
 			}
 
 			break;
 
 		case NET_IPV6_NEXTHDR_HBHO:
-			length = 0;
-			frag = net_frag_read_u8(frag, offset, &offset,
-						(u8_t *)&length);
-			if (!frag) {
+			if (net_pkt_cursor_read_u8(&cursor, &len) < 0) {
 				goto fail;
 			}
 
-			length = length * 8 + 8;
+			length = len * 8 + 8;
 
-			frag = net_frag_skip(frag, offset, &offset, length - 2);
-			if (!frag) {
+			if (net_pkt_cursor_skip(&cursor, length - 2) < 0) {
 				goto fail;
 			}
 
@@ -670,57 +703,22 @@ int net_ipv6_find_last_ext_hdr(struct net_pkt *pkt, u16_t *next_hdr_idx,
 		case IPPROTO_ICMPV6:
 		case IPPROTO_UDP:
 		case IPPROTO_TCP:
-			goto out;
+			return 0;
 
 		default:
 			/* TODO: Add more IPv6 extension headers to check */
 			goto fail;
 		}
 
+		/* The cursor offset is based on whole packet */
 		*next_hdr_idx = *last_hdr_idx;
-		next_hdr_frag = last_hdr_frag;
-
-		*last_hdr_idx = offset;
-		last_hdr_frag = frag;
+		*last_hdr_idx = cursor.offset;
 
 		next = next_hdr;
 	}
 
 fail:
 	return -EINVAL;
-
-out:
-	/* Current next_hdr_idx offset is based on respective fragment, but we
-	 * need to calculate next_hdr_idx offset based on whole packet.
-	 */
-	pkt_offset = 0;
-	frag = pkt->frags;
-	while (frag) {
-		if (next_hdr_frag == frag) {
-			*next_hdr_idx += pkt_offset;
-			break;
-		}
-
-		pkt_offset += frag->len;
-		frag = frag->frags;
-	}
-
-	/* Current last_hdr_idx offset is based on respective fragment, but we
-	 * need to calculate last_hdr_idx offset based on whole packet.
-	 */
-	pkt_offset = 0;
-	frag = pkt->frags;
-	while (frag) {
-		if (last_hdr_frag == frag) {
-			*last_hdr_idx += pkt_offset;
-			break;
-		}
-
-		pkt_offset += frag->len;
-		frag = frag->frags;
-	}
-
-	return 0;
 }
 
 const struct in6_addr *net_ipv6_unspecified_address(void)
@@ -3007,8 +3005,7 @@ static enum net_verdict handle_mld_query(struct net_pkt *pkt)
 	u16_t total_len = net_pkt_get_len(pkt);
 	struct in6_addr mcast;
 	u16_t max_rsp_code, num_src, pkt_len;
-	u16_t offset, pos;
-	struct net_buf *frag;
+	struct net_pkt_cursor cursor;
 
 	dbg_addr_recv("Multicast Listener Query",
 		      &NET_IPV6_HDR(pkt)->src,
@@ -3016,19 +3013,16 @@ static enum net_verdict handle_mld_query(struct net_pkt *pkt)
 
 	net_stats_update_ipv6_mld_recv(net_pkt_iface(pkt));
 
-	/* offset tells now where the ICMPv6 header is starting */
-	frag = net_frag_get_pos(pkt,
+	/* The query starts after the ICMPv6 header */
+	if (net_pkt_cursor_init(&cursor, pkt,
 				net_pkt_ip_hdr_len(pkt) +
 				net_pkt_ipv6_ext_len(pkt) +
-				sizeof(struct net_icmp_hdr),
-				&offset);
-
-	frag = net_frag_read_be16(frag, offset, &pos, &max_rsp_code);
-	frag = net_frag_skip(frag, pos, &pos, 2); /* two reserved bytes */
-	frag = net_frag_read(frag, pos, &pos, sizeof(mcast), mcast.s6_addr);
-	frag = net_frag_skip(frag, pos, &pos, 2); /* skip S, QRV & QQIC */
-	frag = net_frag_read_be16(pkt->frags, pos, &pos, &num_src);
-	if (!frag && pos == 0xffff) {
+				sizeof(struct net_icmp_hdr)) < 0 ||
+	    net_pkt_cursor_read_be16(&cursor, &max_rsp_code) < 0 ||
+	    net_pkt_cursor_skip(&cursor, 2) < 0 || /* two reserved bytes */
+	    net_pkt_cursor_read(&cursor, mcast.s6_addr, sizeof(mcast)) < 0 ||
+	    net_pkt_cursor_skip(&cursor, 2) < 0 || /* skip S, QRV & QQIC */
+	    net_pkt_cursor_read_be16(&cursor, &num_src) < 0) {
 		goto drop;
 	}
 
@@ -3407,10 +3401,8 @@ static int shift_packets(struct net_ipv6_reassembly *reass, int pos)
 }
 
 static enum net_verdict handle_fragment_hdr(struct net_pkt *pkt,
-					    struct net_buf *frag,
+					    struct net_pkt_cursor *cursor,
 					    int total_len,
-					    u16_t buf_offset,
-					    u16_t *loc,
 					    u8_t nexthdr)
 {
 	struct net_ipv6_reassembly *reass = NULL;
@@ -3434,10 +3426,9 @@ static enum net_verdict handle_fragment_hdr(struct net_pkt *pkt,
 	}
 
 	/* Each fragment has a fragment header. */
-	frag = net_frag_skip(frag, buf_offset, loc, 1); /* reserved */
-	frag = net_frag_read_be16(frag, *loc, loc, &flag);
-	frag = net_frag_read_be32(frag, *loc, loc, &id);
-	if (!frag && *loc == 0xffff) {
+	if (net_pkt_cursor_skip(cursor, 1) < 0 || /* reserved */
+	    net_pkt_cursor_read_be16(cursor, &flag) < 0 ||
+	    net_pkt_cursor_read_be32(cursor, &id) < 0) {
 		goto drop;
 	}
 
@@ -3837,113 +3828,86 @@ static inline struct net_pkt *check_unknown_option(struct net_pkt *pkt,
 	return pkt;
 }
 
-static inline struct net_buf *handle_ext_hdr_options(struct net_pkt *pkt,
-						     struct net_buf *frag,
-						     int total_len,
-						     u16_t len,
-						     u16_t offset,
-						     u16_t *pos,
-						     enum net_verdict *verdict)
+static enum net_verdict handle_ext_hdr_options(struct net_pkt *pkt,
+					       struct net_pkt_cursor *cursor,
+					       int total_len,
+					       u16_t len)
 {
 	u8_t opt_type, opt_len;
-	u16_t length = 0, loc;
+	u16_t length = 0;
 #if defined(CONFIG_NET_RPL)
+	struct net_buf *frag;
+	u16_t pos;
 	bool result;
 #endif
 
 	if (len > total_len) {
 		NET_DBG("Corrupted packet, extension header %d too long "
 			"(max %d bytes)", len, total_len);
-		*verdict = NET_DROP;
-		return NULL;
+		goto drop;
 	}
 
 	length += 2;
 
-	/* Each extension option has type and length */
-	frag = net_frag_read_u8(frag, offset, &loc, &opt_type);
-	if (!frag && loc == 0xffff) {
-		goto drop;
-	}
+	while (length < len) {
+		/* Each extension option has type and length */
+		if (net_pkt_cursor_read_u8(cursor, &opt_type) < 0) {
+			goto drop;
+		}
+
+		if (opt_type == NET_IPV6_EXT_HDR_OPT_PAD1) {
+			length++;
+			continue;
+		}
 
-	if (opt_type != NET_IPV6_EXT_HDR_OPT_PAD1) {
-		frag = net_frag_read_u8(frag, loc, &loc, &opt_len);
-		if (!frag && loc == 0xffff) {
+		if (net_pkt_cursor_read_u8(cursor, &opt_len) < 0) {
 			goto drop;
 		}
-	}
 
-	while (frag && (length < len)) {
 		switch (opt_type) {
-		case NET_IPV6_EXT_HDR_OPT_PAD1:
-			length++;
-			break;
 		case NET_IPV6_EXT_HDR_OPT_PADN:
 			NET_DBG("PADN option");
-			length += opt_len + 2;
-			loc += opt_len + 2;
 			break;
 #if defined(CONFIG_NET_RPL)
 		case NET_IPV6_EXT_HDR_OPT_RPL:
 			NET_DBG("Processing RPL option");
-			frag = net_rpl_verify_header(pkt, frag, loc, &loc,
+			frag = net_rpl_verify_header(pkt, cursor->frag,
+						     cursor->pos, &pos,
 						     &result);
 			if (!result) {
 				NET_DBG("RPL option error, packet dropped");
 				goto drop;
 			}
 
-			if (!frag && *pos == 0xffff) {
+			if (!frag && pos == 0xffff) {
 				goto drop;
 			}
 
-			*verdict = NET_CONTINUE;
-			return frag;
+			break;
 #endif
 		default:
 			if (!check_unknown_option(pkt, opt_type, length)) {
 				goto drop;
 			}
 
-			length += opt_len + 2;
-
-			/* No need to +2 here as loc already contains option
-			 * header len.
-			 */
-			loc += opt_len;
-
 			break;
 		}
 
-		if (length >= len) {
-			break;
-		}
+		length += opt_len + 2;
 
-		frag = net_frag_read_u8(frag, loc, &loc, &opt_type);
-		if (!frag && loc == 0xffff) {
+		if (net_pkt_cursor_skip(cursor, opt_len) < 0) {
 			goto drop;
 		}
-
-		if (opt_type != NET_IPV6_EXT_HDR_OPT_PAD1) {
-			frag = net_frag_read_u8(frag, loc, &loc, &opt_len);
-			if (!frag && loc == 0xffff) {
-				goto drop;
-			}
-		}
 	}
 
 	if (length != len) {
 		goto drop;
 	}
 
-	*pos = loc;
-
-	*verdict = NET_CONTINUE;
-	return frag;
+	return NET_CONTINUE;
 
 drop:
-	*verdict = NET_DROP;
-	return NULL;
+	return NET_DROP;
 }
 
 static inline bool is_upper_layer_protocol_header(u8_t proto)
@@ -4062,11 +4026,11 @@ enum net_verdict net_ipv6_process_pkt(struct net_pkt *pkt)
 	struct net_ipv6_hdr *hdr = NET_IPV6_HDR(pkt);
 	int real_len = net_pkt_get_len(pkt);
 	int pkt_len = (hdr->len[0] << 8) + hdr->len[1] + sizeof(*hdr);
-	struct net_buf *frag;
+	struct net_pkt_cursor cursor;
 	u8_t start_of_ext, prev_hdr;
 	u8_t next, next_hdr;
 	u8_t first_option;
-	u16_t offset;
+	u8_t hdr_len;
 	u16_t length;
 	u16_t total_len = 0;
 	u8_t ext_bitmap;
@@ -4144,16 +4108,14 @@ enum net_verdict net_ipv6_process_pkt(struct net_pkt *pkt)
 	}
 
 	/* Go through the extensions */
-	frag = pkt->frags;
+	net_pkt_cursor_init(&cursor, pkt, sizeof(struct net_ipv6_hdr));
 	next = hdr->nexthdr;
 	first_option = next;
-	length = 0;
 	ext_bitmap = 0;
 	start_of_ext = 0;
-	offset = sizeof(struct net_ipv6_hdr);
 	prev_hdr = &NET_IPV6_HDR(pkt)->nexthdr - &NET_IPV6_HDR(pkt)->vtc;
 
-	while (frag) {
+	while (1) {
 		enum net_verdict verdict;
 
 		if (is_upper_layer_protocol_header(next)) {
@@ -4162,11 +4124,10 @@ enum net_verdict net_ipv6_process_pkt(struct net_pkt *pkt)
 		}
 
 		if (!start_of_ext) {
-			start_of_ext = offset;
+			start_of_ext = cursor.offset;
 		}
 
-		frag = net_frag_read_u8(frag, offset, &offset, &next_hdr);
-		if (!frag) {
+		if (net_pkt_cursor_read_u8(&cursor, &next_hdr) < 0) {
 			goto drop;
 		}
 
@@ -4184,13 +4145,11 @@ enum net_verdict net_ipv6_process_pkt(struct net_pkt *pkt)
 			goto drop;
 
 		case NET_IPV6_NEXTHDR_HBHO:
-			frag = net_frag_read_u8(frag, offset, &offset,
-						(u8_t *)&length);
-			if (!frag) {
+			if (net_pkt_cursor_read_u8(&cursor, &hdr_len) < 0) {
 				goto drop;
 			}
 
-			length = length * 8 + 8;
+			length = hdr_len * 8 + 8;
 			total_len += length;
 
 			/* HBH option needs to be the first one */
@@ -4205,9 +4164,8 @@ enum net_verdict net_ipv6_process_pkt(struct net_pkt *pkt)
 
 			ext_bitmap |= NET_IPV6_EXT_HDR_BITMAP_HBHO;
 
-			frag = handle_ext_hdr_options(pkt, frag, real_len,
-						      length, offset, &offset,
-						      &verdict);
+			verdict = handle_ext_hdr_options(pkt, &cursor,
+							 real_len, length);
 			break;
 
 #if defined(CONFIG_NET_IPV6_FRAGMENT)
@@ -4220,8 +4178,8 @@ enum net_verdict net_ipv6_process_pkt(struct net_pkt *pkt)
 							total_len);
 
 			total_len += 8;
-			return handle_fragment_hdr(pkt, frag, real_len, offset,
-						   &offset, next_hdr);
+			return handle_fragment_hdr(pkt, &cursor, real_len,
+						   next_hdr);
 #endif
 		default:
 			goto bad_hdr;
@@ -4264,7 +4222,7 @@ bad_hdr:
 	 */
 	net_icmpv6_send_error(pkt, NET_ICMPV6_PARAM_PROBLEM,
 			      NET_ICMPV6_PARAM_PROB_NEXTHEADER,
-			      offset - 1);
+			      cursor.offset - 1);
 
 	NET_DBG("Unknown next header type");
 	net_stats_update_ip_errors_protoerr(net_pkt_iface(pkt));
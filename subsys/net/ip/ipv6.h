@@ -14,6 +14,7 @@
 #define __IPV6_H
 
 #include <zephyr/types.h>
+#include <misc/slist.h>
 
 #include <net/net_ip.h>
 #include <net/net_pkt.h>
@@ -80,6 +81,9 @@ const char *net_ipv6_nbr_state2str(enum net_ipv6_nbr_state state);
  * @brief IPv6 neighbor information.
  */
 struct net_ipv6_nbr_data {
+	/** Link in the neighbor address hash. */
+	sys_snode_t node;
+
 	/** Any pending packet waiting ND to finish. */
 	struct net_pkt *pending;
 
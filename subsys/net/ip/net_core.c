@@ -307,12 +307,8 @@ static void net_rx(struct net_if *iface, struct net_pkt *pkt)
 	net_pkt_print();
 }
 
-static void process_rx_packet(struct k_work *work)
+void net_process_rx_packet(struct net_pkt *pkt)
 {
-	struct net_pkt *pkt;
-
-	pkt = CONTAINER_OF(work, struct net_pkt, work);
-
 	net_rx(net_pkt_iface(pkt), pkt);
 }
 
@@ -321,8 +317,6 @@ static void net_queue_rx(struct net_if *iface, struct net_pkt *pkt)
 	u8_t prio = net_pkt_priority(pkt);
 	u8_t tc = net_rx_priority2tc(prio);
 
-	k_work_init(net_pkt_work(pkt), process_rx_packet);
-
 #if defined(CONFIG_NET_STATISTICS)
 	pkt->total_pkt_len = net_pkt_get_len(pkt);
 
@@ -134,6 +134,22 @@ static inline void net_context_send_cb(struct net_context *context,
 	}
 }
 
+static void net_if_tx_done(struct net_if *iface,
+			   struct net_context *context, void *context_token,
+			   struct net_linkaddr *dst, int status)
+{
+	if (context) {
+		NET_DBG("Calling context send cb %p token %p status %d",
+			context, context_token, status);
+
+		net_context_send_cb(context, context_token, status);
+	}
+
+	if (dst->addr) {
+		net_if_call_link_cb(iface, dst, status);
+	}
+}
+
 static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
 {
 	const struct net_if_api *api = net_if_get_device(iface)->driver_api;
@@ -175,27 +191,78 @@ static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
 		net_stats_update_bytes_sent(iface, pkt->total_pkt_len);
 	}
 
-	if (context) {
-		NET_DBG("Calling context send cb %p token %p status %d",
-			context, context_token, status);
+	net_if_tx_done(iface, context, context_token, dst, status);
 
-		net_context_send_cb(context, context_token, status);
-	}
+	return true;
+}
 
-	if (dst->addr) {
-		net_if_call_link_cb(iface, dst, status);
+/* The packets are referenced while the driver sends them, so that they
+ * can still be looked at when the driver has released them. The packets
+ * the driver did not send go through net_if_tx() one at a time.
+ */
+static void net_if_tx_batch(struct net_if *iface, struct net_pkt *pkts[],
+			    int count)
+{
+	const struct net_if_api *api = net_if_get_device(iface)->driver_api;
+	int sent = 0;
+	int i;
+
+	if (count > 1 && api->send_batch &&
+	    atomic_test_bit(iface->if_dev->flags, NET_IF_UP)) {
+		for (i = 0; i < count; i++) {
+			debug_check_packet(pkts[i]);
+
+			net_pkt_ref(pkts[i]);
+
+			if (IS_ENABLED(CONFIG_NET_TCP)) {
+				net_pkt_set_sent(pkts[i], true);
+				net_pkt_set_queued(pkts[i], false);
+			}
+		}
+
+		sent = api->send_batch(iface, pkts, count);
+		if (sent < 0) {
+			sent = 0;
+		}
+
+		for (i = 0; i < count; i++) {
+			if (i < sent) {
+				net_stats_update_bytes_sent(iface,
+						pkts[i]->total_pkt_len);
+				net_if_tx_done(iface, net_pkt_context(pkts[i]),
+					       net_pkt_token(pkts[i]),
+					       net_pkt_ll_dst(pkts[i]), 0);
+			} else if (IS_ENABLED(CONFIG_NET_TCP)) {
+				net_pkt_set_sent(pkts[i], false);
+			}
+
+			net_pkt_unref(pkts[i]);
+		}
 	}
 
-	return true;
+	for (i = sent; i < count; i++) {
+		net_if_tx(iface, pkts[i]);
+	}
 }
 
-static void process_tx_packet(struct k_work *work)
+void net_if_process_tx_packets(struct net_pkt *pkts[], int count)
 {
-	struct net_pkt *pkt;
+	int i, start;
 
-	pkt = CONTAINER_OF(work, struct net_pkt, work);
+	for (i = 0; i < count; i++) {
+		atomic_clear_bit(net_pkt_work(pkts[i])->flags,
+				 K_WORK_STATE_PENDING);
+	}
 
-	net_if_tx(net_pkt_iface(pkt), pkt);
+	/* Packets to the same interface are sent together */
+	for (start = 0, i = 1; i <= count; i++) {
+		if (i == count ||
+		    net_pkt_iface(pkts[i]) != net_pkt_iface(pkts[start])) {
+			net_if_tx_batch(net_pkt_iface(pkts[start]),
+					&pkts[start], i - start);
+			start = i;
+		}
+	}
 }
 
 void net_if_queue_tx(struct net_if *iface, struct net_pkt *pkt)
@@ -203,7 +270,14 @@ void net_if_queue_tx(struct net_if *iface, struct net_pkt *pkt)
 	u8_t prio = net_pkt_priority(pkt);
 	u8_t tc = net_tx_priority2tc(prio);
 
-	k_work_init(net_pkt_work(pkt), process_tx_packet);
+	/* As when the packet was queued as a work item, a packet that is
+	 * still waiting to be sent, such as a TCP segment resent before
+	 * it got out, is not queued again.
+	 */
+	if (atomic_test_and_set_bit(net_pkt_work(pkt)->flags,
+				    K_WORK_STATE_PENDING)) {
+		return;
+	}
 
 #if defined(CONFIG_NET_STATISTICS)
 	pkt->total_pkt_len = net_pkt_get_len(pkt);
@@ -85,8 +85,28 @@ NET_PKT_SLAB_DEFINE(rx_pkts, CONFIG_NET_PKT_RX_COUNT);
 NET_PKT_SLAB_DEFINE(tx_pkts, CONFIG_NET_PKT_TX_COUNT);
 
 /* The data fragment pool is for storing network data. */
+#if defined(CONFIG_NET_BUF_VARIABLE_DATA_SIZE)
+NET_PKT_DATA_VAR_POOL_DEFINE(rx_bufs, CONFIG_NET_BUF_RX_COUNT,
+			     CONFIG_NET_BUF_DATA_POOL_SIZE);
+NET_PKT_DATA_VAR_POOL_DEFINE(tx_bufs, CONFIG_NET_BUF_TX_COUNT,
+			     CONFIG_NET_BUF_DATA_POOL_SIZE);
+
+/* The memory pool places the quarters of a block, rounded up to 4 bytes,
+ * next to each other. Each level has to be exactly four times the next
+ * one, or the last quarter overlaps the following block.
+ */
+#define DATA_VAR_LEVEL_OK(sz) ((sz) <= NET_PKT_DATA_VAR_MIN_SIZE ||	\
+			       _ALIGN4((sz) / 4) * 4 == (sz))
+
+BUILD_ASSERT_MSG(DATA_VAR_LEVEL_OK(NET_PKT_DATA_VAR_BLOCK_SIZE) &&
+		 DATA_VAR_LEVEL_OK(NET_PKT_DATA_VAR_BLOCK_SIZE / 4) &&
+		 DATA_VAR_LEVEL_OK(NET_PKT_DATA_VAR_BLOCK_SIZE / 16) &&
+		 DATA_VAR_LEVEL_OK(NET_PKT_DATA_VAR_BLOCK_SIZE / 64),
+		 "Data pool blocks do not split in exact quarters");
+#else
 NET_PKT_DATA_POOL_DEFINE(rx_bufs, CONFIG_NET_BUF_RX_COUNT);
 NET_PKT_DATA_POOL_DEFINE(tx_bufs, CONFIG_NET_BUF_TX_COUNT);
+#endif
 
 #if defined(CONFIG_NET_DEBUG_NET_PKT)
 
@@ -332,16 +352,37 @@ struct net_pkt *net_pkt_get_reserve(struct k_mem_slab *slab,
 	return pkt;
 }
 
+/* Fixed size pools always give fragments of their own size. The data
+ * of the other ones is allocated in the requested size, which must fit
+ * a block of a memory pool along with the k_mem_block_id and reference
+ * count the net_buf allocator puts in front of it.
+ */
+static struct net_buf *data_alloc(struct net_buf_pool *pool, size_t size,
+				  s32_t timeout)
+{
+	if (pool->alloc->cb == &net_buf_fixed_cb) {
+		return net_buf_alloc(pool, timeout);
+	}
+
+	if (pool->alloc->cb == &net_buf_var_cb) {
+		struct k_mem_pool *mem_pool = pool->alloc->alloc_data;
+
+		size = min(size, mem_pool->base.max_sz -
+			   sizeof(struct k_mem_block_id) - 1);
+	}
+
+	return net_buf_alloc_len(pool, size, timeout);
+}
+
 #if defined(CONFIG_NET_DEBUG_NET_PKT)
-struct net_buf *net_pkt_get_reserve_data_debug(struct net_buf_pool *pool,
-					       u16_t reserve_head,
-					       s32_t timeout,
-					       const char *caller,
-					       int line)
+static struct net_buf *get_reserve_data_len(struct net_buf_pool *pool,
+					    size_t size, u16_t reserve_head,
+					    s32_t timeout,
+					    const char *caller, int line)
 #else /* CONFIG_NET_DEBUG_NET_PKT */
-struct net_buf *net_pkt_get_reserve_data(struct net_buf_pool *pool,
-					 u16_t reserve_head,
-					 s32_t timeout)
+static struct net_buf *get_reserve_data_len(struct net_buf_pool *pool,
+					    size_t size, u16_t reserve_head,
+					    s32_t timeout)
 #endif /* CONFIG_NET_DEBUG_NET_PKT */
 {
 	struct net_buf *frag;
@@ -352,9 +393,9 @@ struct net_buf *net_pkt_get_reserve_data(struct net_buf_pool *pool,
 	 */
 
 	if (k_is_in_isr()) {
-		frag = net_buf_alloc(pool, K_NO_WAIT);
+		frag = data_alloc(pool, size, K_NO_WAIT);
 	} else {
-		frag = net_buf_alloc(pool, timeout);
+		frag = data_alloc(pool, size, timeout);
 	}
 
 	if (!frag) {
@@ -376,54 +417,83 @@ struct net_buf *net_pkt_get_reserve_data(struct net_buf_pool *pool,
 	return frag;
 }
 
-/* Get a fragment, try to figure out the pool from where to get
- * the data.
- */
 #if defined(CONFIG_NET_DEBUG_NET_PKT)
-struct net_buf *net_pkt_get_frag_debug(struct net_pkt *pkt,
-				       s32_t timeout,
-				       const char *caller, int line)
-#else
-struct net_buf *net_pkt_get_frag(struct net_pkt *pkt,
-				 s32_t timeout)
-#endif
+struct net_buf *net_pkt_get_reserve_data_debug(struct net_buf_pool *pool,
+					       u16_t reserve_head,
+					       s32_t timeout,
+					       const char *caller,
+					       int line)
+{
+	return get_reserve_data_len(pool, CONFIG_NET_BUF_DATA_SIZE,
+				    reserve_head, timeout, caller, line);
+}
+#else /* CONFIG_NET_DEBUG_NET_PKT */
+struct net_buf *net_pkt_get_reserve_data(struct net_buf_pool *pool,
+					 u16_t reserve_head,
+					 s32_t timeout)
+{
+	return get_reserve_data_len(pool, CONFIG_NET_BUF_DATA_SIZE,
+				    reserve_head, timeout);
+}
+#endif /* CONFIG_NET_DEBUG_NET_PKT */
+
+/* Try to figure out the pool from where to get the data of a fragment */
+static struct net_buf_pool *get_frag_pool(struct net_pkt *pkt)
 {
 #if defined(CONFIG_NET_CONTEXT_NET_PKT_POOL)
 	struct net_context *context;
 
 	context = net_pkt_context(pkt);
 	if (context && context->data_pool) {
-#if defined(CONFIG_NET_DEBUG_NET_PKT)
-		return net_pkt_get_reserve_data_debug(context->data_pool(),
-						      net_pkt_ll_reserve(pkt),
-						      timeout, caller, line);
-#else
-		return net_pkt_get_reserve_data(context->data_pool(),
-						net_pkt_ll_reserve(pkt),
-						timeout);
-#endif /* CONFIG_NET_DEBUG_NET_PKT */
+		return context->data_pool();
 	}
 #endif /* CONFIG_NET_CONTEXT_NET_PKT_POOL */
 
 	if (pkt->slab == &rx_pkts) {
-#if defined(CONFIG_NET_DEBUG_NET_PKT)
-		return net_pkt_get_reserve_rx_data_debug(
-			net_pkt_ll_reserve(pkt), timeout, caller, line);
-#else
-		return net_pkt_get_reserve_rx_data(net_pkt_ll_reserve(pkt),
-						   timeout);
-#endif
+		return &rx_bufs;
 	}
 
+	return &tx_bufs;
+}
+
 #if defined(CONFIG_NET_DEBUG_NET_PKT)
-	return net_pkt_get_reserve_tx_data_debug(net_pkt_ll_reserve(pkt),
-						 timeout, caller, line);
-#else
-	return net_pkt_get_reserve_tx_data(net_pkt_ll_reserve(pkt),
-					   timeout);
-#endif
+struct net_buf *net_pkt_get_frag_debug(struct net_pkt *pkt,
+				       s32_t timeout,
+				       const char *caller, int line)
+{
+	return get_reserve_data_len(get_frag_pool(pkt),
+				    CONFIG_NET_BUF_DATA_SIZE,
+				    net_pkt_ll_reserve(pkt), timeout,
+				    caller, line);
 }
 
+struct net_buf *net_pkt_get_frag_len_debug(struct net_pkt *pkt, u16_t len,
+					   s32_t timeout,
+					   const char *caller, int line)
+{
+	return get_reserve_data_len(get_frag_pool(pkt),
+				    net_pkt_ll_reserve(pkt) + len,
+				    net_pkt_ll_reserve(pkt), timeout,
+				    caller, line);
+}
+#else /* CONFIG_NET_DEBUG_NET_PKT */
+struct net_buf *net_pkt_get_frag(struct net_pkt *pkt,
+				 s32_t timeout)
+{
+	return get_reserve_data_len(get_frag_pool(pkt),
+				    CONFIG_NET_BUF_DATA_SIZE,
+				    net_pkt_ll_reserve(pkt), timeout);
+}
+
+struct net_buf *net_pkt_get_frag_len(struct net_pkt *pkt, u16_t len,
+				     s32_t timeout)
+{
+	return get_reserve_data_len(get_frag_pool(pkt),
+				    net_pkt_ll_reserve(pkt) + len,
+				    net_pkt_ll_reserve(pkt), timeout);
+}
+#endif /* CONFIG_NET_DEBUG_NET_PKT */
+
 #if defined(CONFIG_NET_DEBUG_NET_PKT)
 struct net_pkt *net_pkt_get_reserve_rx_debug(u16_t reserve_head,
 					     s32_t timeout,
@@ -948,7 +1018,7 @@ struct net_buf *net_pkt_copy(struct net_pkt *pkt, size_t amount,
 
 	orig = pkt->frags;
 
-	frag = net_pkt_get_frag(pkt, timeout);
+	frag = net_pkt_get_frag_len(pkt, reserve + amount, timeout);
 	if (!frag) {
 		return NULL;
 	}
@@ -1002,7 +1072,8 @@ struct net_buf *net_pkt_copy(struct net_pkt *pkt, size_t amount,
 				 * We must allocate a new one.
 				 */
 				struct net_buf *new_frag =
-					net_pkt_get_frag(pkt, timeout);
+					net_pkt_get_frag_len(pkt, amount,
+							     timeout);
 				if (!new_frag) {
 					net_pkt_frag_unref(first);
 					return NULL;
@@ -1202,7 +1273,7 @@ static inline u16_t net_pkt_append_bytes(struct net_pkt *pkt,
 			return added_len;
 		}
 
-		frag = net_pkt_get_frag(pkt, timeout);
+		frag = net_pkt_get_frag_len(pkt, len, timeout);
 		if (!frag) {
 			return added_len;
 		}
@@ -1226,7 +1297,7 @@ u16_t net_pkt_append(struct net_pkt *pkt, u16_t len, const u8_t *data,
 	}
 
 	if (!pkt->frags) {
-		frag = net_pkt_get_frag(pkt, timeout);
+		frag = net_pkt_get_frag_len(pkt, len, timeout);
 		if (!frag) {
 			return 0;
 		}
@@ -1536,6 +1607,141 @@ error:
 	return NULL;
 }
 
+int net_pkt_cursor_init(struct net_pkt_cursor *cursor, struct net_pkt *pkt,
+			u16_t offset)
+{
+	struct net_buf *frag = pkt->frags;
+	u16_t pos = offset;
+
+	/* As with net_frag_skip(), the end of a fragment is the start of
+	 * the next one. Only the end of the last fragment is kept.
+	 */
+	while (frag && pos >= frag->len && frag->frags) {
+		pos -= frag->len;
+		frag = frag->frags;
+	}
+
+	if (frag ? pos > frag->len : pos) {
+		return -ENODATA;
+	}
+
+	cursor->pkt = pkt;
+	cursor->frag = frag;
+	cursor->pos = pos;
+	cursor->offset = offset;
+
+	return 0;
+}
+
+void net_pkt_cursor_init_frag(struct net_pkt_cursor *cursor,
+			      struct net_pkt *pkt, struct net_buf *frag,
+			      u16_t pos)
+{
+	struct net_buf *tmp;
+
+	cursor->pkt = pkt;
+	cursor->frag = frag;
+	cursor->pos = pos;
+	cursor->offset = pos;
+
+	for (tmp = pkt->frags; tmp && tmp != frag; tmp = tmp->frags) {
+		cursor->offset += tmp->len;
+	}
+}
+
+int net_pkt_cursor_read(struct net_pkt_cursor *cursor, void *data,
+			u16_t len)
+{
+	struct net_buf *frag = cursor->frag;
+	u16_t pos = cursor->pos;
+	u8_t *ptr = data;
+	u16_t left = len;
+
+	while (left) {
+		u16_t count;
+
+		if (!frag) {
+			return -ENODATA;
+		}
+
+		if (pos >= frag->len) {
+			frag = frag->frags;
+			pos = 0;
+			continue;
+		}
+
+		count = min(left, frag->len - pos);
+
+		if (ptr) {
+			memcpy(ptr, frag->data + pos, count);
+			ptr += count;
+		}
+
+		pos += count;
+		left -= count;
+	}
+
+	cursor->frag = frag;
+	cursor->pos = pos;
+	cursor->offset += len;
+
+	return 0;
+}
+
+int net_pkt_cursor_write(struct net_pkt_cursor *cursor, const void *data,
+			 u16_t len, s32_t timeout)
+{
+	struct net_buf *frag = cursor->frag;
+	u16_t pos = cursor->pos;
+	const u8_t *ptr = data;
+	u16_t left = len;
+
+	while (left) {
+		u16_t count;
+
+		if (!frag) {
+			frag = net_pkt_get_frag_len(cursor->pkt, left, timeout);
+			if (!frag) {
+				return -ENOMEM;
+			}
+
+			net_pkt_frag_add(cursor->pkt, frag);
+			pos = 0;
+		}
+
+		if (pos < frag->len) {
+			/* Overwrite existing data */
+			count = min(left, frag->len - pos);
+			memcpy(frag->data + pos, ptr, count);
+		} else if (frag->frags) {
+			frag = frag->frags;
+			pos = 0;
+			continue;
+		} else {
+			/* Append to the last fragment, or to a new one once
+			 * there is no tailroom left.
+			 */
+			count = min(left, net_buf_tailroom(frag));
+			if (!count) {
+				frag = NULL;
+				continue;
+			}
+
+			net_buf_add_mem(frag, ptr, count);
+		}
+
+		pos += count;
+		ptr += count;
+		left -= count;
+	}
+
+	cursor->frag = frag;
+	cursor->pos = pos;
+	cursor->offset += len;
+
+	return 0;
+}
+
 static inline bool insert_data(struct net_pkt *pkt, struct net_buf *frag,
 			       struct net_buf *temp, u16_t offset,
 			       u16_t len, u8_t *data,
@@ -50,6 +50,8 @@ extern void net_tc_tx_init(void);
 extern void net_tc_rx_init(void);
 extern void net_tc_submit_to_tx_queue(u8_t tc, struct net_pkt *pkt);
 extern void net_tc_submit_to_rx_queue(u8_t tc, struct net_pkt *pkt);
+extern void net_process_rx_packet(struct net_pkt *pkt);
+extern void net_if_process_tx_packets(struct net_pkt *pkts[], int count);
 extern enum net_verdict net_promisc_mode_input(struct net_pkt *pkt);
 
 #if defined(CONFIG_NET_GPTP)
@@ -168,6 +170,68 @@ static inline u16_t net_calc_chksum_tcp(struct net_pkt *pkt)
 	return net_calc_chksum(pkt, IPPROTO_TCP);
 }
 
+/* Update a checksum for a change of the data it covers from old_data to
+ * new_data, both len bytes long and starting at an even offset, without
+ * summing the rest of the data again (RFC 1624). The checksum is in host
+ * byte order, as read with ntohs() from the header.
+ */
+extern u16_t net_chksum_update(u16_t chksum, const void *old_data,
+			       const void *new_data, u16_t len);
+
+/* Same for a 16-bit field, old_val and new_val in host byte order */
+static inline u16_t net_chksum_update_16(u16_t chksum, u16_t old_val,
+					 u16_t new_val)
+{
+	u32_t sum;
+
+	/* HC' = ~(~HC + ~m + m') */
+	sum = (u16_t)~chksum + (u16_t)~old_val + new_val;
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return ~sum;
+}
+
+/* Same for a 32-bit field at an even offset */
+static inline u16_t net_chksum_update_32(u16_t chksum, u32_t old_val,
+					 u32_t new_val)
+{
+	chksum = net_chksum_update_16(chksum, old_val >> 16, new_val >> 16);
+
+	return net_chksum_update_16(chksum, old_val, new_val);
+}
+
+/* Multiplicative hashing for the lookup tables of the stack. Each 32-bit
+ * word of the key is mixed in with net_hash_u32(), which multiplies by
+ * the golden ratio, and net_hash_bucket() takes the top bits of the
+ * result, which depend on all bits of the key, as the bucket index.
+ */
+#define NET_HASH_MULT 0x9e3779b1
+
+static inline u32_t net_hash_u32(u32_t hash, u32_t val)
+{
+	return (hash ^ val) * NET_HASH_MULT;
+}
+
+/* Same for count words, which need not be aligned */
+static inline u32_t net_hash_words(u32_t hash, const void *data, int count)
+{
+	const u32_t *ptr = data;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		hash = net_hash_u32(hash, UNALIGNED_GET(&ptr[i]));
+	}
+
+	return hash;
+}
+
+/* Index in a table of 2^bits buckets */
+static inline u32_t net_hash_bucket(u32_t hash, int bits)
+{
+	return hash >> (32 - bits);
+}
+
 #if NET_LOG_ENABLED > 0
 static inline char *net_sprint_ll_addr(const u8_t *ll, u8_t ll_len)
 {
@@ -724,25 +724,21 @@ static void get_addresses(struct net_context *context,
 {
 #if defined(CONFIG_NET_IPV6)
 	if (context->local.family == AF_INET6) {
-		snprintk(addr_local, local_len, "[%s]:%u",
-			 net_sprint_ipv6_addr(
-				 net_sin6_ptr(&context->local)->sin6_addr),
+		snprintk(addr_local, local_len, "[%pI6]:%u",
+			 net_sin6_ptr(&context->local)->sin6_addr,
 			 ntohs(net_sin6_ptr(&context->local)->sin6_port));
-		snprintk(addr_remote, remote_len, "[%s]:%u",
-			 net_sprint_ipv6_addr(
-				 &net_sin6(&context->remote)->sin6_addr),
+		snprintk(addr_remote, remote_len, "[%pI6]:%u",
+			 &net_sin6(&context->remote)->sin6_addr,
 			 ntohs(net_sin6(&context->remote)->sin6_port));
 	} else
 #endif
 #if defined(CONFIG_NET_IPV4)
 	if (context->local.family == AF_INET) {
-		snprintk(addr_local, local_len, "%s:%d",
-			 net_sprint_ipv4_addr(
-				 net_sin_ptr(&context->local)->sin_addr),
+		snprintk(addr_local, local_len, "%pI4:%d",
+			 net_sin_ptr(&context->local)->sin_addr,
 			 ntohs(net_sin_ptr(&context->local)->sin_port));
-		snprintk(addr_remote, remote_len, "%s:%d",
-			 net_sprint_ipv4_addr(
-				 &net_sin(&context->remote)->sin_addr),
+		snprintk(addr_remote, remote_len, "%pI4:%d",
+			 &net_sin(&context->remote)->sin_addr,
 			 ntohs(net_sin(&context->remote)->sin_port));
 	} else
 #endif
@@ -912,18 +908,15 @@ static void ipv6_frag_cb(struct net_ipv6_reassembly *reass,
 			 void *user_data)
 {
 	int *count = user_data;
-	char src[ADDR_LEN];
 	int i;
 
 	if (!*count) {
 		printk("\nIPv6 reassembly Id         Remain Src             \tDst\n");
 	}
 
-	snprintk(src, ADDR_LEN, "%s", net_sprint_ipv6_addr(&reass->src));
-
-	printk("%p      0x%08x  %5d %16s\t%16s\n",
+	printk("%p      0x%08x  %5d %-16pI6\t%pI6\n",
 	       reass, reass->id, k_delayed_work_remaining_get(&reass->timer),
-	       src, net_sprint_ipv6_addr(&reass->dst));
+	       &reass->src, &reass->dst);
 
 	for (i = 0; i < NET_IPV6_FRAGMENTS_MAX_PKT; i++) {
 		if (reass->pkt[i]) {
@@ -2560,13 +2553,8 @@ static inline void _remove_ipv6_ping_handler(void)
 
 static enum net_verdict _handle_ipv6_echo_reply(struct net_pkt *pkt)
 {
-	char addr[NET_IPV6_ADDR_LEN];
-
-	snprintk(addr, sizeof(addr), "%s",
-		 net_sprint_ipv6_addr(&NET_IPV6_HDR(pkt)->dst));
-
-	printk("Received echo reply from %s to %s\n",
-	       net_sprint_ipv6_addr(&NET_IPV6_HDR(pkt)->src), addr);
+	printk("Received echo reply from %pI6 to %pI6\n",
+	       &NET_IPV6_HDR(pkt)->src, &NET_IPV6_HDR(pkt)->dst);
 
 	k_sem_give(&ping_timeout);
 	_remove_ipv6_ping_handler();
@@ -2638,13 +2626,8 @@ static inline void _remove_ipv4_ping_handler(void)
 
 static enum net_verdict _handle_ipv4_echo_reply(struct net_pkt *pkt)
 {
-	char addr[NET_IPV4_ADDR_LEN];
-
-	snprintk(addr, sizeof(addr), "%s",
-		 net_sprint_ipv4_addr(&NET_IPV4_HDR(pkt)->dst));
-
-	printk("Received echo reply from %s to %s\n",
-	       net_sprint_ipv4_addr(&NET_IPV4_HDR(pkt)->src), addr);
+	printk("Received echo reply from %pI4 to %pI4\n",
+	       &NET_IPV4_HDR(pkt)->src, &NET_IPV4_HDR(pkt)->dst);
 
 	k_sem_give(&ping_timeout);
 	_remove_ipv4_ping_handler();
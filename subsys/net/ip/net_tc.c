@@ -15,33 +15,195 @@
 #include <net/net_core.h>
 #include <net/net_pkt.h>
 #include <net/net_stats.h>
+#include <net/ethernet.h>
 
 #include "net_private.h"
 #include "net_stats.h"
 
-/* Stacks for TX work queue */
+/* Stacks for TX threads */
 NET_STACK_ARRAY_DEFINE(TX, tx_stack,
 		       CONFIG_NET_TX_STACK_SIZE,
 		       CONFIG_NET_TX_STACK_SIZE,
 		       NET_TC_TX_COUNT);
 
-/* Stacks for RX work queue */
+#define NET_RX_QUEUE_COUNT (NET_TC_RX_COUNT * CONFIG_NET_RX_FLOW_QUEUES)
+
+/* Stacks for RX threads */
 NET_STACK_ARRAY_DEFINE(RX, rx_stack,
 		       CONFIG_NET_RX_STACK_SIZE,
 		       CONFIG_NET_RX_STACK_SIZE + CONFIG_NET_RX_STACK_RPL,
-		       NET_TC_RX_COUNT);
+		       NET_RX_QUEUE_COUNT);
 
-static struct net_traffic_class tx_classes[NET_TC_TX_COUNT];
-static struct net_traffic_class rx_classes[NET_TC_RX_COUNT];
+/* Each TX traffic class has a queue, and each RX traffic class has
+ * CONFIG_NET_RX_FLOW_QUEUES queues, each one handled by its own thread.
+ * Packets are queued directly in the FIFO instead of through a work
+ * queue, so that a thread can process a batch of them before yielding.
+ */
+static struct net_traffic_class tx_queues[NET_TC_TX_COUNT];
+static struct net_traffic_class rx_queues[NET_RX_QUEUE_COUNT];
 
 void net_tc_submit_to_tx_queue(u8_t tc, struct net_pkt *pkt)
 {
-	k_work_submit_to_queue(&tx_classes[tc].work_q, net_pkt_work(pkt));
+	k_fifo_put(&tx_queues[tc].fifo, pkt);
+}
+
+static void tx_thread(void *p1, void *p2, void *p3)
+{
+	struct net_traffic_class *queue = p1;
+	struct net_pkt *pkts[CONFIG_NET_TX_BATCH_COUNT];
+	int count;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		pkts[0] = k_fifo_get(&queue->fifo, K_FOREVER);
+		if (!pkts[0]) {
+			continue;
+		}
+
+		for (count = 1; count < CONFIG_NET_TX_BATCH_COUNT; count++) {
+			pkts[count] = k_fifo_get(&queue->fifo, K_NO_WAIT);
+			if (!pkts[count]) {
+				break;
+			}
+		}
+
+		net_if_process_tx_packets(pkts, count);
+
+		k_yield();
+	}
+}
+
+#if CONFIG_NET_RX_FLOW_QUEUES > 1
+/* Length of the link layer header of a received packet, or -1 if the IP
+ * header cannot be found before the packet is processed by L2.
+ */
+static int rx_flow_ll_len(struct net_if *iface, struct net_buf *frag)
+{
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET)) {
+		int len = sizeof(struct net_eth_hdr);
+#if defined(CONFIG_NET_VLAN)
+		struct net_eth_hdr *hdr = (struct net_eth_hdr *)frag->data;
+
+		if (frag->len >= len &&
+		    ntohs(hdr->type) == NET_ETH_PTYPE_VLAN) {
+			len = sizeof(struct net_eth_vlan_hdr);
+		}
+#endif
+
+		return frag->len >= len ? len : -1;
+	}
+#endif
+
+#if defined(CONFIG_NET_L2_DUMMY)
+	if (net_if_l2(iface) == &NET_L2_GET_NAME(DUMMY)) {
+		return 0;
+	}
+#endif
+
+	return -1;
+}
+
+/* Hash of the addresses, protocol and ports of a received packet, so
+ * that all the packets of a flow are processed by the same RX thread.
+ * Only the headers found in the first fragment are used. The ports of
+ * fragmented IPv4 datagrams, and of IPv6 packets with extension headers,
+ * are left out.
+ */
+static u32_t rx_flow_hash(struct net_pkt *pkt)
+{
+	struct net_buf *frag = pkt->frags;
+	u32_t hash = 0;
+	u16_t hdr_len;
+	u8_t *data;
+	u8_t proto;
+	int len;
+
+	len = rx_flow_ll_len(net_pkt_iface(pkt), frag);
+	if (len < 0) {
+		return 0;
+	}
+
+	data = frag->data + len;
+	len = frag->len - len;
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) &&
+	    len >= sizeof(struct net_ipv6_hdr) && (data[0] & 0xf0) == 0x60) {
+		struct net_ipv6_hdr *hdr = (struct net_ipv6_hdr *)data;
+
+		proto = hdr->nexthdr;
+		hdr_len = sizeof(struct net_ipv6_hdr);
+
+		/* The source and destination addresses follow each other */
+		hash = net_hash_words(proto, &hdr->src, 8);
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
+		   len >= sizeof(struct net_ipv4_hdr) &&
+		   (data[0] & 0xf0) == 0x40) {
+		struct net_ipv4_hdr *hdr = (struct net_ipv4_hdr *)data;
+
+		proto = hdr->proto;
+		hdr_len = (hdr->vhl & 0x0f) * 4;
+
+		hash = net_hash_words(proto, &hdr->src, 2);
+
+		/* More fragments flag or fragment offset set */
+		if ((hdr->offset[0] & 0x3f) || hdr->offset[1]) {
+			return hash;
+		}
+	} else {
+		return 0;
+	}
+
+	if ((proto == IPPROTO_UDP || proto == IPPROTO_TCP) &&
+	    len >= hdr_len + 2 * sizeof(u16_t)) {
+		hash = net_hash_words(hash, data + hdr_len, 1);
+	}
+
+	return hash;
 }
+#endif /* CONFIG_NET_RX_FLOW_QUEUES > 1 */
 
 void net_tc_submit_to_rx_queue(u8_t tc, struct net_pkt *pkt)
 {
-	k_work_submit_to_queue(&rx_classes[tc].work_q, net_pkt_work(pkt));
+	int queue = tc * CONFIG_NET_RX_FLOW_QUEUES;
+
+#if CONFIG_NET_RX_FLOW_QUEUES > 1
+	/* The top bits of the hash depend on all of the flow fields */
+	queue += ((u64_t)rx_flow_hash(pkt) * CONFIG_NET_RX_FLOW_QUEUES) >> 32;
+#endif
+
+	k_fifo_put(&rx_queues[queue].fifo, pkt);
+}
+
+static void rx_thread(void *p1, void *p2, void *p3)
+{
+	struct net_traffic_class *queue = p1;
+	struct net_pkt *pkt;
+	int count;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		pkt = k_fifo_get(&queue->fifo, K_FOREVER);
+
+		for (count = 1; pkt; count++) {
+			net_process_rx_packet(pkt);
+
+			if (count == CONFIG_NET_RX_BATCH_COUNT) {
+				break;
+			}
+
+			pkt = k_fifo_get(&queue->fifo, K_NO_WAIT);
+		}
+
+		/* Let the other threads of the same priority, such as the
+		 * RX threads of other flows, run between the batches.
+		 */
+		k_yield();
+	}
 }
 
 int net_tx_priority2tc(enum net_priority prio)
@@ -323,7 +485,9 @@ void net_tc_tx_init(void)
 		u8_t thread_priority;
 
 		thread_priority = tx_tc2thread(i);
-		tx_classes[i].tc = thread_priority;
+		tx_queues[i].tc = thread_priority;
+
+		k_fifo_init(&tx_queues[i].fifo);
 
 #if defined(CONFIG_NET_SHELL)
 		/* Fix the thread start address so that "net stacks"
@@ -336,14 +500,14 @@ void net_tc_tx_init(void)
 
 		NET_DBG("[%d] Starting TX queue %p stack %p size %zd "
 			"prio %d (%d)", i,
-			&tx_classes[i].work_q.queue, TX_STACK(i),
+			&tx_queues[i].fifo, TX_STACK(i),
 			K_THREAD_STACK_SIZEOF(tx_stack[i]),
 			thread_priority, K_PRIO_COOP(thread_priority));
 
-		k_work_q_start(&tx_classes[i].work_q,
-			       tx_stack[i],
-			       K_THREAD_STACK_SIZEOF(tx_stack[i]),
-			       K_PRIO_COOP(thread_priority));
+		k_thread_create(&tx_queues[i].thread, tx_stack[i],
+				K_THREAD_STACK_SIZEOF(tx_stack[i]),
+				tx_thread, &tx_queues[i], NULL, NULL,
+				K_PRIO_COOP(thread_priority), 0, 0);
 	}
 }
 
@@ -357,11 +521,13 @@ void net_tc_rx_init(void)
 	net_if_foreach(net_tc_rx_stats_priority_setup, NULL);
 #endif
 
-	for (i = 0; i < NET_TC_RX_COUNT; i++) {
+	for (i = 0; i < NET_RX_QUEUE_COUNT; i++) {
 		u8_t thread_priority;
 
-		thread_priority = rx_tc2thread(i);
-		rx_classes[i].tc = thread_priority;
+		thread_priority = rx_tc2thread(i / CONFIG_NET_RX_FLOW_QUEUES);
+		rx_queues[i].tc = thread_priority;
+
+		k_fifo_init(&rx_queues[i].fifo);
 
 #if defined(CONFIG_NET_SHELL)
 		/* Fix the thread start address so that "net stacks"
@@ -374,13 +540,13 @@ void net_tc_rx_init(void)
 
 		NET_DBG("[%d] Starting RX queue %p stack %p size %zd "
 			"prio %d (%d)", i,
-			&rx_classes[i].work_q.queue, RX_STACK(i),
+			&rx_queues[i].fifo, RX_STACK(i),
 			K_THREAD_STACK_SIZEOF(rx_stack[i]),
 			thread_priority, K_PRIO_COOP(thread_priority));
 
-		k_work_q_start(&rx_classes[i].work_q,
-			       rx_stack[i],
-			       K_THREAD_STACK_SIZEOF(rx_stack[i]),
-			       K_PRIO_COOP(thread_priority));
+		k_thread_create(&rx_queues[i].thread, rx_stack[i],
+				K_THREAD_STACK_SIZEOF(rx_stack[i]),
+				rx_thread, &rx_queues[i], NULL, NULL,
+				K_PRIO_COOP(thread_priority), 0, 0);
 	}
 }
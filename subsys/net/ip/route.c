@@ -39,7 +39,29 @@
 /* We keep track of the routes in a separate list so that we can remove
  * the oldest routes (at tail) if needed.
  */
-static sys_slist_t routes;
+static sys_dlist_t routes = SYS_DLIST_STATIC_INIT(&routes);
+
+/*
+ * Routes are looked up through a path-compressed binary trie of their
+ * prefixes. A node holds the routes of one prefix, a node without routes
+ * is a branch point and has two children. With at most
+ * CONFIG_NET_MAX_ROUTES prefixes there are less than twice as many nodes.
+ */
+struct route_trie_node {
+	struct route_trie_node *child[2];
+
+	/** Routes with this prefix, in route pool order */
+	sys_slist_t routes;
+
+	/** Prefix, with the bits after len cleared */
+	struct in6_addr prefix;
+
+	u8_t len;
+};
+
+static struct route_trie_node trie_nodes[2 * CONFIG_NET_MAX_ROUTES];
+static struct route_trie_node *trie_free;
+static struct route_trie_node *trie_root;
 
 static void net_route_nexthop_remove(struct net_nbr *nbr)
 {
@@ -60,6 +82,12 @@ static inline struct net_route_nexthop *net_nexthop_data(struct net_nbr *nbr)
 	return (struct net_route_nexthop *)nbr->data;
 }
 
+static inline struct net_nbr *net_nexthop_nbr(struct net_route_nexthop *data)
+{
+	return (struct net_nbr *)((u8_t *)data -
+				  offsetof(struct net_nbr, __nbr));
+}
+
 static inline struct net_nbr *get_nexthop_nbr(struct net_nbr *start, int idx)
 {
 	NET_ASSERT_INFO(idx < CONFIG_NET_MAX_NEXTHOPS, "idx %d >= max %d",
@@ -253,40 +281,225 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 #define net_route_info(...)
 #endif /* CONFIG_NET_DEBUG_ROUTE */
 
-/* Route was accessed, so place it in front of the routes list */
-static inline void update_route_access(struct net_route_entry *route)
+static inline int prefix_bit(const struct in6_addr *addr, u8_t pos)
 {
-	sys_slist_find_and_remove(&routes, &route->node);
-	sys_slist_prepend(&routes, &route->node);
+	return (addr->s6_addr[pos / 8] >> (7 - pos % 8)) & 1;
 }
 
-struct net_route_entry *net_route_lookup(struct net_if *iface,
-					 struct in6_addr *dst)
+/* Number of leading bits two addresses have in common, at most max */
+static u8_t prefix_common_len(const struct in6_addr *addr1,
+			      const struct in6_addr *addr2, u8_t max)
 {
-	struct net_route_entry *route, *found = NULL;
-	u8_t longest_match = 0;
+	u8_t len = 0;
 	int i;
 
-	for (i = 0; i < CONFIG_NET_MAX_ROUTES && longest_match < 128; i++) {
-		struct net_nbr *nbr = get_nbr(i);
+	for (i = 0; i < sizeof(addr1->s6_addr) && len < max; i++) {
+		u8_t diff = addr1->s6_addr[i] ^ addr2->s6_addr[i];
 
-		if (!nbr->ref) {
-			continue;
+		if (diff) {
+			len += 8 - find_msb_set(diff);
+			break;
 		}
 
-		if (iface && nbr->iface != iface) {
+		len += 8;
+	}
+
+	return min(len, max);
+}
+
+static struct route_trie_node *trie_node_alloc(const struct in6_addr *addr,
+					       u8_t len)
+{
+	struct route_trie_node *node = trie_free;
+
+	NET_ASSERT(node);
+
+	trie_free = node->child[0];
+
+	node->child[0] = NULL;
+	node->child[1] = NULL;
+	sys_slist_init(&node->routes);
+	node->len = len;
+
+	memset(&node->prefix, 0, sizeof(node->prefix));
+	memcpy(&node->prefix, addr, len / 8);
+
+	if (len % 8) {
+		node->prefix.s6_addr[len / 8] = addr->s6_addr[len / 8] &
+						(0xff << (8 - len % 8));
+	}
+
+	return node;
+}
+
+static void trie_node_free(struct route_trie_node *node)
+{
+	node->child[0] = trie_free;
+	trie_free = node;
+}
+
+/* Find the node of a prefix, creating it if needed */
+static struct route_trie_node *trie_node_get(const struct in6_addr *addr,
+					     u8_t len)
+{
+	struct route_trie_node **link = &trie_root;
+	struct route_trie_node *node, *new, *branch;
+	u8_t common;
+
+	while ((node = *link)) {
+		common = prefix_common_len(addr, &node->prefix,
+					   min(len, node->len));
+
+		if (common == node->len) {
+			if (node->len == len) {
+				return node;
+			}
+
+			link = &node->child[prefix_bit(addr, node->len)];
 			continue;
 		}
 
-		route = net_route_data(nbr);
+		new = trie_node_alloc(addr, len);
+
+		if (common == len) {
+			/* The new prefix covers the node */
+			new->child[prefix_bit(&node->prefix, len)] = node;
+			*link = new;
+
+			return new;
+		}
+
+		/* The prefixes differ at bit common, branch there */
+		branch = trie_node_alloc(addr, common);
+		branch->child[prefix_bit(&node->prefix, common)] = node;
+		branch->child[prefix_bit(addr, common)] = new;
+		*link = branch;
+
+		return new;
+	}
+
+	*link = trie_node_alloc(addr, len);
+
+	return *link;
+}
+
+static void trie_insert(struct net_route_entry *route)
+{
+	struct route_trie_node *node;
+	sys_snode_t *prev = NULL;
+	sys_snode_t *sn;
+
+	node = trie_node_get(&route->addr, route->prefix_len);
+
+	SYS_SLIST_FOR_EACH_NODE(&node->routes, sn) {
+		if (CONTAINER_OF(sn, struct net_route_entry,
+				 prefix_node) > route) {
+			break;
+		}
+
+		prev = sn;
+	}
 
-		if (route->prefix_len >= longest_match &&
-		    net_is_ipv6_prefix((u8_t *)dst,
-				       (u8_t *)&route->addr,
-				       route->prefix_len)) {
+	sys_slist_insert(&node->routes, prev, &route->prefix_node);
+}
+
+static void trie_remove(struct net_route_entry *route)
+{
+	struct route_trie_node **link = &trie_root;
+	struct route_trie_node **parent_link = NULL;
+	struct route_trie_node *node, *parent;
+
+	/* All the nodes above the route prefix are prefixes of it */
+	while ((node = *link) && node->len < route->prefix_len) {
+		parent_link = link;
+		link = &node->child[prefix_bit(&route->addr, node->len)];
+	}
+
+	if (!node || node->len != route->prefix_len ||
+	    !sys_slist_find_and_remove(&node->routes, &route->prefix_node)) {
+		return;
+	}
+
+	if (!sys_slist_is_empty(&node->routes) ||
+	    (node->child[0] && node->child[1])) {
+		return;
+	}
+
+	*link = node->child[0] ? node->child[0] : node->child[1];
+	trie_node_free(node);
+
+	if (*link || !parent_link) {
+		return;
+	}
+
+	/* A branch point left with a single child is not needed */
+	parent = *parent_link;
+	if (sys_slist_is_empty(&parent->routes)) {
+		*parent_link = parent->child[0] ? parent->child[0] :
+						  parent->child[1];
+		trie_node_free(parent);
+	}
+}
+
+static struct net_route_entry *trie_node_route(struct route_trie_node *node,
+					       struct net_if *iface)
+{
+	struct net_route_entry *route;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&node->routes, route, prefix_node) {
+		if (!iface || route->iface == iface) {
+			return route;
+		}
+	}
+
+	return NULL;
+}
+
+/* Find the route to exactly this prefix */
+static struct net_route_entry *trie_route_find(struct net_if *iface,
+					       const struct in6_addr *addr,
+					       u8_t len)
+{
+	struct route_trie_node *node = trie_root;
+
+	while (node && node->len < len) {
+		node = node->child[prefix_bit(addr, node->len)];
+	}
+
+	if (!node || node->len != len ||
+	    !net_is_ipv6_prefix((u8_t *)addr, (u8_t *)&node->prefix, len)) {
+		return NULL;
+	}
+
+	return trie_node_route(node, iface);
+}
+
+/* Route was accessed, so place it in front of the routes list */
+static inline void update_route_access(struct net_route_entry *route)
+{
+	sys_dlist_remove(&route->node);
+	sys_dlist_prepend(&routes, &route->node);
+}
+
+struct net_route_entry *net_route_lookup(struct net_if *iface,
+					 struct in6_addr *dst)
+{
+	struct net_route_entry *route, *found = NULL;
+	struct route_trie_node *node = trie_root;
+
+	/* The deepest node matching dst with a route on iface wins */
+	while (node && net_is_ipv6_prefix((u8_t *)dst, (u8_t *)&node->prefix,
+					  node->len)) {
+		route = trie_node_route(node, iface);
+		if (route) {
 			found = route;
-			longest_match = route->prefix_len;
 		}
+
+		if (node->len == 128) {
+			break;
+		}
+
+		node = node->child[prefix_bit(dst, node->len)];
 	}
 
 	if (found) {
@@ -334,7 +547,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	NET_DBG("Nexthop %s lladdr is %s", net_sprint_ipv6_addr(nexthop),
 		net_sprint_ll_addr(nexthop_lladdr->addr, nexthop_lladdr->len));
 
-	route = net_route_lookup(iface, addr);
+	route = trie_route_find(iface, addr, prefix_len);
 	if (route) {
 		/* Update nexthop if not the same */
 		struct in6_addr *nexthop_addr;
@@ -342,6 +555,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 		nexthop_addr = net_route_get_nexthop(route);
 		if (nexthop_addr && net_ipv6_addr_cmp(nexthop, nexthop_addr)) {
 			NET_DBG("No changes, return old route %p", route);
+			update_route_access(route);
 			return route;
 		}
 
@@ -354,9 +568,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	nbr = nbr_new(iface, addr, prefix_len);
 	if (!nbr) {
 		/* Remove the oldest route and try again */
-		sys_snode_t *last = sys_slist_peek_tail(&routes);
-
-		sys_slist_find_and_remove(&routes, last);
+		sys_dnode_t *last = sys_dlist_peek_tail(&routes);
 
 		route = CONTAINER_OF(last,
 				     struct net_route_entry,
@@ -393,6 +605,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	tmp = get_nexthop_route();
 	if (!tmp) {
 		NET_ERR("No nexthop route available!");
+		nbr_free(nbr);
 		return NULL;
 	}
 
@@ -401,7 +614,8 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	route = net_route_data(nbr);
 	route->iface = iface;
 
-	sys_slist_prepend(&routes, &route->node);
+	sys_dlist_prepend(&routes, &route->node);
+	trie_insert(route);
 
 	tmp = nbr_nexthop_get(iface, nexthop);
 
@@ -432,7 +646,7 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 int net_route_del(struct net_route_entry *route)
 {
 	struct net_nbr *nbr;
-	struct net_route_nexthop *nexthop_route;
+	struct net_route_nexthop *nexthop_route, *next;
 #if defined(CONFIG_NET_MGMT_EVENT_INFO)
        struct net_event_ipv6_route info;
 #endif
@@ -454,8 +668,6 @@ int net_route_del(struct net_route_entry *route)
 	net_mgmt_event_notify(NET_EVENT_IPV6_ROUTE_DEL, route->iface);
 #endif
 
-	sys_slist_find_and_remove(&routes, &route->node);
-
 	nbr = net_route_get_nbr(route);
 	if (!nbr) {
 		return -ENOENT;
@@ -463,12 +675,17 @@ int net_route_del(struct net_route_entry *route)
 
 	net_route_info("Deleted", route, &route->addr);
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&route->nexthop, nexthop_route, node) {
-		if (!nexthop_route->nbr) {
-			continue;
+	sys_dlist_remove(&route->node);
+	trie_remove(route);
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&route->nexthop, nexthop_route,
+					  next, node) {
+		if (nexthop_route->nbr) {
+			nbr_nexthop_put(nexthop_route->nbr);
 		}
 
-		nbr_nexthop_put(nexthop_route->nbr);
+		/* Give the entry back to the nexthop pool */
+		net_nbr_unref(net_nexthop_nbr(nexthop_route));
 	}
 
 	nbr_free(nbr);
@@ -813,6 +1030,12 @@ int net_route_packet(struct net_pkt *pkt, struct in6_addr *nexthop)
 
 void net_route_init(void)
 {
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(trie_nodes); i++) {
+		trie_node_free(&trie_nodes[i]);
+	}
+
 	NET_DBG("Allocated %d routing entries (%zu bytes)",
 		CONFIG_NET_MAX_ROUTES, sizeof(net_route_entries_pool));
 
@@ -15,6 +15,7 @@
 
 #include <kernel.h>
 #include <misc/slist.h>
+#include <misc/dlist.h>
 
 #include <net/net_ip.h>
 
@@ -48,7 +49,12 @@ struct net_route_entry {
 	 * we can remove it if we run out of available routes.
 	 * The oldest one is the last entry in the list.
 	 */
-	sys_snode_t node;
+	sys_dnode_t node;
+
+	/** Node in the list of routes having the same prefix in the
+	 * lookup trie.
+	 */
+	sys_snode_t prefix_node;
 
 	/** List of neighbors that the routes go through. */
 	sys_slist_t nexthop;
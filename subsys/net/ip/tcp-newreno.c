@@ -0,0 +1,73 @@
+/** @file
+ * @brief TCP NewReno congestion control.
+ *
+ * Slow start and congestion avoidance of RFC 5681. The fast retransmit
+ * and fast recovery of RFC 6582 are done in tcp.c.
+ */
+
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#if defined(CONFIG_NET_DEBUG_TCP)
+#define SYS_LOG_DOMAIN "net/tcp"
+#define NET_LOG_ENABLED 1
+#endif
+
+#include <kernel.h>
+#include <zephyr/types.h>
+
+#include <net/net_core.h>
+
+#include "net_private.h"
+#include "tcp_internal.h"
+
+/* Bytes acknowledged since the window was last grown in congestion
+ * avoidance, see RFC 3465.
+ */
+#define bytes_acked(tcp) ((tcp)->cc_state[0])
+
+void net_tcp_cc_init(struct net_tcp *tcp)
+{
+	u32_t mss = tcp->send_mss;
+
+	/* RFC 5681 section 3.1, initial window */
+	if (mss > 2190) {
+		tcp->cwnd = 2 * mss;
+	} else if (mss > 1095) {
+		tcp->cwnd = 3 * mss;
+	} else {
+		tcp->cwnd = 4 * mss;
+	}
+
+	tcp->ssthresh = UINT32_MAX;
+	bytes_acked(tcp) = 0;
+}
+
+void net_tcp_cc_ack(struct net_tcp *tcp, u32_t acked)
+{
+	if (tcp->cwnd < tcp->ssthresh) {
+		/* Slow start, grow by at most one MSS per ACK */
+		tcp->cwnd += min(acked, tcp->send_mss);
+		return;
+	}
+
+	/* Congestion avoidance, grow by one MSS per window of data */
+	bytes_acked(tcp) += acked;
+	if (bytes_acked(tcp) >= tcp->cwnd) {
+		bytes_acked(tcp) -= tcp->cwnd;
+		tcp->cwnd += tcp->send_mss;
+	}
+}
+
+u32_t net_tcp_cc_ssthresh(struct net_tcp *tcp, u32_t flight)
+{
+	bytes_acked(tcp) = 0;
+
+	NET_DBG("[%p] cwnd %u flight %u", tcp, tcp->cwnd, flight);
+
+	/* RFC 5681 equation (4) */
+	return max(flight / 2, 2 * (u32_t)tcp->send_mss);
+}
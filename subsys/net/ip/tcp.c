@@ -52,7 +52,7 @@ static struct tcp_backlog_entry {
 	u32_t send_ack;
 	struct k_delayed_work ack_timer;
 	struct sockaddr remote;
-	u16_t send_mss;
+	struct net_tcp_options opts;
 } tcp_backlog[CONFIG_NET_TCP_BACKLOG_SIZE];
 
 #if defined(CONFIG_NET_TCP_ACK_TIMEOUT)
@@ -156,8 +156,13 @@ static void net_tcp_trace(struct net_pkt *pkt, struct net_tcp *tcp)
 
 static inline u32_t retry_timeout(const struct net_tcp *tcp)
 {
-	return ((u32_t)1 << tcp->retry_timeout_shift) *
-				CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
+	/* The RTO is doubled on each retry, up to the maximum */
+	if (tcp->retry_timeout_shift >= 16 ||
+	    (tcp->rto << tcp->retry_timeout_shift) > NET_TCP_MAX_RTO) {
+		return NET_TCP_MAX_RTO;
+	}
+
+	return tcp->rto << tcp->retry_timeout_shift;
 }
 
 #define is_6lo_technology(pkt)						    \
@@ -200,10 +205,290 @@ static void abort_connection(struct net_tcp *tcp)
 	net_context_unref(ctx);
 }
 
+/* Bytes of the segments that have been sent and not acknowledged yet */
+static u32_t tcp_flight_size(struct net_tcp *tcp)
+{
+	struct net_pkt *pkt;
+	u32_t flight = 0;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, pkt, sent_list) {
+		if (!net_pkt_sent(pkt) && !net_pkt_queued(pkt)) {
+			break;
+		}
+
+		flight += net_pkt_appdatalen(pkt);
+	}
+
+	return flight;
+}
+
+/* Sequence number of a segment whose TCP header has been checked */
+static u32_t tcp_pkt_seq(struct net_pkt *pkt)
+{
+	struct net_tcp_hdr hdr, *tcp_hdr;
+
+	tcp_hdr = net_tcp_get_hdr(pkt, &hdr);
+	if (!tcp_hdr) {
+		return 0;
+	}
+
+	return sys_get_be32(tcp_hdr->seq);
+}
+
+/* Resend a segment that has been sent and not acknowledged */
+static void tcp_retransmit_pkt(struct net_tcp *tcp, struct net_pkt *pkt)
+{
+	u32_t end = tcp_pkt_seq(pkt) + net_pkt_appdatalen(pkt);
+
+	if (net_tcp_seq_greater(end, tcp->high_rxt)) {
+		tcp->high_rxt = end;
+	}
+
+	if (net_pkt_sent(pkt)) {
+		do_ref_if_needed(tcp, pkt);
+		net_pkt_set_sent(pkt, false);
+	}
+
+	net_pkt_set_queued(pkt, true);
+
+	/* Karn's algorithm, the RTT of a retransmitted segment is
+	 * ambiguous and is not measured.
+	 */
+	tcp->flags &= ~NET_TCP_RTT_MEASURING;
+
+	if (net_tcp_send_pkt(pkt) < 0 && !is_6lo_technology(pkt)) {
+		NET_DBG("retry %u: [%p] pkt %p send failed",
+			tcp->retry_timeout_shift, tcp, pkt);
+		net_pkt_unref(pkt);
+	} else {
+		NET_DBG("retry %u: [%p] sent pkt %p",
+			tcp->retry_timeout_shift, tcp, pkt);
+		if (IS_ENABLED(CONFIG_NET_STATISTICS_TCP) &&
+		    !is_6lo_technology(pkt)) {
+			net_stats_update_tcp_seg_rexmit(net_pkt_iface(pkt));
+		}
+	}
+}
+
+/* Resend the oldest segment that has not been acknowledged */
+static void tcp_retransmit(struct net_tcp *tcp)
+{
+	struct net_pkt *pkt;
+
+	if (sys_slist_is_empty(&tcp->sent_list)) {
+		return;
+	}
+
+	pkt = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
+			   struct net_pkt, sent_list);
+
+	tcp_retransmit_pkt(tcp, pkt);
+}
+
+/* Resend the next segment considered lost in fast recovery, once. It is
+ * the oldest segment as in RFC 6582, and with SACK also the following
+ * holes below the highest data the peer has selectively acknowledged,
+ * which is a simplification of RFC 6675 section 5. Returns false if
+ * there is nothing to resend.
+ */
+static bool tcp_retransmit_next(struct net_tcp *tcp)
+{
+	struct net_pkt *pkt;
+	bool head = true;
+	u32_t seq;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, pkt, sent_list) {
+		if (!net_pkt_sent(pkt) && !net_pkt_queued(pkt)) {
+			break;
+		}
+
+		seq = tcp_pkt_seq(pkt);
+
+		if (!head && !net_tcp_seq_greater(tcp->high_sacked, seq)) {
+			break;
+		}
+
+		head = false;
+
+		if (net_pkt_sacked(pkt) ||
+		    net_tcp_seq_greater(tcp->high_rxt, seq)) {
+			continue;
+		}
+
+		/* Still waiting in the TX queue */
+		if (!net_pkt_sent(pkt) && !is_6lo_technology(pkt)) {
+			continue;
+		}
+
+		tcp_retransmit_pkt(tcp, pkt);
+		return true;
+	}
+
+	return false;
+}
+
+/* Time the segment ending at seq, unless one is being timed already */
+static void tcp_rtt_start(struct net_tcp *tcp, u32_t seq)
+{
+	if (tcp->flags & NET_TCP_RTT_MEASURING) {
+		return;
+	}
+
+	tcp->rtt_seq = seq;
+	tcp->rtt_time = k_uptime_get_32();
+	tcp->flags |= NET_TCP_RTT_MEASURING;
+}
+
+/* RFC 6298 section 2, the smoothed RTT and the RTT variation are kept
+ * scaled by 8 and 4 so that the gains of 1/8 and 1/4 are shifts.
+ */
+static void tcp_rtt_update(struct net_tcp *tcp, u32_t ack)
+{
+	u32_t rtt;
+	s32_t delta;
+
+	if (!(tcp->flags & NET_TCP_RTT_MEASURING) ||
+	    net_tcp_seq_greater(tcp->rtt_seq, ack)) {
+		return;
+	}
+
+	tcp->flags &= ~NET_TCP_RTT_MEASURING;
+	rtt = k_uptime_get_32() - tcp->rtt_time;
+
+	if (!tcp->srtt) {
+		tcp->srtt = rtt << 3;
+		tcp->rttvar = rtt << 1;
+	} else {
+		delta = rtt - (tcp->srtt >> 3);
+		tcp->srtt += delta;
+
+		if (delta < 0) {
+			delta = -delta;
+		}
+
+		tcp->rttvar += delta - (tcp->rttvar >> 2);
+	}
+
+	tcp->rto = (tcp->srtt >> 3) + tcp->rttvar;
+	tcp->rto = max(tcp->rto, CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT);
+	tcp->rto = min(tcp->rto, NET_TCP_MAX_RTO);
+
+	NET_DBG("[%p] rtt %u srtt %u rttvar %u rto %u", tcp, rtt,
+		tcp->srtt >> 3, tcp->rttvar >> 2, tcp->rto);
+}
+
+/* RFC 7323 section 2.3, the smallest shift that lets our window be
+ * announced.
+ */
+static u8_t tcp_window_scale(void)
+{
+	u8_t shift = 0;
+
+	while ((CONFIG_NET_TCP_RECV_WINDOW >> shift) > UINT16_MAX) {
+		shift++;
+	}
+
+	return shift;
+}
+
+/* Keep the options of the SYN or SYN-ACK of the peer. Window scaling
+ * and SACK are used only if both ends offered them, RFC 7323 section
+ * 1.3 and RFC 2018 section 2.
+ */
+static void tcp_syn_opts_received(struct net_tcp *tcp,
+				  struct net_tcp_options *opts)
+{
+	if (opts->mss) {
+		tcp->send_mss = opts->mss;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE) && opts->window_scale) {
+		tcp->flags |= NET_TCP_WINDOW_SCALING;
+		tcp->send_wscale = min(opts->wscale, NET_TCP_MAX_WINDOW_SCALE);
+		tcp->recv_wscale = tcp_window_scale();
+	} else {
+		tcp->flags &= ~NET_TCP_WINDOW_SCALING;
+		tcp->send_wscale = 0;
+		tcp->recv_wscale = 0;
+		tcp->recv_wnd = min(tcp->recv_wnd, UINT16_MAX);
+	}
+
+	if (IS_ENABLED(CONFIG_NET_TCP_SACK) && opts->sack_permitted) {
+		tcp->flags |= NET_TCP_SACK_PERMITTED;
+	} else {
+		tcp->flags &= ~NET_TCP_SACK_PERMITTED;
+	}
+
+	NET_DBG("[%p] mss %u wscale %u/%u sack %d", tcp, tcp->send_mss,
+		tcp->send_wscale, tcp->recv_wscale,
+		!!(tcp->flags & NET_TCP_SACK_PERMITTED));
+}
+
+/* The window of a received segment, it is not scaled in SYN segments */
+static u32_t tcp_peer_wnd(struct net_tcp *tcp, struct net_tcp_hdr *tcp_hdr)
+{
+	u32_t wnd = sys_get_be16(tcp_hdr->wnd);
+
+	if (NET_TCP_FLAGS(tcp_hdr) & NET_TCP_SYN) {
+		return wnd;
+	}
+
+	return wnd << tcp->send_wscale;
+}
+
+/* Called when the connection gets established, with the SYN-ACK or the
+ * ACK that completes the handshake.
+ */
+static void tcp_send_init(struct net_tcp *tcp, struct net_tcp_hdr *tcp_hdr)
+{
+	tcp->send_wnd = tcp_peer_wnd(tcp, tcp_hdr);
+	tcp->send_max = tcp->send_seq;
+	tcp->recover = tcp->send_seq;
+	tcp->high_sacked = tcp->send_seq;
+	tcp->high_rxt = tcp->send_seq;
+
+	net_tcp_cc_init(tcp);
+}
+
+/* RFC 5681 section 3.1, the window falls back to one segment after a
+ * retransmission timeout. The rest of the lost segments are resent one
+ * per ACK until everything sent before the timeout has been acked.
+ */
+static void tcp_cc_timeout(struct net_tcp *tcp)
+{
+	struct net_pkt *pkt;
+
+	/* Only the first timeout of a segment lowers ssthresh */
+	if (tcp->retry_timeout_shift == 1) {
+		tcp->ssthresh = net_tcp_cc_ssthresh(tcp,
+						    tcp_flight_size(tcp));
+	}
+
+	tcp->cwnd = tcp->send_mss;
+	tcp->dup_acks = 0;
+	tcp->recover = tcp->send_max;
+	tcp->flags &= ~NET_TCP_FAST_RECOVERY;
+	tcp->flags |= NET_TCP_RTO_RECOVERY;
+
+	/* The peer may have dropped what it selectively acknowledged,
+	 * RFC 2018 section 8.
+	 */
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, pkt, sent_list) {
+		net_pkt_set_sacked(pkt, false);
+	}
+
+	pkt = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
+			   struct net_pkt, sent_list);
+
+	tcp->high_sacked = tcp_pkt_seq(pkt);
+	tcp->high_rxt = tcp->high_sacked;
+}
+
 static void tcp_retry_expired(struct k_work *work)
 {
 	struct net_tcp *tcp = CONTAINER_OF(work, struct net_tcp, retry_timer);
-	struct net_pkt *pkt;
+
+	k_mutex_lock(&tcp->sent_lock, K_FOREVER);
 
 	/* Double the retry period for exponential backoff and resent
 	 * the first (only the first!) unack'd packet.
@@ -212,42 +497,26 @@ static void tcp_retry_expired(struct k_work *work)
 		tcp->retry_timeout_shift++;
 
 		if (tcp->retry_timeout_shift > CONFIG_NET_TCP_RETRY_COUNT) {
+			k_mutex_unlock(&tcp->sent_lock);
 			abort_connection(tcp);
 			return;
 		}
 
 		k_delayed_work_submit(&tcp->retry_timer, retry_timeout(tcp));
 
-		pkt = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
-				   struct net_pkt, sent_list);
-
-		if (net_pkt_sent(pkt)) {
-			do_ref_if_needed(tcp, pkt);
-			net_pkt_set_sent(pkt, false);
-		}
-
-		net_pkt_set_queued(pkt, true);
-
-		if (net_tcp_send_pkt(pkt) < 0 && !is_6lo_technology(pkt)) {
-			NET_DBG("retry %u: [%p] pkt %p send failed",
-				tcp->retry_timeout_shift, tcp, pkt);
-			net_pkt_unref(pkt);
-		} else {
-			NET_DBG("retry %u: [%p] sent pkt %p",
-				tcp->retry_timeout_shift, tcp, pkt);
-			if (IS_ENABLED(CONFIG_NET_STATISTICS_TCP) &&
-			    !is_6lo_technology(pkt)) {
-				net_stats_update_tcp_seg_rexmit(
-							net_pkt_iface(pkt));
-			}
-		}
+		tcp_cc_timeout(tcp);
+		tcp_retransmit(tcp);
 	} else if (CONFIG_NET_TCP_TIME_WAIT_DELAY != 0) {
 		if (tcp->fin_sent && tcp->fin_rcvd) {
+			k_mutex_unlock(&tcp->sent_lock);
 			NET_DBG("[%p] Closing connection (context %p)",
 				tcp, tcp->context);
 			net_context_unref(tcp->context);
+			return;
 		}
 	}
+
+	k_mutex_unlock(&tcp->sent_lock);
 }
 
 struct net_tcp *net_tcp_alloc(struct net_context *context)
@@ -274,13 +543,29 @@ struct net_tcp *net_tcp_alloc(struct net_context *context)
 	tcp_context[i].context = context;
 
 	tcp_context[i].send_seq = tcp_init_isn();
-	tcp_context[i].recv_wnd = min(NET_TCP_MAX_WIN, NET_TCP_BUF_MAX_LEN);
+	tcp_context[i].recv_wnd = CONFIG_NET_TCP_RECV_WINDOW;
 	tcp_context[i].send_mss = NET_TCP_DEFAULT_MSS;
+	tcp_context[i].send_wnd = NET_TCP_DEFAULT_MSS;
+	tcp_context[i].rto = CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
+
+	/* Offered in our SYN, see tcp_syn_opts_received() */
+	if (IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE)) {
+		tcp_context[i].flags |= NET_TCP_WINDOW_SCALING;
+		tcp_context[i].recv_wscale = tcp_window_scale();
+	} else {
+		tcp_context[i].recv_wnd = min(CONFIG_NET_TCP_RECV_WINDOW,
+					      UINT16_MAX);
+	}
+
+	if (IS_ENABLED(CONFIG_NET_TCP_SACK)) {
+		tcp_context[i].flags |= NET_TCP_SACK_PERMITTED;
+	}
 
 	tcp_context[i].accept_cb = NULL;
 
 	k_delayed_work_init(&tcp_context[i].retry_timer, tcp_retry_expired);
 	k_sem_init(&tcp_context[i].connect_wait, 0, UINT_MAX);
+	k_mutex_init(&tcp_context[i].sent_lock);
 
 	return &tcp_context[i];
 }
@@ -315,12 +600,24 @@ int net_tcp_release(struct net_tcp *tcp)
 		return -EINVAL;
 	}
 
+	k_mutex_lock(&tcp->sent_lock, K_FOREVER);
+
 	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp->sent_list, pkt, tmp,
 					  sent_list) {
 		sys_slist_remove(&tcp->sent_list, NULL, &pkt->sent_list);
 		net_pkt_unref(pkt);
 	}
 
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp->ooo_list, pkt, tmp,
+					  sent_list) {
+		sys_slist_remove(&tcp->ooo_list, NULL, &pkt->sent_list);
+		net_pkt_unref(pkt);
+	}
+
+	tcp->ooo_count = 0;
+
+	k_mutex_unlock(&tcp->sent_lock);
+
 	retry_timer_cancel(tcp);
 	k_sem_reset(&tcp->connect_wait);
 
@@ -508,7 +805,7 @@ int net_tcp_prepare_segment(struct net_tcp *tcp, u8_t flags,
 			    struct net_pkt **send_pkt)
 {
 	u32_t seq;
-	u16_t wnd;
+	u32_t wnd;
 	struct tcp_segment segment = { 0 };
 	int status;
 
@@ -555,14 +852,18 @@ int net_tcp_prepare_segment(struct net_tcp *tcp, u8_t flags,
 		}
 	}
 
+	/* The window is not scaled in SYN segments, RFC 7323 section 2.2 */
 	wnd = net_tcp_get_recv_wnd(tcp);
+	if (!(flags & NET_TCP_SYN)) {
+		wnd >>= tcp->recv_wscale;
+	}
 
 	segment.src_addr = (struct sockaddr_ptr *)local;
 	segment.dst_addr = remote;
 	segment.seq = tcp->send_seq;
 	segment.ack = tcp->send_ack;
 	segment.flags = flags;
-	segment.wnd = wnd;
+	segment.wnd = min(wnd, UINT16_MAX);
 	segment.options = options;
 	segment.optlen = optlen;
 
@@ -648,6 +949,31 @@ u16_t net_tcp_get_recv_mss(const struct net_tcp *tcp)
 	return 0;
 }
 
+/* Window scale and SACK permitted options, offered in a SYN and
+ * echoed in a SYN-ACK if the SYN had them.
+ */
+static void net_tcp_set_wnd_sack_opt(struct net_tcp *tcp, u8_t *options,
+				     u8_t *optionlen)
+{
+	u8_t *opt = options + *optionlen;
+
+	if (tcp->flags & NET_TCP_WINDOW_SCALING) {
+		*opt++ = NET_TCP_NOP_OPT;
+		*opt++ = NET_TCP_WINDOW_SCALE_OPT;
+		*opt++ = NET_TCP_WINDOW_SCALE_SIZE;
+		*opt++ = tcp->recv_wscale;
+	}
+
+	if (tcp->flags & NET_TCP_SACK_PERMITTED) {
+		*opt++ = NET_TCP_NOP_OPT;
+		*opt++ = NET_TCP_NOP_OPT;
+		*opt++ = NET_TCP_SACK_PERM_OPT;
+		*opt++ = NET_TCP_SACK_PERM_SIZE;
+	}
+
+	*optionlen = opt - options;
+}
+
 static void net_tcp_set_syn_opt(struct net_tcp *tcp, u8_t *options,
 				u8_t *optionlen)
 {
@@ -667,6 +993,96 @@ static void net_tcp_set_syn_opt(struct net_tcp *tcp, u8_t *options,
 		      (u32_t *)(options + *optionlen));
 
 	*optionlen += NET_TCP_MSS_SIZE;
+
+	net_tcp_set_wnd_sack_opt(tcp, options, optionlen);
+}
+
+/* Block of the SACK option of an ACK. The block holding the most
+ * recently received segment goes first, RFC 2018 section 4.
+ */
+static void tcp_sack_add(struct net_tcp *tcp,
+			 struct net_tcp_sack_block *blocks, u8_t *count,
+			 struct net_tcp_sack_block *block)
+{
+	if (net_tcp_seq_greater(block->left, tcp->ooo_last_seq) ||
+	    !net_tcp_seq_greater(block->right, tcp->ooo_last_seq)) {
+		if (*count < NET_TCP_MAX_SACK_BLOCKS) {
+			blocks[(*count)++] = *block;
+		}
+
+		return;
+	}
+
+	memmove(&blocks[1], &blocks[0],
+		min(*count, NET_TCP_MAX_SACK_BLOCKS - 1) * sizeof(*blocks));
+	blocks[0] = *block;
+	*count = min(*count + 1, NET_TCP_MAX_SACK_BLOCKS);
+}
+
+/* SACK option of an ACK, with the data received out of order */
+static void net_tcp_set_sack_opt(struct net_tcp *tcp, u8_t *options,
+				 u8_t *optionlen)
+{
+	struct net_tcp_sack_block blocks[NET_TCP_MAX_SACK_BLOCKS];
+	struct net_tcp_sack_block block = { 0 };
+	struct net_pkt *pkt;
+	u8_t count = 0;
+	u8_t i;
+
+	*optionlen = 0;
+
+	if (!(tcp->flags & NET_TCP_SACK_PERMITTED)) {
+		return;
+	}
+
+	k_mutex_lock(&tcp->sent_lock, K_FOREVER);
+
+	if (sys_slist_is_empty(&tcp->ooo_list)) {
+		k_mutex_unlock(&tcp->sent_lock);
+		return;
+	}
+
+	/* The queued segments are in order, contiguous or overlapping
+	 * ones are reported as one block.
+	 */
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->ooo_list, pkt, sent_list) {
+		u32_t seq = tcp_pkt_seq(pkt);
+		u32_t end = seq + net_pkt_appdatalen(pkt);
+
+		if (block.left != block.right &&
+		    !net_tcp_seq_greater(seq, block.right)) {
+			if (net_tcp_seq_greater(end, block.right)) {
+				block.right = end;
+			}
+
+			continue;
+		}
+
+		if (block.left != block.right) {
+			tcp_sack_add(tcp, blocks, &count, &block);
+		}
+
+		block.left = seq;
+		block.right = end;
+	}
+
+	tcp_sack_add(tcp, blocks, &count, &block);
+
+	k_mutex_unlock(&tcp->sent_lock);
+
+	options[0] = NET_TCP_NOP_OPT;
+	options[1] = NET_TCP_NOP_OPT;
+	options[2] = NET_TCP_SACK_OPT;
+	options[3] = 2 + count * NET_TCP_SACK_BLOCK_SIZE;
+
+	for (i = 0; i < count; i++) {
+		sys_put_be32(blocks[i].left,
+			     options + 4 + i * NET_TCP_SACK_BLOCK_SIZE);
+		sys_put_be32(blocks[i].right,
+			     options + 8 + i * NET_TCP_SACK_BLOCK_SIZE);
+	}
+
+	*optionlen = 4 + count * NET_TCP_SACK_BLOCK_SIZE;
 }
 
 int net_tcp_prepare_ack(struct net_tcp *tcp, const struct sockaddr *remote,
@@ -693,8 +1109,10 @@ int net_tcp_prepare_ack(struct net_tcp *tcp, const struct sockaddr *remote,
 		return net_tcp_prepare_segment(tcp, NET_TCP_FIN | NET_TCP_ACK,
 					       0, 0, NULL, remote, pkt);
 	default:
-		return net_tcp_prepare_segment(tcp, NET_TCP_ACK, 0, 0, NULL,
-					       remote, pkt);
+		net_tcp_set_sack_opt(tcp, options, &optionlen);
+
+		return net_tcp_prepare_segment(tcp, NET_TCP_ACK, options,
+					       optionlen, NULL, remote, pkt);
 	}
 
 	return -EINVAL;
@@ -826,7 +1244,9 @@ int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 
 	net_stats_update_tcp_sent(net_pkt_iface(pkt), data_len);
 
+	k_mutex_lock(&context->tcp->sent_lock, K_FOREVER);
 	sys_slist_append(&context->tcp->sent_list, &pkt->sent_list);
+	k_mutex_unlock(&context->tcp->sent_lock);
 
 	/* We need to restart retry_timer if it is stopped. */
 	if (k_delayed_work_remaining_get(&context->tcp->retry_timer) == 0) {
@@ -843,7 +1263,8 @@ int net_tcp_send_pkt(struct net_pkt *pkt)
 {
 	struct net_context *ctx = net_pkt_context(pkt);
 	struct net_tcp_hdr hdr, *tcp_hdr;
-	bool calc_chksum = false;
+	u16_t chksum;
+	u32_t ack;
 
 	tcp_hdr = net_tcp_get_hdr(pkt, &hdr);
 	if (!tcp_hdr) {
@@ -851,9 +1272,16 @@ int net_tcp_send_pkt(struct net_pkt *pkt)
 		return -EMSGSIZE;
 	}
 
-	if (sys_get_be32(tcp_hdr->ack) != ctx->tcp->send_ack) {
+	/* The checksum of the packet is updated for the changed fields
+	 * only, see RFC 1624.
+	 */
+	chksum = ntohs(tcp_hdr->chksum);
+
+	ack = sys_get_be32(tcp_hdr->ack);
+	if (ack != ctx->tcp->send_ack) {
 		sys_put_be32(ctx->tcp->send_ack, tcp_hdr->ack);
-		calc_chksum = true;
+		chksum = net_chksum_update_32(chksum, ack,
+					      ctx->tcp->send_ack);
 	}
 
 	/* The data stream code always sets this flag, because
@@ -863,12 +1291,15 @@ int net_tcp_send_pkt(struct net_pkt *pkt)
 	 */
 	if (ctx->tcp->sent_ack != ctx->tcp->send_ack &&
 		(tcp_hdr->flags & NET_TCP_ACK) == 0) {
+		u16_t word = (tcp_hdr->offset << 8) | tcp_hdr->flags;
+
 		tcp_hdr->flags |= NET_TCP_ACK;
-		calc_chksum = true;
+		chksum = net_chksum_update_16(chksum, word,
+					      word | NET_TCP_ACK);
 	}
 
-	if (calc_chksum) {
-		net_tcp_set_chksum(pkt, pkt->frags);
+	if (net_if_need_calc_tx_checksum(net_pkt_iface(pkt))) {
+		tcp_hdr->chksum = htons(chksum);
 	}
 
 	if (tcp_hdr->flags & NET_TCP_FIN) {
@@ -900,6 +1331,8 @@ int net_tcp_send_pkt(struct net_pkt *pkt)
 		 * we should avoid the extra 6lowpan specific buffer copy
 		 * below.
 		 */
+		k_mutex_lock(&ctx->tcp->sent_lock, K_FOREVER);
+
 		SYS_SLIST_FOR_EACH_CONTAINER(&ctx->tcp->sent_list,
 					     check_pkt, sent_list) {
 			if (check_pkt == pkt) {
@@ -908,6 +1341,8 @@ int net_tcp_send_pkt(struct net_pkt *pkt)
 			}
 		}
 
+		k_mutex_unlock(&ctx->tcp->sent_lock);
+
 		if (pkt_in_slist) {
 			new_pkt = net_pkt_clone(pkt, ALLOC_TIMEOUT);
 			if (!new_pkt) {
@@ -957,36 +1392,67 @@ static void restart_timer(struct net_tcp *tcp)
 int net_tcp_send_data(struct net_context *context, net_context_send_cb_t cb,
 		      void *token, void *user_data)
 {
+	struct net_tcp *tcp = context->tcp;
+	u32_t flight = 0;
 	struct net_pkt *pkt;
+	u32_t wnd;
 
-	/* For now, just send all queued data synchronously.  Need to
-	 * add window handling and retry/ACK logic.
+	/* This is called both by the sender and, when an ACK opens the
+	 * window, by the RX thread, which releases the acked packets.
 	 */
-	SYS_SLIST_FOR_EACH_CONTAINER(&context->tcp->sent_list, pkt, sent_list) {
+	k_mutex_lock(&tcp->sent_lock, K_FOREVER);
+
+	wnd = min(tcp->cwnd, (u32_t)tcp->send_wnd);
+
+	/* Send the queued data synchronously as long as it fits in both
+	 * the congestion window and the window of the peer. One segment
+	 * is always sent when nothing is in flight, which also probes a
+	 * zero window. The rest is sent when ACKs open the window.
+	 */
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, pkt, sent_list) {
+		struct net_tcp_hdr hdr, *tcp_hdr;
+		u16_t len = net_pkt_appdatalen(pkt);
+		u32_t end;
+		int ret;
+
 		/* Do not resend packets that were sent by expire timer */
-		if (net_pkt_queued(pkt)) {
-			NET_DBG("[%p] Skipping pkt %p because it was already "
-				"sent.", context->tcp, pkt);
+		if (net_pkt_queued(pkt) || net_pkt_sent(pkt)) {
+			flight += len;
 			continue;
 		}
 
-		if (!net_pkt_sent(pkt)) {
-			int ret;
+		if (flight && flight + len > wnd) {
+			NET_DBG("[%p] %u bytes in flight, window %u",
+				tcp, flight, wnd);
+			break;
+		}
+
+		net_pkt_set_queued(pkt, true);
 
-			NET_DBG("[%p] Sending pkt %p (%zd bytes)", context->tcp,
-				pkt, net_pkt_get_len(pkt));
+		tcp_hdr = net_tcp_get_hdr(pkt, &hdr);
+		if (tcp_hdr) {
+			end = sys_get_be32(tcp_hdr->seq) + len;
 
-			ret = net_tcp_send_pkt(pkt);
-			if (ret < 0 && !is_6lo_technology(pkt)) {
-				NET_DBG("[%p] pkt %p not sent (%d)",
-					context->tcp, pkt, ret);
-				net_pkt_unref(pkt);
+			if (net_tcp_seq_greater(end, tcp->send_max)) {
+				tcp->send_max = end;
+				tcp_rtt_start(tcp, end);
 			}
+		}
 
-			net_pkt_set_queued(pkt, true);
+		NET_DBG("[%p] Sending pkt %p (%zd bytes)", tcp, pkt,
+			net_pkt_get_len(pkt));
+
+		ret = net_tcp_send_pkt(pkt);
+		if (ret < 0 && !is_6lo_technology(pkt)) {
+			NET_DBG("[%p] pkt %p not sent (%d)", tcp, pkt, ret);
+			net_pkt_unref(pkt);
 		}
+
+		flight += len;
 	}
 
+	k_mutex_unlock(&tcp->sent_lock);
+
 	/* Just make the callback synchronously even if it didn't
 	 * go over the wire.  In theory it would be nice to track
 	 * specific ACK locations in the stream and make the
@@ -1000,6 +1466,181 @@ int net_tcp_send_data(struct net_context *context, net_context_send_cb_t cb,
 	return 0;
 }
 
+/* RFC 5681 section 2, a duplicate ACK acknowledges the oldest
+ * outstanding segment again, carries no data and leaves the window as it
+ * was. This is checked before the ACK is processed.
+ */
+static bool tcp_is_dup_ack(struct net_tcp *tcp, struct net_tcp_hdr *tcp_hdr,
+			   u16_t data_len)
+{
+	struct net_tcp_hdr hdr, *sent_hdr;
+	struct net_pkt *pkt;
+
+	if (data_len || (NET_TCP_FLAGS(tcp_hdr) & (NET_TCP_SYN | NET_TCP_FIN)) ||
+	    tcp_peer_wnd(tcp, tcp_hdr) != tcp->send_wnd ||
+	    sys_slist_is_empty(&tcp->sent_list)) {
+		return false;
+	}
+
+	pkt = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
+			   struct net_pkt, sent_list);
+	if (!net_pkt_sent(pkt) && !net_pkt_queued(pkt)) {
+		return false;
+	}
+
+	sent_hdr = net_tcp_get_hdr(pkt, &hdr);
+
+	return sent_hdr &&
+		sys_get_be32(sent_hdr->seq) == sys_get_be32(tcp_hdr->ack);
+}
+
+/* Fast retransmit on the third duplicate ACK, RFC 5681 section 3.2 and
+ * RFC 6582 section 3.2.
+ */
+static void tcp_dup_ack(struct net_tcp *tcp)
+{
+	struct net_pkt *pkt;
+
+	if (tcp->flags & NET_TCP_FAST_RECOVERY) {
+		/* A segment has left the network. Its place is taken by
+		 * the next hole the peer reported, if any, or else by new
+		 * data as the window is inflated.
+		 */
+		if (!tcp_retransmit_next(tcp)) {
+			tcp->cwnd += tcp->send_mss;
+		}
+
+		return;
+	}
+
+	/* Losses of the window already being recovered are not
+	 * signalled again.
+	 */
+	if (tcp->flags & NET_TCP_RTO_RECOVERY) {
+		return;
+	}
+
+	if (++tcp->dup_acks < NET_TCP_DUP_ACK_THRESHOLD) {
+		return;
+	}
+
+	/* The oldest segment is the first one to resend */
+	pkt = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
+			   struct net_pkt, sent_list);
+
+	tcp->ssthresh = net_tcp_cc_ssthresh(tcp, tcp_flight_size(tcp));
+	tcp->cwnd = tcp->ssthresh + NET_TCP_DUP_ACK_THRESHOLD * tcp->send_mss;
+	tcp->recover = tcp->send_max;
+	tcp->high_rxt = tcp_pkt_seq(pkt);
+	tcp->flags |= NET_TCP_FAST_RECOVERY;
+
+	NET_DBG("[%p] fast retransmit, cwnd %u ssthresh %u", tcp,
+		tcp->cwnd, tcp->ssthresh);
+
+	tcp_retransmit_next(tcp);
+}
+
+/* Called when an ACK acknowledges new data */
+static void tcp_new_ack(struct net_tcp *tcp, u32_t ack, u32_t acked)
+{
+	tcp_rtt_update(tcp, ack);
+
+	tcp->dup_acks = 0;
+
+	if (net_tcp_seq_greater(ack, tcp->high_sacked)) {
+		tcp->high_sacked = ack;
+	}
+
+	if (net_tcp_seq_greater(ack, tcp->high_rxt)) {
+		tcp->high_rxt = ack;
+	}
+
+	if (tcp->flags & NET_TCP_FAST_RECOVERY) {
+		if (net_tcp_seq_greater(tcp->recover, ack)) {
+			/* Partial ACK, the next segment was lost too.
+			 * Deflate the window by the acked data but keep
+			 * one more segment in flight.
+			 */
+			tcp->cwnd -= min(acked, tcp->cwnd);
+			if (acked >= tcp->send_mss) {
+				tcp->cwnd += tcp->send_mss;
+			}
+
+			tcp_retransmit_next(tcp);
+			return;
+		}
+
+		/* Full ACK, deflate the window and leave fast recovery */
+		tcp->cwnd = min(tcp->ssthresh,
+				max(tcp_flight_size(tcp),
+				    (u32_t)tcp->send_mss) + tcp->send_mss);
+		tcp->flags &= ~NET_TCP_FAST_RECOVERY;
+		return;
+	}
+
+	if (tcp->flags & NET_TCP_RTO_RECOVERY) {
+		if (net_tcp_seq_greater(tcp->recover, ack)) {
+			tcp_retransmit(tcp);
+		} else {
+			tcp->flags &= ~NET_TCP_RTO_RECOVERY;
+		}
+	}
+
+	net_tcp_cc_ack(tcp, acked);
+}
+
+/* Mark the segments that the peer reports in the SACK blocks of an
+ * ACK, RFC 2018 section 5. The marks only steer what is resent in fast
+ * recovery, the segments are released by the cumulative ACK.
+ */
+static void tcp_sack_received(struct net_tcp *tcp, struct net_pkt *pkt,
+			      struct net_tcp_hdr *tcp_hdr)
+{
+	struct net_tcp_options tcp_opts = { 0 };
+	struct net_pkt *sent;
+	u32_t left, right, seq;
+	int i;
+
+	if (!(tcp->flags & NET_TCP_SACK_PERMITTED) ||
+	    NET_TCP_HDR_LEN(tcp_hdr) <= NET_TCPH_LEN ||
+	    net_tcp_parse_opts(pkt, NET_TCP_HDR_LEN(tcp_hdr) - NET_TCPH_LEN,
+			       &tcp_opts) < 0) {
+		return;
+	}
+
+	for (i = 0; i < tcp_opts.sack_count; i++) {
+		left = tcp_opts.sack[i].left;
+		right = tcp_opts.sack[i].right;
+
+		/* Ignore invalid blocks and blocks of data not sent */
+		if (!net_tcp_seq_greater(right, left) ||
+		    net_tcp_seq_greater(right, tcp->send_max)) {
+			continue;
+		}
+
+		SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, sent, sent_list) {
+			if (!net_pkt_sent(sent) && !net_pkt_queued(sent)) {
+				break;
+			}
+
+			seq = tcp_pkt_seq(sent);
+
+			if (net_tcp_seq_greater(seq + net_pkt_appdatalen(sent),
+						right)) {
+				break;
+			}
+
+			if (!net_tcp_seq_greater(left, seq)) {
+				net_pkt_set_sacked(sent, true);
+			}
+		}
+
+		if (net_tcp_seq_greater(right, tcp->high_sacked)) {
+			tcp->high_sacked = right;
+		}
+	}
+}
+
 bool net_tcp_ack_received(struct net_context *ctx, u32_t ack)
 {
 	struct net_tcp *tcp = ctx->tcp;
@@ -1007,6 +1648,7 @@ bool net_tcp_ack_received(struct net_context *ctx, u32_t ack)
 	sys_snode_t *head;
 	struct net_pkt *pkt;
 	u32_t seq;
+	u32_t acked = 0;
 	bool valid_ack = false;
 
 	if (net_tcp_seq_greater(ack, ctx->tcp->send_seq)) {
@@ -1053,10 +1695,15 @@ bool net_tcp_ack_received(struct net_context *ctx, u32_t ack)
 		}
 
 		sys_slist_remove(list, NULL, head);
+		acked += net_pkt_appdatalen(pkt);
 		net_pkt_unref(pkt);
 		valid_ack = true;
 	}
 
+	if (valid_ack) {
+		tcp_new_ack(tcp, ack, acked);
+	}
+
 	/* Restart the timer on a valid inbound ACK.  This isn't quite the
 	 * same behavior as per-packet retry timers, but is close in practice
 	 * (it starts retries one timer period after the connection
@@ -1202,8 +1849,7 @@ struct net_tcp_hdr *net_tcp_get_hdr(struct net_pkt *pkt,
 				    struct net_tcp_hdr *hdr)
 {
 	struct net_tcp_hdr *tcp_hdr;
-	struct net_buf *frag;
-	u16_t pos;
+	struct net_pkt_cursor cursor;
 
 	tcp_hdr = net_pkt_tcp_data(pkt);
 	if (!tcp_hdr) {
@@ -1215,28 +1861,15 @@ struct net_tcp_hdr *net_tcp_get_hdr(struct net_pkt *pkt,
 		return tcp_hdr;
 	}
 
-	frag = net_frag_read(pkt->frags, net_pkt_ip_hdr_len(pkt) +
-			     net_pkt_ipv6_ext_len(pkt),
-			     &pos, sizeof(hdr->src_port),
-			     (u8_t *)&hdr->src_port);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->dst_port),
-			     (u8_t *)&hdr->dst_port);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->seq), hdr->seq);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->ack), hdr->ack);
-	frag = net_frag_read_u8(frag, pos, &pos, &hdr->offset);
-	frag = net_frag_read_u8(frag, pos, &pos, &hdr->flags);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->wnd), hdr->wnd);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->chksum),
-			     (u8_t *)&hdr->chksum);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->urg), hdr->urg);
-
-	if (!frag && pos == 0xffff) {
+	if (net_pkt_cursor_init(&cursor, pkt, net_pkt_ip_hdr_len(pkt) +
+				net_pkt_ipv6_ext_len(pkt)) < 0 ||
+	    net_pkt_cursor_read(&cursor, hdr, NET_TCPH_LEN) < 0) {
 		/* If the pkt is compressed, then this is the typical outcome
 		 * so no use printing error in this case.
 		 */
 		if (IS_ENABLED(CONFIG_NET_DEBUG_TCP) &&
 		    !is_6lo_technology(pkt)) {
-			NET_ASSERT(frag);
+			NET_ASSERT(0);
 		}
 
 		return NULL;
@@ -1248,69 +1881,59 @@ struct net_tcp_hdr *net_tcp_get_hdr(struct net_pkt *pkt,
 struct net_tcp_hdr *net_tcp_set_hdr(struct net_pkt *pkt,
 				    struct net_tcp_hdr *hdr)
 {
-	struct net_buf *frag;
-	u16_t pos;
+	struct net_pkt_cursor cursor;
 
 	if (net_tcp_header_fits(pkt, hdr)) {
 		return hdr;
 	}
 
-	frag = net_pkt_write(pkt, pkt->frags, net_pkt_ip_hdr_len(pkt) +
-			     net_pkt_ipv6_ext_len(pkt),
-			     &pos, sizeof(hdr->src_port),
-			     (u8_t *)&hdr->src_port, ALLOC_TIMEOUT);
-	frag = net_pkt_write(pkt, frag, pos, &pos, sizeof(hdr->dst_port),
-			     (u8_t *)&hdr->dst_port, ALLOC_TIMEOUT);
-	frag = net_pkt_write(pkt, frag, pos, &pos, sizeof(hdr->seq), hdr->seq,
-			     ALLOC_TIMEOUT);
-	frag = net_pkt_write(pkt, frag, pos, &pos, sizeof(hdr->ack), hdr->ack,
-			     ALLOC_TIMEOUT);
-	frag = net_pkt_write(pkt, frag, pos, &pos, sizeof(hdr->offset),
-			     &hdr->offset, ALLOC_TIMEOUT);
-	frag = net_pkt_write(pkt, frag, pos, &pos, sizeof(hdr->flags),
-			     &hdr->flags, ALLOC_TIMEOUT);
-	frag = net_pkt_write(pkt, frag, pos, &pos, sizeof(hdr->wnd), hdr->wnd,
-			     ALLOC_TIMEOUT);
-	frag = net_pkt_write(pkt, frag, pos, &pos, sizeof(hdr->chksum),
-			     (u8_t *)&hdr->chksum, ALLOC_TIMEOUT);
-	frag = net_pkt_write(pkt, frag, pos, &pos, sizeof(hdr->urg), hdr->urg,
-			     ALLOC_TIMEOUT);
-
-	if (!frag) {
-		NET_ASSERT(frag);
+	if (net_pkt_cursor_init(&cursor, pkt, net_pkt_ip_hdr_len(pkt) +
+				net_pkt_ipv6_ext_len(pkt)) < 0 ||
+	    net_pkt_cursor_write(&cursor, hdr, NET_TCPH_LEN,
+				 ALLOC_TIMEOUT) < 0) {
+		NET_ASSERT(0);
 		return NULL;
 	}
 
 	return hdr;
 }
 
+/* Cursor at the checksum of the TCP header starting in frag */
+static int tcp_chksum_cursor(struct net_pkt_cursor *cursor,
+			     struct net_pkt *pkt, struct net_buf *frag)
+{
+	net_pkt_cursor_init_frag(cursor, pkt, frag, 0);
+
+	return net_pkt_cursor_skip(cursor, net_pkt_ip_hdr_len(pkt) +
+				   net_pkt_ipv6_ext_len(pkt) +
+				   2 + 2 + 4 + 4 + /* src + dst + seq + ack */
+				   1 + 1 + 2 /* offset + flags + wnd */);
+}
+
 u16_t net_tcp_get_chksum(struct net_pkt *pkt, struct net_buf *frag)
 {
+	struct net_pkt_cursor cursor;
 	struct net_tcp_hdr *hdr;
-	u16_t chksum;
-	u16_t pos;
+	u16_t chksum = 0;
 
 	hdr = net_pkt_tcp_data(pkt);
 	if (net_tcp_header_fits(pkt, hdr)) {
 		return hdr->chksum;
 	}
 
-	frag = net_frag_read(frag,
-			     net_pkt_ip_hdr_len(pkt) +
-			     net_pkt_ipv6_ext_len(pkt) +
-			     2 + 2 + 4 + 4 + /* src + dst + seq + ack */
-			     1 + 1 + 2 /* offset + flags + wnd */,
-			     &pos, sizeof(chksum), (u8_t *)&chksum);
-	NET_ASSERT(frag);
+	if (tcp_chksum_cursor(&cursor, pkt, frag) < 0 ||
+	    net_pkt_cursor_read(&cursor, &chksum, sizeof(chksum)) < 0) {
+		NET_ASSERT(0);
+	}
 
 	return chksum;
 }
 
 struct net_buf *net_tcp_set_chksum(struct net_pkt *pkt, struct net_buf *frag)
 {
+	struct net_pkt_cursor cursor, chksum_cursor;
 	struct net_tcp_hdr *hdr;
 	u16_t chksum = 0;
-	u16_t pos;
 
 	hdr = net_pkt_tcp_data(pkt);
 	if (net_tcp_header_fits(pkt, hdr)) {
@@ -1320,43 +1943,48 @@ struct net_buf *net_tcp_set_chksum(struct net_pkt *pkt, struct net_buf *frag)
 		return frag;
 	}
 
+	if (tcp_chksum_cursor(&cursor, pkt, frag) < 0) {
+		NET_ASSERT(0);
+		return NULL;
+	}
+
 	/* We need to set the checksum to 0 first before the calc */
-	frag = net_pkt_write(pkt, frag,
-			     net_pkt_ip_hdr_len(pkt) +
-			     net_pkt_ipv6_ext_len(pkt) +
-			     2 + 2 + 4 + 4 + /* src + dst + seq + ack */
-			     1 + 1 + 2 /* offset + flags + wnd */,
-			     &pos, sizeof(chksum), (u8_t *)&chksum,
-			     ALLOC_TIMEOUT);
+	chksum_cursor = cursor;
+	if (net_pkt_cursor_write(&cursor, &chksum, sizeof(chksum),
+				 ALLOC_TIMEOUT) < 0) {
+		NET_ASSERT(0);
+		return NULL;
+	}
 
 	chksum = ~net_calc_chksum_tcp(pkt);
 
-	frag = net_pkt_write(pkt, frag, pos - 2, &pos, sizeof(chksum),
-			     (u8_t *)&chksum, ALLOC_TIMEOUT);
-
-	NET_ASSERT(frag);
+	net_pkt_cursor_write(&chksum_cursor, &chksum, sizeof(chksum),
+			     ALLOC_TIMEOUT);
 
-	return frag;
+	return chksum_cursor.frag;
 }
 
 int net_tcp_parse_opts(struct net_pkt *pkt, int opt_totlen,
 		       struct net_tcp_options *opts)
 {
-	struct net_buf *frag = pkt->frags;
+	struct net_pkt_cursor cursor;
+	struct net_tcp_sack_block *block;
 	u16_t pos = net_pkt_ip_hdr_len(pkt)
 		  + net_pkt_ipv6_ext_len(pkt)
 		  + sizeof(struct net_tcp_hdr);
 	u8_t opt, optlen;
+	u8_t i;
 
 	/* TODO: this should be done for each TCP pkt, on reception */
-	if (pos + opt_totlen > net_pkt_get_len(pkt)) {
+	if (pos + opt_totlen > net_pkt_get_len(pkt) ||
+	    net_pkt_cursor_init(&cursor, pkt, pos) < 0) {
 		NET_ERR("Truncated pkt len: %d, expected: %d",
 			(int)net_pkt_get_len(pkt), pos + opt_totlen);
 		return -EINVAL;
 	}
 
 	while (opt_totlen) {
-		frag = net_frag_read(frag, pos, &pos, sizeof(opt), &opt);
+		net_pkt_cursor_read_u8(&cursor, &opt);
 		opt_totlen--;
 
 		/* https://www.iana.org/assignments/tcp-parameters/tcp-parameters.xhtml#tcp-parameters-1 */
@@ -1376,7 +2004,7 @@ int net_tcp_parse_opts(struct net_pkt *pkt, int opt_totlen,
 			goto error;
 		}
 
-		frag = net_frag_read(frag, pos, &pos, sizeof(optlen), &optlen);
+		net_pkt_cursor_read_u8(&cursor, &optlen);
 		opt_totlen--;
 		if (optlen < 2) {
 			goto error;
@@ -1395,11 +2023,44 @@ int net_tcp_parse_opts(struct net_pkt *pkt, int opt_totlen,
 			if (optlen != 2) {
 				goto error;
 			}
-			frag = net_frag_read_be16(frag, pos, &pos,
-						  &opts->mss);
+			net_pkt_cursor_read_be16(&cursor, &opts->mss);
+			break;
+		case NET_TCP_WINDOW_SCALE_OPT:
+			if (optlen != 1) {
+				goto error;
+			}
+			net_pkt_cursor_read_u8(&cursor, &opts->wscale);
+			opts->window_scale = true;
+			break;
+		case NET_TCP_SACK_PERM_OPT:
+			if (optlen != 0) {
+				goto error;
+			}
+			opts->sack_permitted = true;
+			break;
+		case NET_TCP_SACK_OPT:
+			if (!optlen || optlen % NET_TCP_SACK_BLOCK_SIZE) {
+				goto error;
+			}
+
+			/* The first blocks are the most recent ones */
+			for (i = 0; i < optlen / NET_TCP_SACK_BLOCK_SIZE; i++) {
+				if (i >= NET_TCP_MAX_SACK_BLOCKS) {
+					net_pkt_cursor_skip(&cursor,
+						NET_TCP_SACK_BLOCK_SIZE);
+					continue;
+				}
+
+				block = &opts->sack[i];
+				net_pkt_cursor_read_be32(&cursor, &block->left);
+				net_pkt_cursor_read_be32(&cursor,
+							 &block->right);
+			}
+
+			opts->sack_count = min(i, NET_TCP_MAX_SACK_BLOCKS);
 			break;
 		default:
-			frag = net_frag_skip(frag, pos, &pos, optlen);
+			net_pkt_cursor_skip(&cursor, optlen);
 			break;
 		}
 
@@ -1501,7 +2162,8 @@ int net_tcp_update_recv_wnd(struct net_context *context, s32_t delta)
 	}
 
 	new_win = context->tcp->recv_wnd + delta;
-	if (new_win < 0 || new_win > UINT16_MAX) {
+	if (new_win < 0 ||
+	    new_win > ((s32_t)UINT16_MAX << context->tcp->recv_wscale)) {
 		return -EINVAL;
 	}
 
@@ -1594,7 +2256,7 @@ static int tcp_backlog_find(struct net_pkt *pkt, int *empty_slot)
 }
 
 static int tcp_backlog_syn(struct net_pkt *pkt, struct net_context *context,
-			   u16_t send_mss)
+			   struct net_tcp_options *opts)
 {
 	int empty_slot = -1;
 	int ret;
@@ -1620,7 +2282,7 @@ static int tcp_backlog_syn(struct net_pkt *pkt, struct net_context *context,
 
 	tcp_backlog[empty_slot].send_seq = context->tcp->send_seq;
 	tcp_backlog[empty_slot].send_ack = context->tcp->send_ack;
-	tcp_backlog[empty_slot].send_mss = send_mss;
+	tcp_backlog[empty_slot].opts = *opts;
 
 	k_delayed_work_init(&tcp_backlog[empty_slot].ack_timer,
 			    backlog_ack_timeout);
@@ -1654,7 +2316,9 @@ static int tcp_backlog_ack(struct net_pkt *pkt, struct net_context *context)
 		sizeof(struct sockaddr));
 	context->tcp->send_seq = tcp_backlog[r].send_seq + 1;
 	context->tcp->send_ack = tcp_backlog[r].send_ack;
-	context->tcp->send_mss = tcp_backlog[r].send_mss;
+
+	tcp_syn_opts_received(context->tcp, &tcp_backlog[r].opts);
+	tcp_send_init(context->tcp, tcp_hdr);
 
 	k_delayed_work_cancel(&tcp_backlog[r].ack_timer);
 	memset(&tcp_backlog[r], 0, sizeof(struct tcp_backlog_entry));
@@ -1836,6 +2500,8 @@ static inline int send_syn_segment(struct net_context *context,
 
 	if (flags == NET_TCP_SYN) {
 		net_tcp_set_syn_opt(context->tcp, options, &optionlen);
+	} else {
+		net_tcp_set_wnd_sack_opt(context->tcp, options, &optionlen);
 	}
 
 	ret = net_tcp_prepare_segment(context->tcp, flags, options, optionlen,
@@ -1924,6 +2590,123 @@ static int send_reset(struct net_context *context,
 	return ret;
 }
 
+/* RX packets that queueing a segment out of order must leave free, for
+ * the segment that fills the hole and for the other connections
+ */
+#define OOO_RX_RESERVE 2
+
+/* Keep a data segment that arrived after a missing one, until the
+ * missing data has been received. Called with sent_lock held. Returns
+ * false if the segment is not queued, because it is out of the window,
+ * already queued, the queue is full or few RX packets are left.
+ */
+static bool tcp_ooo_queue(struct net_tcp *tcp, struct net_pkt *pkt,
+			  u32_t seq, u16_t len)
+{
+	struct net_pkt *queued, *prev = NULL;
+	struct k_mem_slab *rx;
+	u32_t end = seq + len;
+	u32_t queued_seq;
+
+	net_pkt_get_info(&rx, NULL, NULL, NULL);
+
+	if (tcp->ooo_count >= CONFIG_NET_TCP_OOO_QUEUE_SIZE ||
+	    k_mem_slab_num_free_get(rx) < OOO_RX_RESERVE ||
+	    net_tcp_seq_greater(end, tcp->send_ack + tcp->recv_wnd)) {
+		return false;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->ooo_list, queued, sent_list) {
+		queued_seq = tcp_pkt_seq(queued);
+
+		if (net_tcp_seq_greater(queued_seq, seq)) {
+			break;
+		}
+
+		if (!net_tcp_seq_greater(end, queued_seq +
+					 net_pkt_appdatalen(queued))) {
+			return false;
+		}
+
+		prev = queued;
+	}
+
+	/* An incoming packet is not in a sent list, so the node is free */
+	if (prev) {
+		sys_slist_insert(&tcp->ooo_list, &prev->sent_list,
+				 &pkt->sent_list);
+	} else {
+		sys_slist_prepend(&tcp->ooo_list, &pkt->sent_list);
+	}
+
+	tcp->ooo_count++;
+	tcp->ooo_last_seq = seq;
+
+	NET_DBG("[%p] queued seq %u len %u, %u out of order", tcp, seq, len,
+		tcp->ooo_count);
+
+	return true;
+}
+
+/* Move the data of the queued segments that have become contiguous to
+ * the in order segment pkt, which ends at end. Their headers and the
+ * data received already are dropped, and the fragments are appended to
+ * pkt. Called with sent_lock held. Returns the number of bytes appended.
+ */
+static u16_t tcp_ooo_merge(struct net_tcp *tcp, struct net_pkt *pkt,
+			   u32_t end)
+{
+	struct net_pkt *queued;
+	struct net_buf *frag;
+	u32_t seq, queued_end;
+	u16_t added = 0;
+	u16_t skip;
+
+	while (!sys_slist_is_empty(&tcp->ooo_list)) {
+		queued = CONTAINER_OF(sys_slist_peek_head(&tcp->ooo_list),
+				      struct net_pkt, sent_list);
+
+		seq = tcp_pkt_seq(queued);
+		queued_end = seq + net_pkt_appdatalen(queued);
+
+		if (net_tcp_seq_greater(seq, end) ||
+		    net_pkt_appdatalen(pkt) + added + (queued_end - end) >
+		    UINT16_MAX) {
+			break;
+		}
+
+		sys_slist_remove(&tcp->ooo_list, NULL, &queued->sent_list);
+		tcp->ooo_count--;
+
+		if (net_tcp_seq_greater(queued_end, end)) {
+			skip = net_pkt_get_len(queued) -
+				net_pkt_appdatalen(queued) + (end - seq);
+
+			while (skip) {
+				frag = queued->frags;
+
+				if (frag->len > skip) {
+					net_buf_pull(frag, skip);
+					break;
+				}
+
+				skip -= frag->len;
+				net_pkt_frag_del(queued, NULL, frag);
+			}
+
+			net_pkt_frag_add(pkt, queued->frags);
+			queued->frags = NULL;
+
+			added += queued_end - end;
+			end = queued_end;
+		}
+
+		net_pkt_unref(queued);
+	}
+
+	return added;
+}
+
 /* This is called when we receive data after the connection has been
  * established. The core TCP logic is located here.
  */
@@ -1968,11 +2751,34 @@ resend_ack:
 
 	if (net_tcp_seq_cmp(sys_get_be32(tcp_hdr->seq),
 			    context->tcp->send_ack) > 0) {
-		/* Don't try to reorder packets.  If it doesn't
-		 * match the next segment exactly, drop and wait for
-		 * retransmit
+		/* Some data before this segment is missing. The data is
+		 * queued and acknowledged selectively, and an immediate
+		 * duplicate ACK lets the peer resend the missing data
+		 * without waiting for a timeout, RFC 5681 section 4.2.
 		 */
-		return NET_DROP;
+		if (tcp_flags & (NET_TCP_SYN | NET_TCP_FIN | NET_TCP_RST)) {
+			return NET_DROP;
+		}
+
+		net_context_set_appdata_values(pkt, IPPROTO_TCP);
+
+		data_len = net_pkt_appdatalen(pkt);
+		if (!data_len) {
+			return NET_DROP;
+		}
+
+		k_mutex_lock(&context->tcp->sent_lock, K_FOREVER);
+
+		if (!tcp_ooo_queue(context->tcp, pkt,
+				   sys_get_be32(tcp_hdr->seq), data_len)) {
+			ret = NET_DROP;
+		}
+
+		k_mutex_unlock(&context->tcp->sent_lock);
+
+		send_ack(context, &conn->remote_addr, true);
+
+		return ret;
 	}
 
 	/*
@@ -2000,13 +2806,37 @@ resend_ack:
 		return NET_DROP;
 	}
 
+	net_context_set_appdata_values(pkt, IPPROTO_TCP);
+
+	data_len = net_pkt_appdatalen(pkt);
+
 	/* Handle TCP state transition */
 	if (tcp_flags & NET_TCP_ACK) {
+		bool dup_ack;
+
+		k_mutex_lock(&context->tcp->sent_lock, K_FOREVER);
+
+		dup_ack = tcp_is_dup_ack(context->tcp, tcp_hdr, data_len);
+
 		if (!net_tcp_ack_received(context,
 				     sys_get_be32(tcp_hdr->ack))) {
+			k_mutex_unlock(&context->tcp->sent_lock);
 			return NET_DROP;
 		}
 
+		tcp_sack_received(context->tcp, pkt, tcp_hdr);
+
+		if (dup_ack) {
+			tcp_dup_ack(context->tcp);
+		}
+
+		context->tcp->send_wnd = tcp_peer_wnd(context->tcp, tcp_hdr);
+
+		/* Send the data the window has room for now */
+		net_tcp_send_data(context, NULL, NULL, NULL);
+
+		k_mutex_unlock(&context->tcp->sent_lock);
+
 		/* TCP state might be changed after maintaining the sent pkt
 		 * list, e.g., an ack of FIN is received.
 		 */
@@ -2048,9 +2878,6 @@ resend_ack:
 		context->tcp->fin_rcvd = 1;
 	}
 
-	net_context_set_appdata_values(pkt, IPPROTO_TCP);
-
-	data_len = net_pkt_appdatalen(pkt);
 	if (data_len > net_tcp_get_recv_wnd(context->tcp)) {
 		/* In case we have zero window, we should still accept
 		 * Zero Window Probes from peer, which per convention
@@ -2070,6 +2897,18 @@ resend_ack:
 		return NET_DROP;
 	}
 
+	/* The segment may fill the hole before queued segments */
+	if (data_len > 0 && !(tcp_flags & NET_TCP_FIN) &&
+	    !sys_slist_is_empty(&context->tcp->ooo_list)) {
+		k_mutex_lock(&context->tcp->sent_lock, K_FOREVER);
+		data_len += tcp_ooo_merge(context->tcp, pkt,
+					  sys_get_be32(tcp_hdr->seq) +
+					  data_len);
+		k_mutex_unlock(&context->tcp->sent_lock);
+
+		net_pkt_set_appdatalen(pkt, data_len);
+	}
+
 	/* If the pkt has appdata, notify the recv callback which should
 	 * release the pkt. Otherwise, release the pkt immediately.
 	 */
@@ -2111,6 +2950,9 @@ NET_CONN_CB(tcp_synack_received)
 {
 	struct net_context *context = (struct net_context *)user_data;
 	struct net_tcp_hdr hdr, *tcp_hdr;
+	struct net_tcp_options tcp_opts = {
+		.mss = NET_TCP_DEFAULT_MSS,
+	};
 	int ret;
 
 	NET_ASSERT(context && context->tcp);
@@ -2165,6 +3007,11 @@ NET_CONN_CB(tcp_synack_received)
 		struct sockaddr local_addr;
 		struct sockaddr remote_addr;
 
+		if (net_tcp_parse_opts(pkt, NET_TCP_HDR_LEN(tcp_hdr) -
+				       NET_TCPH_LEN, &tcp_opts) < 0) {
+			return NET_DROP;
+		}
+
 		if (net_pkt_get_src_addr(
 			pkt, &remote_addr, sizeof(remote_addr)) < 0) {
 			NET_DBG("Cannot parse remote address"
@@ -2193,6 +3040,9 @@ NET_CONN_CB(tcp_synack_received)
 			return NET_DROP;
 		}
 
+		tcp_syn_opts_received(context->tcp, &tcp_opts);
+		tcp_send_init(context->tcp, tcp_hdr);
+
 		net_tcp_change_state(context->tcp, NET_TCP_ESTABLISHED);
 		net_context_set_state(context, NET_CONTEXT_CONNECTED);
 
@@ -2332,9 +3182,12 @@ NET_CONN_CB(tcp_syn_rcvd)
 		context->tcp->send_ack =
 			sys_get_be32(tcp_hdr->seq) + 1;
 
-		/* Get MSS from TCP options here*/
+		/* The options of the SYN-ACK depend on those of the SYN,
+		 * and the connection gets them from the backlog.
+		 */
+		tcp_syn_opts_received(tcp, &tcp_opts);
 
-		r = tcp_backlog_syn(pkt, context, tcp_opts.mss);
+		r = tcp_backlog_syn(pkt, context, &tcp_opts);
 		if (r < 0) {
 			if (r == -EADDRINUSE) {
 				NET_DBG("TCP connection already exists");
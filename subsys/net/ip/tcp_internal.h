@@ -44,6 +44,21 @@ extern "C" {
 /** MSS option has been set already */
 #define NET_TCP_RECV_MSS_SET BIT(5)
 
+/** A segment is being timed for the round-trip time estimate */
+#define NET_TCP_RTT_MEASURING BIT(6)
+
+/** Fast recovery after a fast retransmit, RFC 6582 */
+#define NET_TCP_FAST_RECOVERY BIT(7)
+
+/** Resending the segments lost before a retransmission timeout */
+#define NET_TCP_RTO_RECOVERY BIT(8)
+
+/** Window scaling is offered or in use, RFC 7323 */
+#define NET_TCP_WINDOW_SCALING BIT(9)
+
+/** Selective acknowledgments are offered or in use, RFC 2018 */
+#define NET_TCP_SACK_PERMITTED BIT(10)
+
 /*
  * TCP connection states
  */
@@ -84,26 +99,58 @@ enum net_tcp_state {
 /* TCP max window size */
 #define NET_TCP_MAX_WIN   (4 * 1024)
 
+/* Number of duplicate ACKs that trigger a fast retransmit, RFC 5681 */
+#define NET_TCP_DUP_ACK_THRESHOLD 3
+
+/* Upper bound of the retransmission timeout, RFC 6298 */
+#define NET_TCP_MAX_RTO K_SECONDS(60)
+
 /* Maximal value of the sequence number */
 #define NET_TCP_MAX_SEQ   0xffffffff
 
-#define NET_TCP_MAX_OPT_SIZE  8
+/* Largest options we send, SACK blocks with their padding */
+#define NET_TCP_MAX_OPT_SIZE  28
 
 /* TCP Option codes */
 #define NET_TCP_END_OPT          0
 #define NET_TCP_NOP_OPT          1
 #define NET_TCP_MSS_OPT          2
 #define NET_TCP_WINDOW_SCALE_OPT 3
+#define NET_TCP_SACK_PERM_OPT    4
+#define NET_TCP_SACK_OPT         5
 
 /* TCP Option sizes */
 #define NET_TCP_END_SIZE          1
 #define NET_TCP_NOP_SIZE          1
 #define NET_TCP_MSS_SIZE          4
 #define NET_TCP_WINDOW_SCALE_SIZE 3
+#define NET_TCP_SACK_PERM_SIZE    2
+#define NET_TCP_SACK_BLOCK_SIZE   8
+
+/* Largest window scale shift, RFC 7323 section 2.3 */
+#define NET_TCP_MAX_WINDOW_SCALE 14
+
+/* SACK blocks sent in an ACK, and kept from a received one */
+#define NET_TCP_MAX_SACK_BLOCKS 3
+
+/** Block of data received out of order, from a SACK option */
+struct net_tcp_sack_block {
+	u32_t left;
+	u32_t right;
+};
 
 /** Parsed TCP option values for net_tcp_parse_opts()  */
 struct net_tcp_options {
 	u16_t mss;
+	/** Window scale shift, valid if window_scale is set */
+	u8_t wscale;
+	/** Window scale option found */
+	bool window_scale;
+	/** SACK permitted option found */
+	bool sack_permitted;
+	/** Number of blocks in sack */
+	u8_t sack_count;
+	struct net_tcp_sack_block sack[NET_TCP_MAX_SACK_BLOCKS];
 };
 
 /* Max received bytes to buffer internally */
@@ -136,6 +183,11 @@ struct net_tcp {
 	/** List pointer used for TCP retransmit buffering */
 	sys_slist_t sent_list;
 
+	/** Lock of sent_list and ooo_list, used by the sender, the RX
+	 * thread, the retransmit and ACK timers and on release.
+	 */
+	struct k_mutex sent_lock;
+
 	/** Current sequence number. */
 	u32_t send_seq;
 
@@ -158,25 +210,82 @@ struct net_tcp {
 	/**
 	 * Current TCP receive window for our side
 	 */
-	u16_t recv_wnd;
+	u32_t recv_wnd;
 
 	/**
 	 * Send MSS for the peer
 	 */
 	u16_t send_mss;
 
+	/** Receive window advertised by the peer, scaled */
+	u32_t send_wnd;
+
+	/** Duplicate ACKs received in a row */
+	u8_t dup_acks;
+
+	/** Highest sequence number sent so far */
+	u32_t send_max;
+
+	/** Congestion window, in bytes */
+	u32_t cwnd;
+
+	/** Slow start threshold, in bytes */
+	u32_t ssthresh;
+
+	/** Highest sequence number sent when the loss recovery started */
+	u32_t recover;
+
+	/** Smoothed round-trip time, in 1/8 ms */
+	u32_t srtt;
+
+	/** Round-trip time variation, in 1/4 ms */
+	u32_t rttvar;
+
+	/** Current retransmission timeout, in ms */
+	u32_t rto;
+
+	/** Sequence number whose ACK ends the ongoing RTT measurement */
+	u32_t rtt_seq;
+
+	/** Uptime when the timed segment was sent, in ms */
+	u32_t rtt_time;
+
+	/** Private state of the congestion control algorithm */
+	u32_t cc_state[4];
+
+	/** Highest sequence number selectively acknowledged by the peer */
+	u32_t high_sacked;
+
+	/** Highest sequence number resent in the ongoing loss recovery */
+	u32_t high_rxt;
+
+	/** Segments received out of order, in sequence number order,
+	 * locked by sent_lock
+	 */
+	sys_slist_t ooo_list;
+
+	/** Sequence number of the last segment queued to ooo_list */
+	u32_t ooo_last_seq;
+
+	/** Number of segments in ooo_list */
+	u8_t ooo_count;
+
 	/** Current retransmit period */
 	u32_t retry_timeout_shift : 5;
 	/** Flags for the TCP */
-	u32_t flags : 8;
+	u32_t flags : 11;
 	/** Current TCP state */
 	u32_t state : 4;
 	/* An outbound FIN packet has been sent */
 	u32_t fin_sent : 1;
 	/* An inbound FIN packet has been received */
 	u32_t fin_rcvd : 1;
+	/** Window scale shift of the peer, RFC 7323 */
+	u32_t send_wscale : 4;
+	/** Window scale shift of our side */
+	u32_t recv_wscale : 4;
 	/** Remaining bits in this u32_t */
-	u32_t _padding : 13;
+	u32_t _padding : 2;
 };
 
 typedef void (*net_tcp_cb_t)(struct net_tcp *tcp, void *user_data);
@@ -551,6 +660,41 @@ int net_tcp_connect(struct net_context *context,
 		    net_context_connect_cb_t cb,
 		    void *user_data);
 
+/**
+ * @brief Congestion control (CC) initialization.
+ *
+ * @details Set the initial congestion window and slow start threshold.
+ * This function is called when the connection is established and the
+ * send MSS is known.
+ *
+ * @param tcp TCP context
+ */
+void net_tcp_cc_init(struct net_tcp *tcp);
+
+/**
+ * @brief Congestion control (CC) new data acknowledged.
+ *
+ * @details Grow the congestion window when new data is acknowledged
+ * outside of loss recovery, i.e. slow start and congestion avoidance.
+ *
+ * @param tcp TCP context
+ * @param acked Number of bytes acknowledged
+ */
+void net_tcp_cc_ack(struct net_tcp *tcp, u32_t acked);
+
+/**
+ * @brief Congestion control (CC) loss detected.
+ *
+ * @details Called when a segment loss is detected, either by duplicate
+ * ACKs or by the retransmission timer.
+ *
+ * @param tcp TCP context
+ * @param flight Number of bytes sent and not yet acknowledged
+ *
+ * @return New slow start threshold
+ */
+u32_t net_tcp_cc_ssthresh(struct net_tcp *tcp, u32_t flight);
+
 #else
 static inline struct net_tcp *net_tcp_alloc(struct net_context *context)
 {
@@ -121,11 +121,22 @@ fail:
 	return NULL;
 }
 
+/* Cursor at the checksum of the UDP header starting in frag */
+static int udp_chksum_cursor(struct net_pkt_cursor *cursor,
+			     struct net_pkt *pkt, struct net_buf *frag)
+{
+	net_pkt_cursor_init_frag(cursor, pkt, frag, 0);
+
+	return net_pkt_cursor_skip(cursor, net_pkt_ip_hdr_len(pkt) +
+				   net_pkt_ipv6_ext_len(pkt) +
+				   2 + 2 + 2 /* src + dst + len */);
+}
+
 struct net_buf *net_udp_set_chksum(struct net_pkt *pkt, struct net_buf *frag)
 {
+	struct net_pkt_cursor cursor, chksum_cursor;
 	struct net_udp_hdr *hdr;
 	u16_t chksum = 0;
-	u16_t pos;
 
 	hdr = net_pkt_udp_data(pkt);
 	if (net_udp_header_fits(pkt, hdr)) {
@@ -135,41 +146,42 @@ struct net_buf *net_udp_set_chksum(struct net_pkt *pkt, struct net_buf *frag)
 		return frag;
 	}
 
+	if (udp_chksum_cursor(&cursor, pkt, frag) < 0) {
+		NET_ASSERT(0);
+		return NULL;
+	}
+
 	/* We need to set the checksum to 0 first before the calc */
-	frag = net_pkt_write(pkt, frag,
-			     net_pkt_ip_hdr_len(pkt) +
-			     net_pkt_ipv6_ext_len(pkt) +
-			     2 + 2 + 2 /* src + dst + len */,
-			     &pos, sizeof(chksum), (u8_t *)&chksum,
-			     PKT_WAIT_TIME);
+	chksum_cursor = cursor;
+	if (net_pkt_cursor_write(&cursor, &chksum, sizeof(chksum),
+				 PKT_WAIT_TIME) < 0) {
+		NET_ASSERT(0);
+		return NULL;
+	}
 
 	chksum = ~net_calc_chksum_udp(pkt);
 
-	frag = net_pkt_write(pkt, frag, pos - 2, &pos, sizeof(chksum),
-			     (u8_t *)&chksum, PKT_WAIT_TIME);
-
-	NET_ASSERT(frag);
+	net_pkt_cursor_write(&chksum_cursor, &chksum, sizeof(chksum),
+			     PKT_WAIT_TIME);
 
-	return frag;
+	return chksum_cursor.frag;
 }
 
 u16_t net_udp_get_chksum(struct net_pkt *pkt, struct net_buf *frag)
 {
+	struct net_pkt_cursor cursor;
 	struct net_udp_hdr *hdr;
-	u16_t chksum;
-	u16_t pos;
+	u16_t chksum = 0;
 
 	hdr = net_pkt_udp_data(pkt);
 	if (net_udp_header_fits(pkt, hdr)) {
 		return hdr->chksum;
 	}
 
-	frag = net_frag_read(frag,
-			     net_pkt_ip_hdr_len(pkt) +
-			     net_pkt_ipv6_ext_len(pkt) +
-			     2 + 2 + 2 /* src + dst + len */,
-			     &pos, sizeof(chksum), (u8_t *)&chksum);
-	NET_ASSERT(frag);
+	if (udp_chksum_cursor(&cursor, pkt, frag) < 0 ||
+	    net_pkt_cursor_read(&cursor, &chksum, sizeof(chksum)) < 0) {
+		NET_ASSERT(0);
+	}
 
 	return chksum;
 }
@@ -178,26 +190,17 @@ struct net_udp_hdr *net_udp_get_hdr(struct net_pkt *pkt,
 				    struct net_udp_hdr *hdr)
 {
 	struct net_udp_hdr *udp_hdr;
-	struct net_buf *frag;
-	u16_t pos;
+	struct net_pkt_cursor cursor;
 
 	udp_hdr = net_pkt_udp_data(pkt);
 	if (net_udp_header_fits(pkt, udp_hdr)) {
 		return udp_hdr;
 	}
 
-	frag = net_frag_read(pkt->frags, net_pkt_ip_hdr_len(pkt) +
-			     net_pkt_ipv6_ext_len(pkt),
-			     &pos, sizeof(hdr->src_port),
-			     (u8_t *)&hdr->src_port);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->dst_port),
-			     (u8_t *)&hdr->dst_port);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->len),
-			     (u8_t *)&hdr->len);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->chksum),
-			     (u8_t *)&hdr->chksum);
-	if (!frag) {
-		NET_ASSERT(frag);
+	if (net_pkt_cursor_init(&cursor, pkt, net_pkt_ip_hdr_len(pkt) +
+				net_pkt_ipv6_ext_len(pkt)) < 0 ||
+	    net_pkt_cursor_read(&cursor, hdr, sizeof(*hdr)) < 0) {
+		NET_ASSERT(0);
 		return NULL;
 	}
 
@@ -207,26 +210,17 @@ struct net_udp_hdr *net_udp_get_hdr(struct net_pkt *pkt,
 struct net_udp_hdr *net_udp_set_hdr(struct net_pkt *pkt,
 				    struct net_udp_hdr *hdr)
 {
-	struct net_buf *frag;
-	u16_t pos;
+	struct net_pkt_cursor cursor;
 
 	if (net_udp_header_fits(pkt, hdr)) {
 		return hdr;
 	}
 
-	frag = net_pkt_write(pkt, pkt->frags, net_pkt_ip_hdr_len(pkt) +
-			     net_pkt_ipv6_ext_len(pkt),
-			     &pos, sizeof(hdr->src_port),
-			     (u8_t *)&hdr->src_port, PKT_WAIT_TIME);
-	frag = net_pkt_write(pkt, frag, pos, &pos, sizeof(hdr->dst_port),
-			     (u8_t *)&hdr->dst_port, PKT_WAIT_TIME);
-	frag = net_pkt_write(pkt, frag, pos, &pos, sizeof(hdr->len),
-			     (u8_t *)&hdr->len, PKT_WAIT_TIME);
-	frag = net_pkt_write(pkt, frag, pos, &pos, sizeof(hdr->chksum),
-			     (u8_t *)&hdr->chksum, PKT_WAIT_TIME);
-
-	if (!frag) {
-		NET_ASSERT(frag);
+	if (net_pkt_cursor_init(&cursor, pkt, net_pkt_ip_hdr_len(pkt) +
+				net_pkt_ipv6_ext_len(pkt)) < 0 ||
+	    net_pkt_cursor_write(&cursor, hdr, sizeof(*hdr),
+				 PKT_WAIT_TIME) < 0) {
+		NET_ASSERT(0);
 		return NULL;
 	}
 
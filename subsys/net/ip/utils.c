@@ -382,28 +382,77 @@ int net_addr_pton(sa_family_t family, const char *src,
 	return 0;
 }
 
+typedef u16_t __may_alias chksum_u16_t;
+typedef u32_t __may_alias chksum_u32_t;
+
+/* The data is summed in host byte order, 32 bits at a time into a 64-bit
+ * accumulator that cannot overflow for any u16_t length. The one's
+ * complement sum does not depend on the byte order (RFC 1071), so only
+ * the folded result is converted. Data at an odd address is summed one
+ * byte off, which swaps the bytes of the result.
+ */
 static u16_t calc_chksum(u16_t sum, const u8_t *ptr, u16_t len)
 {
+	bool odd = (uintptr_t)ptr & 1;
+	const chksum_u32_t *ptr32;
+	u64_t acc = 0;
 	u16_t tmp;
-	const u8_t *end;
 
-	end = ptr + len - 1;
+	if (odd && len) {
+		acc = sys_be16_to_cpu((u16_t)*ptr);
+		ptr++;
+		len--;
+	}
 
-	while (ptr < end) {
-		tmp = (ptr[0] << 8) + ptr[1];
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+	if (((uintptr_t)ptr & 2) && len >= 2) {
+		acc += *(const chksum_u16_t *)ptr;
 		ptr += 2;
+		len -= 2;
 	}
 
-	if (ptr == end) {
-		tmp = ptr[0] << 8;
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+	ptr32 = (const chksum_u32_t *)ptr;
+
+	while (len >= 16) {
+		acc += ptr32[0];
+		acc += ptr32[1];
+		acc += ptr32[2];
+		acc += ptr32[3];
+		ptr32 += 4;
+		len -= 16;
+	}
+
+	while (len >= 4) {
+		acc += *ptr32++;
+		len -= 4;
+	}
+
+	ptr = (const u8_t *)ptr32;
+
+	if (len >= 2) {
+		acc += *(const chksum_u16_t *)ptr;
+		ptr += 2;
+		len -= 2;
+	}
+
+	if (len) {
+		acc += sys_be16_to_cpu((u16_t)(*ptr << 8));
+	}
+
+	acc = (acc & 0xffffffff) + (acc >> 32);
+	acc = (acc & 0xffffffff) + (acc >> 32);
+	acc = (acc & 0xffff) + (acc >> 16);
+	acc = (acc & 0xffff) + (acc >> 16);
+
+	tmp = acc;
+	if (odd) {
+		tmp = __bswap_16(tmp);
+	}
+
+	tmp = sys_be16_to_cpu(tmp);
+
+	sum += tmp;
+	if (sum < tmp) {
+		sum++;
 	}
 
 	return sum;
@@ -415,8 +464,10 @@ static inline u16_t calc_chksum_pkt(u16_t sum, struct net_pkt *pkt,
 	u16_t proto_len = net_pkt_ip_hdr_len(pkt) +
 		net_pkt_ipv6_ext_len(pkt);
 	struct net_buf *frag;
+	bool odd = false;
 	u16_t offset;
-	s16_t len;
+	u16_t len;
+	u16_t tmp;
 	u8_t *ptr;
 
 	ARG_UNUSED(upper_layer_len);
@@ -434,31 +485,51 @@ static inline u16_t calc_chksum_pkt(u16_t sum, struct net_pkt *pkt,
 	len = frag->len - offset;
 
 	while (frag) {
-		sum = calc_chksum(sum, ptr, len);
+		/* After an odd number of bytes, the data of the fragment
+		 * starts in the low byte of a 16-bit word.
+		 */
+		tmp = calc_chksum(0, ptr, len);
+		if (odd) {
+			tmp = __bswap_16(tmp);
+		}
+
+		sum += tmp;
+		if (sum < tmp) {
+			sum++;
+		}
+
+		odd ^= len & 1;
+
 		frag = frag->frags;
 		if (!frag) {
 			break;
 		}
 
 		ptr = frag->data;
-
-		/* Do we need to take first byte from next fragment */
-		if (len % 2) {
-			u16_t tmp = *ptr;
-			sum += tmp;
-			if (sum < tmp) {
-				sum++;
-			}
-			len = frag->len - 1;
-			ptr++;
-		} else {
-			len = frag->len;
-		}
+		len = frag->len;
 	}
 
 	return sum;
 }
 
+u16_t net_chksum_update(u16_t chksum, const void *old_data,
+			const void *new_data, u16_t len)
+{
+	u16_t sum = ~chksum;
+	u16_t tmp;
+
+	/* The one's complement of the sum of the old data subtracts it */
+	tmp = ~calc_chksum(0, old_data, len);
+	sum += tmp;
+	if (sum < tmp) {
+		sum++;
+	}
+
+	sum = calc_chksum(sum, new_data, len);
+
+	return ~sum;
+}
+
 u16_t net_calc_chksum(struct net_pkt *pkt, u8_t proto)
 {
 	u16_t upper_layer_len;
@@ -28,9 +28,16 @@
 static bool arp_cache_initialized;
 static struct arp_entry arp_entries[CONFIG_NET_ARP_TABLE_SIZE];
 
+#define ARP_HASH_SIZE BIT(CONFIG_NET_ARP_HASH_BITS)
+
 static sys_slist_t arp_free_entries;
 static sys_slist_t arp_pending_entries;
-static sys_slist_t arp_table;
+
+/* Resolved entries are hashed by interface and address, and kept
+ * in least recently used order, the most recent first.
+ */
+static sys_slist_t arp_hash[ARP_HASH_SIZE];
+static sys_dlist_t arp_table;
 
 struct k_delayed_work arp_request_timer;
 
@@ -75,24 +82,48 @@ static struct arp_entry *arp_entry_find(sys_slist_t *list,
 	return NULL;
 }
 
+static inline sys_slist_t *arp_hash_list(struct net_if *iface,
+					 struct in_addr *dst)
+{
+	u32_t hash;
+
+	hash = net_hash_words(0, dst, 1);
+	hash = net_hash_u32(hash, POINTER_TO_UINT(iface));
+
+	return &arp_hash[net_hash_bucket(hash, CONFIG_NET_ARP_HASH_BITS)];
+}
+
+static void arp_table_add(struct arp_entry *entry)
+{
+	sys_slist_prepend(arp_hash_list(entry->iface, &entry->ip),
+			  &entry->node);
+	sys_dlist_prepend(&arp_table, &entry->lru);
+}
+
+static void arp_table_remove(struct arp_entry *entry)
+{
+	sys_slist_find_and_remove(arp_hash_list(entry->iface, &entry->ip),
+				  &entry->node);
+	sys_dlist_remove(&entry->lru);
+}
+
 static inline struct arp_entry *arp_entry_find_move_first(struct net_if *iface,
 							  struct in_addr *dst)
 {
-	sys_snode_t *prev = NULL;
 	struct arp_entry *entry;
 
 	NET_DBG("dst %s", net_sprint_ipv4_addr(dst));
 
-	entry = arp_entry_find(&arp_table, iface, dst, &prev);
+	entry = arp_entry_find(arp_hash_list(iface, dst), iface, dst, NULL);
 	if (entry) {
 		/* Let's assume the target is going to be accessed
 		 * more than once here in a short time frame. So we
 		 * place the entry first in position into the table
-		 * in order to reduce subsequent find.
+		 * so that it is the last one to be evicted.
 		 */
-		if (&entry->node != sys_slist_peek_head(&arp_table)) {
-			sys_slist_remove(&arp_table, prev, &entry->node);
-			sys_slist_prepend(&arp_table, &entry->node);
+		if (&entry->lru != sys_dlist_peek_head(&arp_table)) {
+			sys_dlist_remove(&entry->lru);
+			sys_dlist_prepend(&arp_table, &entry->lru);
 		}
 	}
 
@@ -146,20 +177,23 @@ static struct arp_entry *arp_entry_get_free(void)
 
 static struct arp_entry *arp_entry_get_last_from_table(void)
 {
-	sys_snode_t *node;
+	struct arp_entry *entry;
+	sys_dnode_t *node;
 
 	/* We assume last entry is the oldest one,
 	 * so is the preferred one to be taken out.
 	 */
 
-	node = sys_slist_peek_tail(&arp_table);
+	node = sys_dlist_peek_tail(&arp_table);
 	if (!node) {
 		return NULL;
 	}
 
-	sys_slist_find_and_remove(&arp_table, node);
+	entry = CONTAINER_OF(node, struct arp_entry, lru);
 
-	return CONTAINER_OF(node, struct arp_entry, node);
+	arp_table_remove(entry);
+
+	return entry;
 }
 
 
@@ -455,7 +489,7 @@ static inline void arp_update(struct net_if *iface,
 	memcpy(&entry->eth, hwaddr, sizeof(struct net_eth_addr));
 
 	/* Inserting entry into the table */
-	sys_slist_prepend(&arp_table, &entry->node);
+	arp_table_add(entry);
 
 	if (net_if_send_data(iface, pkt) == NET_DROP) {
 		net_pkt_unref(pkt);
@@ -603,20 +637,18 @@ void net_arp_clear_cache(struct net_if *iface)
 
 	NET_DBG("Flushing ARP table");
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&arp_table, entry, next, node) {
+	SYS_DLIST_FOR_EACH_CONTAINER_SAFE(&arp_table, entry, next, lru) {
 		if (iface && iface != entry->iface) {
-			prev = &entry->node;
 			continue;
 		}
 
+		arp_table_remove(entry);
+
 		arp_entry_cleanup(entry, false);
 
-		sys_slist_remove(&arp_table, prev, &entry->node);
 		sys_slist_prepend(&arp_free_entries, &entry->node);
 	}
 
-	prev = NULL;
-
 	NET_DBG("Flushing ARP pending requests");
 
 	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&arp_pending_entries,
@@ -642,7 +674,7 @@ int net_arp_foreach(net_arp_cb_t cb, void *user_data)
 	int ret = 0;
 	struct arp_entry *entry;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&arp_table, entry, node) {
+	SYS_DLIST_FOR_EACH_CONTAINER(&arp_table, entry, lru) {
 		ret++;
 		cb(entry, user_data);
 	}
@@ -660,7 +692,11 @@ void net_arp_init(void)
 
 	sys_slist_init(&arp_free_entries);
 	sys_slist_init(&arp_pending_entries);
-	sys_slist_init(&arp_table);
+	sys_dlist_init(&arp_table);
+
+	for (i = 0; i < ARP_HASH_SIZE; i++) {
+		sys_slist_init(&arp_hash[i]);
+	}
 
 	for (i = 0; i < CONFIG_NET_ARP_TABLE_SIZE; i++) {
 		/* Inserting entry as free */
@@ -14,6 +14,7 @@ extern "C" {
 #if defined(CONFIG_NET_ARP)
 
 #include <misc/slist.h>
+#include <misc/dlist.h>
 #include <net/ethernet.h>
 
 /**
@@ -46,7 +47,10 @@ struct net_pkt *net_arp_prepare(struct net_pkt *pkt);
 enum net_verdict net_arp_input(struct net_pkt *pkt);
 
 struct arp_entry {
+	/* Free or pending list, or hash bucket once resolved */
 	sys_snode_t node;
+	/* Least recently used order of resolved entries */
+	sys_dnode_t lru;
 	s64_t req_start;
 	struct net_if *iface;
 	struct in_addr ip;
@@ -25,8 +25,7 @@
 
 struct option_context {
 	u16_t delta;
-	u16_t offset;
-	struct net_buf *frag;
+	struct net_pkt_cursor cursor;
 };
 
 #define COAP_VERSION 1
@@ -87,15 +86,23 @@ static u16_t get_coap_packet_len(struct net_pkt *pkt)
 	return len;
 }
 
-static int check_frag_read_status(const struct net_buf *frag, u16_t offset)
+/* 0 if all the data has been read, 1 otherwise */
+static int check_read_status(const struct net_pkt_cursor *cursor)
 {
-	if (!frag && offset == 0xffff) {
+	return net_pkt_cursor_is_end(cursor) ? 0 : 1;
+}
+
+/* Cursor after the CoAP header, see check_read_status() for the result */
+static int skip_header(const struct coap_packet *cpkt,
+		       struct net_pkt_cursor *cursor)
+{
+	net_pkt_cursor_init_frag(cursor, cpkt->pkt, cpkt->frag, cpkt->offset);
+
+	if (net_pkt_cursor_skip(cursor, cpkt->hdr_len) < 0) {
 		return -EINVAL;
-	} else if (!frag && offset == 0) {
-		return 0;
 	}
 
-	return 1;
+	return check_read_status(cursor);
 }
 
 static int decode_delta(struct option_context *context, u16_t opt,
@@ -107,31 +114,23 @@ static int decode_delta(struct option_context *context, u16_t opt,
 		u8_t val;
 
 		*hdr_len = 1;
-		context->frag = net_frag_read_u8(context->frag,
-						 context->offset,
-						 &context->offset,
-						 &val);
-		ret = check_frag_read_status(context->frag,
-					     context->offset);
-		if (ret < 0) {
+		if (net_pkt_cursor_read_u8(&context->cursor, &val) < 0) {
 			return -EINVAL;
 		}
 
+		ret = check_read_status(&context->cursor);
+
 		opt = val + COAP_OPTION_EXT_13;
 	} else if (opt == COAP_OPTION_EXT_14) {
 		u16_t val;
 
 		*hdr_len = 2;
-		context->frag = net_frag_read_be16(context->frag,
-						   context->offset,
-						   &context->offset,
-						   &val);
-		ret = check_frag_read_status(context->frag,
-					     context->offset);
-		if (ret < 0) {
+		if (net_pkt_cursor_read_be16(&context->cursor, &val) < 0) {
 			return -EINVAL;
 		}
 
+		ret = check_read_status(&context->cursor);
+
 		opt = val + COAP_OPTION_EXT_269;
 	} else if (opt == COAP_OPTION_EXT_15) {
 		return -EINVAL;
@@ -153,15 +152,12 @@ static int parse_option(const struct coap_packet *cpkt,
 	u8_t opt;
 	int r;
 
-	context->frag = net_frag_read_u8(context->frag,
-					 context->offset,
-					 &context->offset,
-					 &opt);
-	r = check_frag_read_status(context->frag, context->offset);
-	if (r < 0) {
-		return r;
+	if (net_pkt_cursor_read_u8(&context->cursor, &opt) < 0) {
+		return -EINVAL;
 	}
 
+	r = check_read_status(&context->cursor);
+
 	*opt_len += 1;
 
 	/* This indicates that options have ended */
@@ -232,19 +228,18 @@ static int parse_option(const struct coap_packet *cpkt,
 
 		option->delta = context->delta + delta;
 		option->len = len;
-		context->frag = net_frag_read(context->frag, context->offset,
-					      &context->offset, len,
-					      &option->value[0]);
+		r = net_pkt_cursor_read(&context->cursor, &option->value[0],
+					len);
 	} else {
-		context->frag = net_frag_skip(context->frag, context->offset,
-					      &context->offset, len);
+		r = net_pkt_cursor_skip(&context->cursor, len);
 	}
 
-	r = check_frag_read_status(context->frag, context->offset);
 	if (r < 0) {
-		return r;
+		return -EINVAL;
 	}
 
+	r = check_read_status(&context->cursor);
+
 	context->delta += delta;
 
 	return r;
@@ -255,17 +250,12 @@ static int parse_options(const struct coap_packet *cpkt,
 {
 	struct option_context context = {
 					.delta = 0,
-					.frag = NULL,
-					.offset = 0
 					};
 	u16_t opt_len;
 	u8_t num;
 	int r;
 
-	/* Skip CoAP header */
-	context.frag = net_frag_skip(cpkt->frag, cpkt->offset,
-				     &context.offset, cpkt->hdr_len);
-	r = check_frag_read_status(context.frag, context.offset);
+	r = skip_header(cpkt, &context.cursor);
 	if (r <= 0) {
 		return r;
 	}
@@ -348,6 +338,7 @@ static int get_header_len(struct coap_packet *cpkt)
 int coap_packet_parse(struct coap_packet *cpkt, struct net_pkt *pkt,
 		      struct coap_option *options, u8_t opt_num)
 {
+	struct net_pkt_cursor cursor;
 	int ret;
 
 	if (!cpkt || !pkt || !pkt->frags) {
@@ -358,11 +349,17 @@ int coap_packet_parse(struct coap_packet *cpkt, struct net_pkt *pkt,
 	cpkt->hdr_len = 0;
 	cpkt->opt_len = 0;
 
-	cpkt->frag = net_frag_skip(pkt->frags, 0, &cpkt->offset,
-				   net_pkt_ip_hdr_len(pkt) +
-				   NET_UDPH_LEN +
-				   net_pkt_ipv6_ext_len(pkt));
-	ret = check_frag_read_status(cpkt->frag, cpkt->offset);
+	if (net_pkt_cursor_init(&cursor, pkt,
+				net_pkt_ip_hdr_len(pkt) +
+				NET_UDPH_LEN +
+				net_pkt_ipv6_ext_len(pkt)) < 0) {
+		return -EINVAL;
+	}
+
+	cpkt->frag = cursor.frag;
+	cpkt->offset = cursor.pos;
+
+	ret = check_read_status(&cursor);
 	if (ret <= 0) {
 		return ret;
 	}
@@ -1059,8 +1056,6 @@ int coap_find_options(const struct coap_packet *cpkt, u16_t code,
 {
 	struct option_context context = {
 					  .delta = 0,
-					  .frag = NULL,
-					  .offset = 0
 					};
 	u16_t opt_len;
 	int count;
@@ -1070,10 +1065,7 @@ int coap_find_options(const struct coap_packet *cpkt, u16_t code,
 		return -EINVAL;
 	}
 
-	/* Skip CoAP header */
-	context.frag = net_frag_skip(cpkt->frag, cpkt->offset,
-				     &context.offset, cpkt->hdr_len);
-	r = check_frag_read_status(context.frag, context.offset);
+	r = skip_header(cpkt, &context.cursor);
 	if (r <= 0) {
 		return r;
 	}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * base64 encoder and decoder benchmark, see README.txt.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <base64.h>
+#include <bench_report.h>
+
+#define BENCH_ITERATIONS 32
+
+#define MAX_SIZE 1024
+
+/* Chunk size of the streaming benchmarks, as read from a UART or socket */
+#define CHUNK_SIZE 64
+
+static const u32_t sizes[] = { 16, 64, 256, MAX_SIZE };
+
+static u8_t raw[MAX_SIZE];
+/* Encoded data, with room for the terminator */
+static u8_t enc[MAX_SIZE / 3 * 4 + 8];
+static u8_t dec[MAX_SIZE];
+static size_t enc_len;
+
+static u32_t sample_buf[BENCH_ITERATIONS];
+static struct bench_samples samples;
+static struct bench_report report;
+
+#define BENCH_TIME(stmt)						\
+	do {								\
+		int _i;							\
+									\
+		for (_i = 0; _i < BENCH_ITERATIONS; _i++) {		\
+			u32_t _start = bench_timer_get();		\
+			stmt;						\
+			bench_samples_add(&samples, _start,		\
+					  bench_timer_get());		\
+		}							\
+	} while (0)
+
+static void emit(const char *name, u32_t size)
+{
+	struct bench_result result;
+	char params[32];
+
+	snprintk(params, sizeof(params), "\"size\": %u", size);
+
+	bench_samples_reduce(&samples, &result);
+	result.bytes = size;
+	bench_report_result(&report, name, params, &result);
+	bench_samples_reset(&samples);
+}
+
+static void stream_encode(u32_t size)
+{
+	struct base64_enc_ctx ctx;
+	size_t off, len, olen;
+
+	base64_enc_init(&ctx);
+	len = 0;
+
+	for (off = 0; off < size; off += CHUNK_SIZE) {
+		base64_enc_update(&ctx, enc + len, sizeof(enc) - len, &olen,
+				  raw + off, min(CHUNK_SIZE, size - off));
+		len += olen;
+	}
+
+	base64_enc_finish(&ctx, enc + len, sizeof(enc) - len, &olen);
+}
+
+static void stream_decode(size_t len)
+{
+	struct base64_dec_ctx ctx;
+	size_t off, out, olen;
+
+	base64_dec_init(&ctx);
+	out = 0;
+
+	for (off = 0; off < len; off += CHUNK_SIZE) {
+		base64_dec_update(&ctx, dec + out, sizeof(dec) - out, &olen,
+				  enc + off, min(CHUNK_SIZE, len - off));
+		out += olen;
+	}
+
+	base64_dec_finish(&ctx);
+}
+
+/* Throughput is given in raw bytes, for both directions */
+static void bench_size(u32_t size)
+{
+	size_t olen;
+
+	BENCH_TIME(base64_encode(enc, sizeof(enc), &enc_len, raw, size));
+	emit("base64_encode", size);
+
+	BENCH_TIME(base64_decode(dec, sizeof(dec), &olen, enc, enc_len));
+	emit("base64_decode", size);
+
+	BENCH_TIME(stream_encode(size));
+	emit("base64_enc_stream", size);
+
+	BENCH_TIME(stream_decode(enc_len));
+	emit("base64_dec_stream", size);
+}
+
+void main(void)
+{
+	int i;
+
+	for (i = 0; i < sizeof(raw); i++) {
+		raw[i] = i * 7 + (i >> 8);
+	}
+
+	bench_samples_init(&samples, sample_buf, ARRAY_SIZE(sample_buf));
+
+	TC_START("base64 benchmark");
+
+	bench_report_begin(&report, "base64");
+
+	for (i = 0; i < ARRAY_SIZE(sizes); i++) {
+		bench_size(sizes[i]);
+	}
+
+	bench_report_end(&report);
+
+	TC_END_REPORT(TC_PASS);
+}
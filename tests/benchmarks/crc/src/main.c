@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * CRC throughput benchmark, see README.txt.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <crc8.h>
+#include <crc16.h>
+#include <crc32.h>
+#include <bench_report.h>
+
+#define BENCH_ITERATIONS 50
+
+#if defined(CONFIG_CRC_SLICING_BY_8)
+#define CRC_IMPL "slicing_by_8"
+#elif defined(CONFIG_CRC_SLICING_BY_4)
+#define CRC_IMPL "slicing_by_4"
+#elif defined(CONFIG_CRC_TABLE)
+#define CRC_IMPL "table"
+#else
+#define CRC_IMPL "bitwise"
+#endif
+
+static const u32_t sizes[] = { 16, 256, 4096 };
+
+static u8_t data[4096];
+
+static u32_t sample_buf[BENCH_ITERATIONS];
+static struct bench_samples samples;
+static struct bench_report report;
+
+/* Keeps results alive so the calls are not optimized away */
+static volatile u32_t sink;
+
+#define BENCH_CRC(name, size, expr)					\
+	do {								\
+		int _i;							\
+									\
+		for (_i = 0; _i < BENCH_ITERATIONS; _i++) {		\
+			u32_t _start = bench_timer_get();		\
+			sink = (expr);					\
+			bench_samples_add(&samples, _start,		\
+					  bench_timer_get());		\
+		}							\
+		emit(name, size);					\
+	} while (0)
+
+static void emit(const char *name, u32_t size)
+{
+	struct bench_result result;
+	char params[48];
+
+	snprintk(params, sizeof(params),
+		 "\"impl\": \"%s\", \"size\": %u", CRC_IMPL, size);
+
+	bench_samples_reduce(&samples, &result);
+	result.bytes = size;
+	bench_report_result(&report, name, params, &result);
+	bench_samples_reset(&samples);
+}
+
+void main(void)
+{
+	u32_t size;
+	int i;
+
+	for (i = 0; i < sizeof(data); i++) {
+		data[i] = i * 7 + 3;
+	}
+
+	bench_samples_init(&samples, sample_buf, ARRAY_SIZE(sample_buf));
+
+	TC_START("crc benchmark (" CRC_IMPL ")");
+
+	bench_report_begin(&report, "crc");
+
+	for (i = 0; i < ARRAY_SIZE(sizes); i++) {
+		size = sizes[i];
+
+		BENCH_CRC("crc32_ieee", size, crc32_ieee(data, size));
+		BENCH_CRC("crc16_ccitt", size, crc16_ccitt(0, data, size));
+		BENCH_CRC("crc16_ansi", size, crc16_ansi(data, size));
+		BENCH_CRC("crc8_ccitt", size,
+			  crc8_ccitt(CRC8_CCITT_INITIAL_VALUE, data, size));
+	}
+
+	bench_report_end(&report);
+
+	TC_END_REPORT(TC_PASS);
+}
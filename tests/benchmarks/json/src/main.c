@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * JSON decoding throughput benchmark, see README.txt.
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <tc_util.h>
+#include <json.h>
+#include <net/buf.h>
+#include <bench_report.h>
+
+#define BENCH_ITERATIONS 20
+
+struct person {
+	const char *name;
+	int height;
+	bool active;
+};
+
+struct people {
+	struct person people[10];
+	size_t people_len;
+};
+
+struct readings {
+	int samples[64];
+	size_t samples_len;
+	s64_t timestamp;
+	s64_t average;
+};
+
+#define WIDE_FIELDS_8(m, n) \
+	m(n##0) m(n##1) m(n##2) m(n##3) m(n##4) m(n##5) m(n##6) m(n##7)
+#define WIDE_FIELDS(m) \
+	WIDE_FIELDS_8(m, 0) WIDE_FIELDS_8(m, 1) WIDE_FIELDS_8(m, 2) \
+	WIDE_FIELDS_8(m, 3) WIDE_FIELDS_8(m, 4) WIDE_FIELDS_8(m, 5) \
+	WIDE_FIELDS_8(m, 6) WIDE_FIELDS_8(m, 7)
+
+#define WIDE_FIELD(n) int field_##n;
+#define WIDE_DESCR(n) \
+	JSON_OBJ_DESCR_PRIM(struct wide, field_##n, JSON_TOK_NUMBER),
+
+/* Objects of 8, 32 and 64 fields use the start of the same descriptors */
+struct wide {
+	WIDE_FIELDS(WIDE_FIELD)
+};
+
+static const struct json_obj_descr wide_descr[] = {
+	WIDE_FIELDS(WIDE_DESCR)
+};
+
+static const struct json_obj_descr person_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct person, name, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM(struct person, height, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct person, active, JSON_TOK_TRUE),
+};
+
+static const struct json_obj_descr people_descr[] = {
+	JSON_OBJ_DESCR_OBJ_ARRAY(struct people, people, 10, people_len,
+				 person_descr, ARRAY_SIZE(person_descr)),
+};
+
+static const struct json_obj_descr readings_descr[] = {
+	JSON_OBJ_DESCR_ARRAY(struct readings, samples, 64, samples_len,
+			     JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct readings, timestamp, JSON_TOK_INT64),
+	JSON_OBJ_DESCR_FIXED_POINT(struct readings, average, 3),
+};
+
+static const char people_json[] = "{\"people\":["
+	"{\"name\":\"Simón Bolívar\",\"height\":168,\"active\":false},"
+	"{\"name\":\"Muggsy Bogues\",\"height\":160,\"active\":true},"
+	"{\"name\":\"Pelé\",\"height\":173,\"active\":false},"
+	"{\"name\":\"Hakeem Olajuwon\",\"height\":213,\"active\":true},"
+	"{\"name\":\"Alex Honnold\",\"height\":180,\"active\":true},"
+	"{\"name\":\"Hazel Findlay\",\"height\":157,\"active\":true},"
+	"{\"name\":\"Daila Ojeda\",\"height\":158,\"active\":true},"
+	"{\"name\":\"Albert Einstein\",\"height\":172,\"active\":false},"
+	"{\"name\":\"Usain Bolt\",\"height\":195,\"active\":false},"
+	"{\"name\":\"Paavo Nurmi\",\"height\":174,\"active\":false}"
+	"]}";
+
+static char readings_json[640];
+static char wide_json[6][1280];
+
+static const struct bench_payload {
+	const char *name;
+	const char *json;
+	const struct json_obj_descr *descr;
+	size_t descr_len;
+} payloads[] = {
+	{ "people", people_json, people_descr, ARRAY_SIZE(people_descr) },
+	{ "readings", readings_json, readings_descr,
+	  ARRAY_SIZE(readings_descr) },
+	/* Keys in the order of the descriptors, then in reverse order */
+	{ "fields_8", wide_json[0], wide_descr, 8 },
+	{ "fields_32", wide_json[1], wide_descr, 32 },
+	{ "fields_64", wide_json[2], wide_descr, 64 },
+	{ "fields_8_reverse", wide_json[3], wide_descr, 8 },
+	{ "fields_32_reverse", wide_json[4], wide_descr, 32 },
+	{ "fields_64_reverse", wide_json[5], wide_descr, 64 },
+};
+
+/* Chunk sizes fed to json_parser_feed(), 0 for the whole payload */
+static const size_t chunks[] = { 0, 64, 16 };
+
+static union {
+	struct people people;
+	struct readings readings;
+	struct wide wide;
+} decoded;
+
+/* json_obj_parse() modifies its input, so it works on a copy */
+static char work_buf[sizeof(wide_json[0])];
+static char str_buf[256];
+
+static char encode_buf[sizeof(wide_json[0])];
+static char chunk_buf[64];
+
+#define BENCH_BUF_SIZE 128
+
+NET_BUF_POOL_DEFINE(bench_buf_pool, 16, BENCH_BUF_SIZE, 0, NULL);
+
+static u32_t sample_buf[BENCH_ITERATIONS];
+static struct bench_samples samples;
+static struct bench_report report;
+
+static void emit(const char *name, const char *payload, size_t chunk,
+		 size_t len)
+{
+	struct bench_result result;
+	char params[64];
+
+	snprintk(params, sizeof(params),
+		 "\"payload\": \"%s\", \"chunk\": %zu", payload, chunk);
+
+	bench_samples_reduce(&samples, &result);
+	result.bytes = len;
+	bench_report_result(&report, name, params, &result);
+	bench_samples_reset(&samples);
+}
+
+static void bench_obj_parse(const struct bench_payload *p, size_t len)
+{
+	u32_t start;
+	int ret;
+	int i;
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		memcpy(work_buf, p->json, len);
+
+		start = bench_timer_get();
+		ret = json_obj_parse(work_buf, len, p->descr, p->descr_len,
+				     &decoded);
+		bench_samples_add(&samples, start, bench_timer_get());
+
+		if (ret < 0) {
+			TC_ERROR("json_obj_parse(%s) failed: %d\n",
+				 p->name, ret);
+		}
+	}
+
+	emit("json_obj_parse", p->name, len, len);
+}
+
+static void bench_parser(const struct bench_payload *p, size_t len,
+			 size_t chunk)
+{
+	struct json_parser parser;
+	size_t step = chunk ? chunk : len;
+	size_t off;
+	u32_t start;
+	int ret;
+	int i;
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		start = bench_timer_get();
+
+		json_parser_init(&parser, p->descr, p->descr_len, &decoded,
+				 str_buf, sizeof(str_buf));
+
+		for (off = 0; off < len; off += step) {
+			json_parser_feed(&parser, p->json + off,
+					 min(step, len - off));
+		}
+
+		ret = json_parser_finish(&parser);
+
+		bench_samples_add(&samples, start, bench_timer_get());
+
+		if (ret < 0) {
+			TC_ERROR("json_parser(%s) failed: %d\n", p->name, ret);
+		}
+	}
+
+	emit("json_parser", p->name, step, len);
+}
+
+static int flush_chunk(const char *bytes, size_t len, void *data)
+{
+	size_t *total = data;
+
+	*total += len;
+
+	return 0;
+}
+
+/* Encode the values decoded from a payload back to JSON */
+static void bench_encode(const struct bench_payload *p)
+{
+	struct net_buf *buf;
+	ssize_t len;
+	size_t total;
+	u32_t start;
+	int ret;
+	int i;
+
+	len = json_calc_encoded_len(p->descr, p->descr_len, &decoded);
+	if (len < 0) {
+		TC_ERROR("json_calc_encoded_len(%s) failed: %d\n",
+			 p->name, (int)len);
+		return;
+	}
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		start = bench_timer_get();
+		json_calc_encoded_len(p->descr, p->descr_len, &decoded);
+		bench_samples_add(&samples, start, bench_timer_get());
+	}
+
+	emit("json_calc_encoded_len", p->name, len, len);
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		start = bench_timer_get();
+		ret = json_obj_encode_buf(p->descr, p->descr_len, &decoded,
+					  encode_buf, sizeof(encode_buf));
+		bench_samples_add(&samples, start, bench_timer_get());
+
+		if (ret < 0) {
+			TC_ERROR("json_obj_encode_buf(%s) failed: %d\n",
+				 p->name, ret);
+		}
+	}
+
+	emit("json_obj_encode_buf", p->name, len, len);
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		total = 0;
+
+		start = bench_timer_get();
+		ret = json_obj_encode_chunked(p->descr, p->descr_len,
+					      &decoded, chunk_buf,
+					      sizeof(chunk_buf), flush_chunk,
+					      &total);
+		bench_samples_add(&samples, start, bench_timer_get());
+
+		if (ret < 0 || total != len) {
+			TC_ERROR("json_obj_encode_chunked(%s) failed: %d\n",
+				 p->name, ret);
+		}
+	}
+
+	emit("json_obj_encode_chunked", p->name, sizeof(chunk_buf), len);
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		buf = net_buf_alloc(&bench_buf_pool, K_NO_WAIT);
+		if (!buf) {
+			TC_ERROR("out of network buffers\n");
+			return;
+		}
+
+		start = bench_timer_get();
+		ret = json_obj_encode_net_buf(p->descr, p->descr_len,
+					      &decoded, buf, &bench_buf_pool,
+					      K_NO_WAIT);
+		bench_samples_add(&samples, start, bench_timer_get());
+
+		if (ret < 0) {
+			TC_ERROR("json_obj_encode_net_buf(%s) failed: %d\n",
+				 p->name, ret);
+		}
+
+		net_buf_unref(buf);
+	}
+
+	emit("json_obj_encode_net_buf", p->name, BENCH_BUF_SIZE, len);
+}
+
+static void readings_json_init(void)
+{
+	size_t len;
+	int i;
+
+	len = snprintk(readings_json, sizeof(readings_json), "{\"samples\":[");
+
+	for (i = 0; i < 64; i++) {
+		len += snprintk(readings_json + len,
+				sizeof(readings_json) - len, "%s%d",
+				i ? "," : "", (i * 7919) % 20011 - 10000);
+	}
+
+	snprintk(readings_json + len, sizeof(readings_json) - len,
+		 "],\"timestamp\":1530000000123456,\"average\":-12.345}");
+}
+
+static void wide_json_init(char *json, size_t size, int fields,
+			   bool reverse)
+{
+	size_t len;
+	int i;
+
+	len = snprintk(json, size, "{");
+
+	for (i = 0; i < fields; i++) {
+		int n = reverse ? fields - 1 - i : i;
+
+		len += snprintk(json + len, size - len, "%s\"%s\":%d",
+				i ? "," : "", wide_descr[n].field_name,
+				n * 1000);
+	}
+
+	snprintk(json + len, size - len, "}");
+}
+
+void main(void)
+{
+	static const int wide_fields[] = { 8, 32, 64 };
+	size_t len;
+	int i, j;
+
+	readings_json_init();
+
+	for (i = 0; i < ARRAY_SIZE(wide_fields); i++) {
+		wide_json_init(wide_json[i], sizeof(wide_json[i]),
+			       wide_fields[i], false);
+		wide_json_init(wide_json[i + 3], sizeof(wide_json[i + 3]),
+			       wide_fields[i], true);
+	}
+
+	bench_samples_init(&samples, sample_buf, ARRAY_SIZE(sample_buf));
+
+	TC_START("json benchmark");
+
+	bench_report_begin(&report, "json");
+
+	for (i = 0; i < ARRAY_SIZE(payloads); i++) {
+		len = strlen(payloads[i].json);
+
+		bench_obj_parse(&payloads[i], len);
+
+		for (j = 0; j < ARRAY_SIZE(chunks); j++) {
+			bench_parser(&payloads[i], len, chunks[j]);
+		}
+
+		bench_encode(&payloads[i]);
+	}
+
+	bench_report_end(&report);
+
+	TC_END_REPORT(TC_PASS);
+}
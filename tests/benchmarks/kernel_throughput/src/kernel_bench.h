@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _KERNEL_BENCH_H_
+#define _KERNEL_BENCH_H_
+
+#include <zephyr.h>
+#include <bench_report.h>
+
+/* Number of timed iterations per operation and scenario */
+#define BENCH_ITERATIONS 500
+
+/* Largest number of contending worker threads in a scenario */
+#define BENCH_MAX_WORKERS 4
+
+#define BENCH_STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+/* Main thread priority; workers run at the same or the next higher one */
+#define BENCH_MAIN_PRIO K_PRIO_PREEMPT(5)
+
+/* Size of the data transferred by pipe and mailbox operations */
+#define BENCH_DATA_SIZE 16
+
+enum bench_prio {
+	/* Workers share the main thread priority, woken ones run on yield */
+	BENCH_PRIO_EQUAL,
+	/* Workers preempt the main thread as soon as they are woken */
+	BENCH_PRIO_HIGHER,
+};
+
+/*
+ * A scenario is the number of worker threads blocked on the object under
+ * test and their priority relative to the main thread. With no workers
+ * the uncontended fast paths are measured.
+ */
+struct bench_scenario {
+	int threads;
+	enum bench_prio prio;
+};
+
+/* Time a single statement and record it as one sample */
+#define BENCH_TIME(stmt)						\
+	do {								\
+		u32_t _start = bench_timer_get();			\
+		stmt;							\
+		bench_samples_add(&bench_samples, _start,		\
+				  bench_timer_get());			\
+	} while (0)
+
+extern struct bench_samples bench_samples;
+
+void bench_workers_start(const struct bench_scenario *sc,
+			 k_thread_entry_t entry, void *obj);
+void bench_workers_stop(const struct bench_scenario *sc);
+void bench_settle(const struct bench_scenario *sc);
+void bench_emit(const char *name, const struct bench_scenario *sc);
+
+void sem_bench(const struct bench_scenario *sc);
+void mutex_bench(const struct bench_scenario *sc);
+void poll_bench(const struct bench_scenario *sc);
+void fifo_bench(const struct bench_scenario *sc);
+void lifo_bench(const struct bench_scenario *sc);
+void msgq_bench(const struct bench_scenario *sc);
+void pipe_bench(const struct bench_scenario *sc);
+void mbox_bench(const struct bench_scenario *sc);
+void mem_slab_bench(const struct bench_scenario *sc);
+void mem_pool_bench(const struct bench_scenario *sc);
+void thread_bench(const struct bench_scenario *sc);
+
+#endif /* _KERNEL_BENCH_H_ */
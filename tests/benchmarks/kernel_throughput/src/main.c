@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Kernel object throughput benchmark.
+ *
+ * Every kernel object is exercised uncontended and then with 1, 2 and 4
+ * worker threads blocked on it, at the same and at a higher priority than
+ * the main thread. Each operation is timed BENCH_ITERATIONS times and the
+ * distribution is reported as JSON, see tests/include/bench_report.h.
+ */
+
+#include <tc_util.h>
+#include "kernel_bench.h"
+
+static u32_t sample_buf[BENCH_ITERATIONS];
+struct bench_samples bench_samples;
+
+static struct bench_report report;
+
+static K_THREAD_STACK_ARRAY_DEFINE(worker_stacks, BENCH_MAX_WORKERS,
+				   BENCH_STACK_SIZE);
+static struct k_thread worker_threads[BENCH_MAX_WORKERS];
+
+static const struct bench_scenario scenarios[] = {
+	{ 0, BENCH_PRIO_EQUAL },
+	{ 1, BENCH_PRIO_EQUAL },
+	{ 1, BENCH_PRIO_HIGHER },
+	{ 2, BENCH_PRIO_EQUAL },
+	{ 2, BENCH_PRIO_HIGHER },
+	{ 4, BENCH_PRIO_EQUAL },
+	{ 4, BENCH_PRIO_HIGHER },
+};
+
+static void (*const benchmarks[])(const struct bench_scenario *sc) = {
+	sem_bench,
+	mutex_bench,
+	poll_bench,
+	fifo_bench,
+	lifo_bench,
+	msgq_bench,
+	pipe_bench,
+	mbox_bench,
+	mem_slab_bench,
+	mem_pool_bench,
+	thread_bench,
+};
+
+/**
+ * @brief Start the worker threads of a scenario
+ *
+ * Workers receive @a obj as their first argument and their index as the
+ * second. On return all of them have run and blocked on the object.
+ */
+void bench_workers_start(const struct bench_scenario *sc,
+			 k_thread_entry_t entry, void *obj)
+{
+	int prio = BENCH_MAIN_PRIO;
+	int i;
+
+	if (sc->prio == BENCH_PRIO_HIGHER) {
+		prio--;
+	}
+
+	for (i = 0; i < sc->threads; i++) {
+		k_thread_create(&worker_threads[i], worker_stacks[i],
+				K_THREAD_STACK_SIZEOF(worker_stacks[i]),
+				entry, obj, INT_TO_POINTER(i), NULL,
+				prio, 0, K_NO_WAIT);
+	}
+
+	bench_settle(sc);
+}
+
+void bench_workers_stop(const struct bench_scenario *sc)
+{
+	int i;
+
+	for (i = 0; i < sc->threads; i++) {
+		k_thread_abort(&worker_threads[i]);
+	}
+}
+
+/**
+ * @brief Let woken workers run until they block again
+ *
+ * Higher priority workers have already done so by the time the waking
+ * call returns; equal priority ones only run once the main thread yields.
+ */
+void bench_settle(const struct bench_scenario *sc)
+{
+	if (sc->prio == BENCH_PRIO_EQUAL) {
+		k_yield();
+	}
+}
+
+/**
+ * @brief Reduce the collected samples and report them
+ */
+void bench_emit(const char *name, const struct bench_scenario *sc)
+{
+	struct bench_result result;
+	char params[48];
+
+	snprintk(params, sizeof(params), "\"threads\": %d, \"prio\": \"%s\"",
+		 sc->threads,
+		 sc->prio == BENCH_PRIO_HIGHER ? "higher" : "equal");
+
+	bench_samples_reduce(&bench_samples, &result);
+	bench_report_result(&report, name, params, &result);
+	bench_samples_reset(&bench_samples);
+}
+
+void main(void)
+{
+	int i, j;
+
+	k_thread_priority_set(k_current_get(), BENCH_MAIN_PRIO);
+
+	bench_samples_init(&bench_samples, sample_buf, ARRAY_SIZE(sample_buf));
+
+	TC_START("kernel throughput benchmark");
+	TC_PRINT("%d iterations per operation, timer overhead %u cycles\n",
+		 BENCH_ITERATIONS, bench_samples.overhead);
+
+	bench_report_begin(&report, "kernel");
+
+	for (i = 0; i < ARRAY_SIZE(scenarios); i++) {
+		for (j = 0; j < ARRAY_SIZE(benchmarks); j++) {
+			benchmarks[j](&scenarios[i]);
+		}
+	}
+
+	bench_report_end(&report);
+
+	TC_END_REPORT(TC_PASS);
+}
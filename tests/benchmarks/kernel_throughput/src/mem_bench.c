@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Memory slab and memory pool benchmarks */
+
+#include "kernel_bench.h"
+
+#define SLAB_BLOCK_SIZE 64
+#define SLAB_NUM_BLOCKS 4
+
+K_MEM_SLAB_DEFINE(bench_slab, SLAB_BLOCK_SIZE, SLAB_NUM_BLOCKS, 4);
+K_MEM_POOL_DEFINE(bench_pool, 64, 1024, 2, 4);
+
+static struct k_sem gate_sem;
+
+/*
+ * Each gate token lets one worker wait for a block of the exhausted slab
+ * once; it releases the block right after the timed free hands it over.
+ */
+static void mem_slab_worker(void *p1, void *p2, void *p3)
+{
+	struct k_mem_slab *slab = p1;
+	void *block;
+
+	while (1) {
+		k_sem_take(&gate_sem, K_FOREVER);
+		k_mem_slab_alloc(slab, &block, K_FOREVER);
+		k_mem_slab_free(slab, &block);
+	}
+}
+
+void mem_slab_bench(const struct bench_scenario *sc)
+{
+	void *blocks[SLAB_NUM_BLOCKS];
+	int i;
+
+	if (!sc->threads) {
+		for (i = 0; i < BENCH_ITERATIONS; i++) {
+			BENCH_TIME(k_mem_slab_alloc(&bench_slab, &blocks[0],
+						    K_NO_WAIT));
+			k_mem_slab_free(&bench_slab, &blocks[0]);
+		}
+		bench_emit("mem_slab.alloc", sc);
+
+		for (i = 0; i < BENCH_ITERATIONS; i++) {
+			k_mem_slab_alloc(&bench_slab, &blocks[0], K_NO_WAIT);
+			BENCH_TIME(k_mem_slab_free(&bench_slab, &blocks[0]));
+		}
+		bench_emit("mem_slab.free", sc);
+		return;
+	}
+
+	for (i = 0; i < SLAB_NUM_BLOCKS; i++) {
+		k_mem_slab_alloc(&bench_slab, &blocks[i], K_NO_WAIT);
+	}
+
+	k_sem_init(&gate_sem, 0, sc->threads);
+	bench_workers_start(sc, mem_slab_worker, &bench_slab);
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		k_sem_give(&gate_sem);
+		bench_settle(sc);
+
+		BENCH_TIME(k_mem_slab_free(&bench_slab, &blocks[0]));
+		bench_settle(sc);
+
+		k_mem_slab_alloc(&bench_slab, &blocks[0], K_NO_WAIT);
+	}
+	bench_emit("mem_slab.free_wake", sc);
+
+	bench_workers_stop(sc);
+
+	for (i = 0; i < SLAB_NUM_BLOCKS; i++) {
+		k_mem_slab_free(&bench_slab, &blocks[i]);
+	}
+}
+
+static void mem_pool_size_bench(const struct bench_scenario *sc,
+				size_t size, const char *alloc_name,
+				const char *free_name)
+{
+	struct k_mem_block block;
+	int i;
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		BENCH_TIME(k_mem_pool_alloc(&bench_pool, &block, size,
+					    K_NO_WAIT));
+		k_mem_pool_free(&block);
+	}
+	bench_emit(alloc_name, sc);
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		k_mem_pool_alloc(&bench_pool, &block, size, K_NO_WAIT);
+		BENCH_TIME(k_mem_pool_free(&block));
+	}
+	bench_emit(free_name, sc);
+}
+
+/*
+ * A pool free wakes every waiter to retry its allocation, which mostly
+ * measures the scheduler; only the allocator itself is timed.
+ */
+void mem_pool_bench(const struct bench_scenario *sc)
+{
+	if (sc->threads) {
+		return;
+	}
+
+	/* Smallest block: splits a maximum size block down every level */
+	mem_pool_size_bench(sc, 64, "mem_pool.alloc_64", "mem_pool.free_64");
+	mem_pool_size_bench(sc, 1024, "mem_pool.alloc_1024",
+			    "mem_pool.free_1024");
+}
@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* FIFO, LIFO, message queue, pipe and mailbox benchmarks */
+
+#include "kernel_bench.h"
+
+struct bench_item {
+	void *reserved;	/* 1st word reserved for use by the kernel */
+	u32_t data;
+};
+
+static struct bench_item item;
+
+static struct k_fifo bench_fifo;
+static struct k_lifo bench_lifo;
+
+K_MSGQ_DEFINE(bench_msgq, sizeof(u32_t), 4, 4);
+K_PIPE_DEFINE(bench_pipe, 4 * BENCH_DATA_SIZE, 4);
+K_MBOX_DEFINE(bench_mbox);
+
+static u8_t tx_data[BENCH_DATA_SIZE];
+static u8_t rx_data[BENCH_MAX_WORKERS][BENCH_DATA_SIZE];
+
+static void fifo_worker(void *p1, void *p2, void *p3)
+{
+	struct k_fifo *fifo = p1;
+
+	while (1) {
+		k_fifo_get(fifo, K_FOREVER);
+	}
+}
+
+void fifo_bench(const struct bench_scenario *sc)
+{
+	int i;
+
+	k_fifo_init(&bench_fifo);
+
+	if (!sc->threads) {
+		for (i = 0; i < BENCH_ITERATIONS; i++) {
+			BENCH_TIME(k_fifo_put(&bench_fifo, &item));
+			k_fifo_get(&bench_fifo, K_NO_WAIT);
+		}
+		bench_emit("fifo.put", sc);
+
+		for (i = 0; i < BENCH_ITERATIONS; i++) {
+			k_fifo_put(&bench_fifo, &item);
+			BENCH_TIME(k_fifo_get(&bench_fifo, K_NO_WAIT));
+		}
+		bench_emit("fifo.get", sc);
+		return;
+	}
+
+	bench_workers_start(sc, fifo_worker, &bench_fifo);
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		BENCH_TIME(k_fifo_put(&bench_fifo, &item));
+		bench_settle(sc);
+	}
+	bench_emit("fifo.put_wake", sc);
+
+	bench_workers_stop(sc);
+}
+
+static void lifo_worker(void *p1, void *p2, void *p3)
+{
+	struct k_lifo *lifo = p1;
+
+	while (1) {
+		k_lifo_get(lifo, K_FOREVER);
+	}
+}
+
+void lifo_bench(const struct bench_scenario *sc)
+{
+	int i;
+
+	k_lifo_init(&bench_lifo);
+
+	if (!sc->threads) {
+		for (i = 0; i < BENCH_ITERATIONS; i++) {
+			BENCH_TIME(k_lifo_put(&bench_lifo, &item));
+			k_lifo_get(&bench_lifo, K_NO_WAIT);
+		}
+		bench_emit("lifo.put", sc);
+
+		for (i = 0; i < BENCH_ITERATIONS; i++) {
+			k_lifo_put(&bench_lifo, &item);
+			BENCH_TIME(k_lifo_get(&bench_lifo, K_NO_WAIT));
+		}
+		bench_emit("lifo.get", sc);
+		return;
+	}
+
+	bench_workers_start(sc, lifo_worker, &bench_lifo);
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		BENCH_TIME(k_lifo_put(&bench_lifo, &item));
+		bench_settle(sc);
+	}
+	bench_emit("lifo.put_wake", sc);
+
+	bench_workers_stop(sc);
+}
+
+static void msgq_worker(void *p1, void *p2, void *p3)
+{
+	struct k_msgq *msgq = p1;
+	u32_t data;
+
+	while (1) {
+		k_msgq_get(msgq, &data, K_FOREVER);
+	}
+}
+
+void msgq_bench(const struct bench_scenario *sc)
+{
+	u32_t data = 0;
+	int i;
+
+	k_msgq_purge(&bench_msgq);
+
+	if (!sc->threads) {
+		for (i = 0; i < BENCH_ITERATIONS; i++) {
+			BENCH_TIME(k_msgq_put(&bench_msgq, &data, K_NO_WAIT));
+			k_msgq_get(&bench_msgq, &data, K_NO_WAIT);
+		}
+		bench_emit("msgq.put", sc);
+
+		for (i = 0; i < BENCH_ITERATIONS; i++) {
+			k_msgq_put(&bench_msgq, &data, K_NO_WAIT);
+			BENCH_TIME(k_msgq_get(&bench_msgq, &data, K_NO_WAIT));
+		}
+		bench_emit("msgq.get", sc);
+		return;
+	}
+
+	bench_workers_start(sc, msgq_worker, &bench_msgq);
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		BENCH_TIME(k_msgq_put(&bench_msgq, &data, K_NO_WAIT));
+		bench_settle(sc);
+	}
+	bench_emit("msgq.put_wake", sc);
+
+	bench_workers_stop(sc);
+}
+
+static void pipe_worker(void *p1, void *p2, void *p3)
+{
+	struct k_pipe *pipe = p1;
+	int id = POINTER_TO_INT(p2);
+	size_t read;
+
+	while (1) {
+		k_pipe_get(pipe, rx_data[id], BENCH_DATA_SIZE, &read,
+			   BENCH_DATA_SIZE, K_FOREVER);
+	}
+}
+
+void pipe_bench(const struct bench_scenario *sc)
+{
+	size_t n;
+	int i;
+
+	if (!sc->threads) {
+		for (i = 0; i < BENCH_ITERATIONS; i++) {
+			BENCH_TIME(k_pipe_put(&bench_pipe, tx_data,
+					      BENCH_DATA_SIZE, &n,
+					      BENCH_DATA_SIZE, K_NO_WAIT));
+			k_pipe_get(&bench_pipe, rx_data[0], BENCH_DATA_SIZE,
+				   &n, BENCH_DATA_SIZE, K_NO_WAIT);
+		}
+		bench_emit("pipe.put", sc);
+
+		for (i = 0; i < BENCH_ITERATIONS; i++) {
+			k_pipe_put(&bench_pipe, tx_data, BENCH_DATA_SIZE, &n,
+				   BENCH_DATA_SIZE, K_NO_WAIT);
+			BENCH_TIME(k_pipe_get(&bench_pipe, rx_data[0],
+					      BENCH_DATA_SIZE, &n,
+					      BENCH_DATA_SIZE, K_NO_WAIT));
+		}
+		bench_emit("pipe.get", sc);
+		return;
+	}
+
+	bench_workers_start(sc, pipe_worker, &bench_pipe);
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		BENCH_TIME(k_pipe_put(&bench_pipe, tx_data, BENCH_DATA_SIZE,
+				      &n, BENCH_DATA_SIZE, K_NO_WAIT));
+		bench_settle(sc);
+	}
+	bench_emit("pipe.put_wake", sc);
+
+	bench_workers_stop(sc);
+}
+
+static void mbox_worker(void *p1, void *p2, void *p3)
+{
+	struct k_mbox *mbox = p1;
+	int id = POINTER_TO_INT(p2);
+	struct k_mbox_msg msg;
+
+	while (1) {
+		msg.rx_source_thread = K_ANY;
+		msg.size = BENCH_DATA_SIZE;
+		k_mbox_get(mbox, &msg, rx_data[id], K_FOREVER);
+	}
+}
+
+/*
+ * Mailbox sends are synchronous and need a receiver, so there is no
+ * uncontended variant: the timed put includes handing the message over.
+ */
+void mbox_bench(const struct bench_scenario *sc)
+{
+	struct k_mbox_msg msg;
+	int i;
+
+	if (!sc->threads) {
+		return;
+	}
+
+	bench_workers_start(sc, mbox_worker, &bench_mbox);
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		msg.info = i;
+		msg.size = BENCH_DATA_SIZE;
+		msg.tx_data = tx_data;
+		msg.tx_block.data = NULL;
+		msg.tx_target_thread = K_ANY;
+
+		BENCH_TIME(k_mbox_put(&bench_mbox, &msg, K_FOREVER));
+		bench_settle(sc);
+	}
+	bench_emit("mbox.put_sync", sc);
+
+	bench_workers_stop(sc);
+}
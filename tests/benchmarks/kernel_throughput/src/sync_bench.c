@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Semaphore, mutex and k_poll benchmarks */
+
+#include "kernel_bench.h"
+
+static struct k_sem bench_sem;
+static struct k_sem gate_sem;
+static struct k_mutex bench_mutex;
+static struct k_poll_signal bench_signal;
+
+static void sem_worker(void *p1, void *p2, void *p3)
+{
+	struct k_sem *sem = p1;
+
+	while (1) {
+		k_sem_take(sem, K_FOREVER);
+	}
+}
+
+void sem_bench(const struct bench_scenario *sc)
+{
+	int i;
+
+	if (!sc->threads) {
+		k_sem_init(&bench_sem, 0, BENCH_ITERATIONS);
+
+		for (i = 0; i < BENCH_ITERATIONS; i++) {
+			BENCH_TIME(k_sem_give(&bench_sem));
+		}
+		bench_emit("sem.give", sc);
+
+		for (i = 0; i < BENCH_ITERATIONS; i++) {
+			BENCH_TIME(k_sem_take(&bench_sem, K_NO_WAIT));
+		}
+		bench_emit("sem.take", sc);
+		return;
+	}
+
+	k_sem_init(&bench_sem, 0, 1);
+	bench_workers_start(sc, sem_worker, &bench_sem);
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		BENCH_TIME(k_sem_give(&bench_sem));
+		bench_settle(sc);
+	}
+	bench_emit("sem.give_wake", sc);
+
+	bench_workers_stop(sc);
+}
+
+/*
+ * Each gate token lets one worker contend for the mutex once, so it
+ * blocks on the mutex held by the main thread and is handed the mutex
+ * by the timed unlock.
+ */
+static void mutex_worker(void *p1, void *p2, void *p3)
+{
+	struct k_mutex *mutex = p1;
+
+	while (1) {
+		k_sem_take(&gate_sem, K_FOREVER);
+		k_mutex_lock(mutex, K_FOREVER);
+		k_mutex_unlock(mutex);
+	}
+}
+
+void mutex_bench(const struct bench_scenario *sc)
+{
+	int i;
+
+	k_mutex_init(&bench_mutex);
+
+	if (!sc->threads) {
+		for (i = 0; i < BENCH_ITERATIONS; i++) {
+			BENCH_TIME(k_mutex_lock(&bench_mutex, K_NO_WAIT));
+			k_mutex_unlock(&bench_mutex);
+		}
+		bench_emit("mutex.lock", sc);
+
+		for (i = 0; i < BENCH_ITERATIONS; i++) {
+			k_mutex_lock(&bench_mutex, K_NO_WAIT);
+			BENCH_TIME(k_mutex_unlock(&bench_mutex));
+		}
+		bench_emit("mutex.unlock", sc);
+
+		k_mutex_lock(&bench_mutex, K_NO_WAIT);
+		for (i = 0; i < BENCH_ITERATIONS; i++) {
+			BENCH_TIME(k_mutex_lock(&bench_mutex, K_NO_WAIT));
+			k_mutex_unlock(&bench_mutex);
+		}
+		k_mutex_unlock(&bench_mutex);
+		bench_emit("mutex.lock_recursive", sc);
+		return;
+	}
+
+	k_sem_init(&gate_sem, 0, sc->threads);
+	bench_workers_start(sc, mutex_worker, &bench_mutex);
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		k_mutex_lock(&bench_mutex, K_FOREVER);
+		k_sem_give(&gate_sem);
+		bench_settle(sc);
+
+		BENCH_TIME(k_mutex_unlock(&bench_mutex));
+		bench_settle(sc);
+	}
+	bench_emit("mutex.unlock_wake", sc);
+
+	bench_workers_stop(sc);
+}
+
+static void poll_worker(void *p1, void *p2, void *p3)
+{
+	struct k_poll_signal *signal = p1;
+	struct k_poll_event event;
+
+	k_poll_event_init(&event, K_POLL_TYPE_SIGNAL,
+			  K_POLL_MODE_NOTIFY_ONLY, signal);
+
+	while (1) {
+		k_poll(&event, 1, K_FOREVER);
+		event.state = K_POLL_STATE_NOT_READY;
+		k_poll_signal_reset(signal);
+	}
+}
+
+void poll_bench(const struct bench_scenario *sc)
+{
+	struct k_poll_event event;
+	int i;
+
+	k_poll_signal_init(&bench_signal);
+
+	if (!sc->threads) {
+		k_sem_init(&bench_sem, 0, 1);
+		k_poll_event_init(&event, K_POLL_TYPE_SEM_AVAILABLE,
+				  K_POLL_MODE_NOTIFY_ONLY, &bench_sem);
+
+		for (i = 0; i < BENCH_ITERATIONS; i++) {
+			k_sem_give(&bench_sem);
+			BENCH_TIME(k_poll(&event, 1, K_NO_WAIT));
+			event.state = K_POLL_STATE_NOT_READY;
+			k_sem_take(&bench_sem, K_NO_WAIT);
+		}
+		bench_emit("poll.ready", sc);
+
+		for (i = 0; i < BENCH_ITERATIONS; i++) {
+			BENCH_TIME(k_poll_signal(&bench_signal, 0));
+			k_poll_signal_reset(&bench_signal);
+		}
+		bench_emit("poll.signal", sc);
+		return;
+	}
+
+	bench_workers_start(sc, poll_worker, &bench_signal);
+
+	/* Every worker polls the same signal, but k_poll_signal() only
+	 * readies the poller registered first, so each signal wakes one
+	 * worker whatever the number of threads.
+	 */
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		BENCH_TIME(k_poll_signal(&bench_signal, 0));
+		bench_settle(sc);
+		k_poll_signal_reset(&bench_signal);
+	}
+	bench_emit("poll.signal_wake", sc);
+
+	bench_workers_stop(sc);
+}
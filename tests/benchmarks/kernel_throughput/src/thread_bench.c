@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Thread create and abort benchmarks */
+
+#include "kernel_bench.h"
+
+static K_THREAD_STACK_DEFINE(bench_stack, BENCH_STACK_SIZE);
+static struct k_thread bench_thread;
+
+static void empty_entry(void *p1, void *p2, void *p3)
+{
+}
+
+void thread_bench(const struct bench_scenario *sc)
+{
+	int i;
+
+	if (sc->threads) {
+		return;
+	}
+
+	/* Lower priority: the new thread never gets to run */
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		BENCH_TIME(k_thread_create(&bench_thread, bench_stack,
+					   K_THREAD_STACK_SIZEOF(bench_stack),
+					   empty_entry, NULL, NULL, NULL,
+					   BENCH_MAIN_PRIO + 1, 0, K_NO_WAIT));
+		k_thread_abort(&bench_thread);
+	}
+	bench_emit("thread.create", sc);
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		k_thread_create(&bench_thread, bench_stack,
+				K_THREAD_STACK_SIZEOF(bench_stack),
+				empty_entry, NULL, NULL, NULL,
+				BENCH_MAIN_PRIO + 1, 0, K_NO_WAIT);
+		BENCH_TIME(k_thread_abort(&bench_thread));
+	}
+	bench_emit("thread.abort", sc);
+
+	/* Higher priority: includes running the thread to completion */
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		BENCH_TIME(k_thread_create(&bench_thread, bench_stack,
+					   K_THREAD_STACK_SIZEOF(bench_stack),
+					   empty_entry, NULL, NULL, NULL,
+					   BENCH_MAIN_PRIO - 1, 0, K_NO_WAIT));
+	}
+	bench_emit("thread.create_run", sc);
+}
@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Log output benchmark, see README.txt.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <logging/log_backend.h>
+#include <logging/log_ctrl.h>
+#include <logging/log_output.h>
+#include <bench_report.h>
+#include <string.h>
+
+#define LOG_MODULE_NAME bench
+#include <logging/log.h>
+LOG_MODULE_REGISTER();
+
+#define BENCH_ITERATIONS 32
+
+/* Baud rate used to express the UART bound message rate */
+#define BENCH_BAUD_RATE 115200
+
+/* Messages sent through the UART backend, and how many of the first ones
+ * are timed for CPU usage. Those fit in the transmit buffer of the
+ * interrupt driven backend, so no time is spent waiting for space.
+ */
+#define BENCH_UART_MSGS 64
+#define BENCH_UART_CPU_MSGS 8
+
+enum bench_format {
+	BENCH_FORMAT_TEXT,
+	BENCH_FORMAT_DICT,
+	BENCH_FORMATS,
+};
+
+static const char *const format_names[] = {
+	[BENCH_FORMAT_TEXT] = "text",
+	[BENCH_FORMAT_DICT] = "dictionary",
+};
+
+static const char *const msg_names[] = {
+	"args_0", "args_1", "args_3", "args_6", "hexdump_16",
+};
+
+#define BENCH_MSGS ARRAY_SIZE(msg_names)
+
+static const u8_t hexdump_data[16] = "0123456789abcdef";
+
+static u32_t sample_buf[BENCH_ITERATIONS];
+static struct bench_samples samples;
+static struct bench_report report;
+
+static int format;
+static u32_t out_bytes;
+
+/* Mean processing cycles and output bytes per message, for the summary */
+static u32_t msg_cycles[BENCH_FORMATS][BENCH_MSGS];
+static u32_t msg_bytes[BENCH_FORMATS][BENCH_MSGS];
+
+/* Sink standing in for the UART: bytes are counted, not sent */
+static int out_func(u8_t *data, size_t length, void *ctx)
+{
+	out_bytes += length;
+
+	return length;
+}
+
+/* One byte buffer, as in the UART backend */
+static u8_t out_buf;
+
+static struct log_output_ctx out_ctx = {
+	.func = out_func,
+	.data = &out_buf,
+	.length = 1,
+};
+
+static void put(const struct log_backend *const backend,
+		struct log_msg *msg)
+{
+	log_msg_get(msg);
+
+	if (format == BENCH_FORMAT_DICT) {
+		log_output_msg_dict_process(msg, &out_ctx);
+	} else {
+		log_output_msg_process(msg, &out_ctx,
+				       LOG_OUTPUT_FLAG_FORMAT_TIMESTAMP);
+	}
+
+	log_msg_put(msg);
+}
+
+static void panic(const struct log_backend *const backend)
+{
+}
+
+const struct log_backend_api log_backend_bench_api = {
+	.put = put,
+	.panic = panic,
+};
+
+LOG_BACKEND_DEFINE(log_backend_bench, log_backend_bench_api);
+
+static void log_msg_kind(int kind, u32_t i)
+{
+	switch (kind) {
+	case 0:
+		LOG_INF("link up");
+		break;
+	case 1:
+		LOG_INF("rx packet, len %u", i);
+		break;
+	case 2:
+		LOG_INF("conn %p state %d -> %d", &samples, i & 3, i & 7);
+		break;
+	case 3:
+		LOG_INF("stats: rx %u tx %u drop %u err %d rssi %d ch %u",
+			i, 2 * i, i >> 3, -(int)i, -40 - (int)(i & 15), 11);
+		break;
+	default:
+		LOG_HEXDUMP_INF(hexdump_data, sizeof(hexdump_data));
+		break;
+	}
+}
+
+static u32_t emit(const char *name, int kind, u32_t bytes)
+{
+	struct bench_result result;
+	char params[64];
+
+	snprintk(params, sizeof(params),
+		 "\"format\": \"%s\", \"msg\": \"%s\"",
+		 format_names[format], msg_names[kind]);
+
+	bench_samples_reduce(&samples, &result);
+	result.bytes = bytes;
+	bench_report_result(&report, name, params, &result);
+	bench_samples_reset(&samples);
+
+	return result.mean;
+}
+
+static void bench_msg(int kind)
+{
+	u32_t start;
+	int i;
+
+	/* Message creation does not depend on the output format */
+	if (format == BENCH_FORMAT_TEXT) {
+		for (i = 0; i < BENCH_ITERATIONS; i++) {
+			start = bench_timer_get();
+			log_msg_kind(kind, i);
+			bench_samples_add(&samples, start, bench_timer_get());
+			log_process(false);
+		}
+		emit("log_frontend", kind, 0);
+	}
+
+	out_bytes = 0;
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		log_msg_kind(kind, i);
+		start = bench_timer_get();
+		log_process(false);
+		bench_samples_add(&samples, start, bench_timer_get());
+	}
+
+	msg_bytes[format][kind] = out_bytes / BENCH_ITERATIONS;
+	msg_cycles[format][kind] = emit("log_process", kind,
+					msg_bytes[format][kind]);
+}
+
+/*
+ * Messages per second the backend sustains, bound either by the processing
+ * time or by the time the output takes on a UART with 10 bits per byte.
+ */
+static void print_summary(void)
+{
+	u32_t cpu_rate, uart_rate;
+	int i;
+
+	TC_PRINT("\nmessages per second, UART at %u baud:\n",
+		 BENCH_BAUD_RATE);
+
+	for (format = 0; format < BENCH_FORMATS; format++) {
+		for (i = 0; i < BENCH_MSGS; i++) {
+			cpu_rate = sys_clock_hw_cycles_per_sec /
+				   max(msg_cycles[format][i], 1);
+			uart_rate = BENCH_BAUD_RATE / 10 /
+				    max(msg_bytes[format][i], 1);
+
+			TC_PRINT("%s %s: %u bytes, cpu %u, uart %u\n",
+				 format_names[format], msg_names[i],
+				 msg_bytes[format][i], cpu_rate, uart_rate);
+		}
+	}
+}
+
+#ifdef CONFIG_LOG_BACKEND_UART
+static const struct log_backend *uart_backend_get(void)
+{
+	const struct log_backend *backend;
+	int i;
+
+	for (i = 0; i < log_backend_count_get(); i++) {
+		backend = log_backend_get(i);
+		if (strcmp(backend->name, "log_backend_uart") == 0) {
+			return backend;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Messages are sent through the UART backend of the logger, with the
+ * output appearing on the console. CPU usage is the mean log_process()
+ * time of the first messages. Throughput covers logging and processing
+ * all messages, until the output is flushed by log_panic().
+ */
+static void bench_uart(const struct log_backend *uart)
+{
+	u32_t cpu_cycles = 0;
+	u32_t start, total;
+	u32_t t;
+	int i;
+
+	log_backend_disable(&log_backend_bench);
+	log_backend_enable(uart, NULL, LOG_LEVEL_INF);
+
+	start = bench_timer_get();
+
+	for (i = 0; i < BENCH_UART_MSGS; i++) {
+		log_msg_kind(1, i);
+
+		t = bench_timer_get();
+		log_process(false);
+		if (i < BENCH_UART_CPU_MSGS) {
+			cpu_cycles += bench_timer_get() - t;
+		}
+	}
+
+	log_panic();
+
+	total = bench_timer_get() - start;
+
+	TC_PRINT("\nUART backend, %s transmission:\n",
+		 IS_ENABLED(CONFIG_LOG_BACKEND_UART_ASYNC) ?
+		 "interrupt driven" : "polled");
+	TC_PRINT("cpu %u cycles per message, %u messages per second\n",
+		 cpu_cycles / BENCH_UART_CPU_MSGS,
+		 (u32_t)((u64_t)BENCH_UART_MSGS * sys_clock_hw_cycles_per_sec /
+			 max(total, 1)));
+}
+#endif /* CONFIG_LOG_BACKEND_UART */
+
+void main(void)
+{
+	int i;
+
+	log_init();
+
+#ifdef CONFIG_LOG_BACKEND_UART
+	const struct log_backend *uart = uart_backend_get();
+
+	/* Keep the output of the JSON block clean */
+	log_backend_disable(uart);
+#endif
+
+	log_backend_enable(&log_backend_bench, NULL, LOG_LEVEL_INF);
+
+	bench_samples_init(&samples, sample_buf, ARRAY_SIZE(sample_buf));
+
+	TC_START("logging benchmark");
+
+	bench_report_begin(&report, "logging");
+
+	for (format = 0; format < BENCH_FORMATS; format++) {
+		for (i = 0; i < BENCH_MSGS; i++) {
+			bench_msg(i);
+		}
+	}
+
+	bench_report_end(&report);
+
+	print_summary();
+
+#ifdef CONFIG_LOG_BACKEND_UART
+	bench_uart(uart);
+#endif
+
+	TC_END_REPORT(TC_PASS);
+}
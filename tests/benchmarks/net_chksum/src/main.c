@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Checksum benchmark, see README.txt.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_ip.h>
+#include <net/udp.h>
+#include <bench_report.h>
+
+#include "net_private.h"
+
+#define BENCH_ITERATIONS 32
+
+#define MAX_PAYLOAD (1280 - sizeof(struct net_ipv6_hdr) - \
+		     sizeof(struct net_udp_hdr))
+
+#define UDP_CHKSUM_OFFSET (sizeof(struct net_ipv6_hdr) + 6)
+
+static const u16_t payloads[] = { 64, 512, MAX_PAYLOAD };
+static const u16_t frag_lens[] = { 127, CONFIG_NET_BUF_DATA_SIZE };
+
+/* 2001:db8::1:1, the rewritten destination */
+static const struct in6_addr new_dst = { { { 0x20, 0x01, 0x0d, 0xb8,
+					     0, 0, 0, 0, 0, 0, 0, 0,
+					     0, 0x01, 0, 0x01 } } };
+
+static u8_t data[1280];
+
+static bool failed;
+
+static u32_t sample_buf[BENCH_ITERATIONS];
+static struct bench_samples samples;
+static struct bench_report report;
+
+/* Keeps results alive so the calls are not optimized away */
+static volatile u16_t sink;
+
+#define BENCH_TIME(expr)						\
+	do {								\
+		int _i;							\
+									\
+		for (_i = 0; _i < BENCH_ITERATIONS; _i++) {		\
+			u32_t _start = bench_timer_get();		\
+			sink = (expr);					\
+			bench_samples_add(&samples, _start,		\
+					  bench_timer_get());		\
+		}							\
+	} while (0)
+
+static void emit(const char *name, u16_t payload, u16_t frag_len,
+		 u32_t bytes)
+{
+	struct bench_result result;
+	char params[48];
+
+	snprintk(params, sizeof(params),
+		 "\"payload\": %u, \"frag_len\": %u", payload, frag_len);
+
+	bench_samples_reduce(&samples, &result);
+	result.bytes = bytes;
+	bench_report_result(&report, name, params, &result);
+	bench_samples_reset(&samples);
+}
+
+/*
+ * IPv6 header from 2001:db8::2 to 2001:db8::1 and UDP header followed by
+ * the payload, with a valid UDP checksum.
+ */
+static void fill_data(u16_t payload)
+{
+	struct net_ipv6_hdr *hdr = (struct net_ipv6_hdr *)data;
+	struct net_udp_hdr *udp_hdr = (struct net_udp_hdr *)(hdr + 1);
+	u16_t len = sizeof(*udp_hdr) + payload;
+	int i;
+
+	memset(hdr, 0, sizeof(*hdr));
+	hdr->vtc = 0x60;
+	hdr->len[0] = len >> 8;
+	hdr->len[1] = len;
+	hdr->nexthdr = IPPROTO_UDP;
+	hdr->hop_limit = 64;
+	net_ipv6_addr_create(&hdr->src, 0x2001, 0x0db8, 0, 0, 0, 0, 0, 2);
+	net_ipv6_addr_create(&hdr->dst, 0x2001, 0x0db8, 0, 0, 0, 0, 0, 1);
+
+	udp_hdr->src_port = htons(49152);
+	udp_hdr->dst_port = htons(5683);
+	udp_hdr->len = htons(len);
+	udp_hdr->chksum = 0;
+
+	for (i = 0; i < payload; i++) {
+		data[sizeof(*hdr) + sizeof(*udp_hdr) + i] = i * 7 + 3;
+	}
+}
+
+/* The data is split in fragments holding at most frag_len bytes */
+static struct net_pkt *build_pkt(u16_t len, u16_t frag_len)
+{
+	const u8_t *ptr = data;
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+	u16_t count;
+
+	pkt = net_pkt_get_reserve_rx(0, K_FOREVER);
+
+	while (len) {
+		frag = net_pkt_get_frag(pkt, K_FOREVER);
+		net_pkt_frag_add(pkt, frag);
+
+		count = min(len, frag_len);
+		net_buf_add_mem(frag, ptr, count);
+
+		ptr += count;
+		len -= count;
+	}
+
+	net_pkt_set_family(pkt, AF_INET6);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(struct net_ipv6_hdr));
+	net_pkt_set_ipv6_ext_len(pkt, 0);
+
+	return pkt;
+}
+
+static void check(bool cond)
+{
+	if (!cond) {
+		failed = true;
+	}
+}
+
+/*
+ * The sum over a packet with a valid checksum is 0xffff, as computed when
+ * a packet is received.
+ */
+static void bench_sum(u16_t payload, u16_t frag_len)
+{
+	u16_t len = sizeof(struct net_ipv6_hdr) +
+		sizeof(struct net_udp_hdr) + payload;
+	struct net_pkt *pkt;
+
+	pkt = build_pkt(len, frag_len);
+
+	BENCH_TIME(net_calc_chksum_udp(pkt));
+	emit("net_calc_chksum_udp", payload, frag_len,
+	     len - sizeof(struct net_ipv6_hdr));
+	check(sink == 0xffff);
+
+	net_pkt_unref(pkt);
+}
+
+/*
+ * The updates of a header rewrite, to compare with the full sum of the
+ * packet they save.
+ */
+static void bench_update(u16_t payload)
+{
+	struct net_ipv6_hdr *hdr = (struct net_ipv6_hdr *)data;
+	struct net_udp_hdr *udp_hdr = (struct net_udp_hdr *)(hdr + 1);
+	u16_t chksum = ntohs(udp_hdr->chksum);
+
+	sink = chksum;
+	BENCH_TIME(net_chksum_update_16(sink, 5683, 5684));
+	emit("net_chksum_update_16", payload, 0, 0);
+
+	sink = chksum;
+	BENCH_TIME(net_chksum_update_32(sink, 0x00000001, 0x00010001));
+	emit("net_chksum_update_32", payload, 0, 0);
+
+	sink = chksum;
+	BENCH_TIME(net_chksum_update(sink, &hdr->dst, &new_dst,
+				     sizeof(new_dst)));
+	emit("net_chksum_update_addr", payload, 0, 0);
+
+	/* Apply the address rewrite and check the result */
+	chksum = net_chksum_update(chksum, &hdr->dst, &new_dst,
+				   sizeof(new_dst));
+	net_ipaddr_copy(&hdr->dst, &new_dst);
+	udp_hdr->chksum = htons(chksum);
+}
+
+void main(void)
+{
+	struct net_pkt *pkt;
+	u16_t payload, len;
+	int i, j;
+
+	bench_samples_init(&samples, sample_buf, ARRAY_SIZE(sample_buf));
+
+	TC_START("net_chksum benchmark");
+
+	bench_report_begin(&report, "net_chksum");
+
+	for (i = 0; i < ARRAY_SIZE(payloads); i++) {
+		payload = payloads[i];
+		len = sizeof(struct net_ipv6_hdr) +
+			sizeof(struct net_udp_hdr) + payload;
+
+		fill_data(payload);
+
+		pkt = build_pkt(len, CONFIG_NET_BUF_DATA_SIZE);
+		UNALIGNED_PUT(~net_calc_chksum_udp(pkt),
+			      (u16_t *)&data[UDP_CHKSUM_OFFSET]);
+		net_pkt_unref(pkt);
+
+		for (j = 0; j < ARRAY_SIZE(frag_lens); j++) {
+			bench_sum(payload, frag_lens[j]);
+		}
+
+		bench_update(payload);
+
+		pkt = build_pkt(len, frag_lens[0]);
+		check(net_calc_chksum_udp(pkt) == 0xffff);
+		net_pkt_unref(pkt);
+	}
+
+	bench_report_end(&report);
+
+	TC_END_REPORT(failed ? TC_FAIL : TC_PASS);
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Connection demultiplexing benchmark, see README.txt.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_ip.h>
+#include <bench_report.h>
+
+#include "connection.h"
+
+#define BENCH_ITERATIONS 32
+
+#define LOCAL_PORT 5683
+#define REMOTE_PORT_BASE 10000
+#define CLOSED_PORT 9999
+
+static const u32_t counts[] = { 16, 128, CONFIG_NET_MAX_CONN };
+
+/* 2001:db8::1 */
+static const struct in6_addr local_addr = { { { 0x20, 0x01, 0x0d, 0xb8,
+						0, 0, 0, 0, 0, 0, 0, 0,
+						0, 0, 0, 0x01 } } };
+
+/* ff02::1 */
+static const struct in6_addr mcast_addr = { { { 0xff, 0x02, 0, 0,
+						0, 0, 0, 0, 0, 0, 0, 0,
+						0, 0, 0, 0x01 } } };
+
+static struct net_conn_handle *handles[CONFIG_NET_MAX_CONN];
+static u32_t received;
+
+static u32_t sample_buf[BENCH_ITERATIONS];
+static struct bench_samples samples;
+static struct bench_report report;
+
+#define BENCH_TIME(stmt)						\
+	do {								\
+		int _i;							\
+									\
+		for (_i = 0; _i < BENCH_ITERATIONS; _i++) {		\
+			u32_t _start = bench_timer_get();		\
+			stmt;						\
+			bench_samples_add(&samples, _start,		\
+					  bench_timer_get());		\
+		}							\
+	} while (0)
+
+static void emit(const char *name, u32_t count)
+{
+	struct bench_result result;
+	char params[32];
+
+	snprintk(params, sizeof(params), "\"conns\": %u", count);
+
+	bench_samples_reduce(&samples, &result);
+	bench_report_result(&report, name, params, &result);
+	bench_samples_reset(&samples);
+}
+
+/* The packet is not consumed, so the same one can be received again */
+static enum net_verdict recv_cb(struct net_conn *conn, struct net_pkt *pkt,
+				void *user_data)
+{
+	received++;
+
+	return NET_OK;
+}
+
+/* Peer n is 2001:db8::1:n */
+static void peer_addr(struct in6_addr *addr, u16_t n)
+{
+	memcpy(addr, &local_addr, sizeof(*addr));
+	addr->s6_addr[13] = 0x01;
+	addr->s6_addr[14] = n >> 8;
+	addr->s6_addr[15] = n;
+}
+
+/*
+ * A server with one listener on LOCAL_PORT, and count - 1 connections
+ * from distinct peers to it, as a UDP socket connect()ed per peer or the
+ * TCP connections accepted by a listening socket would register.
+ */
+static void register_conns(u32_t count)
+{
+	struct sockaddr_in6 remote = { .sin6_family = AF_INET6 };
+	struct sockaddr_in6 local = { .sin6_family = AF_INET6 };
+	u32_t i;
+
+	net_ipaddr_copy(&local.sin6_addr, &local_addr);
+
+	net_conn_register(IPPROTO_UDP, NULL, (struct sockaddr *)&local,
+			  0, LOCAL_PORT, recv_cb, NULL, &handles[0]);
+
+	for (i = 1; i < count; i++) {
+		peer_addr(&remote.sin6_addr, i);
+
+		net_conn_register(IPPROTO_UDP, (struct sockaddr *)&remote,
+				  (struct sockaddr *)&local,
+				  REMOTE_PORT_BASE + i, LOCAL_PORT,
+				  recv_cb, NULL, &handles[i]);
+	}
+}
+
+static void unregister_conns(u32_t count)
+{
+	u32_t i;
+
+	for (i = 0; i < count; i++) {
+		net_conn_unregister(handles[i]);
+	}
+}
+
+static void setup_pkt(struct net_pkt *pkt, const struct in6_addr *src,
+		      const struct in6_addr *dst, u16_t src_port,
+		      u16_t dst_port)
+{
+	struct net_udp_hdr *udp_hdr;
+
+	net_buf_reset(pkt->frags);
+
+	NET_IPV6_HDR(pkt)->vtc = 0x60;
+	NET_IPV6_HDR(pkt)->tcflow = 0;
+	NET_IPV6_HDR(pkt)->flow = 0;
+	NET_IPV6_HDR(pkt)->len[0] = 0;
+	NET_IPV6_HDR(pkt)->len[1] = NET_UDPH_LEN;
+	NET_IPV6_HDR(pkt)->nexthdr = IPPROTO_UDP;
+	NET_IPV6_HDR(pkt)->hop_limit = 255;
+
+	net_ipaddr_copy(&NET_IPV6_HDR(pkt)->src, src);
+	net_ipaddr_copy(&NET_IPV6_HDR(pkt)->dst, dst);
+
+	net_buf_add(pkt->frags, sizeof(struct net_ipv6_hdr) +
+		    sizeof(struct net_udp_hdr));
+
+	udp_hdr = (struct net_udp_hdr *)(pkt->frags->data +
+					 sizeof(struct net_ipv6_hdr));
+	udp_hdr->src_port = htons(src_port);
+	udp_hdr->dst_port = htons(dst_port);
+	udp_hdr->len = htons(NET_UDPH_LEN);
+	udp_hdr->chksum = 0;
+}
+
+/*
+ * Packets from the most recently registered peer, from an unknown peer
+ * to the listener, and to a closed port. The multicast destination of
+ * the last one keeps net_conn_input() from sending an ICMP error.
+ */
+static void bench_input(struct net_pkt *pkt, u32_t count)
+{
+	struct in6_addr peer;
+
+	peer_addr(&peer, count - 1);
+	setup_pkt(pkt, &peer, &local_addr, REMOTE_PORT_BASE + count - 1,
+		  LOCAL_PORT);
+	BENCH_TIME(net_conn_input(IPPROTO_UDP, pkt));
+	emit("net_conn_input_connected", count);
+
+	peer_addr(&peer, count);
+	setup_pkt(pkt, &peer, &local_addr, REMOTE_PORT_BASE + count,
+		  LOCAL_PORT);
+	BENCH_TIME(net_conn_input(IPPROTO_UDP, pkt));
+	emit("net_conn_input_listener", count);
+
+	setup_pkt(pkt, &peer, &mcast_addr, REMOTE_PORT_BASE, CLOSED_PORT);
+	BENCH_TIME(net_conn_input(IPPROTO_UDP, pkt));
+	emit("net_conn_input_no_match", count);
+}
+
+void main(void)
+{
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+	int i;
+
+	bench_samples_init(&samples, sample_buf, ARRAY_SIZE(sample_buf));
+
+	TC_START("net_conn benchmark");
+
+	pkt = net_pkt_get_reserve_rx(0, K_FOREVER);
+	frag = net_pkt_get_frag(pkt, K_FOREVER);
+	net_pkt_frag_add(pkt, frag);
+
+	net_pkt_set_family(pkt, AF_INET6);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(struct net_ipv6_hdr));
+	net_pkt_set_ipv6_ext_len(pkt, 0);
+
+	bench_report_begin(&report, "net_conn");
+
+	for (i = 0; i < ARRAY_SIZE(counts); i++) {
+		register_conns(counts[i]);
+		bench_input(pkt, counts[i]);
+		unregister_conns(counts[i]);
+	}
+
+	bench_report_end(&report);
+
+	net_pkt_unref(pkt);
+
+	/* Every packet except the unmatched ones is delivered */
+	TC_END_REPORT(received == 2 * BENCH_ITERATIONS * ARRAY_SIZE(counts) ?
+		      TC_PASS : TC_FAIL);
+}
@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Neighbor and ARP cache benchmark, see README.txt.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <net/net_core.h>
+#include <net/net_if.h>
+#include <net/net_ip.h>
+#include <net/net_pkt.h>
+#include <net/ethernet.h>
+#include <bench_report.h>
+
+#include "ipv6.h"
+#include "arp.h"
+
+#define BENCH_ITERATIONS 32
+
+static const u32_t counts4[] = { 16, 128, CONFIG_NET_ARP_TABLE_SIZE };
+static const u32_t counts6[] = { 16, 128, CONFIG_NET_IPV6_MAX_NEIGHBORS };
+
+/* 10.0.0.1/16 */
+static struct in_addr local_addr4 = { { { 10, 0, 0, 1 } } };
+static struct in_addr netmask = { { { 255, 255, 0, 0 } } };
+
+/* 2001:db8::1, with 2001:db8::/64 on-link */
+static struct in6_addr local_addr6 = { { { 0x20, 0x01, 0x0d, 0xb8,
+					   0, 0, 0, 0, 0, 0, 0, 0,
+					   0, 0, 0, 0x01 } } };
+
+static struct net_if *iface;
+static bool failed;
+
+static u32_t sample_buf[BENCH_ITERATIONS];
+static struct bench_samples samples;
+static struct bench_report report;
+
+static u8_t mac_addr[6] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+static int bench_dev_init(struct device *dev)
+{
+	return 0;
+}
+
+static void bench_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, mac_addr, sizeof(mac_addr),
+			     NET_LINK_ETHERNET);
+}
+
+static int bench_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	net_pkt_unref(pkt);
+
+	return 0;
+}
+
+static const struct ethernet_api bench_if_api = {
+	.iface_api.init = bench_iface_init,
+	.iface_api.send = bench_send,
+};
+
+NET_DEVICE_INIT(bench_nbr, "bench_nbr", bench_dev_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &bench_if_api,
+		ETHERNET_L2, NET_L2_GET_CTX_TYPE(ETHERNET_L2), 1500);
+
+static void emit(const char *name, const char *family, u32_t count)
+{
+	struct bench_result result;
+	char params[48];
+
+	snprintk(params, sizeof(params),
+		 "\"family\": \"%s\", \"neighbors\": %u", family, count);
+
+	bench_samples_reduce(&samples, &result);
+	bench_report_result(&report, name, params, &result);
+	bench_samples_reset(&samples);
+}
+
+/* Host n is 10.0.1.1 and up for IPv4, 2001:db8::1:1 and up for IPv6,
+ * with 02:00:5e:00:xx:xx as link address.
+ */
+static void host_addr4(struct in_addr *addr, u16_t n)
+{
+	addr->s_addr = htonl(0x0a000101 + n);
+}
+
+static void host_addr6(struct in6_addr *addr, u16_t n)
+{
+	net_ipv6_addr_create(addr, 0x2001, 0x0db8, 0, 0, 0, 0, 1, 1 + n);
+}
+
+static void host_lladdr(struct net_eth_addr *lladdr, u16_t n)
+{
+	memcpy(lladdr, mac_addr, sizeof(*lladdr));
+	lladdr->addr[0] = 0x02;
+	lladdr->addr[4] = n >> 8;
+	lladdr->addr[5] = n;
+}
+
+static struct net_pkt *ipv4_pkt(void)
+{
+	struct net_ipv4_hdr *hdr;
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+
+	pkt = net_pkt_get_reserve_tx(sizeof(struct net_eth_hdr), K_FOREVER);
+	frag = net_pkt_get_frag(pkt, K_FOREVER);
+	net_pkt_frag_add(pkt, frag);
+
+	net_pkt_set_iface(pkt, iface);
+	net_pkt_set_family(pkt, AF_INET);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(struct net_ipv4_hdr));
+
+	hdr = (struct net_ipv4_hdr *)net_buf_add(frag, sizeof(*hdr));
+	memset(hdr, 0, sizeof(*hdr));
+	hdr->vhl = 0x45;
+	hdr->len[1] = sizeof(*hdr);
+	hdr->ttl = 64;
+	hdr->proto = IPPROTO_UDP;
+	net_ipaddr_copy(&hdr->src, &local_addr4);
+
+	return pkt;
+}
+
+static struct net_pkt *ipv6_pkt(void)
+{
+	struct net_ipv6_hdr *hdr;
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+
+	pkt = net_pkt_get_reserve_tx(sizeof(struct net_eth_hdr), K_FOREVER);
+	frag = net_pkt_get_frag(pkt, K_FOREVER);
+	net_pkt_frag_add(pkt, frag);
+
+	net_pkt_set_iface(pkt, iface);
+	net_pkt_set_family(pkt, AF_INET6);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(struct net_ipv6_hdr));
+	net_pkt_set_ipv6_ext_len(pkt, 0);
+
+	hdr = (struct net_ipv6_hdr *)net_buf_add(frag, sizeof(*hdr));
+	memset(hdr, 0, sizeof(*hdr));
+	hdr->vtc = 0x60;
+	hdr->nexthdr = IPPROTO_UDP;
+	hdr->hop_limit = 64;
+	net_ipaddr_copy(&hdr->src, &local_addr6);
+
+	return pkt;
+}
+
+/*
+ * A packet to the host is queued by net_arp_prepare() while the ARP
+ * request goes out, then the reply for it resolves the entry and sends
+ * the queued packet.
+ */
+static bool arp_resolve(u16_t n)
+{
+	struct net_arp_hdr *hdr;
+	struct net_pkt *pkt, *req, *reply;
+	struct net_buf *frag;
+
+	pkt = ipv4_pkt();
+	host_addr4(&NET_IPV4_HDR(pkt)->dst, n);
+
+	req = net_arp_prepare(pkt);
+	if (!req || req == pkt) {
+		net_pkt_unref(pkt);
+		return false;
+	}
+
+	net_pkt_unref(req);
+
+	reply = net_pkt_get_reserve_rx(sizeof(struct net_eth_hdr), K_FOREVER);
+	frag = net_pkt_get_frag(reply, K_FOREVER);
+	net_pkt_frag_add(reply, frag);
+	net_pkt_set_iface(reply, iface);
+
+	hdr = NET_ARP_HDR(reply);
+	hdr->hwtype = htons(NET_ARP_HTYPE_ETH);
+	hdr->protocol = htons(NET_ETH_PTYPE_IP);
+	hdr->hwlen = sizeof(struct net_eth_addr);
+	hdr->protolen = sizeof(struct in_addr);
+	hdr->opcode = htons(NET_ARP_REPLY);
+	host_lladdr(&hdr->src_hwaddr, n);
+	host_addr4(&hdr->src_ipaddr, n);
+	memcpy(&hdr->dst_hwaddr, mac_addr, sizeof(mac_addr));
+	net_ipaddr_copy(&hdr->dst_ipaddr, &local_addr4);
+
+	net_buf_add(frag, sizeof(struct net_arp_hdr));
+
+	net_arp_input(reply);
+
+	net_pkt_unref(pkt);
+
+	return true;
+}
+
+static bool nbr_add(u16_t n)
+{
+	struct net_eth_addr lladdr;
+	struct net_linkaddr ll = {
+		.addr = lladdr.addr,
+		.len = sizeof(lladdr),
+		.type = NET_LINK_ETHERNET,
+	};
+	struct in6_addr addr;
+
+	host_addr6(&addr, n);
+	host_lladdr(&lladdr, n);
+
+	return net_ipv6_nbr_add(iface, &addr, &ll, false,
+				NET_IPV6_NBR_STATE_REACHABLE) != NULL;
+}
+
+/*
+ * A hit moves an ARP entry first, so hosts are sent to round robin from
+ * the least recently used one, each lookup going for the last entry of
+ * a list ordered by use.
+ */
+static void bench_ipv4(struct net_pkt *pkt, u32_t count)
+{
+	u32_t start;
+	int i;
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		host_addr4(&NET_IPV4_HDR(pkt)->dst, i % count);
+
+		start = bench_timer_get();
+		if (net_arp_prepare(pkt) != pkt) {
+			failed = true;
+		}
+		bench_samples_add(&samples, start, bench_timer_get());
+	}
+
+	emit("net_arp_prepare", "ipv4", count);
+}
+
+/*
+ * Neighbors are allocated in pool order, so hosts are sent to starting
+ * from the most recently added one, the last one a scan of the pool
+ * reaches.
+ */
+static void bench_ipv6(struct net_pkt *pkt, u32_t count)
+{
+	u32_t start;
+	int i;
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		host_addr6(&NET_IPV6_HDR(pkt)->dst, count - 1 - i % count);
+		net_pkt_ll_dst(pkt)->addr = NULL;
+
+		start = bench_timer_get();
+		if (net_ipv6_prepare_for_send(pkt) != pkt) {
+			failed = true;
+		}
+		bench_samples_add(&samples, start, bench_timer_get());
+	}
+
+	emit("net_ipv6_prepare_for_send", "ipv6", count);
+}
+
+static bool setup(void)
+{
+	struct net_if_addr *ifaddr;
+	struct in6_addr prefix;
+
+	iface = net_if_get_default();
+
+	net_if_ipv4_set_netmask(iface, &netmask);
+
+	ifaddr = net_if_ipv4_addr_add(iface, &local_addr4, NET_ADDR_MANUAL, 0);
+	if (!ifaddr) {
+		return false;
+	}
+
+	ifaddr->addr_state = NET_ADDR_PREFERRED;
+
+	if (!net_if_ipv6_addr_add(iface, &local_addr6, NET_ADDR_MANUAL, 0)) {
+		return false;
+	}
+
+	net_ipv6_addr_create(&prefix, 0x2001, 0x0db8, 0, 0, 0, 0, 0, 0);
+
+	return net_if_ipv6_prefix_add(iface, &prefix, 64,
+				      NET_IPV6_ND_INFINITE_LIFETIME) != NULL;
+}
+
+void main(void)
+{
+	struct net_pkt *pkt;
+	u32_t added;
+	int i;
+
+	bench_samples_init(&samples, sample_buf, ARRAY_SIZE(sample_buf));
+
+	TC_START("net_nbr benchmark");
+
+	if (!setup()) {
+		TC_PRINT("Cannot set up addresses\n");
+		TC_END_REPORT(TC_FAIL);
+		return;
+	}
+
+	bench_report_begin(&report, "net_nbr");
+
+	pkt = ipv4_pkt();
+
+	for (i = 0, added = 0; i < ARRAY_SIZE(counts4); i++) {
+		for (; added < counts4[i]; added++) {
+			if (!arp_resolve(added)) {
+				TC_PRINT("Cannot resolve host %u\n", added);
+				TC_END_REPORT(TC_FAIL);
+				return;
+			}
+		}
+
+		bench_ipv4(pkt, added);
+	}
+
+	net_pkt_unref(pkt);
+
+	pkt = ipv6_pkt();
+
+	for (i = 0, added = 0; i < ARRAY_SIZE(counts6); i++) {
+		for (; added < counts6[i]; added++) {
+			if (!nbr_add(added)) {
+				TC_PRINT("Cannot add neighbor %u\n", added);
+				TC_END_REPORT(TC_FAIL);
+				return;
+			}
+		}
+
+		bench_ipv6(pkt, added);
+	}
+
+	net_pkt_unref(pkt);
+
+	bench_report_end(&report);
+
+	TC_END_REPORT(failed ? TC_FAIL : TC_PASS);
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Header parsing benchmark, see README.txt.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_ip.h>
+#include <net/udp.h>
+#include <net/tcp.h>
+#include <net/coap.h>
+#include <bench_report.h>
+
+#include "ipv6.h"
+#include "tcp_internal.h"
+
+#define BENCH_ITERATIONS 32
+
+#define COAP_OPTIONS 8
+
+static const u16_t frag_lens[] = { 24, CONFIG_NET_BUF_DATA_SIZE };
+
+/*
+ * IPv6 header, hop-by-hop options header with a PadN option, fragment
+ * header and UDP header, then a CoAP GET for
+ * coap://[2001:db8::1]/sensors/temp?unit=c with a token and some options.
+ */
+static const u8_t udp_data[] = {
+	/* IPv6 */
+	0x60, 0x00, 0x00, 0x00, 0x00, 0x40, NET_IPV6_NEXTHDR_HBHO, 0x40,
+	0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+	0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+	/* Hop-by-hop options, 16 bytes */
+	NET_IPV6_NEXTHDR_FRAG, 0x01, 0x01, 0x0c, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	/* Fragment, offset 0 and no more fragments */
+	IPPROTO_UDP, 0x00, 0x00, 0x00, 0x12, 0x34, 0x56, 0x78,
+	/* UDP */
+	0xc0, 0x00, 0x16, 0x33, 0x00, 0x28, 0x00, 0x00,
+	/* CoAP header, CON GET, token length 4 */
+	0x44, 0x01, 0x12, 0x34, 0xde, 0xad, 0xbe, 0xef,
+	/* Uri-Path "sensors" and "temp" */
+	0xb7, 's', 'e', 'n', 's', 'o', 'r', 's',
+	0x04, 't', 'e', 'm', 'p',
+	/* Uri-Query "unit=c" */
+	0x46, 'u', 'n', 'i', 't', '=', 'c',
+	/* Accept text/plain, Block2 0/64 */
+	0x21, 0x00,
+	0x61, 0x02,
+};
+
+/* IPv6 and TCP header of a SYN with MSS, SACK, timestamp and window scale */
+static const u8_t tcp_data[] = {
+	/* IPv6 */
+	0x60, 0x00, 0x00, 0x00, 0x00, 0x28, IPPROTO_TCP, 0x40,
+	0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+	0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+	/* TCP, 40 bytes with options */
+	0xc0, 0x00, 0x10, 0x92, 0x12, 0x34, 0x56, 0x78,
+	0x00, 0x00, 0x00, 0x00, 0xa0, NET_TCP_SYN, 0xff, 0xff,
+	0x00, 0x00, 0x00, 0x00,
+	NET_TCP_MSS_OPT, 0x04, 0x05, 0xb4,
+	0x04, 0x02,
+	0x08, 0x0a, 0x00, 0x00, 0x12, 0x34, 0x00, 0x00, 0x00, 0x00,
+	NET_TCP_NOP_OPT,
+	0x03, 0x03, 0x07,
+};
+
+#define UDP_EXT_LEN (16 + 8)
+#define TCP_OPT_LEN (sizeof(tcp_data) - sizeof(struct net_ipv6_hdr) - \
+		     NET_TCPH_LEN)
+
+static bool failed;
+
+static u32_t sample_buf[BENCH_ITERATIONS];
+static struct bench_samples samples;
+static struct bench_report report;
+
+#define BENCH_TIME(stmt)						\
+	do {								\
+		int _i;							\
+									\
+		for (_i = 0; _i < BENCH_ITERATIONS; _i++) {		\
+			u32_t _start = bench_timer_get();		\
+			stmt;						\
+			bench_samples_add(&samples, _start,		\
+					  bench_timer_get());		\
+		}							\
+	} while (0)
+
+static void emit(const char *name, u16_t frag_len)
+{
+	struct bench_result result;
+	char params[32];
+
+	snprintk(params, sizeof(params), "\"frag_len\": %u", frag_len);
+
+	bench_samples_reduce(&samples, &result);
+	bench_report_result(&report, name, params, &result);
+	bench_samples_reset(&samples);
+}
+
+/* The data is split in fragments holding at most frag_len bytes */
+static struct net_pkt *build_pkt(const u8_t *data, u16_t len,
+				 u16_t frag_len)
+{
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+	u16_t count;
+
+	pkt = net_pkt_get_reserve_rx(0, K_FOREVER);
+
+	while (len) {
+		frag = net_pkt_get_frag(pkt, K_FOREVER);
+		net_pkt_frag_add(pkt, frag);
+
+		count = min(len, frag_len);
+		net_buf_add_mem(frag, data, count);
+
+		data += count;
+		len -= count;
+	}
+
+	net_pkt_set_family(pkt, AF_INET6);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(struct net_ipv6_hdr));
+
+	return pkt;
+}
+
+static void check(bool cond)
+{
+	if (!cond) {
+		failed = true;
+	}
+}
+
+static void bench_udp(u16_t frag_len)
+{
+	struct coap_option options[COAP_OPTIONS];
+	u16_t next_hdr_idx, last_hdr_idx;
+	struct net_udp_hdr hdr;
+	struct coap_packet cpkt;
+	struct net_pkt *pkt;
+
+	pkt = build_pkt(udp_data, sizeof(udp_data), frag_len);
+
+	BENCH_TIME(check(net_ipv6_find_last_ext_hdr(pkt, &next_hdr_idx,
+						    &last_hdr_idx) == 0));
+	emit("ipv6_find_last_ext_hdr", frag_len);
+	check(last_hdr_idx == sizeof(struct net_ipv6_hdr) + UDP_EXT_LEN);
+
+	net_pkt_set_ipv6_ext_len(pkt, UDP_EXT_LEN);
+
+	BENCH_TIME(check(net_udp_get_hdr(pkt, &hdr) != NULL));
+	emit("udp_get_hdr", frag_len);
+
+	BENCH_TIME(check(coap_packet_parse(&cpkt, pkt, options,
+					   COAP_OPTIONS) == 0));
+	emit("coap_packet_parse", frag_len);
+	check(coap_header_get_id(&cpkt) == 0x1234);
+
+	net_pkt_unref(pkt);
+}
+
+static void bench_tcp(u16_t frag_len)
+{
+	struct net_tcp_options opts;
+	struct net_tcp_hdr hdr;
+	struct net_pkt *pkt;
+
+	pkt = build_pkt(tcp_data, sizeof(tcp_data), frag_len);
+
+	net_pkt_set_ipv6_ext_len(pkt, 0);
+
+	BENCH_TIME(check(net_tcp_get_hdr(pkt, &hdr) != NULL &&
+			 net_tcp_parse_opts(pkt, TCP_OPT_LEN, &opts) == 0));
+	emit("tcp_get_hdr_parse_opts", frag_len);
+	check(opts.mss == 1460);
+
+	net_pkt_unref(pkt);
+}
+
+void main(void)
+{
+	int i;
+
+	bench_samples_init(&samples, sample_buf, ARRAY_SIZE(sample_buf));
+
+	TC_START("net_pkt_cursor benchmark");
+
+	bench_report_begin(&report, "net_pkt_cursor");
+
+	for (i = 0; i < ARRAY_SIZE(frag_lens); i++) {
+		bench_udp(frag_lens[i]);
+		bench_tcp(frag_lens[i]);
+	}
+
+	bench_report_end(&report);
+
+	TC_END_REPORT(failed ? TC_FAIL : TC_PASS);
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * IPv6 route lookup benchmark, see README.txt.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <net/net_core.h>
+#include <net/net_if.h>
+#include <net/net_ip.h>
+#include <net/net_pkt.h>
+#include <bench_report.h>
+
+#include "ipv6.h"
+#include "route.h"
+
+#define BENCH_ITERATIONS 32
+
+#define NEXTHOPS CONFIG_NET_IPV6_MAX_NEIGHBORS
+
+static const u32_t counts[] = { 16, 128, CONFIG_NET_MAX_ROUTES };
+
+static struct net_if *iface;
+static struct in6_addr nexthops[NEXTHOPS];
+static u8_t nexthop_lladdr[NEXTHOPS][6];
+
+static u32_t sample_buf[BENCH_ITERATIONS];
+static struct bench_samples samples;
+static struct bench_report report;
+
+#define BENCH_TIME(stmt)						\
+	do {								\
+		int _i;							\
+									\
+		for (_i = 0; _i < BENCH_ITERATIONS; _i++) {		\
+			u32_t _start = bench_timer_get();		\
+			stmt;						\
+			bench_samples_add(&samples, _start,		\
+					  bench_timer_get());		\
+		}							\
+	} while (0)
+
+static u8_t mac_addr[6] = { 0x00, 0x00, 0x5e, 0x00, 0x53, 0x01 };
+
+static int bench_dev_init(struct device *dev)
+{
+	return 0;
+}
+
+static void bench_iface_init(struct net_if *iface)
+{
+	net_if_set_link_addr(iface, mac_addr, sizeof(mac_addr),
+			     NET_LINK_DUMMY);
+}
+
+static int bench_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	net_pkt_unref(pkt);
+
+	return 0;
+}
+
+static struct net_if_api bench_if_api = {
+	.init = bench_iface_init,
+	.send = bench_send,
+};
+
+NET_DEVICE_INIT(bench_route, "bench_route", bench_dev_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &bench_if_api,
+		DUMMY_L2, NET_L2_GET_CTX_TYPE(DUMMY_L2), 127);
+
+static void emit(const char *name, u32_t count)
+{
+	struct bench_result result;
+	char params[32];
+
+	snprintk(params, sizeof(params), "\"routes\": %u", count);
+
+	bench_samples_reduce(&samples, &result);
+	bench_report_result(&report, name, params, &result);
+	bench_samples_reset(&samples);
+}
+
+/* Route n is to 2001:db8:0:n::/64, host is the interface identifier */
+static void route_addr(struct in6_addr *addr, u16_t n, u8_t host)
+{
+	net_ipv6_addr_create(addr, 0x2001, 0x0db8, 0, n, 0, 0, 0, host);
+}
+
+/* Next hops are link-local neighbors fe80::1 and up */
+static bool add_nexthops(void)
+{
+	struct net_linkaddr lladdr;
+	int i;
+
+	for (i = 0; i < NEXTHOPS; i++) {
+		net_ipv6_addr_create(&nexthops[i], 0xfe80, 0, 0, 0, 0, 0, 0,
+				     i + 1);
+
+		memcpy(nexthop_lladdr[i], mac_addr, sizeof(mac_addr));
+		nexthop_lladdr[i][5] = 0x10 + i;
+
+		lladdr.addr = nexthop_lladdr[i];
+		lladdr.len = sizeof(nexthop_lladdr[i]);
+		lladdr.type = NET_LINK_DUMMY;
+
+		if (!net_ipv6_nbr_add(iface, &nexthops[i], &lladdr, false,
+				      NET_IPV6_NBR_STATE_REACHABLE)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Routes are only added, each count extends the previous table */
+static bool add_routes(u32_t from, u32_t to)
+{
+	struct in6_addr addr;
+	u32_t i;
+
+	for (i = from; i < to; i++) {
+		route_addr(&addr, i, 0);
+
+		if (!net_route_add(iface, &addr, 64,
+				   &nexthops[i % NEXTHOPS])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+ * A destination behind the most recently added route, the forwarding
+ * decision for it, and a destination without a route.
+ */
+static void bench_lookup(u32_t count)
+{
+	struct net_route_entry *route;
+	struct in6_addr *nexthop;
+	struct in6_addr dst;
+
+	route_addr(&dst, count - 1, 1);
+	BENCH_TIME(net_route_lookup(iface, &dst));
+	emit("net_route_lookup_hit", count);
+
+	BENCH_TIME(net_route_get_info(iface, &dst, &route, &nexthop));
+	emit("net_route_get_info", count);
+
+	net_ipv6_addr_create(&dst, 0x2001, 0x0db8, 1, 0, 0, 0, 0, 1);
+	BENCH_TIME(net_route_lookup(iface, &dst));
+	emit("net_route_lookup_miss", count);
+}
+
+void main(void)
+{
+	u32_t added = 0;
+	int i;
+
+	bench_samples_init(&samples, sample_buf, ARRAY_SIZE(sample_buf));
+
+	TC_START("net_route benchmark");
+
+	iface = net_if_get_default();
+
+	if (!add_nexthops()) {
+		TC_PRINT("Cannot add next hop neighbors\n");
+		TC_END_REPORT(TC_FAIL);
+		return;
+	}
+
+	bench_report_begin(&report, "net_route");
+
+	for (i = 0; i < ARRAY_SIZE(counts); i++) {
+		if (!add_routes(added, counts[i])) {
+			TC_PRINT("Cannot add %u routes\n", counts[i]);
+			TC_END_REPORT(TC_FAIL);
+			return;
+		}
+
+		added = counts[i];
+
+		bench_lookup(added);
+	}
+
+	bench_report_end(&report);
+
+	TC_END_REPORT(TC_PASS);
+}
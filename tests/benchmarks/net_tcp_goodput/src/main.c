@@ -0,0 +1,433 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * TCP goodput over a lossy link benchmark, see README.txt.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_ip.h>
+#include <net/net_if.h>
+#include <net/net_context.h>
+#include <net/net_l2.h>
+#include <net/tcp.h>
+#include <bench_report.h>
+
+#include "net_private.h"
+#include "tcp_internal.h"
+
+#define BENCH_ITERATIONS 4
+
+#define SEGMENT_LEN NET_TCP_DEFAULT_MSS
+#define SEGMENT_COUNT 64
+#define TRANSFER_LEN (SEGMENT_LEN * SEGMENT_COUNT)
+
+#define TRANSFER_TIMEOUT K_SECONDS(60)
+
+#define MY_PORT 4242
+#define PEER_PORT 5001
+#define PEER_ISN 1000
+#define PEER_WINDOW 16384
+
+/* One data segment in loss_interval is dropped, 0 for no loss */
+static const u16_t loss_intervals[] = { 0, 100, 20 };
+
+/* 2001:db8::1 is ours, the peer is 2001:db8::2 */
+static struct in6_addr my_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+				       0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+static struct in6_addr peer_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					 0, 0, 0, 0, 0, 0, 0, 0x2 } } };
+
+static u8_t data[SEGMENT_LEN];
+
+static bool failed;
+
+static u32_t sample_buf[BENCH_ITERATIONS];
+static struct bench_samples samples;
+static struct bench_report report;
+
+/* The receiving end of the connection, run by the driver. It acks
+ * every segment it gets. Without SACK it only accepts the next segment
+ * in order, with SACK it keeps the segments received out of order and
+ * reports them in SACK blocks.
+ */
+static struct {
+	u32_t ack;
+	u32_t end;
+	u32_t segments;
+	u32_t dropped;
+	u32_t done;
+	u16_t loss_interval;
+	bool sack;
+	bool received[SEGMENT_COUNT];
+} peer;
+
+static K_SEM_DEFINE(transfer_done, 0, 1);
+
+static int peer_dev_init(struct device *dev)
+{
+	return 0;
+}
+
+static void peer_iface_init(struct net_if *iface)
+{
+}
+
+/* SACK option with the segments received after the missing one, in
+ * sequence order. Returns the length of the option.
+ */
+static u8_t peer_sack_opt(u8_t *opt)
+{
+	u32_t start = peer.end - TRANSFER_LEN;
+	u8_t len = 4;
+	int i, first;
+
+	i = (peer.ack - start) / SEGMENT_LEN;
+
+	while (i < SEGMENT_COUNT &&
+	       len < 4 + NET_TCP_MAX_SACK_BLOCKS * NET_TCP_SACK_BLOCK_SIZE) {
+		if (!peer.received[i]) {
+			i++;
+			continue;
+		}
+
+		first = i;
+		while (i < SEGMENT_COUNT && peer.received[i]) {
+			i++;
+		}
+
+		sys_put_be32(start + first * SEGMENT_LEN, opt + len);
+		sys_put_be32(start + i * SEGMENT_LEN, opt + len + 4);
+		len += NET_TCP_SACK_BLOCK_SIZE;
+	}
+
+	if (len == 4) {
+		return 0;
+	}
+
+	opt[0] = NET_TCP_NOP_OPT;
+	opt[1] = NET_TCP_NOP_OPT;
+	opt[2] = NET_TCP_SACK_OPT;
+	opt[3] = len - 2;
+
+	return len;
+}
+
+static void peer_reply(struct net_if *iface, struct net_pkt *req,
+		       struct net_tcp_hdr *req_hdr, u8_t flags)
+{
+	u8_t opt[NET_TCP_MAX_OPT_SIZE];
+	struct net_ipv6_hdr *ip_hdr;
+	struct net_tcp_hdr *tcp_hdr;
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+	u8_t optlen = 0;
+
+	if (peer.sack && (flags & NET_TCP_SYN)) {
+		opt[0] = NET_TCP_NOP_OPT;
+		opt[1] = NET_TCP_NOP_OPT;
+		opt[2] = NET_TCP_SACK_PERM_OPT;
+		opt[3] = NET_TCP_SACK_PERM_SIZE;
+		optlen = 4;
+	} else if (peer.sack) {
+		optlen = peer_sack_opt(opt);
+	}
+
+	/* A reply that cannot be allocated is one more loss */
+	pkt = net_pkt_get_reserve_rx(0, K_NO_WAIT);
+	if (!pkt) {
+		return;
+	}
+
+	frag = net_pkt_get_frag(pkt, K_NO_WAIT);
+	if (!frag) {
+		net_pkt_unref(pkt);
+		return;
+	}
+
+	net_pkt_frag_add(pkt, frag);
+
+	ip_hdr = net_buf_add(frag, sizeof(*ip_hdr));
+	memset(ip_hdr, 0, sizeof(*ip_hdr));
+	ip_hdr->vtc = 0x60;
+	ip_hdr->len[1] = sizeof(*tcp_hdr) + optlen;
+	ip_hdr->nexthdr = IPPROTO_TCP;
+	ip_hdr->hop_limit = 64;
+	net_ipaddr_copy(&ip_hdr->src, &NET_IPV6_HDR(req)->dst);
+	net_ipaddr_copy(&ip_hdr->dst, &NET_IPV6_HDR(req)->src);
+
+	tcp_hdr = net_buf_add(frag, sizeof(*tcp_hdr));
+	memset(tcp_hdr, 0, sizeof(*tcp_hdr));
+	tcp_hdr->src_port = req_hdr->dst_port;
+	tcp_hdr->dst_port = req_hdr->src_port;
+	sys_put_be32(flags & NET_TCP_SYN ? PEER_ISN : PEER_ISN + 1,
+		     tcp_hdr->seq);
+	sys_put_be32(peer.ack, tcp_hdr->ack);
+	tcp_hdr->offset = ((sizeof(*tcp_hdr) + optlen) / 4) << 4;
+	tcp_hdr->flags = flags;
+	sys_put_be16(PEER_WINDOW, tcp_hdr->wnd);
+
+	net_buf_add_mem(frag, opt, optlen);
+
+	net_pkt_set_family(pkt, AF_INET6);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(*ip_hdr));
+	net_pkt_set_ipv6_ext_len(pkt, 0);
+
+	if (net_recv_data(iface, pkt) < 0) {
+		net_pkt_unref(pkt);
+	}
+}
+
+static int peer_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	struct net_tcp_hdr hdr, *tcp_hdr;
+	u32_t seq, start;
+	u16_t len;
+
+	tcp_hdr = net_tcp_get_hdr(pkt, &hdr);
+	if (!tcp_hdr) {
+		goto out;
+	}
+
+	seq = sys_get_be32(tcp_hdr->seq);
+	len = net_pkt_get_len(pkt) - net_pkt_ip_hdr_len(pkt) -
+		NET_TCP_HDR_LEN(tcp_hdr);
+
+	if (tcp_hdr->flags & NET_TCP_SYN) {
+		peer.ack = seq + 1;
+		peer_reply(iface, pkt, tcp_hdr, NET_TCP_SYN | NET_TCP_ACK);
+		goto out;
+	}
+
+	if (tcp_hdr->flags & NET_TCP_FIN) {
+		peer.ack = seq + len + 1;
+		peer_reply(iface, pkt, tcp_hdr, NET_TCP_FIN | NET_TCP_ACK);
+		goto out;
+	}
+
+	if (!len) {
+		goto out;
+	}
+
+	peer.segments++;
+
+	if (peer.loss_interval && peer.segments % peer.loss_interval == 0) {
+		peer.dropped++;
+		goto out;
+	}
+
+	/* Other segments than the next one are acked with a duplicate
+	 * ACK, and dropped unless SACK is used.
+	 */
+	start = peer.end - TRANSFER_LEN;
+
+	if (seq == peer.ack) {
+		peer.ack += len;
+
+		while (peer.ack != peer.end &&
+		       peer.received[(peer.ack - start) / SEGMENT_LEN]) {
+			peer.ack += SEGMENT_LEN;
+		}
+
+		if (peer.ack == peer.end) {
+			peer.done = bench_timer_get();
+			k_sem_give(&transfer_done);
+		}
+	} else if (peer.sack && net_tcp_seq_greater(seq, peer.ack) &&
+		   seq - start < TRANSFER_LEN) {
+		peer.received[(seq - start) / SEGMENT_LEN] = true;
+	}
+
+	peer_reply(iface, pkt, tcp_hdr, NET_TCP_ACK);
+
+out:
+	net_pkt_unref(pkt);
+
+	return 0;
+}
+
+static struct net_if_api peer_if_api = {
+	.init = peer_iface_init,
+	.send = peer_send,
+};
+
+#define _PEER_L2_LAYER DUMMY_L2
+#define _PEER_L2_CTX_TYPE NET_L2_GET_CTX_TYPE(DUMMY_L2)
+
+NET_DEVICE_INIT(net_tcp_goodput, "net_tcp_goodput",
+		peer_dev_init, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&peer_if_api, _PEER_L2_LAYER, _PEER_L2_CTX_TYPE, 1280);
+
+static void emit(u16_t loss_interval)
+{
+	struct bench_result result;
+	char params[64];
+
+	snprintk(params, sizeof(params),
+		 "\"loss_interval\": %u, \"segment\": %u, \"sack\": %d",
+		 loss_interval, SEGMENT_LEN, peer.sack);
+
+	bench_samples_reduce(&samples, &result);
+	result.bytes = TRANSFER_LEN;
+	bench_report_result(&report, "tcp_goodput", params, &result);
+	bench_samples_reset(&samples);
+}
+
+static struct net_context *peer_connect(void)
+{
+	struct sockaddr_in6 local = {
+		.sin6_family = AF_INET6,
+		.sin6_port = htons(MY_PORT),
+	};
+	struct sockaddr_in6 remote = {
+		.sin6_family = AF_INET6,
+		.sin6_port = htons(PEER_PORT),
+	};
+	struct net_context *ctx;
+	int ret;
+
+	net_ipaddr_copy(&local.sin6_addr, &my_addr);
+	net_ipaddr_copy(&remote.sin6_addr, &peer_addr);
+
+	ret = net_context_get(AF_INET6, SOCK_STREAM, IPPROTO_TCP, &ctx);
+	if (ret < 0) {
+		TC_PRINT("Cannot get context (%d)\n", ret);
+		return NULL;
+	}
+
+	ret = net_context_bind(ctx, (struct sockaddr *)&local,
+			       sizeof(local));
+	if (ret < 0) {
+		TC_PRINT("Cannot bind context (%d)\n", ret);
+		goto fail;
+	}
+
+	ret = net_context_connect(ctx, (struct sockaddr *)&remote,
+				  sizeof(remote), NULL, K_SECONDS(1), NULL);
+	if (ret < 0) {
+		TC_PRINT("Cannot connect (%d)\n", ret);
+		goto fail;
+	}
+
+	return ctx;
+
+fail:
+	net_context_put(ctx);
+	return NULL;
+}
+
+/* Sending blocks on the TX packets, which the ACKs of the peer free */
+static bool transfer(struct net_context *ctx)
+{
+	struct net_pkt *pkt;
+	int i;
+
+	for (i = 0; i < SEGMENT_COUNT; i++) {
+		pkt = net_pkt_get_tx(ctx, K_FOREVER);
+
+		if (net_pkt_append(pkt, sizeof(data), data, K_FOREVER) !=
+		    sizeof(data)) {
+			TC_PRINT("Cannot append data\n");
+			net_pkt_unref(pkt);
+			return false;
+		}
+
+		if (net_context_send(pkt, NULL, K_NO_WAIT, NULL, NULL) < 0) {
+			TC_PRINT("Cannot send segment %d\n", i);
+			net_pkt_unref(pkt);
+			return false;
+		}
+	}
+
+	if (k_sem_take(&transfer_done, TRANSFER_TIMEOUT)) {
+		TC_PRINT("Transfer timed out, %u bytes acked\n",
+			 peer.ack - (peer.end - TRANSFER_LEN));
+		return false;
+	}
+
+	return true;
+}
+
+static void bench_goodput(u16_t loss_interval, bool sack)
+{
+	struct net_context *ctx;
+	u32_t start;
+	int i;
+
+	peer.loss_interval = loss_interval;
+	peer.sack = sack;
+	peer.segments = 0;
+	peer.dropped = 0;
+
+	for (i = 0; i < BENCH_ITERATIONS; i++) {
+		ctx = peer_connect();
+		if (!ctx) {
+			failed = true;
+			return;
+		}
+
+		peer.end = peer.ack + TRANSFER_LEN;
+		memset(peer.received, 0, sizeof(peer.received));
+
+		start = bench_timer_get();
+		if (!transfer(ctx)) {
+			failed = true;
+			net_context_put(ctx);
+			return;
+		}
+
+		bench_samples_add(&samples, start, peer.done);
+
+		net_context_put(ctx);
+
+		/* Let the connection close before the port is reused */
+		k_sleep(CONFIG_NET_TCP_TIME_WAIT_DELAY + 100);
+	}
+
+	TC_PRINT("Loss interval %u%s: %u of %u segments dropped\n",
+		 loss_interval, sack ? " with SACK" : "", peer.dropped,
+		 peer.segments);
+
+	emit(loss_interval);
+}
+
+void main(void)
+{
+	int i;
+
+	bench_samples_init(&samples, sample_buf, ARRAY_SIZE(sample_buf));
+
+	TC_START("net_tcp_goodput benchmark");
+
+	if (!net_if_ipv6_addr_add(net_if_get_default(), &my_addr,
+				  NET_ADDR_MANUAL, 0)) {
+		TC_PRINT("Cannot add address\n");
+		TC_END_REPORT(TC_FAIL);
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(data); i++) {
+		data[i] = i;
+	}
+
+	bench_report_begin(&report, "net_tcp_goodput");
+
+	for (i = 0; i < ARRAY_SIZE(loss_intervals); i++) {
+		bench_goodput(loss_intervals[i], false);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(loss_intervals); i++) {
+		bench_goodput(loss_intervals[i], true);
+	}
+
+	bench_report_end(&report);
+
+	TC_END_REPORT(failed ? TC_FAIL : TC_PASS);
+}
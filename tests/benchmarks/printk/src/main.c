@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * snprintk() and printk() formatting benchmark, see README.txt.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <string.h>
+#include <bench_report.h>
+
+#define BENCH_ITERATIONS 100
+
+void __printk_hook_install(int (*fn)(int));
+void *__printk_get_hook(void);
+
+static u32_t sample_buf[BENCH_ITERATIONS];
+static struct bench_samples samples;
+static struct bench_report report;
+
+static char buf[128];
+static int out_len;
+
+static const u8_t ipv4[4] = { 192, 168, 100, 254 };
+static const u8_t ipv6[16] = { 0x20, 0x01, 0x0d, 0xb8, 0x12, 0x34, 0, 0,
+			       0, 0, 0, 0, 0xab, 0xcd, 0x00, 0x01 };
+static const u8_t mac[6] = { 0x00, 0x1b, 0x2c, 0xa4, 0xb5, 0xf6 };
+
+#define BENCH_TIME(stmt)						\
+	do {								\
+		int _i;							\
+									\
+		for (_i = 0; _i < BENCH_ITERATIONS; _i++) {		\
+			u32_t _start = bench_timer_get();		\
+			stmt;						\
+			bench_samples_add(&samples, _start,		\
+					  bench_timer_get());		\
+		}							\
+	} while (0)
+
+static void emit(const char *name, const char *format)
+{
+	struct bench_result result;
+	char params[64];
+
+	snprintk(params, sizeof(params), "\"format\": \"%s\"", format);
+
+	bench_samples_reduce(&samples, &result);
+	result.bytes = out_len;
+	bench_report_result(&report, name, params, &result);
+	bench_samples_reset(&samples);
+}
+
+static int sink_char_out(int c)
+{
+	return c;
+}
+
+static void bench_snprintk(void)
+{
+	u32_t v = 0x9e3779b9;
+
+	BENCH_TIME(out_len = snprintk(buf, sizeof(buf), "%u", v));
+	emit("snprintk", "dec_u32");
+
+	BENCH_TIME(out_len = snprintk(buf, sizeof(buf), "%u", 42));
+	emit("snprintk", "dec_small");
+
+	BENCH_TIME(out_len = snprintk(buf, sizeof(buf), "%lld",
+				      -1234567890123456789LL));
+	emit("snprintk", "dec_s64");
+
+	BENCH_TIME(out_len = snprintk(buf, sizeof(buf), "0x%08x", v));
+	emit("snprintk", "hex_u32");
+
+	/* A line of statistics, as printed by the network shell */
+	BENCH_TIME(out_len = snprintk(buf, sizeof(buf),
+				      "%-12s recv %u\tsent %u\tdrop %u\terr %d",
+				      "IPv6", v, v >> 4, 17, -3));
+	emit("snprintk", "stats_line");
+
+	BENCH_TIME(out_len = snprintk(buf, sizeof(buf), "%pI4", ipv4));
+	emit("snprintk", "ipv4");
+
+	/* The same output, built from one conversion per byte */
+	BENCH_TIME(out_len = snprintk(buf, sizeof(buf), "%u.%u.%u.%u",
+				      ipv4[0], ipv4[1], ipv4[2], ipv4[3]));
+	emit("snprintk", "ipv4_bytes");
+
+	BENCH_TIME(out_len = snprintk(buf, sizeof(buf), "%pI6", ipv6));
+	emit("snprintk", "ipv6");
+
+	BENCH_TIME(out_len = snprintk(buf, sizeof(buf), "%pM", mac));
+	emit("snprintk", "mac");
+
+	BENCH_TIME(out_len = snprintk(buf, sizeof(buf),
+				      "%02x:%02x:%02x:%02x:%02x:%02x",
+				      mac[0], mac[1], mac[2],
+				      mac[3], mac[4], mac[5]));
+	emit("snprintk", "mac_bytes");
+}
+
+/* printk() to a console hook which drops the output */
+static void bench_printk(void)
+{
+	int (*old_hook)(int) = __printk_get_hook();
+	u32_t v = 0x9e3779b9;
+
+	__printk_hook_install(sink_char_out);
+
+	BENCH_TIME(out_len = printk("%-12s recv %u\tsent %u\tdrop %u\terr %d",
+				    "IPv6", v, v >> 4, 17, -3));
+
+	__printk_hook_install(old_hook);
+
+	emit("printk", "stats_line");
+}
+
+void main(void)
+{
+	bench_samples_init(&samples, sample_buf, ARRAY_SIZE(sample_buf));
+
+	TC_START("printk benchmark");
+
+	bench_report_begin(&report, "printk");
+
+	bench_snprintk();
+	bench_printk();
+
+	bench_report_end(&report);
+
+	TC_END_REPORT(TC_PASS);
+}
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Minimal libc string routine benchmark, see README.txt.
+ */
+
+#include <zephyr.h>
+#include <tc_util.h>
+#include <string.h>
+#include <bench_report.h>
+
+#define BENCH_ITERATIONS 100
+
+#define MAX_SIZE 1024
+/* Room for the largest misalignment and a terminator */
+#define BUF_SIZE (MAX_SIZE + 8)
+
+static const u32_t sizes[] = { 4, 16, 64, 256, MAX_SIZE };
+
+/* Offsets from a word aligned address of the destination and source */
+static const struct {
+	u8_t dst;
+	u8_t src;
+} aligns[] = {
+	{ 0, 0 },
+	{ 1, 1 },
+	{ 0, 1 },
+	{ 3, 2 },
+};
+
+static u8_t __aligned(8) buf1[BUF_SIZE];
+static u8_t __aligned(8) buf2[BUF_SIZE];
+
+static u32_t sample_buf[BENCH_ITERATIONS];
+static struct bench_samples samples;
+static struct bench_report report;
+
+/* Keeps results alive so the calls are not optimized away */
+static volatile int sink;
+
+#define BENCH_TIME(stmt)						\
+	do {								\
+		int _i;							\
+									\
+		for (_i = 0; _i < BENCH_ITERATIONS; _i++) {		\
+			u32_t _start = bench_timer_get();		\
+			stmt;						\
+			bench_samples_add(&samples, _start,		\
+					  bench_timer_get());		\
+		}							\
+	} while (0)
+
+static void emit(const char *name, u32_t size, int dst, int src)
+{
+	struct bench_result result;
+	char params[64];
+
+	snprintk(params, sizeof(params),
+		 "\"size\": %u, \"dst_align\": %d, \"src_align\": %d",
+		 size, dst, src);
+
+	bench_samples_reduce(&samples, &result);
+	result.bytes = size;
+	bench_report_result(&report, name, params, &result);
+	bench_samples_reset(&samples);
+}
+
+/* Fill both buffers with the same NUL terminated string of @a size bytes */
+static void fill_strings(u8_t *s1, u8_t *s2, u32_t size)
+{
+	memset(s1, 'a', size);
+	memset(s2, 'a', size);
+	s1[size] = '\0';
+	s2[size] = '\0';
+}
+
+static void bench_size(u32_t size, int dst, int src)
+{
+	u8_t *d = buf1 + dst;
+	u8_t *s = buf2 + src;
+
+	BENCH_TIME(memcpy(d, s, size));
+	emit("memcpy", size, dst, src);
+
+	memcpy(d, s, size);
+	BENCH_TIME(sink = memcmp(d, s, size));
+	emit("memcmp", size, dst, src);
+
+	fill_strings(d, s, size);
+	BENCH_TIME(sink = strcmp((char *)d, (char *)s));
+	emit("strcmp", size, dst, src);
+
+	/* Single buffer routines only depend on the destination offset */
+	if (dst != src) {
+		return;
+	}
+
+	BENCH_TIME(memset(d, 0x55, size));
+	emit("memset", size, dst, src);
+
+	fill_strings(d, s, size);
+	BENCH_TIME(sink = strlen((char *)d));
+	emit("strlen", size, dst, src);
+
+	/* Worst case, the character is not in the string */
+	BENCH_TIME(sink = (strchr((char *)d, 'z') != NULL));
+	emit("strchr", size, dst, src);
+}
+
+void main(void)
+{
+	int i, j;
+
+	bench_samples_init(&samples, sample_buf, ARRAY_SIZE(sample_buf));
+
+	TC_START("string benchmark");
+
+	bench_report_begin(&report, "string");
+
+	for (i = 0; i < ARRAY_SIZE(aligns); i++) {
+		for (j = 0; j < ARRAY_SIZE(sizes); j++) {
+			bench_size(sizes[j], aligns[i].dst, aligns[i].src);
+		}
+	}
+
+	bench_report_end(&report);
+
+	TC_END_REPORT(TC_PASS);
+}
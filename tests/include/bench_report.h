@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file helpers for machine-readable benchmark results
+ *
+ * Benchmarks collect one cycle count per iteration into a caller-provided
+ * sample buffer, reduce the samples to mean/min/max/percentiles, and emit
+ * them as a JSON document framed by BENCH_JSON_BEGIN/BENCH_JSON_END marker
+ * lines so that host tooling (scripts/bench_compare.py) can extract it from
+ * a console log.
+ */
+
+#ifndef _BENCH_REPORT_H_
+#define _BENCH_REPORT_H_
+
+#include <zephyr.h>
+#include <misc/printk.h>
+#include <version.h>
+
+#define BENCH_JSON_BEGIN "--- BENCH_JSON_BEGIN ---"
+#define BENCH_JSON_END "--- BENCH_JSON_END ---"
+
+#define bench_timer_get() k_cycle_get_32()
+
+struct bench_samples {
+	u32_t *buf;
+	u32_t size;
+	u32_t count;
+	/* Timer read overhead subtracted from every sample */
+	u32_t overhead;
+};
+
+struct bench_result {
+	u32_t count;
+	u32_t mean;
+	u32_t min;
+	u32_t p50;
+	u32_t p90;
+	u32_t p99;
+	u32_t max;
+	/* Bytes processed per iteration, 0 if not a throughput benchmark */
+	u32_t bytes;
+};
+
+struct bench_report {
+	u32_t records;
+};
+
+/*
+ * Measure the cost of back to back timer reads, so it can be removed
+ * from each sample. The minimum of a few tries filters out interrupts.
+ */
+static inline u32_t bench_timer_overhead(void)
+{
+	u32_t best = ~0;
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		u32_t t = bench_timer_get();
+		u32_t d = bench_timer_get() - t;
+
+		if (d < best) {
+			best = d;
+		}
+	}
+
+	return best;
+}
+
+static inline void bench_samples_init(struct bench_samples *s,
+				      u32_t *buf, u32_t size)
+{
+	s->buf = buf;
+	s->size = size;
+	s->count = 0;
+	s->overhead = bench_timer_overhead();
+}
+
+static inline void bench_samples_reset(struct bench_samples *s)
+{
+	s->count = 0;
+}
+
+/* Record one sample given start and end timer values */
+static inline void bench_samples_add(struct bench_samples *s,
+				     u32_t start, u32_t end)
+{
+	u32_t delta = end - start;
+
+	delta = (delta > s->overhead) ? delta - s->overhead : 0;
+
+	if (s->count < s->size) {
+		s->buf[s->count++] = delta;
+	}
+}
+
+/* Shell sort, there is no qsort() in the minimal libc */
+static inline void bench_samples_sort(u32_t *buf, u32_t n)
+{
+	u32_t gap, i, j;
+
+	for (gap = n / 2; gap > 0; gap /= 2) {
+		for (i = gap; i < n; i++) {
+			u32_t v = buf[i];
+
+			for (j = i; j >= gap && buf[j - gap] > v; j -= gap) {
+				buf[j] = buf[j - gap];
+			}
+			buf[j] = v;
+		}
+	}
+}
+
+static inline u32_t bench_percentile(const u32_t *sorted, u32_t n, u32_t pct)
+{
+	u32_t idx;
+
+	if (n == 0) {
+		return 0;
+	}
+
+	idx = (n * pct) / 100;
+	if (idx >= n) {
+		idx = n - 1;
+	}
+
+	return sorted[idx];
+}
+
+/* Reduce the samples into @a r. Sorts the sample buffer in place. */
+static inline void bench_samples_reduce(struct bench_samples *s,
+					struct bench_result *r)
+{
+	u64_t sum = 0;
+	u32_t i;
+
+	bench_samples_sort(s->buf, s->count);
+
+	for (i = 0; i < s->count; i++) {
+		sum += s->buf[i];
+	}
+
+	r->count = s->count;
+	r->mean = s->count ? (u32_t)(sum / s->count) : 0;
+	r->min = s->count ? s->buf[0] : 0;
+	r->max = s->count ? s->buf[s->count - 1] : 0;
+	r->p50 = bench_percentile(s->buf, s->count, 50);
+	r->p90 = bench_percentile(s->buf, s->count, 90);
+	r->p99 = bench_percentile(s->buf, s->count, 99);
+	r->bytes = 0;
+}
+
+/**
+ * @brief Start a JSON result document
+ *
+ * @param rep Report state, owned by the caller.
+ * @param suite Name of the benchmark suite, e.g. "kernel".
+ */
+static inline void bench_report_begin(struct bench_report *rep,
+				      const char *suite)
+{
+	rep->records = 0;
+
+	printk("\n%s\n", BENCH_JSON_BEGIN);
+	printk("{\"suite\": \"%s\", \"board\": \"%s\", "
+	       "\"version\": \"%s\", \"cycles_per_sec\": %u,\n"
+	       "\"results\": [\n",
+	       suite, CONFIG_BOARD, KERNEL_VERSION_STRING,
+	       (u32_t)CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC);
+}
+
+/**
+ * @brief Emit one result record
+ *
+ * @param rep Report state.
+ * @param name Operation name, e.g. "sem.give".
+ * @param params JSON object members describing the scenario, e.g.
+ *        "\"threads\": 2, \"prio\": \"higher\"", or NULL.
+ * @param r Reduced samples.
+ */
+static inline void bench_report_result(struct bench_report *rep,
+				       const char *name, const char *params,
+				       const struct bench_result *r)
+{
+	printk("%s{\"name\": \"%s\", \"params\": {%s}, \"iterations\": %u, "
+	       "\"mean\": %u, \"min\": %u, \"p50\": %u, \"p90\": %u, "
+	       "\"p99\": %u, \"max\": %u, \"bytes\": %u}",
+	       rep->records ? ",\n" : "", name, params ? params : "",
+	       r->count, r->mean, r->min, r->p50, r->p90, r->p99, r->max,
+	       r->bytes);
+	rep->records++;
+}
+
+static inline void bench_report_end(struct bench_report *rep)
+{
+	printk("\n]}\n%s\n", BENCH_JSON_END);
+}
+
+#endif /* _BENCH_REPORT_H_ */
@@ -25,7 +25,10 @@ char *expected = "22 113 10000 32768 40000 22\n"
 		 "42 42   42       42\n"
 		 "42 42 0042 00000042\n"
 		 "255     42    abcdef  0x0000002a      42\n"
-		 "-1 4294967295 ffffffff\n"
+		 "-1 18446744073709551615 ffffffffffffffff\n"
+		 "192.0.2.1 2001:db8::1 fe80::211:22ff:fe33:4455 :: "
+		 "00:11:22:aa:bb:cc\n"
+		 "     2001:db8::1|192.0.2.1   |\n"
 ;
 
 
@@ -35,10 +38,6 @@ unsigned short int usi = 10000;
 unsigned int ui = 32768;
 unsigned long ul = 40000;
 
-/* FIXME
- * we know printk doesn't have full support for 64-bit values.
- * at least show it can print u64_t values less than 32-bits wide
- */
 unsigned long long ull = 22;
 
 char c = 'p';
@@ -51,6 +50,14 @@ u32_t hex = 0xCAFEBABE;
 
 void *ptr = (void *)0xBEEF;
 
+u8_t ipv4[4] = { 192, 0, 2, 1 };
+u8_t ipv6[16] = { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+		  0, 0, 0, 0, 0, 0, 0, 0x01 };
+u8_t ipv6_ll[16] = { 0xfe, 0x80, 0, 0, 0, 0, 0, 0,
+		     0x02, 0x11, 0x22, 0xff, 0xfe, 0x33, 0x44, 0x55 };
+u8_t ipv6_any[16];
+u8_t mac[6] = { 0x00, 0x11, 0x22, 0xaa, 0xbb, 0xcc };
+
 static int ram_console_out(int character)
 {
 	ram_console[pos] = (char)character;
@@ -89,6 +96,8 @@ void test_printk(void)
 	printk("%u %02u %04u %08u\n", 42, 42, 42, 42);
 	printk("%-8u%-6d%-4x%-2p%8d\n", 0xFF, 42, 0xABCDEF, (char *)42, 42);
 	printk("%lld %llu %llx\n", -1LL, -1ULL, -1ULL);
+	printk("%pI4 %pI6 %pI6 %pI6 %pM\n", ipv4, ipv6, ipv6_ll, ipv6_any, mac);
+	printk("%16pI6|%-12pI4|\n", ipv6, ipv4);
 
 	ram_console[pos] = '\0';
 	zassert_true((strcmp(ram_console, expected) == 0), "printk failed");
@@ -121,6 +130,11 @@ void test_printk(void)
 	count += snprintk(ram_console + count, sizeof(ram_console) - count,
 			  "%lld %llu %llx\n",
 			  -1LL, -1ULL, -1ULL);
+	count += snprintk(ram_console + count, sizeof(ram_console) - count,
+			  "%pI4 %pI6 %pI6 %pI6 %pM\n",
+			  ipv4, ipv6, ipv6_ll, ipv6_any, mac);
+	count += snprintk(ram_console + count, sizeof(ram_console) - count,
+			  "%16pI6|%-12pI4|\n", ipv6, ipv4);
 	ram_console[count] = '\0';
 	zassert_true((strcmp(ram_console, expected) == 0), "snprintk failed");
 }
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+/* Matches CONFIG_PRINTK_DEFERRED_BUFFER_SIZE */
+#define RING_SIZE 256
+
+/* Each line is a single record: a 4 byte header and 29 bytes padded to
+ * 36. As 36 does not divide the ring size, the end of the ring falls
+ * inside a record at least once every two laps.
+ */
+#define LINE_LEN 29
+#define LINE_REC_LEN 36
+
+#define CAPTURE_SIZE 1024
+
+void __printk_hook_install(int (*fn)(int));
+void *__printk_get_hook(void);
+
+static int (*old_char_out)(int);
+static char capture[CAPTURE_SIZE];
+static int capture_len;
+
+static int capture_out(int c)
+{
+	if (capture_len < CAPTURE_SIZE) {
+		capture[capture_len++] = c;
+	}
+
+	return old_char_out(c);
+}
+
+/* Sends pending output to the console and captures the next one */
+static void capture_start(void)
+{
+	k_sleep(K_MSEC(100));
+
+	old_char_out = __printk_get_hook();
+	__printk_hook_install(capture_out);
+	capture_len = 0;
+}
+
+static void capture_stop(void)
+{
+	__printk_hook_install(old_char_out);
+}
+
+static void line(char *buf, int i)
+{
+	snprintk(buf, LINE_LEN + 1, "deferred printk line %04d...\n", i);
+}
+
+/* Checks the captured output is lines first to first + cnt - 1 */
+static void check_lines(int first, int cnt)
+{
+	char buf[LINE_LEN + 1];
+	int i;
+
+	zassert_equal(capture_len, cnt * LINE_LEN, "Captured %d bytes",
+		      capture_len);
+
+	for (i = 0; i < cnt; i++) {
+		line(buf, first + i);
+		zassert_true(!memcmp(&capture[i * LINE_LEN], buf, LINE_LEN),
+			     "Line %d out of order", first + i);
+	}
+}
+
+/**
+ * @brief Test that records are sent in order across the end of the ring
+ *
+ * @see printk()
+ */
+static void test_printk_deferred_wrap(void)
+{
+	char buf[LINE_LEN + 1];
+	int i;
+
+	capture_start();
+
+	for (i = 0; i < 2 * 2 * RING_SIZE / LINE_REC_LEN; i += 2) {
+		line(buf, i);
+		printk("%s", buf);
+		line(buf, i + 1);
+		printk("%s", buf);
+
+		zassert_equal(capture_len, 0, "Output not deferred");
+		k_sleep(K_MSEC(100));
+		check_lines(i, 2);
+		capture_len = 0;
+	}
+
+	capture_stop();
+}
+
+/**
+ * @brief Test that output which does not fit in the ring is dropped
+ *
+ * @see printk()
+ */
+static void test_printk_deferred_full(void)
+{
+	int max = RING_SIZE / LINE_REC_LEN + 2;
+	char buf[LINE_LEN + 1];
+	int cnt;
+	int i;
+
+	capture_start();
+
+	for (i = 0; i < max; i++) {
+		line(buf, i);
+		printk("%s", buf);
+	}
+
+	k_sleep(K_MSEC(100));
+
+	/* Older output is kept, a padding record may take some space */
+	cnt = capture_len / LINE_LEN;
+	zassert_true(cnt >= RING_SIZE / LINE_REC_LEN - 1 &&
+		     cnt < max, "%d lines kept", cnt);
+	check_lines(0, cnt);
+
+	/* Space is reused once sent */
+	capture_len = 0;
+	line(buf, max);
+	printk("%s", buf);
+	k_sleep(K_MSEC(100));
+	check_lines(max, 1);
+
+	capture_stop();
+}
+
+/**
+ * @brief Test that pending output is sent in order on a panic and that
+ * printk() is synchronous afterwards
+ *
+ * Panic mode cannot be left, so this test runs last.
+ *
+ * @see printk(), printk_panic()
+ */
+static void test_printk_deferred_panic(void)
+{
+	char buf[LINE_LEN + 1];
+	int i;
+
+	capture_start();
+
+	for (i = 0; i < 3; i++) {
+		line(buf, i);
+		printk("%s", buf);
+	}
+
+	zassert_equal(capture_len, 0, "Output not deferred");
+
+	printk_panic();
+	check_lines(0, 3);
+
+	capture_len = 0;
+	line(buf, 3);
+	printk("%s", buf);
+	check_lines(3, 1);
+
+	capture_stop();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(printk_deferred,
+			 ztest_unit_test(test_printk_deferred_wrap),
+			 ztest_unit_test(test_printk_deferred_full),
+			 ztest_unit_test(test_printk_deferred_panic));
+	ztest_run_test_suite(printk_deferred);
+}
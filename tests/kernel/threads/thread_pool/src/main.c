@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define POOL_PRIO K_PRIO_PREEMPT(1)
+#define NUM_REQS 4
+
+K_THREAD_POOL_DEFINE(queue_pool, 2, STACK_SIZE, 0, 2);
+K_THREAD_POOL_DEFINE(abort_pool, 1, STACK_SIZE, 0, 0);
+K_THREAD_POOL_DEFINE(alloc_pool, 2, STACK_SIZE, 0, 0);
+
+K_SEM_DEFINE(gate_sem, 0, NUM_REQS);
+K_SEM_DEFINE(done_sem, 0, NUM_REQS);
+K_SEM_DEFINE(never_sem, 0, 1);
+
+static k_tid_t ran_on[NUM_REQS];
+static struct k_thread foreign_thread;
+
+static void gated_entry(void *p1, void *p2, void *p3)
+{
+	ran_on[POINTER_TO_INT(p1)] = k_current_get();
+
+	k_sem_take(&gate_sem, K_FOREVER);
+	k_sem_give(&done_sem);
+}
+
+static void blocking_entry(void *p1, void *p2, void *p3)
+{
+	k_sem_take(&never_sem, K_FOREVER);
+}
+
+static void empty_entry(void *p1, void *p2, void *p3)
+{
+}
+
+/**
+ * @brief Test that spawn requests are queued and run on recycled threads
+ *
+ * @see k_thread_pool_spawn()
+ */
+void test_thread_pool_queue(void)
+{
+	k_tid_t tids[2];
+	int i;
+
+	zassert_equal(k_thread_pool_spawn(&queue_pool, gated_entry,
+					  INT_TO_POINTER(0), NULL, NULL,
+					  POOL_PRIO, &tids[0]), 0, NULL);
+	zassert_equal(k_thread_pool_spawn(&queue_pool, gated_entry,
+					  INT_TO_POINTER(1), NULL, NULL,
+					  POOL_PRIO, &tids[1]), 0, NULL);
+
+	/* Pool exhausted: requests are queued until the queue is full */
+	zassert_equal(k_thread_pool_spawn(&queue_pool, gated_entry,
+					  INT_TO_POINTER(2), NULL, NULL,
+					  POOL_PRIO, NULL), -EINPROGRESS, NULL);
+	zassert_equal(k_thread_pool_spawn(&queue_pool, gated_entry,
+					  INT_TO_POINTER(3), NULL, NULL,
+					  POOL_PRIO, NULL), -EINPROGRESS, NULL);
+	zassert_equal(k_thread_pool_spawn(&queue_pool, gated_entry,
+					  NULL, NULL, NULL,
+					  POOL_PRIO, NULL), -ENOMEM, NULL);
+
+	for (i = 0; i < NUM_REQS; i++) {
+		k_sem_give(&gate_sem);
+	}
+
+	for (i = 0; i < NUM_REQS; i++) {
+		zassert_equal(k_sem_take(&done_sem, 100), 0,
+			      "request %d not run", i);
+	}
+
+	/* Queued requests ran on the threads of the first ones */
+	for (i = 0; i < NUM_REQS; i++) {
+		zassert_true(ran_on[i] == tids[0] || ran_on[i] == tids[1],
+			     "request %d ran on a foreign thread", i);
+	}
+}
+
+/**
+ * @brief Test that exited and aborted threads go back to the pool
+ *
+ * @see k_thread_pool_spawn()
+ */
+void test_thread_pool_recycle(void)
+{
+	k_tid_t tid;
+
+	zassert_equal(k_thread_pool_spawn(&abort_pool, empty_entry,
+					  NULL, NULL, NULL,
+					  POOL_PRIO, NULL), 0, NULL);
+	k_sleep(10);
+
+	zassert_equal(k_thread_pool_spawn(&abort_pool, blocking_entry,
+					  NULL, NULL, NULL,
+					  POOL_PRIO, &tid), 0, NULL);
+	k_sleep(10);
+
+	zassert_equal(k_thread_pool_spawn(&abort_pool, empty_entry,
+					  NULL, NULL, NULL,
+					  POOL_PRIO, NULL), -ENOMEM, NULL);
+
+	k_thread_abort(tid);
+
+	zassert_equal(k_thread_pool_spawn(&abort_pool, empty_entry,
+					  NULL, NULL, NULL,
+					  POOL_PRIO, NULL), 0, NULL);
+	k_sleep(10);
+}
+
+/**
+ * @brief Test that reserved threads are held until freed
+ *
+ * @see k_thread_pool_alloc(), k_thread_pool_start(), k_thread_pool_free()
+ */
+void test_thread_pool_alloc_free(void)
+{
+	struct k_thread *t1, *t2;
+
+	t1 = k_thread_pool_alloc(&alloc_pool);
+	t2 = k_thread_pool_alloc(&alloc_pool);
+	zassert_not_null(t1, NULL);
+	zassert_not_null(t2, NULL);
+	zassert_is_null(k_thread_pool_alloc(&alloc_pool), NULL);
+
+	zassert_equal(k_thread_pool_start(&alloc_pool, t1, empty_entry,
+					  NULL, NULL, NULL, POOL_PRIO,
+					  K_NO_WAIT), t1, NULL);
+	k_sleep(10);
+
+	/* Exited, but still owned by the caller */
+	zassert_is_null(k_thread_pool_alloc(&alloc_pool), NULL);
+
+	zassert_equal(k_thread_pool_free(&alloc_pool, t1), 0, NULL);
+	zassert_equal(k_thread_pool_alloc(&alloc_pool), t1, NULL);
+
+	zassert_equal(k_thread_pool_free(&alloc_pool, &foreign_thread),
+		      -EINVAL, NULL);
+
+	zassert_equal(k_thread_pool_free(&alloc_pool, t1), 0, NULL);
+	zassert_equal(k_thread_pool_free(&alloc_pool, t2), 0, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(thread_pool,
+			 ztest_unit_test(test_thread_pool_queue),
+			 ztest_unit_test(test_thread_pool_recycle),
+			 ztest_unit_test(test_thread_pool_alloc_free));
+	ztest_run_test_suite(thread_pool);
+}
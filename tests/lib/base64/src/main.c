@@ -27,6 +27,7 @@
 #include <stdbool.h>
 #include <ztest.h>
 #include <base64.h>
+#include <net/buf.h>
 
 static const unsigned char base64_test_dec[64] = {
 	0x24, 0x48, 0x6E, 0x56, 0x87, 0x62, 0x5A, 0xBD,
@@ -65,10 +66,151 @@ static void test_base64_codec(void)
 	zassert_equal(rc, 0, "Decode test comparison");
 }
 
+/* Encode and decode in chunks of every size, the output does not change */
+static void test_base64_stream(void)
+{
+	struct base64_enc_ctx enc;
+	struct base64_dec_ctx dec;
+	unsigned char buffer[128];
+	size_t len, olen, off, chunk;
+	int rc;
+
+	for (chunk = 1; chunk <= 8; chunk++) {
+		base64_enc_init(&enc);
+		len = 0;
+
+		for (off = 0; off < 64; off += chunk) {
+			rc = base64_enc_update(&enc, buffer + len,
+					       sizeof(buffer) - len, &olen,
+					       base64_test_dec + off,
+					       min(chunk, 64 - off));
+			zassert_equal(rc, 0, "Encode update return value");
+			zassert_equal(olen % 4, 0, "Encode partial group");
+			len += olen;
+		}
+
+		rc = base64_enc_finish(&enc, buffer + len,
+				       sizeof(buffer) - len, &olen);
+		zassert_equal(rc, 0, "Encode finish return value");
+		len += olen;
+
+		zassert_equal(len, 88, "Encode stream length");
+		zassert_equal(memcmp(base64_test_enc, buffer, 88), 0,
+			      "Encode stream comparison");
+
+		base64_dec_init(&dec);
+		len = 0;
+
+		for (off = 0; off < 88; off += chunk) {
+			rc = base64_dec_update(&dec, buffer + len,
+					       sizeof(buffer) - len, &olen,
+					       base64_test_enc + off,
+					       min(chunk, 88 - off));
+			zassert_equal(rc, 0, "Decode update return value");
+			len += olen;
+		}
+
+		zassert_equal(base64_dec_finish(&dec), 0,
+			      "Decode finish return value");
+		zassert_equal(len, 64, "Decode stream length");
+		zassert_equal(memcmp(base64_test_dec, buffer, 64), 0,
+			      "Decode stream comparison");
+	}
+}
+
+static void test_base64_stream_errors(void)
+{
+	static const u8_t spaced[] = "Zm9v\r\nYm Fy\nYQ==";
+	struct base64_dec_ctx dec;
+	unsigned char buffer[16];
+	size_t olen;
+	int rc;
+
+	/* White space is skipped anywhere */
+	base64_dec_init(&dec);
+	rc = base64_dec_update(&dec, buffer, sizeof(buffer), &olen,
+			       spaced, sizeof(spaced) - 1);
+	zassert_equal(rc, 0, "Decode with white space");
+	zassert_equal(olen, 7, "Decode with white space length");
+	zassert_equal(memcmp(buffer, "foobara", 7), 0,
+		      "Decode with white space comparison");
+	zassert_equal(base64_dec_finish(&dec), 0, "Decode finish");
+
+	/* Data after padding */
+	base64_dec_init(&dec);
+	rc = base64_dec_update(&dec, buffer, sizeof(buffer), &olen,
+			       (const u8_t *)"YQ==YQ==", 8);
+	zassert_equal(rc, -EINVAL, "Data after padding accepted");
+
+	/* Padding at the start of a group */
+	base64_dec_init(&dec);
+	rc = base64_dec_update(&dec, buffer, sizeof(buffer), &olen,
+			       (const u8_t *)"Y===", 4);
+	zassert_equal(rc, -EINVAL, "Misplaced padding accepted");
+
+	/* Invalid character */
+	base64_dec_init(&dec);
+	rc = base64_dec_update(&dec, buffer, sizeof(buffer), &olen,
+			       (const u8_t *)"Zm9v!mFy", 8);
+	zassert_equal(rc, -EINVAL, "Invalid character accepted");
+
+	/* Incomplete group */
+	base64_dec_init(&dec);
+	rc = base64_dec_update(&dec, buffer, sizeof(buffer), &olen,
+			       (const u8_t *)"Zm9vYm", 6);
+	zassert_equal(rc, 0, "Decode incomplete group");
+	zassert_equal(olen, 3, "Decode incomplete group length");
+	zassert_equal(base64_dec_finish(&dec), -EINVAL,
+		      "Incomplete group accepted");
+
+	/* Output buffer too small, nothing is consumed */
+	base64_dec_init(&dec);
+	rc = base64_dec_update(&dec, buffer, 2, &olen,
+			       (const u8_t *)"Zm9v", 4);
+	zassert_equal(rc, -ENOMEM, "Small buffer accepted");
+	zassert_equal(olen, 3, "Required length");
+}
+
+/* Fragments smaller than the output, with room for three groups */
+NET_BUF_POOL_DEFINE(base64_pool, 8, 14, 0, NULL);
+
+static void test_base64_net_buf(void)
+{
+	struct base64_enc_ctx enc;
+	struct net_buf *buf, *frag;
+	size_t len = 0;
+	int rc;
+
+	buf = net_buf_alloc(&base64_pool, K_NO_WAIT);
+	zassert_not_null(buf, "Buffer allocation");
+
+	base64_enc_init(&enc);
+	rc = base64_enc_net_buf(&enc, buf, &base64_pool, K_NO_WAIT,
+				base64_test_dec, 31, false);
+	zassert_equal(rc, 0, "Encode to net_buf");
+	rc = base64_enc_net_buf(&enc, buf, &base64_pool, K_NO_WAIT,
+				base64_test_dec + 31, 33, true);
+	zassert_equal(rc, 0, "Encode to net_buf finish");
+
+	for (frag = buf; frag; frag = frag->frags) {
+		zassert_equal(frag->len % 4, 0, "Group split across fragments");
+		zassert_equal(memcmp(base64_test_enc + len, frag->data,
+				     frag->len), 0, "Fragment comparison");
+		len += frag->len;
+	}
+
+	zassert_equal(len, 88, "Encoded length");
+
+	net_buf_unref(buf);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(lib_base64_test,
-			 ztest_unit_test(test_base64_codec));
+			 ztest_unit_test(test_base64_codec),
+			 ztest_unit_test(test_base64_stream),
+			 ztest_unit_test(test_base64_stream_errors),
+			 ztest_unit_test(test_base64_net_buf));
 
 	ztest_run_test_suite(lib_base64_test);
 }
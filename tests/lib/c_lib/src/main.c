@@ -254,6 +254,113 @@ void test_memcmp(void)
 	zassert_true((ret != 0), "memcmp 5");
 }
 
+/**
+ *
+ * @brief Test memory and string functions across alignments
+ *
+ * The word-at-a-time implementations handle the unaligned head and tail
+ * of a buffer separately, so check every start offset and a range of
+ * lengths around the word size against byte-by-byte expectations.
+ */
+
+#define ALIGN_BUFSIZE 64
+#define ALIGN_OFFSETS 8
+
+void test_mem_alignment(void)
+{
+	static u8_t src[ALIGN_BUFSIZE + ALIGN_OFFSETS];
+	static u8_t dst[ALIGN_BUFSIZE + ALIGN_OFFSETS];
+	int so, doff, len, i;
+
+	for (i = 0; i < sizeof(src); i++) {
+		src[i] = i + 1;
+	}
+
+	for (so = 0; so < ALIGN_OFFSETS; so++) {
+		for (doff = 0; doff < ALIGN_OFFSETS; doff++) {
+			for (len = 0; len < ALIGN_BUFSIZE; len++) {
+				memset(dst, 0, sizeof(dst));
+				memcpy(dst + doff, src + so, len);
+
+				for (i = 0; i < sizeof(dst); i++) {
+					u8_t exp = (i >= doff && i < doff + len) ?
+						   src[so + i - doff] : 0;
+
+					zassert_equal(dst[i], exp,
+						      "memcpy %d/%d/%d", so,
+						      doff, len);
+				}
+
+				zassert_equal(memcmp(dst + doff, src + so, len),
+					      0, "memcmp %d/%d/%d", so, doff,
+					      len);
+
+				if (len) {
+					dst[doff + len - 1] = 0xff;
+					zassert_true(memcmp(dst + doff, src + so,
+							    len) > 0,
+						     "memcmp unsigned");
+				}
+			}
+		}
+
+		for (len = 0; len < ALIGN_BUFSIZE; len++) {
+			memset(dst, 0x55, sizeof(dst));
+			memset(dst + so, 0xaa, len);
+
+			for (i = 0; i < sizeof(dst); i++) {
+				zassert_equal(dst[i],
+					      (i >= so && i < so + len) ?
+					      0xaa : 0x55, "memset %d/%d",
+					      so, len);
+			}
+		}
+	}
+}
+
+void test_str_alignment(void)
+{
+	static char s1[ALIGN_BUFSIZE + ALIGN_OFFSETS];
+	static char s2[ALIGN_BUFSIZE + ALIGN_OFFSETS];
+	int o1, o2, len;
+
+	for (o1 = 0; o1 < ALIGN_OFFSETS; o1++) {
+		for (len = 0; len < ALIGN_BUFSIZE - 1; len++) {
+			memset(s1, 'x', sizeof(s1));
+			memset(s1 + o1, 'a', len);
+			s1[o1 + len] = '\0';
+
+			zassert_equal(strlen(s1 + o1), len, "strlen %d/%d",
+				      o1, len);
+			zassert_equal(strchr(s1 + o1, 'x'), NULL,
+				      "strchr miss %d/%d", o1, len);
+			zassert_equal(strchr(s1 + o1, '\0'), s1 + o1 + len,
+				      "strchr nul %d/%d", o1, len);
+
+			if (len) {
+				s1[o1 + len - 1] = 'b';
+				zassert_equal(strchr(s1 + o1, 'b'),
+					      s1 + o1 + len - 1,
+					      "strchr hit %d/%d", o1, len);
+			}
+
+			for (o2 = 0; o2 < ALIGN_OFFSETS; o2++) {
+				memset(s2, 'y', sizeof(s2));
+				strcpy(s2 + o2, s1 + o1);
+
+				zassert_equal(strcmp(s1 + o1, s2 + o2), 0,
+					      "strcmp %d/%d/%d", o1, o2, len);
+
+				s2[o2 + len] = 'c';
+				s2[o2 + len + 1] = '\0';
+				zassert_true(strcmp(s1 + o1, s2 + o2) < 0,
+					     "strcmp prefix %d/%d/%d", o1, o2,
+					     len);
+			}
+		}
+	}
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_c_lib,
@@ -267,7 +374,9 @@ void test_main(void)
 			 ztest_unit_test(test_strncpy),
 			 ztest_unit_test(test_memset),
 			 ztest_unit_test(test_strlen),
-			 ztest_unit_test(test_strcmp)
+			 ztest_unit_test(test_strcmp),
+			 ztest_unit_test(test_mem_alignment),
+			 ztest_unit_test(test_str_alignment)
 			 );
 	ztest_run_test_suite(test_c_lib);
 }
@@ -3,11 +3,13 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include <limits.h>
 #include <string.h>
 #include <zephyr/types.h>
 #include <stdbool.h>
 #include <ztest.h>
 #include <json.h>
+#include <net/buf.h>
 
 struct test_nested {
 	int nested_int;
@@ -354,6 +356,112 @@ static void test_json_obj_arr_decoding(void)
 		     "Element 9 height decoded correctly");
 }
 
+/* Members of mixed width, so that the size of the struct is not the sum
+ * of its members rounded up to the alignment of the struct
+ */
+struct sample {
+	s64_t stamp;
+	bool valid;
+	bool calibrated;
+	int value;
+};
+
+struct sample_array {
+	struct sample samples[4];
+	size_t num_samples;
+};
+
+static const struct json_obj_descr sample_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct sample, stamp, JSON_TOK_INT64),
+	JSON_OBJ_DESCR_PRIM(struct sample, valid, JSON_TOK_TRUE),
+	JSON_OBJ_DESCR_PRIM(struct sample, calibrated, JSON_TOK_TRUE),
+	JSON_OBJ_DESCR_PRIM(struct sample, value, JSON_TOK_NUMBER),
+};
+
+static const struct json_obj_descr sample_array_descr[] = {
+	JSON_OBJ_DESCR_OBJ_ARRAY(struct sample_array, samples, 4, num_samples,
+				 sample_descr, ARRAY_SIZE(sample_descr)),
+};
+
+/* Same, built by hand without the struct size of the macros */
+static const struct json_obj_descr sample_array_no_size_descr[] = {
+	{
+		.field_name = "samples",
+		.field_name_len = sizeof("samples") - 1,
+		.offset = offsetof(struct sample_array, samples),
+		.type = JSON_TOK_LIST_START,
+		.array = {
+			.element_descr = &(struct json_obj_descr) {
+				.type = JSON_TOK_OBJECT_START,
+				.object = {
+					.sub_descr = sample_descr,
+					.sub_descr_len =
+						ARRAY_SIZE(sample_descr),
+				},
+				.offset = offsetof(struct sample_array,
+						   num_samples),
+			},
+			.n_elements = 4,
+		},
+	},
+};
+
+static void test_json_obj_arr_mixed_width(void)
+{
+	const struct json_obj_descr *descrs[] = {
+		sample_array_descr, sample_array_no_size_descr,
+	};
+	char encoded[] = "{\"samples\":["
+		"{\"stamp\":1000000000001,\"valid\":true,"
+		"\"calibrated\":false,\"value\":-7},"
+		"{\"stamp\":2,\"valid\":false,"
+		"\"calibrated\":true,\"value\":42},"
+		"{\"stamp\":-3,\"valid\":true,"
+		"\"calibrated\":true,\"value\":1234}"
+		"]}";
+	char buffer[sizeof(encoded)];
+	struct sample_array sa;
+	int ret;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(descrs); i++) {
+		memset(&sa, 0xa5, sizeof(sa));
+
+		ret = json_obj_parse(encoded, sizeof(encoded) - 1, descrs[i],
+				     1, &sa);
+		zassert_equal(ret, 1, "Array of samples decoded");
+		zassert_equal(sa.num_samples, 3, "Three samples decoded");
+
+		zassert_equal(sa.samples[0].stamp, 1000000000001LL,
+			      "Sample 0 stamp decoded");
+		zassert_true(sa.samples[0].valid, "Sample 0 valid decoded");
+		zassert_false(sa.samples[0].calibrated,
+			      "Sample 0 calibrated decoded");
+		zassert_equal(sa.samples[0].value, -7,
+			      "Sample 0 value decoded");
+		zassert_equal(sa.samples[1].stamp, 2, "Sample 1 stamp decoded");
+		zassert_false(sa.samples[1].valid, "Sample 1 valid decoded");
+		zassert_true(sa.samples[1].calibrated,
+			     "Sample 1 calibrated decoded");
+		zassert_equal(sa.samples[1].value, 42,
+			      "Sample 1 value decoded");
+		zassert_equal(sa.samples[2].stamp, -3, "Sample 2 stamp decoded");
+		zassert_true(sa.samples[2].valid, "Sample 2 valid decoded");
+		zassert_true(sa.samples[2].calibrated,
+			     "Sample 2 calibrated decoded");
+		zassert_equal(sa.samples[2].value, 1234,
+			      "Sample 2 value decoded");
+		zassert_equal(sa.samples[3].value, (int)0xa5a5a5a5,
+			      "Sample past the array left untouched");
+
+		ret = json_obj_encode_buf(descrs[i], 1, &sa, buffer,
+					  sizeof(buffer));
+		zassert_equal(ret, 0, "Array of samples encoded");
+		zassert_true(!strcmp(buffer, encoded),
+			     "Encoded array of samples is consistent");
+	}
+}
+
 static void test_json_invalid_unicode(void)
 {
 	struct test_struct ts;
@@ -409,6 +517,37 @@ static void test_json_key_not_in_descr(void)
 	zassert_equal(ret, 0, "No items should be decoded");
 }
 
+static void test_json_descr_no_hash(void)
+{
+	/* Built by hand, without the name hash of the JSON_OBJ_DESCR_*()
+	 * macros
+	 */
+	static const struct json_obj_descr descr[] = {
+		{
+			.field_name = "name",
+			.field_name_len = sizeof("name") - 1,
+			.offset = offsetof(struct elt, name),
+			.type = JSON_TOK_STRING,
+		},
+		{
+			.field_name = "height",
+			.field_name_len = sizeof("height") - 1,
+			.offset = offsetof(struct elt, height),
+			.type = JSON_TOK_NUMBER,
+		},
+	};
+	char encoded[] = "{\"height\":188,\"name\":\"Luka\"}";
+	struct elt elt = {};
+	int ret;
+
+	ret = json_obj_parse(encoded, sizeof(encoded) - 1, descr,
+			     ARRAY_SIZE(descr), &elt);
+	zassert_equal(ret, 0x3, "Both fields decoded");
+	zassert_equal(elt.height, 188, "Number decoded");
+	zassert_true(elt.name && !strcmp(elt.name, "Luka"),
+		     "String decoded");
+}
+
 static void test_json_escape(void)
 {
 	char buf[42];
@@ -494,6 +633,480 @@ static void test_json_escape_bounds_check(void)
 	zassert_equal(ret, -ENOMEM, "Bounds check OK");
 }
 
+struct test_numbers {
+	int num;
+	s64_t big;
+	s64_t price;
+	double ratio;
+	s64_t bigs[3];
+	size_t bigs_len;
+};
+
+static const struct json_obj_descr numbers_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct test_numbers, num, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct test_numbers, big, JSON_TOK_INT64),
+	JSON_OBJ_DESCR_FIXED_POINT(struct test_numbers, price, 2),
+	JSON_OBJ_DESCR_PRIM(struct test_numbers, ratio, JSON_TOK_FLOAT),
+	JSON_OBJ_DESCR_ARRAY(struct test_numbers, bigs, 3, bigs_len,
+			     JSON_TOK_INT64),
+};
+
+static int parse_in_chunks(const char *payload, size_t len, size_t chunk,
+			   const struct json_obj_descr *descr,
+			   size_t descr_len, void *val,
+			   char *str_buf, size_t str_size)
+{
+	struct json_parser parser;
+	size_t off;
+	int ret = 0;
+
+	json_parser_init(&parser, descr, descr_len, val, str_buf, str_size);
+
+	for (off = 0; off < len && !ret; off += chunk) {
+		ret = json_parser_feed(&parser, payload + off,
+				       min(chunk, len - off));
+	}
+
+	return json_parser_finish(&parser);
+}
+
+static void test_json_parser_chunks(void)
+{
+	const char encoded[] = "{\"some_string\":\"zephyr \\\"123\\\"\","
+		"\"some_int\":\t42\n,"
+		"\"some_bool\":true    \t  ,"
+		"\"some_nested_struct\":{    "
+		"\"nested_int\":-1234,\n\n"
+		"\"nested_bool\":false,\t"
+		"\"nested_string\":\"this should be escaped: \\t\"},"
+		"\"some_array\":[11,22, 33,\t45,\n299],"
+		"\"another_b!@l\":true,"
+		"\"if\":false,"
+		"\"another-array\":[2,3,5,7],"
+		"\"4nother_ne$+\":{\"nested_int\":1234,"
+		"\"nested_bool\":true,"
+		"\"nested_string\":\"no escape necessary\"}"
+		"}";
+	const int expected_array[] = { 11, 22, 33, 45, 299 };
+	const int expected_other_array[] = { 2, 3, 5, 7 };
+	const size_t chunks[] = { 1, 2, 7, 64, sizeof(encoded) };
+	struct test_struct ts;
+	char strings[80];
+	int ret;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(chunks); i++) {
+		memset(&ts, 0, sizeof(ts));
+
+		ret = parse_in_chunks(encoded, sizeof(encoded) - 1, chunks[i],
+				      test_descr, ARRAY_SIZE(test_descr), &ts,
+				      strings, sizeof(strings));
+
+		zassert_equal(ret, (1 << ARRAY_SIZE(test_descr)) - 1,
+			      "All fields decoded in chunks of %zu",
+			      chunks[i]);
+		zassert_true(!strcmp(ts.some_string, "zephyr \\\"123\\\""),
+			     "String decoded correctly");
+		zassert_equal(ts.some_int, 42, "Integer decoded correctly");
+		zassert_true(ts.some_bool, "Boolean decoded correctly");
+		zassert_equal(ts.some_nested_struct.nested_int, -1234,
+			      "Nested integer decoded correctly");
+		zassert_false(ts.some_nested_struct.nested_bool,
+			      "Nested boolean decoded correctly");
+		zassert_true(!strcmp(ts.some_nested_struct.nested_string,
+				     "this should be escaped: \\t"),
+			     "Nested string decoded correctly");
+		zassert_equal(ts.some_array_len, 5,
+			      "Array has correct number of items");
+		zassert_true(!memcmp(ts.some_array, expected_array,
+				     sizeof(expected_array)),
+			     "Array decoded with expected values");
+		zassert_true(ts.another_bxxl, "Named boolean decoded");
+		zassert_false(ts.if_, "Reserved word decoded");
+		zassert_equal(ts.another_array_len, 4,
+			      "Named array has correct number of items");
+		zassert_true(!memcmp(ts.another_array, expected_other_array,
+				     sizeof(expected_other_array)),
+			     "Named array decoded with expected values");
+		zassert_true(!strcmp(ts.xnother_nexx.nested_string,
+				     "no escape necessary"),
+			     "Named nested string decoded correctly");
+	}
+}
+
+static void test_json_parser_obj_arr(void)
+{
+	const char encoded[] = "{\"elements\":["
+		"{\"name\":\"Simón Bolívar\",\"height\":168},"
+		"{\"height\":160,\"name\":\"Muggsy Bogues\"},"
+		"{\"name\":\"Pelé\",\"height\":173}"
+		"]}";
+	struct obj_array oa;
+	char strings[48];
+	int ret;
+
+	ret = parse_in_chunks(encoded, sizeof(encoded) - 1, 3,
+			      obj_array_descr, ARRAY_SIZE(obj_array_descr),
+			      &oa, strings, sizeof(strings));
+
+	zassert_equal(ret, 1, "Array of objects decoded");
+	zassert_equal(oa.num_elements, 3, "Number of elements decoded");
+	zassert_true(!strcmp(oa.elements[0].name, "Simón Bolívar"),
+		     "Element 0 name decoded correctly");
+	zassert_equal(oa.elements[1].height, 160,
+		      "Element 1 height decoded correctly");
+	zassert_true(!strcmp(oa.elements[2].name, "Pelé"),
+		     "Element 2 name decoded correctly");
+
+	ret = parse_in_chunks(encoded, sizeof(encoded) - 1, 3,
+			      obj_array_descr, ARRAY_SIZE(obj_array_descr),
+			      &oa, strings, 16);
+	zassert_equal(ret, -ENOMEM, "String buffer overflow detected");
+}
+
+static void test_json_parser_skip_unknown(void)
+{
+	const char encoded[] = "{\"unknown\":{\"a\":[1,{\"b\":null},"
+		"\"\\u00e9\"],\"c\":-1.5e3},"
+		"\"some_int\":7,"
+		"\"also_unknown\":[[],[true,false]],"
+		"\"some_int\":8}";
+	struct test_struct ts;
+	int ret;
+
+	ret = parse_in_chunks(encoded, sizeof(encoded) - 1, 5,
+			      test_descr, ARRAY_SIZE(test_descr), &ts,
+			      NULL, 0);
+
+	zassert_equal(ret, 1 << 1, "Only some_int decoded");
+	zassert_equal(ts.some_int, 7, "First occurrence of a key decoded");
+}
+
+static void test_json_parser_errors(void)
+{
+	static const char * const invalid[] = {
+		"[]",
+		"{\"some_int\":1 \"some_bool\":true}",
+		"{\"some_int\":1,}",
+		"{\"some_int\":1.5}",
+		"{\"some_int\":2147483648}",
+		"{\"some_int\":-}",
+		"{\"some_int\":1e}",
+		"{\"some_string\":null}",
+		"{\"some_bool\":tru}",
+		"{\"some_string\":\"\\uABC@\"}",
+		"{\"some_array\":[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17]}",
+		"{\"unknown\":[[[[[[[[[[1]]]]]]]]]]}",
+		"{\"some_int\":1]",
+		"{\"some_int\":1",
+	};
+	const int expected[] = {
+		-EINVAL, -EINVAL, -EINVAL, -EINVAL, -ERANGE, -EINVAL,
+		-EINVAL, -EINVAL, -EINVAL, -EINVAL, -ENOSPC, -ENOMEM,
+		-EINVAL, -EINVAL,
+	};
+	struct test_struct ts;
+	char strings[16];
+	int ret;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(invalid); i++) {
+		ret = parse_in_chunks(invalid[i], strlen(invalid[i]), 1,
+				      test_descr, ARRAY_SIZE(test_descr), &ts,
+				      strings, sizeof(strings));
+		zassert_equal(ret, expected[i], "Decoding %s returned %d",
+			      invalid[i], ret);
+	}
+}
+
+static void test_json_numbers_decoding(void)
+{
+	char encoded[] = "{\"num\":-2147483648,"
+		"\"big\":-9223372036854775808,"
+		"\"price\":-12.3456,"
+		"\"ratio\":1.5e-3,"
+		"\"bigs\":[9223372036854775807,0,1099511627776]}";
+	struct test_numbers tn;
+	int ret;
+	int i;
+
+	for (i = 0; i < 2; i++) {
+		memset(&tn, 0, sizeof(tn));
+
+		if (i) {
+			ret = parse_in_chunks(encoded, sizeof(encoded) - 1, 1,
+					      numbers_descr,
+					      ARRAY_SIZE(numbers_descr), &tn,
+					      NULL, 0);
+		} else {
+			ret = json_obj_parse(encoded, sizeof(encoded) - 1,
+					     numbers_descr,
+					     ARRAY_SIZE(numbers_descr), &tn);
+		}
+
+		zassert_equal(ret, (1 << ARRAY_SIZE(numbers_descr)) - 1,
+			      "All numbers decoded");
+		zassert_equal(tn.num, INT32_MIN, "32-bit minimum decoded");
+		zassert_true(tn.big == LLONG_MIN, "64-bit minimum decoded");
+		zassert_true(tn.price == -1234,
+			     "Fixed-point number truncated");
+		zassert_true(tn.ratio == 0.0015, "Float decoded");
+		zassert_equal(tn.bigs_len, 3, "64-bit array decoded");
+		zassert_true(tn.bigs[0] == LLONG_MAX, "64-bit maximum decoded");
+		zassert_true(tn.bigs[2] == 1099511627776LL,
+			     "64-bit element decoded");
+	}
+}
+
+static void test_json_numbers_encoding(void)
+{
+	const struct json_obj_descr descr[] = {
+		JSON_OBJ_DESCR_PRIM(struct test_numbers, big, JSON_TOK_INT64),
+		JSON_OBJ_DESCR_FIXED_POINT(struct test_numbers, price, 2),
+		JSON_OBJ_DESCR_ARRAY(struct test_numbers, bigs, 3, bigs_len,
+				     JSON_TOK_INT64),
+	};
+	struct test_numbers tn = {
+		.big = LLONG_MIN,
+		.price = -5,
+		.bigs = { LLONG_MAX, 0, -1 },
+		.bigs_len = 3,
+	};
+	const char expected[] = "{\"big\":-9223372036854775808,"
+		"\"price\":-0.05,"
+		"\"bigs\":[9223372036854775807,0,-1]}";
+	char buffer[sizeof(expected)];
+	int ret;
+
+	ret = json_obj_encode_buf(descr, ARRAY_SIZE(descr), &tn,
+				  buffer, sizeof(buffer));
+	zassert_equal(ret, 0, "Encoding function returned no errors");
+	zassert_true(!strcmp(buffer, expected), "Encoded contents consistent");
+
+	tn.price = 123456;
+	ret = json_obj_encode_buf(descr, 2, &tn, buffer, sizeof(buffer));
+	zassert_equal(ret, 0, "Encoding function returned no errors");
+	zassert_true(!strcmp(buffer, "{\"big\":-9223372036854775808,"
+			     "\"price\":1234.56}"),
+		     "Fixed-point number encoded");
+}
+
+#define WIDE_FIELDS(m) \
+	m(0) m(1) m(2) m(3) m(4) m(5) m(6) m(7) \
+	m(8) m(9) m(10) m(11) m(12) m(13) m(14) m(15) \
+	m(16) m(17) m(18) m(19) m(20) m(21) m(22) m(23) \
+	m(24) m(25) m(26) m(27) m(28) m(29) m(30) m(31) \
+	m(32) m(33) m(34) m(35) m(36) m(37) m(38) m(39)
+
+#define WIDE_FIELD(n) int f##n;
+#define WIDE_DESCR(n) \
+	JSON_OBJ_DESCR_PRIM(struct test_wide, f##n, JSON_TOK_NUMBER),
+
+struct test_wide {
+	WIDE_FIELDS(WIDE_FIELD)
+	int with_a_rather_long_name_1;
+	int with_a_rather_long_name_2;
+};
+
+static const struct json_obj_descr wide_descr[] = {
+	WIDE_FIELDS(WIDE_DESCR)
+	JSON_OBJ_DESCR_PRIM(struct test_wide, with_a_rather_long_name_1,
+			    JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct test_wide, with_a_rather_long_name_2,
+			    JSON_TOK_NUMBER),
+};
+
+static void test_json_wide_object(void)
+{
+	char encoded[512];
+	struct test_wide tw;
+	size_t len;
+	int ret;
+	int i;
+
+	/* Keys in reverse order, the value of f<n> is n */
+	len = snprintk(encoded, sizeof(encoded),
+		       "{\"with_a_rather_long_name_2\":-2,"
+		       "\"with_a_rather_long_name_1\":-1");
+	for (i = 39; i >= 0; i--) {
+		len += snprintk(encoded + len, sizeof(encoded) - len,
+				",\"f%d\":%d", i, i);
+	}
+	len += snprintk(encoded + len, sizeof(encoded) - len, "}");
+	zassert_true(len < sizeof(encoded), "Payload fits");
+
+	for (i = 0; i < 2; i++) {
+		memset(&tw, 0xff, sizeof(tw));
+
+		if (i) {
+			ret = parse_in_chunks(encoded, len, 11, wide_descr,
+					      ARRAY_SIZE(wide_descr), &tw,
+					      NULL, 0);
+		} else {
+			ret = json_obj_parse(encoded, len, wide_descr,
+					     ARRAY_SIZE(wide_descr), &tw);
+		}
+
+		zassert_equal(ret, INT_MAX, "First 31 fields reported");
+		zassert_equal(tw.f0, 0, "First field decoded");
+		zassert_equal(tw.f31, 31, "Field 31 decoded");
+		zassert_equal(tw.f39, 39, "Last numbered field decoded");
+		zassert_equal(tw.with_a_rather_long_name_1, -1,
+			      "Long name decoded");
+		zassert_equal(tw.with_a_rather_long_name_2, -2,
+			      "Long name with same prefix decoded");
+	}
+
+	for (i = 0; i < 2; i++) {
+		u32_t fields[JSON_FIELDS_WORDS(ARRAY_SIZE(wide_descr))] = { 0 };
+		struct json_parser parser;
+		size_t off;
+
+		if (i) {
+			json_parser_init(&parser, wide_descr,
+					 ARRAY_SIZE(wide_descr), &tw, NULL, 0);
+			for (off = 0; off < len; off += 11) {
+				json_parser_feed(&parser, encoded + off,
+						 min(11, len - off));
+			}
+
+			ret = json_parser_finish_fields(&parser, fields);
+		} else {
+			ret = json_obj_parse_fields(encoded, len, wide_descr,
+						    ARRAY_SIZE(wide_descr),
+						    &tw, fields);
+		}
+
+		zassert_equal(ret, INT_MAX, "First 31 fields returned");
+		zassert_equal(fields[0], 0xffffffff, "First 32 fields set");
+		zassert_equal(fields[1], BIT(ARRAY_SIZE(wide_descr) - 32) - 1,
+			      "Fields 32 and up set");
+	}
+}
+
+NET_BUF_POOL_DEFINE(json_buf_pool, 8, 32, 0, NULL);
+
+static const struct obj_array encoding_array = {
+	.elements = {
+		[0] = { .name = "Simón \"El Libertador\" Bolívar",
+			.height = 168 },
+		[1] = { .name = "Muggsy Bogues\n", .height = -160 },
+		[2] = { .name = "\\Pelé/", .height = 173 },
+	},
+	.num_elements = 3,
+};
+
+struct flushed {
+	char buf[256];
+	size_t len;
+	size_t chunk_size;
+	int partial;
+};
+
+static int flush_chunk(const char *bytes, size_t len, void *data)
+{
+	struct flushed *flushed = data;
+
+	if (len % flushed->chunk_size) {
+		flushed->partial++;
+	}
+
+	if (len > sizeof(flushed->buf) - flushed->len) {
+		return -ENOMEM;
+	}
+
+	memcpy(flushed->buf + flushed->len, bytes, len);
+	flushed->len += len;
+
+	return 0;
+}
+
+static void test_json_encoding_chunked(void)
+{
+	const size_t chunks[] = { 1, 7, 64, 256 };
+	struct flushed flushed;
+	char expected[256];
+	char chunk[256];
+	int ret;
+	int i;
+
+	ret = json_obj_encode_buf(obj_array_descr, ARRAY_SIZE(obj_array_descr),
+				  &encoding_array, expected, sizeof(expected));
+	zassert_equal(ret, 0, "Encoding function returned no errors");
+
+	for (i = 0; i < ARRAY_SIZE(chunks); i++) {
+		memset(&flushed, 0, sizeof(flushed));
+		flushed.chunk_size = chunks[i];
+
+		ret = json_obj_encode_chunked(obj_array_descr,
+					      ARRAY_SIZE(obj_array_descr),
+					      &encoding_array, chunk,
+					      chunks[i], flush_chunk,
+					      &flushed);
+		zassert_equal(ret, 0, "Chunked encoding returned no errors");
+		zassert_true(flushed.partial <= 1,
+			     "Only the last chunk may be partial");
+		zassert_equal(flushed.len, strlen(expected),
+			      "Encoded length consistent");
+		zassert_true(!memcmp(flushed.buf, expected, flushed.len),
+			     "Encoded contents consistent");
+	}
+
+	ret = json_obj_encode_chunked(obj_array_descr,
+				      ARRAY_SIZE(obj_array_descr),
+				      &encoding_array, chunk, 0, flush_chunk,
+				      &flushed);
+	zassert_equal(ret, -EINVAL, "Empty chunk rejected");
+}
+
+static void test_json_encoding_net_buf(void)
+{
+	char expected[256];
+	char encoded[256];
+	struct net_buf *buf;
+	struct net_buf *frag;
+	size_t len = 0;
+	int ret;
+
+	ret = json_obj_encode_buf(obj_array_descr, ARRAY_SIZE(obj_array_descr),
+				  &encoding_array, expected, sizeof(expected));
+	zassert_equal(ret, 0, "Encoding function returned no errors");
+
+	buf = net_buf_alloc(&json_buf_pool, K_NO_WAIT);
+	zassert_not_null(buf, "Buffer allocated");
+	net_buf_add_mem(buf, "x", 1);
+
+	ret = json_obj_encode_net_buf(obj_array_descr,
+				      ARRAY_SIZE(obj_array_descr),
+				      &encoding_array, buf, &json_buf_pool,
+				      K_NO_WAIT);
+	zassert_equal(ret, 0, "Encoding to network buffers returned no errors");
+	zassert_not_null(buf->frags, "Fragments added");
+
+	for (frag = buf; frag; frag = frag->frags) {
+		memcpy(encoded + len, frag->data, frag->len);
+		len += frag->len;
+	}
+
+	zassert_equal(len, strlen(expected) + 1, "Encoded length consistent");
+	zassert_true(!memcmp(encoded + 1, expected, len - 1),
+		     "Encoded contents appended");
+
+	net_buf_unref(buf);
+
+	buf = net_buf_alloc(&json_buf_pool, K_NO_WAIT);
+	zassert_not_null(buf, "Buffer allocated");
+
+	ret = json_obj_encode_net_buf(obj_array_descr,
+				      ARRAY_SIZE(obj_array_descr),
+				      &encoding_array, buf, NULL, K_NO_WAIT);
+	zassert_equal(ret, -ENOMEM, "Output larger than one buffer");
+	zassert_true(!memcmp(buf->data, expected, buf->len),
+		     "Partial output consistent");
+
+	net_buf_unref(buf);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(lib_json_test,
@@ -502,16 +1115,27 @@ void test_main(void)
 			 ztest_unit_test(test_json_decoding_array_array),
 			 ztest_unit_test(test_json_obj_arr_encoding),
 			 ztest_unit_test(test_json_obj_arr_decoding),
+			 ztest_unit_test(test_json_obj_arr_mixed_width),
 			 ztest_unit_test(test_json_invalid_unicode),
 			 ztest_unit_test(test_json_missing_quote),
 			 ztest_unit_test(test_json_wrong_token),
 			 ztest_unit_test(test_json_item_wrong_type),
 			 ztest_unit_test(test_json_key_not_in_descr),
+			 ztest_unit_test(test_json_descr_no_hash),
 			 ztest_unit_test(test_json_escape),
 			 ztest_unit_test(test_json_escape_one),
 			 ztest_unit_test(test_json_escape_empty),
 			 ztest_unit_test(test_json_escape_no_op),
-			 ztest_unit_test(test_json_escape_bounds_check)
+			 ztest_unit_test(test_json_escape_bounds_check),
+			 ztest_unit_test(test_json_parser_chunks),
+			 ztest_unit_test(test_json_parser_obj_arr),
+			 ztest_unit_test(test_json_parser_skip_unknown),
+			 ztest_unit_test(test_json_parser_errors),
+			 ztest_unit_test(test_json_numbers_decoding),
+			 ztest_unit_test(test_json_numbers_encoding),
+			 ztest_unit_test(test_json_wide_object),
+			 ztest_unit_test(test_json_encoding_chunked),
+			 ztest_unit_test(test_json_encoding_net_buf)
 			 );
 
 	ztest_run_test_suite(lib_json_test);
@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <stats.h>
+
+STATS_SECT_START(hist_test)
+	STATS_SECT_ENTRY_HIST(len, 8)
+	STATS_SECT_ENTRY_HIST(lat, 8)
+STATS_SECT_END;
+
+STATS_NAME_START(hist_test)
+	STATS_NAME(hist_test, len)
+	STATS_NAME(hist_test, lat)
+STATS_NAME_END(hist_test);
+
+static STATS_SECT_DECL(hist_test) hist_test;
+
+/* More values than fit in 8 bits */
+STATS_SECT_START(wide_test)
+	STATS_SECT_ENTRY_HIST(h0, 33)
+	STATS_SECT_ENTRY_HIST(h1, 33)
+	STATS_SECT_ENTRY_HIST(h2, 33)
+	STATS_SECT_ENTRY_HIST(h3, 33)
+	STATS_SECT_ENTRY_HIST(h4, 33)
+	STATS_SECT_ENTRY_HIST(h5, 33)
+	STATS_SECT_ENTRY_HIST(h6, 33)
+	STATS_SECT_ENTRY_HIST(h7, 33)
+STATS_SECT_END;
+
+STATS_NAME_START(wide_test)
+	STATS_NAME(wide_test, h0)
+	STATS_NAME(wide_test, h1)
+	STATS_NAME(wide_test, h2)
+	STATS_NAME(wide_test, h3)
+	STATS_NAME(wide_test, h4)
+	STATS_NAME(wide_test, h5)
+	STATS_NAME(wide_test, h6)
+	STATS_NAME(wide_test, h7)
+STATS_NAME_END(wide_test);
+
+static STATS_SECT_DECL(wide_test) wide_test;
+
+STATS_SECT_START(pcpu_test)
+	STATS_SECT_ENTRY_PCPU(rx)
+	STATS_SECT_ENTRY_PCPU(tx)
+STATS_SECT_END;
+
+STATS_NAME_START(pcpu_test)
+	STATS_NAME(pcpu_test, rx)
+	STATS_NAME(pcpu_test, tx)
+STATS_NAME_END(pcpu_test);
+
+static STATS_SECT_DECL(pcpu_test) pcpu_test;
+
+#define MAX_WALKED 300
+
+static struct {
+	char name[32];
+	u64_t value;
+} walked[MAX_WALKED];
+static int walked_count;
+
+static int walk_cb(struct stats_hdr *hdr, void *arg, const char *name,
+		   u16_t off)
+{
+	zassert_true(walked_count < MAX_WALKED, "Too many entries");
+	zassert_true(strlen(name) < sizeof(walked[0].name), "Name too long");
+
+	strcpy(walked[walked_count].name, name);
+	walked[walked_count].value = stats_value_get(hdr, off);
+	walked_count++;
+
+	return 0;
+}
+
+static void walk(struct stats_hdr *hdr)
+{
+	walked_count = 0;
+	zassert_equal(stats_walk(hdr, walk_cb, NULL), 0, "Walk completed");
+}
+
+/* Name of a statistic entry as reported by stats_walk() */
+static const char *entry_name(const char *name, int idx)
+{
+	static char buf[32];
+
+	if (IS_ENABLED(CONFIG_STATS_NAMES)) {
+		return name;
+	}
+
+	snprintk(buf, sizeof(buf), "s%d", idx);
+	return buf;
+}
+
+static void check_bucket(int i, const char *name, int idx, int bucket,
+			 u64_t value)
+{
+	char expected[32];
+
+	snprintk(expected, sizeof(expected), "%s.%d", entry_name(name, idx),
+		 bucket);
+
+	zassert_true(!strcmp(walked[i].name, expected), "Bucket %s named %s",
+		     expected, walked[i].name);
+	zassert_equal(walked[i].value, value, "Bucket %s counted %u",
+		      expected, (u32_t)walked[i].value);
+}
+
+static void test_stats_hist(void)
+{
+	static const u64_t len_buckets[8] = { 1, 1, 2, 1, 0, 0, 0, 3 };
+	int ret;
+	int i;
+
+	ret = STATS_HIST_INIT_AND_REG(hist_test, 8, "hist_test");
+	zassert_equal(ret, 0, "Group registered");
+
+	/* Bucket 0 counts 0, bucket n from 2^(n-1) to 2^n - 1, the last
+	 * one everything larger
+	 */
+	STATS_HIST_ADD(hist_test, len, 0);
+	STATS_HIST_ADD(hist_test, len, 1);
+	STATS_HIST_ADD(hist_test, len, 2);
+	STATS_HIST_ADD(hist_test, len, 3);
+	STATS_HIST_ADD(hist_test, len, 4);
+	STATS_HIST_ADD(hist_test, len, 127);
+	STATS_HIST_ADD(hist_test, len, 128);
+	STATS_HIST_ADD(hist_test, len, 0xffffffff);
+	STATS_HIST_ADD(hist_test, lat, 64);
+
+	walk(&hist_test.s_hdr);
+	zassert_equal(walked_count, 16, "One entry per bucket");
+
+	for (i = 0; i < 8; i++) {
+		check_bucket(i, "len", 0, i, len_buckets[i]);
+		check_bucket(8 + i, "lat", 1, i, i == 7 ? 1 : 0);
+	}
+
+	stats_reset(&hist_test.s_hdr);
+
+	walk(&hist_test.s_hdr);
+	for (i = 0; i < walked_count; i++) {
+		zassert_equal(walked[i].value, 0, "Bucket reset");
+	}
+}
+
+static void test_stats_hist_wide(void)
+{
+	int ret;
+
+	ret = STATS_HIST_INIT_AND_REG(wide_test, 33, "wide_test");
+	zassert_equal(ret, 0, "Group registered");
+	zassert_equal(wide_test.s_hdr.s_cnt, 8 * 33, "Count not truncated");
+
+	STATS_HIST_ADD(wide_test, h0, 1);
+	STATS_HIST_ADD(wide_test, h7, 0x80000000);
+
+	walk(&wide_test.s_hdr);
+	zassert_equal(walked_count, 8 * 33, "All buckets walked");
+
+	check_bucket(1, "h0", 0, 1, 1);
+	check_bucket(7 * 33 + 31, "h7", 7, 31, 0);
+	check_bucket(7 * 33 + 32, "h7", 7, 32, 1);
+}
+
+static void test_stats_pcpu(void)
+{
+	u64_t sum = 0;
+	int ret;
+	int i;
+
+	ret = STATS_PCPU_INIT_AND_REG(pcpu_test, "pcpu_test");
+	zassert_equal(ret, 0, "Group registered");
+
+	STATS_PCPU_INCN(pcpu_test, rx, 5);
+	STATS_PCPU_INC(pcpu_test, rx);
+
+	/* Counts of other CPUs are summed as well */
+	for (i = 0; i < STATS_NUM_CPUS; i++) {
+		pcpu_test.tx[i] = i + 1;
+		sum += i + 1;
+	}
+
+	walk(&pcpu_test.s_hdr);
+	zassert_equal(walked_count, 2, "Counters reported once");
+	zassert_true(!strcmp(walked[0].name, entry_name("rx", 0)),
+		     "First counter named");
+	zassert_equal(walked[0].value, 6, "Increments counted");
+	zassert_true(!strcmp(walked[1].name, entry_name("tx", 1)),
+		     "Second counter named");
+	zassert_equal(walked[1].value, sum, "Slots of all CPUs summed");
+}
+
+/* Plain counters, whatever the header held before */
+static void test_stats_counter_init(void)
+{
+	struct {
+		struct stats_hdr s_hdr;
+		u32_t values[3];
+	} group;
+	char expected[8];
+	int i;
+
+	memset(&group, 0xff, sizeof(group));
+	stats_init(&group.s_hdr, sizeof(u32_t), ARRAY_SIZE(group.values),
+		   NULL, 0);
+	group.values[2] = 7;
+
+	walk(&group.s_hdr);
+	zassert_equal(walked_count, ARRAY_SIZE(group.values),
+		      "Each counter reported once");
+
+	for (i = 0; i < walked_count; i++) {
+		snprintk(expected, sizeof(expected), "s%d", i);
+		zassert_true(!strcmp(walked[i].name, expected),
+			     "Counter %s named %s", expected, walked[i].name);
+	}
+
+	zassert_equal(walked[0].value, 0, "Counter reset");
+	zassert_equal(walked[2].value, 7, "Counter read");
+}
+
+static void test_stats_invalid_stride(void)
+{
+	struct {
+		struct stats_hdr s_hdr;
+		u32_t values[7];
+	} group;
+
+	zassert_equal(stats_init_and_reg_type(&group.s_hdr, STATS_TYPE_HIST,
+					      2, ARRAY_SIZE(group.values),
+					      NULL, 0, "invalid_test"),
+		      -EINVAL, "Partial histogram rejected");
+	zassert_equal(stats_init_and_reg_type(&group.s_hdr, STATS_TYPE_HIST,
+					      0, ARRAY_SIZE(group.values),
+					      NULL, 0, "invalid_test"),
+		      -EINVAL, "Histogram without buckets rejected");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(stats_test,
+			 ztest_unit_test(test_stats_hist),
+			 ztest_unit_test(test_stats_hist_wide),
+			 ztest_unit_test(test_stats_pcpu),
+			 ztest_unit_test(test_stats_counter_init),
+			 ztest_unit_test(test_stats_invalid_stride));
+
+	ztest_run_test_suite(stats_test);
+}
@@ -1149,6 +1149,148 @@ static void test_pkt_pull(void)
 	zassert_true(res == 0, "Failed to pull 10 bytes from offset 0");
 }
 
+static void test_pkt_cursor(void)
+{
+	u16_t len = sizeof(example_data) - 1;
+	struct net_pkt_cursor cursor, tmp;
+	u8_t data[sizeof(example_data)];
+	struct net_pkt *pkt;
+	u16_t off, pos;
+	u32_t val32;
+	u16_t val16;
+	u8_t val8;
+	int i;
+
+	pkt = net_pkt_get_reserve_rx(0, K_FOREVER);
+	net_pkt_set_ll_reserve(pkt, LL_RESERVE);
+
+	zassert_true(net_pkt_append_all(pkt, len, (u8_t *)example_data,
+					K_FOREVER), "Failed to append data");
+	zassert_not_null(pkt->frags->frags, "Data should span fragments");
+
+	/* Byte by byte over the whole packet */
+	zassert_equal(net_pkt_cursor_init(&cursor, pkt, 0), 0, "Init failed");
+
+	for (i = 0; i < len; i++) {
+		zassert_equal(net_pkt_cursor_read_u8(&cursor, &val8), 0,
+			      "Read failed at %d", i);
+		zassert_equal(val8, (u8_t)example_data[i],
+			      "Invalid data at %d", i);
+	}
+
+	zassert_true(net_pkt_cursor_is_end(&cursor), "Not at the end");
+	zassert_equal(cursor.offset, len, "Invalid offset");
+	zassert_equal(net_pkt_cursor_read_u8(&cursor, &val8), -ENODATA,
+		      "Read past the end");
+
+	/* Values across the end of the first fragment */
+	off = pkt->frags->len - 2;
+
+	zassert_equal(net_pkt_cursor_init(&cursor, pkt, off), 0,
+		      "Init failed");
+
+	tmp = cursor;
+	zassert_equal(net_pkt_cursor_peek_be32(&cursor, &val32), 0,
+		      "Peek failed");
+	zassert_equal(val32, sys_get_be32((u8_t *)example_data + off),
+		      "Invalid peeked value");
+	zassert_true(!memcmp(&tmp, &cursor, sizeof(cursor)),
+		     "Peek moved the cursor");
+
+	zassert_equal(net_pkt_cursor_read_be16(&cursor, &val16), 0,
+		      "Read failed");
+	zassert_equal(val16, sys_get_be16((u8_t *)example_data + off),
+		      "Invalid be16 value");
+	zassert_equal(net_pkt_cursor_read_be32(&cursor, &val32), 0,
+		      "Read failed");
+	zassert_equal(val32, sys_get_be32((u8_t *)example_data + off + 2),
+		      "Invalid be32 value");
+	zassert_equal(cursor.frag, pkt->frags->frags, "Invalid fragment");
+	zassert_equal(cursor.offset, off + 6, "Invalid offset");
+
+	/* A failed read does not move the cursor */
+	tmp = cursor;
+	zassert_equal(net_pkt_cursor_read(&cursor, data, len), -ENODATA,
+		      "Read past the end");
+	zassert_true(!memcmp(&tmp, &cursor, sizeof(cursor)),
+		     "Failed read moved the cursor");
+
+	zassert_equal(net_pkt_cursor_init(&cursor, pkt, len + 1), -ENODATA,
+		      "Init past the end");
+
+	/* Overwrite across fragments, then append to the packet */
+	zassert_equal(net_pkt_cursor_init(&cursor, pkt, off), 0,
+		      "Init failed");
+	zassert_equal(net_pkt_cursor_write(&cursor, "ABCDEFGH", 8, K_FOREVER),
+		      0, "Write failed");
+
+	net_frag_read(pkt->frags, off, &pos, 8, data);
+	zassert_true(!memcmp(data, "ABCDEFGH", 8), "Invalid written data");
+	zassert_equal(net_pkt_get_len(pkt), len, "Overwrite changed length");
+
+	zassert_equal(net_pkt_cursor_init(&cursor, pkt, len), 0,
+		      "Init failed");
+	zassert_equal(net_pkt_cursor_write(&cursor, example_data, len,
+					   K_FOREVER), 0, "Write failed");
+	zassert_equal(net_pkt_get_len(pkt), 2 * len, "Invalid length");
+
+	zassert_equal(net_pkt_cursor_init(&cursor, pkt, len), 0,
+		      "Init failed");
+	zassert_equal(net_pkt_cursor_read(&cursor, data, len), 0,
+		      "Read failed");
+	zassert_true(!memcmp(data, example_data, len),
+		     "Invalid appended data");
+
+	net_pkt_unref(pkt);
+}
+
+static void test_pkt_frag_len(void)
+{
+	u16_t len = sizeof(example_data) - 1;
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+	u8_t data[sizeof(example_data)];
+	u16_t pos;
+
+	pkt = net_pkt_get_reserve_tx(0, K_FOREVER);
+	net_pkt_set_ll_reserve(pkt, LL_RESERVE);
+
+	/* Unsized fragments are the same in both allocation modes */
+	frag = net_pkt_get_frag(pkt, K_FOREVER);
+	zassert_equal(net_buf_headroom(frag), LL_RESERVE, "Invalid headroom");
+	zassert_equal(net_buf_tailroom(frag),
+		      CONFIG_NET_BUF_DATA_SIZE - LL_RESERVE,
+		      "Invalid tailroom");
+	net_pkt_frag_unref(frag);
+
+	frag = net_pkt_get_frag_len(pkt, len, K_FOREVER);
+	zassert_equal(net_buf_headroom(frag), LL_RESERVE, "Invalid headroom");
+
+	if (IS_ENABLED(CONFIG_NET_BUF_VARIABLE_DATA_SIZE)) {
+		zassert_equal(net_buf_tailroom(frag), len, "Invalid tailroom");
+	} else {
+		zassert_equal(net_buf_tailroom(frag),
+			      CONFIG_NET_BUF_DATA_SIZE - LL_RESERVE,
+			      "Invalid tailroom");
+	}
+
+	net_pkt_frag_unref(frag);
+
+	/* Appended data is allocated in its own size */
+	zassert_true(net_pkt_append_all(pkt, len, (u8_t *)example_data,
+					K_FOREVER), "Failed to append data");
+	zassert_equal(net_pkt_get_len(pkt), len, "Invalid length");
+
+	if (IS_ENABLED(CONFIG_NET_BUF_VARIABLE_DATA_SIZE)) {
+		zassert_is_null(pkt->frags->frags, "Data should be contiguous");
+	}
+
+	net_frag_read(pkt->frags, 0, &pos, len, data);
+	zassert_true(!memcmp(data, example_data, len), "Invalid data");
+
+	net_pkt_unref(pkt);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(net_pkt_tests,
@@ -1158,7 +1300,9 @@ void test_main(void)
 			 ztest_unit_test(test_pkt_read_write_insert),
 			 ztest_unit_test(test_fragment_compact),
 			 ztest_unit_test(test_fragment_split),
-			 ztest_unit_test(test_pkt_pull)
+			 ztest_unit_test(test_pkt_pull),
+			 ztest_unit_test(test_pkt_cursor),
+			 ztest_unit_test(test_pkt_frag_len)
 			 );
 
 	ztest_run_test_suite(net_pkt_tests);
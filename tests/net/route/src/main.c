@@ -469,6 +469,73 @@ static void route_del_many(void)
 	}
 }
 
+/* Deleting a route gives its nexthop entry back, so routes can be added
+ * and deleted more times than there are nexthop entries.
+ */
+static void route_add_del_repeat(void)
+{
+	struct net_route_entry *route;
+	int i;
+
+	for (i = 0; i < 2 * CONFIG_NET_MAX_NEXTHOPS; i++) {
+		route = net_route_add(my_iface, &dest_addr, 128, &peer_addr);
+		zassert_not_null(route, "Route add %d failed", i);
+		zassert_false(net_route_del(route), "Route del %d failed", i);
+	}
+}
+
+/* The longest prefix matching the destination is used, and a shorter one
+ * once the longer route is deleted.
+ */
+static void route_lookup_prefix(void)
+{
+	struct net_route_entry *route32, *route64, *route128;
+	struct in6_addr addr;
+
+	route32 = net_route_add(my_iface, &generic_addr, 32, &peer_addr);
+	zassert_not_null(route32, "Route /32 add failed");
+
+	route64 = net_route_add(my_iface, &generic_addr, 64, &peer_addr);
+	zassert_not_null(route64, "Route /64 add failed");
+	zassert_not_equal(route64, route32, "Route /64 not added");
+
+	route128 = net_route_add(my_iface, &dest_addr, 128, &peer_addr);
+	zassert_not_null(route128, "Route /128 add failed");
+	zassert_not_equal(route128, route64, "Route /128 not added");
+
+	zassert_equal_ptr(net_route_lookup(my_iface, &dest_addr), route128,
+			  "Host route not found");
+	zassert_equal_ptr(net_route_lookup(NULL, &dest_addr), route128,
+			  "Host route not found on any interface");
+	zassert_is_null(net_route_lookup(peer_iface, &dest_addr),
+			"Route found on wrong interface");
+
+	memcpy(&addr, &dest_addr, sizeof(addr));
+	addr.s6_addr[15]++;
+	zassert_equal_ptr(net_route_lookup(my_iface, &addr), route64,
+			  "Route /64 not found");
+
+	addr.s6_addr[7] = 0x01;
+	zassert_equal_ptr(net_route_lookup(my_iface, &addr), route32,
+			  "Route /32 not found");
+
+	addr.s6_addr[3]++;
+	zassert_is_null(net_route_lookup(my_iface, &addr),
+			"Route found for other prefix");
+
+	zassert_false(net_route_del(route128), "Route /128 del failed");
+	zassert_equal_ptr(net_route_lookup(my_iface, &dest_addr), route64,
+			  "Route /64 not used after /128 del");
+
+	zassert_false(net_route_del(route64), "Route /64 del failed");
+	zassert_equal_ptr(net_route_lookup(my_iface, &dest_addr), route32,
+			  "Route /32 not used after /64 del");
+
+	zassert_false(net_route_del(route32), "Route /32 del failed");
+	zassert_is_null(net_route_lookup(my_iface, &dest_addr),
+			"Route found after all deleted");
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -488,6 +555,8 @@ void test_main(void)
 			ztest_unit_test(route_del_nexthop_again),
 			ztest_unit_test(populate_nbr_cache),
 			ztest_unit_test(route_add_many),
-			ztest_unit_test(route_del_many));
+			ztest_unit_test(route_del_many),
+			ztest_unit_test(route_add_del_repeat),
+			ztest_unit_test(route_lookup_prefix));
 	ztest_run_test_suite(test_route);
 }
@@ -1416,10 +1416,9 @@ static inline u32_t get_recv_wnd(struct net_tcp *tcp)
 	/* We don't queue received data inside the stack, we hand off
 	 * packets to synchronous callbacks (who can queue if they
 	 * want, but it's not our business).  So the available window
-	 * size is always the same.  There are two configurables to
-	 * check though.
+	 * size is always the configured one.
 	 */
-	return min(NET_TCP_MAX_WIN, NET_TCP_BUF_MAX_LEN);
+	return CONFIG_NET_TCP_RECV_WINDOW;
 }
 
 static bool test_tcp_seq_validity(void)
@@ -1470,6 +1469,117 @@ static bool test_tcp_seq_validity(void)
 	return true;
 }
 
+static bool test_tcp_options(void)
+{
+	u8_t options[] = {
+		NET_TCP_NOP_OPT, NET_TCP_WINDOW_SCALE_OPT,
+		NET_TCP_WINDOW_SCALE_SIZE, 7,
+		NET_TCP_NOP_OPT, NET_TCP_NOP_OPT,
+		NET_TCP_SACK_PERM_OPT, NET_TCP_SACK_PERM_SIZE,
+		NET_TCP_NOP_OPT, NET_TCP_NOP_OPT,
+		NET_TCP_SACK_OPT, 2 + 2 * NET_TCP_SACK_BLOCK_SIZE,
+		0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x20, 0x00,
+		0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x01, 0x00,
+	};
+	struct net_tcp_options opts = { 0 };
+	struct net_pkt *pkt = NULL;
+	int ret;
+
+	ret = net_tcp_prepare_segment(v6_ctx->tcp, NET_TCP_ACK, options,
+				      sizeof(options), NULL,
+				      (struct sockaddr *)&peer_v6_addr, &pkt);
+	if (ret) {
+		DBG("Prepare segment failed (%d)\n", ret);
+		return false;
+	}
+
+	ret = net_tcp_parse_opts(pkt, NET_TCP_HDR_LEN(NET_TCP_HDR(pkt)) -
+				 NET_TCPH_LEN, &opts);
+	net_pkt_unref(pkt);
+
+	if (ret < 0) {
+		DBG("1) Parsing options failed (%d)\n", ret);
+		return false;
+	}
+
+	if (!opts.window_scale || opts.wscale != 7) {
+		DBG("2) Window scale %d shift %u\n", opts.window_scale,
+		    opts.wscale);
+		return false;
+	}
+
+	if (!opts.sack_permitted) {
+		DBG("3) SACK permitted option missing\n");
+		return false;
+	}
+
+	/* The second block wraps around the sequence number space */
+	if (opts.sack_count != 2 ||
+	    opts.sack[0].left != 0x1000 || opts.sack[0].right != 0x2000 ||
+	    opts.sack[1].left != 0xffffff00 || opts.sack[1].right != 0x100) {
+		DBG("4) %u SACK blocks\n", opts.sack_count);
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_tcp_congestion_window(void)
+{
+	struct net_tcp tcp;
+	int i;
+
+	memset(&tcp, 0, sizeof(tcp));
+	tcp.send_mss = NET_TCP_DEFAULT_MSS;
+
+	/* Initial window of four segments for a small MSS */
+	net_tcp_cc_init(&tcp);
+	if (tcp.cwnd != 4 * NET_TCP_DEFAULT_MSS) {
+		DBG("1) Initial window %u\n", tcp.cwnd);
+		return false;
+	}
+
+	/* Slow start grows by at most one MSS per ACK */
+	net_tcp_cc_ack(&tcp, 2 * NET_TCP_DEFAULT_MSS);
+	if (tcp.cwnd != 5 * NET_TCP_DEFAULT_MSS) {
+		DBG("2) Slow start window %u\n", tcp.cwnd);
+		return false;
+	}
+
+	/* A loss halves the data in flight, down to two segments */
+	tcp.ssthresh = net_tcp_cc_ssthresh(&tcp, 4000);
+	if (tcp.ssthresh != 2000) {
+		DBG("3) ssthresh %u\n", tcp.ssthresh);
+		return false;
+	}
+
+	if (net_tcp_cc_ssthresh(&tcp, NET_TCP_DEFAULT_MSS) !=
+	    2 * NET_TCP_DEFAULT_MSS) {
+		DBG("4) ssthresh of a small flight\n");
+		return false;
+	}
+
+	/* Congestion avoidance grows by one MSS per window acked */
+	tcp.cwnd = tcp.ssthresh;
+	for (i = 0; i < 3; i++) {
+		net_tcp_cc_ack(&tcp, NET_TCP_DEFAULT_MSS);
+	}
+
+	if (tcp.cwnd != 2000) {
+		DBG("5) Window grew to %u before a window was acked\n",
+		    tcp.cwnd);
+		return false;
+	}
+
+	net_tcp_cc_ack(&tcp, NET_TCP_DEFAULT_MSS);
+	if (tcp.cwnd != 2000 + NET_TCP_DEFAULT_MSS) {
+		DBG("6) Congestion avoidance window %u\n", tcp.cwnd);
+		return false;
+	}
+
+	return true;
+}
+
 static bool test_init_tcp_reply_context(void)
 {
 	struct net_if *iface = peer_iface;
@@ -1754,6 +1864,8 @@ static const struct {
 	{ "test IPv6 TCP seq check", test_v6_seq_check },
 	{ "test IPv4 TCP seq check", test_v4_seq_check },
 	{ "test TCP seq validity", test_tcp_seq_validity },
+	{ "test TCP options", test_tcp_options },
+	{ "test TCP congestion window", test_tcp_congestion_window },
 	{ "test TCP reply context init", test_init_tcp_reply_context },
 	{ "test TCP accept init", test_init_tcp_accept },
 #if 0
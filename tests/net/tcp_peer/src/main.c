@@ -0,0 +1,969 @@
+/* main.c - Application main entry point */
+
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* The test plays the peer of TCP connections of the stack. The segments
+ * the stack sends are recorded by the driver of the test interface, and
+ * the segments of the peer are crafted and passed to net_recv_data().
+ */
+
+#include <zephyr.h>
+
+#include <zephyr/types.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <device.h>
+#include <init.h>
+#include <misc/printk.h>
+#include <net/buf.h>
+#include <net/net_core.h>
+#include <net/net_pkt.h>
+#include <net/net_ip.h>
+#include <net/net_if.h>
+#include <net/net_context.h>
+#include <net/tcp.h>
+
+#include <ztest.h>
+
+#include "tcp_internal.h"
+#include "net_private.h"
+
+#define MY_PORT 4242
+#define PEER_PORT 9876
+
+#define PEER_ISN 1000
+#define PEER_MSS 100
+#define PEER_WND 8000
+
+#define WAIT_TIME K_MSEC(500)
+#define NO_SEGMENT_TIME K_MSEC(30)
+
+/* Time for the RX thread to process a segment of the peer */
+#define RECV_TIME K_MSEC(10)
+
+/* Accepted error of the measured timer periods */
+#define TIME_SLACK K_MSEC(50)
+
+/* Window scale of our side for CONFIG_NET_TCP_RECV_WINDOW of prj.conf */
+#define RECV_WSCALE 2
+
+/* Window scale the peer asks for, above the largest one allowed */
+#define PEER_WSCALE 15
+
+#define MAX_SEGMENTS 32
+#define MAX_RECV_DATA 1024
+
+/* A segment sent by the stack */
+struct segment {
+	u32_t seq;
+	u32_t ack;
+	u32_t time;
+	u16_t wnd;
+	u16_t len;
+	u8_t flags;
+	struct net_tcp_options opts;
+};
+
+static struct in6_addr my_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+				       0, 0, 0, 0, 0, 0, 0, 0x1 } } };
+static struct in6_addr peer_addr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					 0, 0, 0, 0, 0, 0, 0, 0x2 } } };
+
+static struct net_if *iface;
+static struct net_context *ctx;
+static struct net_context *listen_ctx;
+
+/* Local port of the connection being tested, the segments of the
+ * earlier connections are ignored.
+ */
+static u16_t my_port = MY_PORT;
+
+static struct segment segments[MAX_SEGMENTS];
+static int segments_sent;
+static int segments_seen;
+static struct k_sem segment_sem;
+
+/* The SYN or SYN-ACK the stack sent for the connection */
+static struct segment syn;
+
+/* Sequence number of the first data byte of the stack, and next one the
+ * peer sends.
+ */
+static u32_t my_seq;
+static u32_t peer_seq;
+
+static u8_t recv_data[MAX_RECV_DATA];
+static int recv_len;
+
+static const u8_t send_buf[PEER_MSS];
+
+/* Options of the SYN or SYN-ACK of the peer */
+static const u8_t mss_opts[] = {
+	NET_TCP_MSS_OPT, NET_TCP_MSS_SIZE, PEER_MSS >> 8, PEER_MSS & 0xff,
+};
+
+static const u8_t sack_opts[] = {
+	NET_TCP_MSS_OPT, NET_TCP_MSS_SIZE, PEER_MSS >> 8, PEER_MSS & 0xff,
+	NET_TCP_NOP_OPT, NET_TCP_NOP_OPT,
+	NET_TCP_SACK_PERM_OPT, NET_TCP_SACK_PERM_SIZE,
+};
+
+static const u8_t all_opts[] = {
+	NET_TCP_MSS_OPT, NET_TCP_MSS_SIZE, PEER_MSS >> 8, PEER_MSS & 0xff,
+	NET_TCP_NOP_OPT,
+	NET_TCP_WINDOW_SCALE_OPT, NET_TCP_WINDOW_SCALE_SIZE, PEER_WSCALE,
+	NET_TCP_NOP_OPT, NET_TCP_NOP_OPT,
+	NET_TCP_SACK_PERM_OPT, NET_TCP_SACK_PERM_SIZE,
+};
+
+struct net_tcp_peer_context {
+	u8_t mac_addr[6];
+};
+
+static struct net_tcp_peer_context tcp_peer_context_data;
+
+static int tcp_peer_dev_init(struct device *dev)
+{
+	return 0;
+}
+
+static void tcp_peer_iface_init(struct net_if *iface)
+{
+	struct net_tcp_peer_context *context =
+		net_if_get_device(iface)->driver_data;
+
+	/* 00-00-5E-00-53-xx Documentation RFC 7042 */
+	context->mac_addr[0] = 0x00;
+	context->mac_addr[1] = 0x00;
+	context->mac_addr[2] = 0x5E;
+	context->mac_addr[3] = 0x00;
+	context->mac_addr[4] = 0x53;
+	context->mac_addr[5] = 0x01;
+
+	net_if_set_link_addr(iface, context->mac_addr,
+			     sizeof(context->mac_addr), NET_LINK_ETHERNET);
+}
+
+static int tester_send(struct net_if *iface, struct net_pkt *pkt)
+{
+	struct net_tcp_hdr hdr, *tcp_hdr;
+	struct segment *seg;
+	u16_t hdr_len;
+
+	if (NET_IPV6_HDR(pkt)->nexthdr != IPPROTO_TCP) {
+		goto out;
+	}
+
+	tcp_hdr = net_tcp_get_hdr(pkt, &hdr);
+	if (!tcp_hdr || tcp_hdr->src_port != htons(my_port)) {
+		goto out;
+	}
+
+	seg = &segments[segments_sent % MAX_SEGMENTS];
+	memset(seg, 0, sizeof(*seg));
+
+	hdr_len = NET_TCP_HDR_LEN(tcp_hdr);
+
+	seg->seq = sys_get_be32(tcp_hdr->seq);
+	seg->ack = sys_get_be32(tcp_hdr->ack);
+	seg->wnd = sys_get_be16(tcp_hdr->wnd);
+	seg->flags = NET_TCP_FLAGS(tcp_hdr);
+	seg->len = net_pkt_get_len(pkt) - net_pkt_ip_hdr_len(pkt) - hdr_len;
+	seg->time = k_uptime_get_32();
+
+	if (hdr_len > NET_TCPH_LEN) {
+		net_tcp_parse_opts(pkt, hdr_len - NET_TCPH_LEN, &seg->opts);
+	}
+
+	segments_sent++;
+	k_sem_give(&segment_sem);
+
+out:
+	net_pkt_unref(pkt);
+
+	return 0;
+}
+
+static struct net_if_api tcp_peer_if_api = {
+	.init = tcp_peer_iface_init,
+	.send = tester_send,
+};
+
+#define _ETH_L2_LAYER DUMMY_L2
+#define _ETH_L2_CTX_TYPE NET_L2_GET_CTX_TYPE(DUMMY_L2)
+
+NET_DEVICE_INIT(tcp_peer_test, "tcp_peer_test",
+		tcp_peer_dev_init, &tcp_peer_context_data, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,
+		&tcp_peer_if_api, _ETH_L2_LAYER, _ETH_L2_CTX_TYPE, 127);
+
+static struct segment *expect_segment(s32_t timeout)
+{
+	zassert_equal(k_sem_take(&segment_sem, timeout), 0, "No segment sent");
+
+	return &segments[segments_seen++ % MAX_SEGMENTS];
+}
+
+/* The next segment sent carries len bytes at offset of our stream */
+static struct segment *expect_data(u32_t offset, u16_t len)
+{
+	struct segment *seg = expect_segment(WAIT_TIME);
+
+	zassert_equal(seg->seq - my_seq, offset, "Segment at %u, not %u",
+		      seg->seq - my_seq, offset);
+	zassert_equal(seg->len, len, "Segment of %u bytes, not %u",
+		      seg->len, len);
+
+	return seg;
+}
+
+/* The next segment sent is a pure ACK of the peer data up to ack */
+static struct segment *expect_ack(u32_t ack)
+{
+	struct segment *seg = expect_segment(WAIT_TIME);
+
+	zassert_equal(seg->flags & (NET_TCP_SYN | NET_TCP_FIN | NET_TCP_RST),
+		      0, "Not an ACK, flags 0x%02x", seg->flags);
+	zassert_equal(seg->len, 0, "ACK with data");
+	zassert_equal(seg->ack, ack, "ACK of %u, not %u", seg->ack, ack);
+
+	return seg;
+}
+
+/* The next segment is an ACK of the peer data up to ack, with count SACK
+ * blocks. The blocks are pairs of offsets of the peer stream.
+ */
+static void expect_sack(u32_t ack, const u32_t *blocks, int count)
+{
+	struct segment *seg = expect_ack(ack);
+	u32_t left, right;
+	int i;
+
+	zassert_equal(seg->opts.sack_count, count, "%u SACK blocks, not %d",
+		      seg->opts.sack_count, count);
+
+	for (i = 0; i < count; i++) {
+		left = seg->opts.sack[i].left - PEER_ISN - 1;
+		right = seg->opts.sack[i].right - PEER_ISN - 1;
+
+		zassert_true(left == blocks[2 * i] &&
+			     right == blocks[2 * i + 1],
+			     "Block %d from %u to %u, not %u to %u", i,
+			     left, right, blocks[2 * i], blocks[2 * i + 1]);
+	}
+}
+
+static void expect_no_segment(void)
+{
+	zassert_not_equal(k_sem_take(&segment_sem, NO_SEGMENT_TIME), 0,
+			  "Unexpected segment");
+}
+
+/* Byte of the peer stream at offset, so that the data delivered can be
+ * checked.
+ */
+static u8_t peer_byte(u32_t offset)
+{
+	return (u8_t)(offset * 7 + 1);
+}
+
+static void peer_send(u8_t flags, u32_t seq, u32_t ack, u16_t wnd,
+		      const u8_t *opts, u8_t opts_len, u16_t len)
+{
+	struct net_ipv6_hdr ip_hdr;
+	struct net_tcp_hdr tcp_hdr;
+	struct net_pkt *pkt;
+	u16_t i;
+
+	memset(&ip_hdr, 0, sizeof(ip_hdr));
+	ip_hdr.vtc = 0x60;
+	ip_hdr.nexthdr = IPPROTO_TCP;
+	ip_hdr.hop_limit = 64;
+	sys_put_be16(sizeof(tcp_hdr) + opts_len + len, ip_hdr.len);
+	net_ipaddr_copy(&ip_hdr.src, &peer_addr);
+	net_ipaddr_copy(&ip_hdr.dst, &my_addr);
+
+	memset(&tcp_hdr, 0, sizeof(tcp_hdr));
+	tcp_hdr.src_port = htons(PEER_PORT);
+	tcp_hdr.dst_port = htons(my_port);
+	sys_put_be32(seq, tcp_hdr.seq);
+	sys_put_be32(ack, tcp_hdr.ack);
+	tcp_hdr.offset = ((sizeof(tcp_hdr) + opts_len) / 4) << 4;
+	tcp_hdr.flags = flags;
+	sys_put_be16(wnd, tcp_hdr.wnd);
+
+	pkt = net_pkt_get_reserve_rx(0, K_FOREVER);
+	zassert_not_null(pkt, "No RX packet");
+
+	net_pkt_set_iface(pkt, iface);
+	net_pkt_set_family(pkt, AF_INET6);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(ip_hdr));
+
+	zassert_true(net_pkt_append_all(pkt, sizeof(ip_hdr), (u8_t *)&ip_hdr,
+					K_FOREVER), "IPv6 header not added");
+	zassert_true(net_pkt_append_all(pkt, sizeof(tcp_hdr),
+					(u8_t *)&tcp_hdr, K_FOREVER),
+		     "TCP header not added");
+
+	if (opts_len) {
+		zassert_true(net_pkt_append_all(pkt, opts_len, opts,
+						K_FOREVER),
+			     "TCP options not added");
+	}
+
+	for (i = 0; i < len; i++) {
+		zassert_true(net_pkt_append_u8(pkt, peer_byte(seq + i -
+							      PEER_ISN - 1)),
+			     "Data not added");
+	}
+
+	zassert_true(net_recv_data(iface, pkt) >= 0, "Segment not received");
+
+	k_sleep(RECV_TIME);
+}
+
+/* Pure ACK of our stream up to offset */
+static void peer_ack(u32_t offset, u16_t wnd)
+{
+	peer_send(NET_TCP_ACK, peer_seq, my_seq + offset, wnd, NULL, 0, 0);
+}
+
+/* Data of the peer stream at offset */
+static void peer_data(u32_t offset, u16_t len)
+{
+	peer_send(NET_TCP_ACK | NET_TCP_PSH, PEER_ISN + 1 + offset, my_seq,
+		  PEER_WND, NULL, 0, len);
+}
+
+/* Duplicate ACK with count SACK blocks, pairs of offsets of our stream */
+static void peer_sack(const u32_t *blocks, int count)
+{
+	u8_t opts[4 + NET_TCP_MAX_SACK_BLOCKS * NET_TCP_SACK_BLOCK_SIZE];
+	int i;
+
+	opts[0] = NET_TCP_NOP_OPT;
+	opts[1] = NET_TCP_NOP_OPT;
+	opts[2] = NET_TCP_SACK_OPT;
+	opts[3] = 2 + count * NET_TCP_SACK_BLOCK_SIZE;
+
+	for (i = 0; i < count; i++) {
+		sys_put_be32(my_seq + blocks[2 * i],
+			     opts + 4 + i * NET_TCP_SACK_BLOCK_SIZE);
+		sys_put_be32(my_seq + blocks[2 * i + 1],
+			     opts + 8 + i * NET_TCP_SACK_BLOCK_SIZE);
+	}
+
+	peer_send(NET_TCP_ACK, peer_seq, my_seq, PEER_WND, opts,
+		  4 + count * NET_TCP_SACK_BLOCK_SIZE, 0);
+}
+
+static void check_recv_data(int len)
+{
+	int i;
+
+	zassert_equal(recv_len, len, "%d bytes received, not %d", recv_len,
+		      len);
+
+	for (i = 0; i < len; i++) {
+		zassert_equal(recv_data[i], peer_byte(i), "Byte %d differs", i);
+	}
+}
+
+static void recv_cb(struct net_context *context, struct net_pkt *pkt,
+		    int status, void *user_data)
+{
+	u16_t len, pos;
+
+	if (!pkt) {
+		return;
+	}
+
+	len = net_pkt_appdatalen(pkt);
+
+	if (recv_len + len <= sizeof(recv_data)) {
+		net_frag_read(pkt->frags, net_pkt_get_len(pkt) - len, &pos,
+			      len, recv_data + recv_len);
+	}
+
+	recv_len += len;
+
+	net_pkt_unref(pkt);
+}
+
+static void send_data(u16_t len)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = net_pkt_get_tx(ctx, K_FOREVER);
+	zassert_not_null(pkt, "No TX packet");
+
+	zassert_true(net_pkt_append_all(pkt, len, send_buf, K_FOREVER),
+		     "Data not added");
+
+	ret = net_context_send(pkt, NULL, K_NO_WAIT, NULL, NULL);
+	zassert_equal(ret, 0, "Data not sent (%d)", ret);
+}
+
+static void start_connection(void)
+{
+	my_port++;
+
+	k_sem_reset(&segment_sem);
+	segments_sent = 0;
+	segments_seen = 0;
+	recv_len = 0;
+}
+
+/* Connect to the peer, which answers with the options opts. Returns
+ * the ACK that completes the handshake.
+ */
+static struct segment *connect_active(const u8_t *opts, u8_t opts_len)
+{
+	struct sockaddr_in6 addr = { .sin6_family = AF_INET6 };
+	struct segment *seg;
+	int ret;
+
+	start_connection();
+
+	ret = net_context_get(AF_INET6, SOCK_STREAM, IPPROTO_TCP, &ctx);
+	zassert_equal(ret, 0, "Context not allocated (%d)", ret);
+
+	net_ipaddr_copy(&addr.sin6_addr, &my_addr);
+	addr.sin6_port = htons(my_port);
+
+	ret = net_context_bind(ctx, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(ret, 0, "Context not bound (%d)", ret);
+
+	net_ipaddr_copy(&addr.sin6_addr, &peer_addr);
+	addr.sin6_port = htons(PEER_PORT);
+
+	ret = net_context_connect(ctx, (struct sockaddr *)&addr, sizeof(addr),
+				  NULL, K_NO_WAIT, NULL);
+	zassert_equal(ret, 0, "Connect failed (%d)", ret);
+
+	seg = expect_segment(WAIT_TIME);
+	zassert_equal(seg->flags, NET_TCP_SYN, "Not a SYN");
+
+	syn = *seg;
+	my_seq = syn.seq + 1;
+	peer_seq = PEER_ISN + 1;
+
+	peer_send(NET_TCP_SYN | NET_TCP_ACK, PEER_ISN, my_seq, PEER_WND,
+		  opts, opts_len, 0);
+	seg = expect_ack(peer_seq);
+
+	ret = net_context_recv(ctx, recv_cb, K_NO_WAIT, NULL);
+	zassert_equal(ret, 0, "Receive callback not set (%d)", ret);
+
+	return seg;
+}
+
+static void accept_cb(struct net_context *new_context, struct sockaddr *addr,
+		      socklen_t addrlen, int status, void *user_data)
+{
+	ctx = new_context;
+}
+
+/* Accept a connection of the peer, whose SYN has the options opts and
+ * whose ACK announces the window wnd.
+ */
+static void connect_passive(const u8_t *opts, u8_t opts_len, u16_t wnd)
+{
+	struct sockaddr_in6 addr = { .sin6_family = AF_INET6 };
+	struct segment *seg;
+	int ret;
+
+	start_connection();
+	ctx = NULL;
+
+	ret = net_context_get(AF_INET6, SOCK_STREAM, IPPROTO_TCP,
+			      &listen_ctx);
+	zassert_equal(ret, 0, "Context not allocated (%d)", ret);
+
+	net_ipaddr_copy(&addr.sin6_addr, &my_addr);
+	addr.sin6_port = htons(my_port);
+
+	ret = net_context_bind(listen_ctx, (struct sockaddr *)&addr,
+			       sizeof(addr));
+	zassert_equal(ret, 0, "Context not bound (%d)", ret);
+
+	ret = net_context_listen(listen_ctx, 0);
+	zassert_equal(ret, 0, "Listen failed (%d)", ret);
+
+	ret = net_context_accept(listen_ctx, accept_cb, K_NO_WAIT, NULL);
+	zassert_equal(ret, 0, "Accept failed (%d)", ret);
+
+	peer_send(NET_TCP_SYN, PEER_ISN, 0, PEER_WND, opts, opts_len, 0);
+
+	seg = expect_segment(WAIT_TIME);
+	zassert_equal(seg->flags, NET_TCP_SYN | NET_TCP_ACK, "Not a SYN-ACK");
+	zassert_equal(seg->ack, PEER_ISN + 1, "SYN-ACK of %u", seg->ack);
+
+	syn = *seg;
+	my_seq = syn.seq + 1;
+	peer_seq = PEER_ISN + 1;
+
+	peer_send(NET_TCP_ACK, peer_seq, my_seq, wnd, NULL, 0, 0);
+	zassert_not_null(ctx, "Connection not accepted");
+
+	ret = net_context_recv(ctx, recv_cb, K_NO_WAIT, NULL);
+	zassert_equal(ret, 0, "Receive callback not set (%d)", ret);
+}
+
+static void close_connection(void)
+{
+	net_context_put(ctx);
+	ctx = NULL;
+
+	peer_send(NET_TCP_RST, peer_seq, 0, 0, NULL, 0, 0);
+
+	if (listen_ctx) {
+		net_context_put(listen_ctx);
+		listen_ctx = NULL;
+	}
+}
+
+static void test_tcp_peer_setup(void)
+{
+	struct net_if_addr *ifaddr;
+
+	k_sem_init(&segment_sem, 0, MAX_SEGMENTS);
+
+	iface = net_if_get_default();
+	zassert_not_null(iface, "No interface");
+
+	ifaddr = net_if_ipv6_addr_add(iface, &my_addr, NET_ADDR_MANUAL, 0);
+	zassert_not_null(ifaddr, "Address not added");
+}
+
+static void test_tcp_window_limited(void)
+{
+	int i;
+
+	connect_active(mss_opts, sizeof(mss_opts));
+
+	zassert_equal(ctx->tcp->cwnd, 4 * PEER_MSS, "Initial window of %u",
+		      ctx->tcp->cwnd);
+
+	for (i = 0; i < 6; i++) {
+		send_data(PEER_MSS);
+	}
+
+	for (i = 0; i < 4; i++) {
+		expect_data(i * PEER_MSS, PEER_MSS);
+	}
+
+	expect_no_segment();
+
+	/* Slow start, the window grows by one segment per ACK */
+	peer_ack(PEER_MSS, PEER_WND);
+	zassert_equal(ctx->tcp->cwnd, 5 * PEER_MSS, "Window of %u",
+		      ctx->tcp->cwnd);
+
+	expect_data(4 * PEER_MSS, PEER_MSS);
+	expect_data(5 * PEER_MSS, PEER_MSS);
+	expect_no_segment();
+
+	/* The window of the peer limits the data in flight as well */
+	peer_ack(6 * PEER_MSS, 2 * PEER_MSS);
+
+	for (i = 0; i < 4; i++) {
+		send_data(PEER_MSS);
+	}
+
+	expect_data(6 * PEER_MSS, PEER_MSS);
+	expect_data(7 * PEER_MSS, PEER_MSS);
+	expect_no_segment();
+
+	peer_ack(8 * PEER_MSS, PEER_WND);
+
+	expect_data(8 * PEER_MSS, PEER_MSS);
+	expect_data(9 * PEER_MSS, PEER_MSS);
+	expect_no_segment();
+
+	peer_ack(10 * PEER_MSS, PEER_WND);
+	expect_no_segment();
+
+	close_connection();
+}
+
+static void test_tcp_fast_retransmit(void)
+{
+	u16_t wnd = PEER_WND - PEER_MSS;
+	struct net_tcp *tcp;
+	int i;
+
+	connect_active(mss_opts, sizeof(mss_opts));
+	tcp = ctx->tcp;
+
+	/* Keep the retransmission timer out of the way */
+	tcp->rto = K_SECONDS(1);
+
+	for (i = 0; i < 4; i++) {
+		send_data(PEER_MSS);
+		expect_data(i * PEER_MSS, PEER_MSS);
+	}
+
+	/* Neither a window update nor an ACK with data is a duplicate */
+	peer_ack(0, wnd);
+	expect_no_segment();
+
+	peer_send(NET_TCP_ACK | NET_TCP_PSH, peer_seq, my_seq, wnd, NULL, 0,
+		  10);
+	peer_seq += 10;
+	expect_ack(peer_seq);
+
+	zassert_equal(tcp->dup_acks, 0, "%u duplicate ACKs", tcp->dup_acks);
+	check_recv_data(10);
+
+	peer_ack(0, wnd);
+	peer_ack(0, wnd);
+	expect_no_segment();
+	zassert_equal(tcp->dup_acks, 2, "%u duplicate ACKs", tcp->dup_acks);
+
+	/* The third one resends the oldest segment */
+	peer_ack(0, wnd);
+	expect_data(0, PEER_MSS);
+	expect_no_segment();
+
+	zassert_true(tcp->flags & NET_TCP_FAST_RECOVERY, "Not recovering");
+	zassert_equal(tcp->ssthresh, 2 * PEER_MSS, "ssthresh of %u",
+		      tcp->ssthresh);
+	zassert_equal(tcp->cwnd, 5 * PEER_MSS, "Window of %u", tcp->cwnd);
+
+	/* Further duplicates inflate the window */
+	peer_ack(0, wnd);
+	expect_no_segment();
+	zassert_equal(tcp->cwnd, 6 * PEER_MSS, "Window of %u", tcp->cwnd);
+
+	/* A partial ACK resends the next segment and deflates the window */
+	peer_ack(2 * PEER_MSS, wnd);
+	expect_data(2 * PEER_MSS, PEER_MSS);
+	expect_no_segment();
+
+	zassert_true(tcp->flags & NET_TCP_FAST_RECOVERY, "Not recovering");
+	zassert_equal(tcp->cwnd, 5 * PEER_MSS, "Window of %u", tcp->cwnd);
+
+	/* A full ACK ends the recovery */
+	peer_ack(4 * PEER_MSS, wnd);
+	expect_no_segment();
+
+	zassert_false(tcp->flags & NET_TCP_FAST_RECOVERY, "Still recovering");
+	zassert_equal(tcp->cwnd, 2 * PEER_MSS, "Window of %u", tcp->cwnd);
+
+	close_connection();
+}
+
+/* The segment at offset is sent again, period ms after last */
+static u32_t expect_resend(u32_t offset, u32_t last, u32_t period)
+{
+	struct segment *seg = expect_segment(period + TIME_SLACK);
+
+	zassert_equal(seg->seq - my_seq, offset, "Segment at %u, not %u",
+		      seg->seq - my_seq, offset);
+	zassert_true(seg->time - last + TIME_SLACK >= period,
+		     "Resent after %u ms, not %u", seg->time - last, period);
+
+	return seg->time;
+}
+
+static void test_tcp_rto(void)
+{
+	struct net_tcp *tcp;
+	u32_t srtt, rto, last;
+
+	connect_active(mss_opts, sizeof(mss_opts));
+	tcp = ctx->tcp;
+
+	/* The first RTT sample sets the estimate, RFC 6298 section 2.2 */
+	send_data(PEER_MSS);
+	expect_data(0, PEER_MSS);
+	k_sleep(K_MSEC(100));
+	peer_ack(PEER_MSS, PEER_WND);
+
+	srtt = tcp->srtt >> 3;
+	rto = tcp->rto;
+
+	zassert_true(srtt >= 100 && srtt <= 100 + TIME_SLACK,
+		     "RTT of %u ms", srtt);
+	zassert_equal(tcp->rttvar, srtt << 1, "RTT variation of %u",
+		      tcp->rttvar);
+	zassert_equal(rto, srtt + tcp->rttvar, "RTO of %u ms", rto);
+
+	/* Let the timer started by the first segment expire */
+	k_sleep(rto);
+
+	send_data(PEER_MSS);
+	last = expect_data(PEER_MSS, PEER_MSS)->time;
+
+	/* The timeout doubles with each retransmission */
+	last = expect_resend(PEER_MSS, last, rto);
+
+	zassert_equal(tcp->cwnd, PEER_MSS, "Window of %u", tcp->cwnd);
+	zassert_equal(tcp->ssthresh, 2 * PEER_MSS, "ssthresh of %u",
+		      tcp->ssthresh);
+
+	last = expect_resend(PEER_MSS, last, rto << 1);
+	last = expect_resend(PEER_MSS, last, rto << 2);
+
+	zassert_equal(tcp->retry_timeout_shift, 3, "Backoff of %u",
+		      tcp->retry_timeout_shift);
+	zassert_equal(tcp->ssthresh, 2 * PEER_MSS, "ssthresh of %u",
+		      tcp->ssthresh);
+
+	/* Karn's algorithm, a resent segment gives no RTT sample */
+	peer_ack(2 * PEER_MSS, PEER_WND);
+
+	zassert_equal(tcp->srtt >> 3, srtt, "RTT of %u ms", tcp->srtt >> 3);
+	zassert_false(tcp->flags & NET_TCP_RTO_RECOVERY, "Still recovering");
+
+	close_connection();
+}
+
+static void test_tcp_ooo_sack(void)
+{
+	static const u32_t one_block[] = { 100, 200 };
+	static const u32_t two_blocks[] = { 300, 400, 100, 200 };
+	static const u32_t three_blocks[] = { 500, 600, 300, 400, 100, 200 };
+	static const u32_t merged_blocks[] = { 100, 400, 500, 600 };
+	static const u32_t last_block[] = { 500, 600 };
+
+	connect_active(sack_opts, sizeof(sack_opts));
+
+	/* Each segment after the hole is reported, the latest first */
+	peer_data(100, 100);
+	expect_sack(peer_seq, one_block, 1);
+
+	peer_data(300, 100);
+	expect_sack(peer_seq, two_blocks, 2);
+
+	peer_data(500, 100);
+	expect_sack(peer_seq, three_blocks, 3);
+
+	/* A duplicate is dropped */
+	peer_data(100, 100);
+	expect_sack(peer_seq, three_blocks, 3);
+
+	/* A segment overlapping two others joins their blocks */
+	peer_data(150, 200);
+	expect_sack(peer_seq, merged_blocks, 2);
+
+	/* The queue of CONFIG_NET_TCP_OOO_QUEUE_SIZE segments is full */
+	peer_data(700, 100);
+	expect_sack(peer_seq, merged_blocks, 2);
+
+	zassert_equal(recv_len, 0, "Data received before the hole");
+
+	/* Filling the hole delivers the contiguous data once */
+	peer_data(0, 100);
+	peer_seq += 400;
+	expect_sack(peer_seq, last_block, 1);
+	check_recv_data(400);
+
+	peer_data(400, 100);
+	peer_seq += 200;
+	expect_sack(peer_seq, NULL, 0);
+	check_recv_data(600);
+
+	close_connection();
+}
+
+static void test_tcp_ooo_rx_reserve(void)
+{
+	static const u32_t one_block[] = { 100, 200 };
+	struct net_pkt *held[CONFIG_NET_PKT_RX_COUNT];
+	struct k_mem_slab *rx;
+	int count = 0;
+
+	connect_active(sack_opts, sizeof(sack_opts));
+
+	/* Leave one RX packet, for the segment itself */
+	net_pkt_get_info(&rx, NULL, NULL, NULL);
+
+	while (k_mem_slab_num_free_get(rx) > 1) {
+		held[count] = net_pkt_get_reserve_rx(0, K_NO_WAIT);
+		zassert_not_null(held[count], "No RX packet");
+		count++;
+	}
+
+	peer_data(100, 100);
+	expect_sack(peer_seq, NULL, 0);
+
+	while (count) {
+		net_pkt_unref(held[--count]);
+	}
+
+	peer_data(100, 100);
+	expect_sack(peer_seq, one_block, 1);
+
+	peer_data(0, 100);
+	peer_seq += 200;
+	expect_sack(peer_seq, NULL, 0);
+	check_recv_data(200);
+
+	close_connection();
+}
+
+static void test_tcp_sack_retransmit(void)
+{
+	static const u32_t one_block[] = { 100, 200 };
+	static const u32_t two_blocks[] = { 300, 400, 100, 200 };
+	struct net_tcp *tcp;
+	int i;
+
+	connect_active(sack_opts, sizeof(sack_opts));
+	tcp = ctx->tcp;
+
+	zassert_true(tcp->flags & NET_TCP_SACK_PERMITTED, "SACK not used");
+
+	/* Keep the retransmission timer out of the way */
+	tcp->rto = K_SECONDS(1);
+
+	for (i = 0; i < 4; i++) {
+		send_data(PEER_MSS);
+		expect_data(i * PEER_MSS, PEER_MSS);
+	}
+
+	/* The first and the third segments are lost */
+	peer_sack(one_block, 1);
+	peer_sack(two_blocks, 2);
+	expect_no_segment();
+
+	peer_sack(two_blocks, 2);
+	expect_data(0, PEER_MSS);
+	expect_no_segment();
+
+	/* The next duplicate resends the other hole, not the segment
+	 * the peer has.
+	 */
+	peer_sack(two_blocks, 2);
+	expect_data(2 * PEER_MSS, PEER_MSS);
+	expect_no_segment();
+	zassert_equal(tcp->cwnd, 5 * PEER_MSS, "Window of %u", tcp->cwnd);
+
+	/* Nothing is left to resend, the window is inflated */
+	peer_sack(two_blocks, 2);
+	expect_no_segment();
+	zassert_equal(tcp->cwnd, 6 * PEER_MSS, "Window of %u", tcp->cwnd);
+
+	peer_ack(4 * PEER_MSS, PEER_WND);
+	expect_no_segment();
+	zassert_false(tcp->flags & NET_TCP_FAST_RECOVERY, "Still recovering");
+
+	close_connection();
+}
+
+static void test_tcp_wscale_active(void)
+{
+	struct segment *ack;
+	struct net_tcp *tcp;
+
+	ack = connect_active(all_opts, sizeof(all_opts));
+	tcp = ctx->tcp;
+
+	zassert_true(syn.opts.window_scale, "Window scale not offered");
+	zassert_equal(syn.opts.wscale, RECV_WSCALE, "Window scale of %u",
+		      syn.opts.wscale);
+	zassert_true(syn.opts.sack_permitted, "SACK not offered");
+
+	/* The window is scaled from the first segment after the SYN */
+	zassert_equal(syn.wnd, UINT16_MAX, "SYN window of %u", syn.wnd);
+	zassert_equal(ack->wnd, CONFIG_NET_TCP_RECV_WINDOW >> RECV_WSCALE,
+		      "ACK window of %u", ack->wnd);
+
+	zassert_equal(tcp->send_wscale, NET_TCP_MAX_WINDOW_SCALE,
+		      "Peer window scale of %u", tcp->send_wscale);
+	zassert_equal(tcp->send_wnd, PEER_WND, "Peer window of %u",
+		      tcp->send_wnd);
+
+	peer_ack(0, 2);
+	zassert_equal(tcp->send_wnd, 2 << NET_TCP_MAX_WINDOW_SCALE,
+		      "Peer window of %u", tcp->send_wnd);
+
+	close_connection();
+
+	/* Without the option of the peer, our window is capped instead */
+	ack = connect_active(mss_opts, sizeof(mss_opts));
+	tcp = ctx->tcp;
+
+	zassert_false(tcp->flags & NET_TCP_WINDOW_SCALING, "Window scaled");
+	zassert_equal(tcp->send_wscale, 0, "Peer window scale of %u",
+		      tcp->send_wscale);
+	zassert_equal(tcp->recv_wscale, 0, "Window scale of %u",
+		      tcp->recv_wscale);
+	zassert_equal(tcp->recv_wnd, UINT16_MAX, "Window of %u",
+		      tcp->recv_wnd);
+	zassert_equal(ack->wnd, UINT16_MAX, "ACK window of %u", ack->wnd);
+
+	peer_ack(0, 3000);
+	zassert_equal(tcp->send_wnd, 3000, "Peer window of %u",
+		      tcp->send_wnd);
+
+	close_connection();
+}
+
+static void test_tcp_wscale_passive(void)
+{
+	struct net_tcp *tcp;
+
+	connect_passive(all_opts, sizeof(all_opts), 2);
+	tcp = ctx->tcp;
+
+	zassert_true(syn.opts.window_scale, "Window scale not echoed");
+	zassert_equal(syn.opts.wscale, RECV_WSCALE, "Window scale of %u",
+		      syn.opts.wscale);
+	zassert_true(syn.opts.sack_permitted, "SACK not echoed");
+	zassert_equal(syn.wnd, UINT16_MAX, "SYN-ACK window of %u", syn.wnd);
+
+	zassert_true(tcp->flags & NET_TCP_SACK_PERMITTED, "SACK not used");
+	zassert_equal(tcp->send_wscale, NET_TCP_MAX_WINDOW_SCALE,
+		      "Peer window scale of %u", tcp->send_wscale);
+	zassert_equal(tcp->recv_wscale, RECV_WSCALE, "Window scale of %u",
+		      tcp->recv_wscale);
+	zassert_equal(tcp->send_wnd, 2 << NET_TCP_MAX_WINDOW_SCALE,
+		      "Peer window of %u", tcp->send_wnd);
+
+	close_connection();
+
+	/* The options the SYN does not have are not in the SYN-ACK */
+	connect_passive(mss_opts, sizeof(mss_opts), 3000);
+	tcp = ctx->tcp;
+
+	zassert_false(syn.opts.window_scale, "Window scale in SYN-ACK");
+	zassert_false(syn.opts.sack_permitted, "SACK in SYN-ACK");
+
+	zassert_false(tcp->flags & NET_TCP_SACK_PERMITTED, "SACK used");
+	zassert_false(tcp->flags & NET_TCP_WINDOW_SCALING, "Window scaled");
+	zassert_equal(tcp->send_wscale, 0, "Peer window scale of %u",
+		      tcp->send_wscale);
+	zassert_equal(tcp->recv_wscale, 0, "Window scale of %u",
+		      tcp->recv_wscale);
+	zassert_equal(tcp->recv_wnd, UINT16_MAX, "Window of %u",
+		      tcp->recv_wnd);
+	zassert_equal(tcp->send_wnd, 3000, "Peer window of %u",
+		      tcp->send_wnd);
+
+	close_connection();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(net_tcp_peer,
+			 ztest_unit_test(test_tcp_peer_setup),
+			 ztest_unit_test(test_tcp_window_limited),
+			 ztest_unit_test(test_tcp_fast_retransmit),
+			 ztest_unit_test(test_tcp_rto),
+			 ztest_unit_test(test_tcp_ooo_sack),
+			 ztest_unit_test(test_tcp_ooo_rx_reserve),
+			 ztest_unit_test(test_tcp_sack_retransmit),
+			 ztest_unit_test(test_tcp_wscale_active),
+			 ztest_unit_test(test_tcp_wscale_passive));
+
+	ztest_run_test_suite(net_tcp_peer);
+}
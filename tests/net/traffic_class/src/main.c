@@ -145,6 +145,34 @@ static bool check_higher_priority_pkt_recv(int tc, struct net_pkt *pkt)
 	return false;
 }
 
+/* Packets of the send_batch() test, recorded in the order the driver
+ * sent them, with the reference count they had in the driver.
+ */
+#define BATCH_PKTS 4
+
+static bool batch_test;
+static struct {
+	u8_t seq;
+	u8_t ref;
+	bool batched;
+} batch_sent[BATCH_PKTS];
+static int batch_sent_count;
+
+static void batch_record(struct net_pkt *pkt, bool batched)
+{
+	u16_t pos;
+
+	if (batch_sent_count < BATCH_PKTS) {
+		net_frag_read_u8(pkt->frags, sizeof(struct net_ipv6_hdr) +
+				 sizeof(struct net_udp_hdr), &pos,
+				 &batch_sent[batch_sent_count].seq);
+		batch_sent[batch_sent_count].ref = pkt->ref;
+		batch_sent[batch_sent_count].batched = batched;
+	}
+
+	batch_sent_count++;
+}
+
 /* The eth_tx() will handle both sent packets or and it will also
  * simulate the receiving of the packets.
  */
@@ -155,6 +183,13 @@ static int eth_tx(struct net_if *iface, struct net_pkt *pkt)
 		return -ENODATA;
 	}
 
+	if (batch_test) {
+		batch_record(pkt, false);
+		net_pkt_unref(pkt);
+
+		return 0;
+	}
+
 	if (start_receiving) {
 		struct in6_addr addr;
 		struct net_udp_hdr hdr, *udp_hdr;
@@ -231,9 +266,30 @@ fail:
 	return 0;
 }
 
+/* Sends all but the last packet of a batch, which the stack then passes
+ * to eth_tx(). Outside of the send_batch() test nothing is sent here.
+ */
+static int eth_tx_batch(struct net_if *iface, struct net_pkt *pkts[],
+			int count)
+{
+	int i;
+
+	if (!batch_test) {
+		return 0;
+	}
+
+	for (i = 0; i < count - 1; i++) {
+		batch_record(pkts[i], true);
+		net_pkt_unref(pkts[i]);
+	}
+
+	return count - 1;
+}
+
 static struct net_if_api api_funcs = {
 	.init	= eth_iface_init,
 	.send	= eth_tx,
+	.send_batch = eth_tx_batch,
 };
 
 static void generate_mac(u8_t *mac_addr)
@@ -986,6 +1042,274 @@ static void traffic_class_recv_data_mix_all_2(void)
 	zassert_false(test_failed, "Traffic class verification failed.");
 }
 
+#if CONFIG_NET_RX_FLOW_QUEUES > 1
+#define FLOW_COUNT 4
+#define FLOW_PKTS 4
+
+/* The local ports of the flows. Their hashes put them in different
+ * queues of the traffic class for any CONFIG_NET_RX_FLOW_QUEUES > 1.
+ */
+#define FLOW_PORT 4242
+
+static struct {
+	struct net_context *ctx;
+	k_tid_t thread;
+	int recv_count;
+	bool out_of_order;
+	bool moved;
+} flows[FLOW_COUNT];
+
+static void flow_recv_cb(struct net_context *context,
+			 struct net_pkt *pkt,
+			 int status,
+			 void *user_data)
+{
+	int flow = POINTER_TO_INT(user_data);
+	u8_t seq = net_pkt_appdata(pkt)[0];
+
+	if (!flows[flow].recv_count) {
+		flows[flow].thread = k_current_get();
+	} else if (flows[flow].thread != k_current_get()) {
+		flows[flow].moved = true;
+	}
+
+	if (seq != flows[flow].recv_count) {
+		flows[flow].out_of_order = true;
+	}
+
+	flows[flow].recv_count++;
+
+	k_sem_give(&wait_data);
+
+	net_pkt_unref(pkt);
+}
+
+static void traffic_class_setup_flows(void)
+{
+	struct sockaddr_in6 src_addr6 = {
+		.sin6_family = AF_INET6,
+	};
+	int i, ret;
+
+	memcpy(&src_addr6.sin6_addr, &my_addr1, sizeof(struct in6_addr));
+	memcpy(&dst_addr6.sin6_addr, &dst_addr, sizeof(struct in6_addr));
+
+	for (i = 0; i < FLOW_COUNT; i++) {
+		ret = net_context_get(AF_INET6, SOCK_DGRAM, IPPROTO_UDP,
+				      &flows[i].ctx);
+		zassert_equal(ret, 0, "Create flow %d context failed (%d)\n",
+			      i, ret);
+
+		src_addr6.sin6_port = htons(FLOW_PORT + i);
+
+		ret = net_context_bind(flows[i].ctx,
+				       (struct sockaddr *)&src_addr6,
+				       sizeof(struct sockaddr_in6));
+		zassert_equal(ret, 0, "Bind flow %d failed (%d)\n", i, ret);
+
+		ret = net_context_recv(flows[i].ctx, flow_recv_cb, 0,
+				       INT_TO_POINTER(i));
+		zassert_equal(ret, 0, "Recv flow %d setup failed (%d)\n",
+			      i, ret);
+	}
+}
+
+static void traffic_class_recv_flow_pkt(int flow, u8_t seq)
+{
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+	int ret;
+
+	pkt = net_pkt_get_tx(flows[flow].ctx, K_FOREVER);
+	zassert_not_null(pkt, "Cannot get pkt for flow %d\n", flow);
+
+	frag = net_pkt_get_data(flows[flow].ctx, K_FOREVER);
+	zassert_not_null(frag, "Cannot get frag");
+	net_pkt_frag_add(pkt, frag);
+
+	net_buf_add_u8(frag, seq);
+	ret = strlen(test_data);
+	memcpy(net_buf_add(frag, ret), test_data, ret);
+	net_pkt_set_appdatalen(pkt, ret + 1);
+
+	net_pkt_set_iface(pkt, net_if_get_default());
+
+	/* Looped back as a received packet by eth_tx() */
+	ret = net_context_sendto(pkt, (struct sockaddr *)&dst_addr6,
+				 sizeof(struct sockaddr_in6),
+				 NULL, 0, NULL, NULL);
+	zassert_equal(ret, 0, "Send UDP pkt failed");
+}
+
+static void traffic_class_recv_data_flows(void)
+{
+	int spread = 0;
+	int i, seq;
+
+	start_receiving = true;
+	k_sem_init(&wait_data, 0, UINT_MAX);
+
+	/* Interleave the packets of the flows */
+	for (seq = 0; seq < FLOW_PKTS; seq++) {
+		for (i = 0; i < FLOW_COUNT; i++) {
+			traffic_class_recv_flow_pkt(i, seq);
+		}
+	}
+
+	for (i = 0; i < FLOW_COUNT * FLOW_PKTS; i++) {
+		zassert_equal(k_sem_take(&wait_data, WAIT_TIME), 0,
+			      "Timeout");
+	}
+
+	for (i = 0; i < FLOW_COUNT; i++) {
+		zassert_equal(flows[i].recv_count, FLOW_PKTS,
+			      "Flow %d lost packets", i);
+		zassert_false(flows[i].out_of_order,
+			      "Flow %d received out of order", i);
+		zassert_false(flows[i].moved,
+			      "Flow %d processed by several threads", i);
+
+		if (flows[i].thread != flows[0].thread) {
+			spread++;
+		}
+	}
+
+	zassert_true(spread > 0, "Flows not spread over the Rx queues");
+}
+
+static void traffic_class_cleanup_flows(void)
+{
+	int i;
+
+	for (i = 0; i < FLOW_COUNT; i++) {
+		if (flows[i].ctx) {
+			net_context_unref(flows[i].ctx);
+			flows[i].ctx = NULL;
+		}
+	}
+}
+#else
+static void traffic_class_setup_flows(void)
+{
+	ztest_test_skip();
+}
+
+static void traffic_class_recv_data_flows(void)
+{
+	ztest_test_skip();
+}
+
+static void traffic_class_cleanup_flows(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_NET_RX_FLOW_QUEUES > 1 */
+
+#if CONFIG_NET_TX_BATCH_COUNT >= BATCH_PKTS
+static int batch_cb_count;
+static bool batch_cb_failed;
+
+static void batch_send_cb(struct net_context *context, int status,
+			  void *token, void *user_data)
+{
+	if (status < 0 || POINTER_TO_INT(token) != batch_cb_count) {
+		batch_cb_failed = true;
+	}
+
+	batch_cb_count++;
+}
+
+static void traffic_class_send_batch(void)
+{
+	struct k_mem_slab *tx_slab;
+	struct net_context *ctx;
+	struct net_pkt *pkts[BATCH_PKTS];
+	struct net_buf *frag;
+	u32_t tx_free;
+	int i, ret;
+
+	net_pkt_get_info(NULL, &tx_slab, NULL, NULL);
+
+	setup_net_context(&ctx);
+
+	for (i = 0; i < BATCH_PKTS; i++) {
+		pkts[i] = net_pkt_get_tx(ctx, K_FOREVER);
+		zassert_not_null(pkts[i], "Cannot get pkt");
+
+		frag = net_pkt_get_data(ctx, K_FOREVER);
+		zassert_not_null(frag, "Cannot get frag");
+		net_pkt_frag_add(pkts[i], frag);
+
+		net_buf_add_u8(frag, i);
+		net_pkt_set_appdatalen(pkts[i], 1);
+	}
+
+	/* Let the packets of the earlier tests go first */
+	k_sleep(K_MSEC(10));
+
+	tx_free = k_mem_slab_num_free_get(tx_slab);
+
+	start_receiving = false;
+	test_started = false;
+	batch_test = true;
+
+	/* Queue all of them before the Tx thread runs, so that it takes
+	 * them as one batch.
+	 */
+	k_sched_lock();
+
+	for (i = 0; i < BATCH_PKTS; i++) {
+		ret = net_context_sendto(pkts[i],
+					 (struct sockaddr *)&dst_addr6,
+					 sizeof(struct sockaddr_in6),
+					 batch_send_cb, 0, INT_TO_POINTER(i),
+					 NULL);
+		zassert_equal(ret, 0, "Send UDP pkt failed");
+	}
+
+	k_sched_unlock();
+
+	k_sleep(K_MSEC(10));
+
+	batch_test = false;
+
+	zassert_equal(batch_sent_count, BATCH_PKTS, "Packets not sent");
+
+	for (i = 0; i < BATCH_PKTS; i++) {
+		zassert_equal(batch_sent[i].seq, i, "Packet %d out of order",
+			      i);
+
+		/* The stack holds a reference during send_batch() */
+		if (i < BATCH_PKTS - 1) {
+			zassert_true(batch_sent[i].batched,
+				     "Packet %d not in the batch", i);
+			zassert_equal(batch_sent[i].ref, 2,
+				      "Packet %d ref %d in send_batch()",
+				      i, batch_sent[i].ref);
+		} else {
+			zassert_false(batch_sent[i].batched,
+				      "Unsent packet %d not sent alone", i);
+			zassert_equal(batch_sent[i].ref, 1,
+				      "Packet %d ref %d in send()",
+				      i, batch_sent[i].ref);
+		}
+	}
+
+	zassert_equal(batch_cb_count, BATCH_PKTS, "Send callbacks missing");
+	zassert_false(batch_cb_failed, "Send callbacks out of order");
+
+	zassert_equal(k_mem_slab_num_free_get(tx_slab), tx_free + BATCH_PKTS,
+		      "Packets not released");
+
+	net_context_unref(ctx);
+}
+#else
+static void traffic_class_send_batch(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_NET_TX_BATCH_COUNT >= BATCH_PKTS */
+
 void test_main(void)
 {
 	ztest_test_suite(net_traffic_class_test,
@@ -1024,7 +1348,17 @@ void test_main(void)
 			 ztest_unit_test(traffic_class_recv_data_mix),
 			 ztest_unit_test(traffic_class_recv_data_mix_all_1),
 			 ztest_unit_test(traffic_class_recv_data_mix_all_2),
-			 ztest_unit_test(traffic_class_cleanup_rx)
+			 ztest_unit_test(traffic_class_cleanup_rx),
+
+			 /* The packets of a flow stay in order on one Rx
+			  * queue, different flows use different queues.
+			  */
+			 ztest_unit_test(traffic_class_setup_flows),
+			 ztest_unit_test(traffic_class_recv_data_flows),
+			 ztest_unit_test(traffic_class_cleanup_flows),
+
+			 /* A driver sending part of a batch */
+			 ztest_unit_test(traffic_class_send_batch)
 			 );
 
 	ztest_run_test_suite(net_traffic_class_test);
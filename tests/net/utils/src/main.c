@@ -25,6 +25,7 @@
 
 #define NET_LOG_ENABLED 1
 #include "net_private.h"
+#include "icmpv6.h"
 
 #if defined(CONFIG_NET_IPV6)
 /* ICMPv6 frame (104 bytes) */
@@ -1589,13 +1590,105 @@ void test_net_pkt_addr_parse(void)
 #endif
 }
 
+#if defined(CONFIG_NET_IPV6)
+static struct net_pkt *chksum_pkt(const u8_t *data, u16_t len,
+				   const u16_t *frag_lens, int count)
+{
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+	int i;
+
+	pkt = net_pkt_get_reserve_rx(0, K_SECONDS(1));
+	zassert_not_null(pkt, "Out of mem");
+
+	for (i = 0; i < count; i++) {
+		frag = net_pkt_get_reserve_rx_data(0, K_SECONDS(1));
+		zassert_not_null(frag, "Out of mem");
+
+		net_pkt_frag_add(pkt, frag);
+
+		net_buf_add_mem(frag, data, frag_lens[i]);
+		data += frag_lens[i];
+		len -= frag_lens[i];
+	}
+
+	zassert_equal(len, 0, "Data left over");
+
+	net_pkt_set_ip_hdr_len(pkt, sizeof(struct net_ipv6_hdr));
+	net_pkt_set_family(pkt, AF_INET6);
+	net_pkt_set_ipv6_ext_len(pkt, 0);
+
+	return pkt;
+}
+#endif
+
+void test_chksum_update(void)
+{
+#if defined(CONFIG_NET_IPV6)
+	/* Fragments ending at odd offsets, and an empty one */
+	static const u16_t split[] = { 41, 0, 27, 36 };
+	static const u16_t whole[] = { sizeof(pkt1) };
+	struct in6_addr new_dst = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0,
+					0, 0, 0, 0, 0x12, 0x34, 0x56, 0x78 } } };
+	struct net_icmp_hdr *icmp_hdr;
+	struct net_ipv6_hdr *hdr;
+	struct net_pkt *pkt;
+	u16_t chksum;
+	u32_t old32;
+	u8_t *data;
+
+	pkt = chksum_pkt(pkt1, sizeof(pkt1), split, ARRAY_SIZE(split));
+	zassert_equal(net_calc_chksum(pkt, IPPROTO_ICMPV6), 0xffff,
+		      "Invalid chksum of fragmented pkt1");
+	net_pkt_unref(pkt);
+
+	pkt = chksum_pkt(pkt1, sizeof(pkt1), whole, ARRAY_SIZE(whole));
+	data = pkt->frags->data;
+	hdr = NET_IPV6_HDR(pkt);
+	icmp_hdr = (struct net_icmp_hdr *)(data + sizeof(*hdr));
+
+	/* Rewrite the destination address */
+	chksum = net_chksum_update(ntohs(icmp_hdr->chksum), &hdr->dst,
+				   &new_dst, sizeof(new_dst));
+	net_ipaddr_copy(&hdr->dst, &new_dst);
+	icmp_hdr->chksum = htons(chksum);
+
+	zassert_equal(net_calc_chksum(pkt, IPPROTO_ICMPV6), 0xffff,
+		      "Invalid chksum after address update");
+
+	/* Turn the echo request into a reply */
+	chksum = net_chksum_update_16(ntohs(icmp_hdr->chksum),
+				      (icmp_hdr->type << 8) | icmp_hdr->code,
+				      NET_ICMPV6_ECHO_REPLY << 8);
+	icmp_hdr->type = NET_ICMPV6_ECHO_REPLY;
+	icmp_hdr->code = 0;
+	icmp_hdr->chksum = htons(chksum);
+
+	zassert_equal(net_calc_chksum(pkt, IPPROTO_ICMPV6), 0xffff,
+		      "Invalid chksum after 16-bit update");
+
+	/* Change the identifier and sequence number together */
+	old32 = sys_get_be32(data + sizeof(*hdr) + 4);
+	chksum = net_chksum_update_32(ntohs(icmp_hdr->chksum), old32,
+				      0xfedcba98);
+	sys_put_be32(0xfedcba98, data + sizeof(*hdr) + 4);
+	icmp_hdr->chksum = htons(chksum);
+
+	zassert_equal(net_calc_chksum(pkt, IPPROTO_ICMPV6), 0xffff,
+		      "Invalid chksum after 32-bit update");
+
+	net_pkt_unref(pkt);
+#endif
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_utils_fn,
 			 ztest_unit_test(test_utils),
 			 ztest_unit_test(test_net_addr),
 			 ztest_unit_test(test_addr_parse),
-			 ztest_unit_test(test_net_pkt_addr_parse));
+			 ztest_unit_test(test_net_pkt_addr_parse),
+			 ztest_unit_test(test_chksum_update));
 
 	ztest_run_test_suite(test_utils_fn);
 }
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <pthread.h>
+
+#define N_ROUNDS 3
+
+static void *thread_top(void *p1)
+{
+	return p1;
+}
+
+static void *thread_exit(void *p1)
+{
+	pthread_exit(p1);
+	return NULL;
+}
+
+/* Create more joinable threads than the pool holds, without stacks */
+void test_pthread_pool_join(void)
+{
+	pthread_t threads[CONFIG_MAX_PTHREAD_COUNT];
+	pthread_t extra;
+	void *retval;
+	int i, round;
+
+	for (round = 0; round < N_ROUNDS; round++) {
+		for (i = 0; i < CONFIG_MAX_PTHREAD_COUNT; i++) {
+			zassert_false(pthread_create(&threads[i], NULL,
+						     thread_exit,
+						     INT_TO_POINTER(i)),
+				      "round %d: create %d failed", round, i);
+		}
+
+		/* Pool exhausted until the threads are joined */
+		zassert_equal(pthread_create(&extra, NULL, thread_top, NULL),
+			      EAGAIN, NULL);
+
+		for (i = 0; i < CONFIG_MAX_PTHREAD_COUNT; i++) {
+			zassert_false(pthread_join(threads[i], &retval), NULL);
+			zassert_equal(POINTER_TO_INT(retval), i, NULL);
+		}
+
+		/* Joined threads are reusable once they have finished dying */
+		k_sleep(10);
+	}
+}
+
+/* Detached threads are returned to the pool when they exit */
+void test_pthread_pool_detach(void)
+{
+	pthread_attr_t attr;
+	pthread_t thread;
+	int i;
+
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+	for (i = 0; i < N_ROUNDS * CONFIG_MAX_PTHREAD_COUNT; i++) {
+		zassert_false(pthread_create(&thread, &attr, thread_top, NULL),
+			      "create %d failed", i);
+		/* Let it run to completion */
+		k_sleep(10);
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_pthread_pool,
+			 ztest_unit_test(test_pthread_pool_join),
+			 ztest_unit_test(test_pthread_pool_detach));
+	ztest_run_test_suite(test_pthread_pool);
+}
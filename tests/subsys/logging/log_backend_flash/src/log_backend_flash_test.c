@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Test flash log backend
+ *
+ */
+
+
+#include <tc_util.h>
+#include <stdbool.h>
+#include <zephyr.h>
+#include <ztest.h>
+#include <logging/log_backend_flash.h>
+#include <logging/log_ctrl.h>
+#include <logging/log_output.h>
+
+#define LOG_MODULE_NAME test
+#include "logging/log.h"
+LOG_MODULE_REGISTER();
+
+#define PACKET_MAX_LEN 16
+
+static const char fmt[] = "flash test %d";
+
+/* Length of a packet of the test message, all fields but the format
+ * string address are encoded on a single byte.
+ */
+static size_t packet_len;
+
+struct read_ctx {
+	size_t len;
+	u8_t tail[PACKET_MAX_LEN];
+};
+
+static int read_cb(const u8_t *data, size_t length, void *ctx)
+{
+	struct read_ctx *read = ctx;
+
+	for (size_t i = 0; i < length; i++) {
+		memmove(read->tail, &read->tail[1], packet_len - 1);
+		read->tail[packet_len - 1] = data[i];
+	}
+
+	read->len += length;
+
+	return 0;
+}
+
+static u32_t timestamp_get(void)
+{
+	return 0;
+}
+
+static void log_setup(void)
+{
+	u32_t addr = (u32_t)(uintptr_t)fmt;
+
+	log_init();
+
+	zassert_equal(0, log_set_timestamp_func(timestamp_get, 0),
+		      "Expects successful timestamp function setting.");
+
+	/* sync, header, source ID, timestamp, nargs and argument */
+	packet_len = 6;
+	do {
+		packet_len++;
+		addr >>= 7;
+	} while (addr != 0);
+
+	zassert_equal(0, log_backend_flash_clear(), "Clear failed.");
+}
+
+static void log_messages(int cnt)
+{
+	for (int i = 0; i < cnt; i++) {
+		LOG_INF(fmt, i % 100);
+
+		while (log_process(false)) {
+		}
+	}
+}
+
+static void check_last_packet(struct read_ctx *read, int arg)
+{
+	zassert_equal(LOG_OUTPUT_DICT_SYNC, read->tail[0],
+		      "Unexpected packet start.");
+	zassert_equal(arg, read->tail[packet_len - 1],
+		      "Unexpected argument of the last message.");
+}
+
+/*
+ * Messages are collected in RAM until a batch is full, stored logs are
+ * reported together with the pending batch.
+ */
+static void test_log_backend_flash_store(void)
+{
+	struct read_ctx read = { 0 };
+
+	log_setup();
+	log_messages(10);
+
+	zassert_equal(0, log_backend_flash_read(read_cb, &read),
+		      "Read failed.");
+	zassert_equal(10 * packet_len, read.len,
+		      "Unexpected amount of stored data.");
+	check_last_packet(&read, 9);
+}
+
+/*
+ * When the flash area is full the oldest sector is erased, so the newest
+ * messages are kept.
+ */
+static void test_log_backend_flash_rotate(void)
+{
+	struct read_ctx read = { 0 };
+	int cnt = 2 * FLASH_AREA_STORAGE_SIZE / packet_len;
+
+	log_setup();
+	log_messages(cnt);
+
+	zassert_equal(0, log_backend_flash_read(read_cb, &read),
+		      "Read failed.");
+	zassert_true(read.len < FLASH_AREA_STORAGE_SIZE,
+		     "Unexpected amount of stored data.");
+	zassert_true(read.len > FLASH_AREA_STORAGE_SIZE / 4,
+		     "Unexpected amount of stored data.");
+	check_last_packet(&read, (cnt - 1) % 100);
+}
+
+/*
+ * Cleared logs are not reported.
+ */
+static void test_log_backend_flash_clear(void)
+{
+	struct read_ctx read = { 0 };
+
+	log_setup();
+	log_messages(10);
+
+	zassert_equal(0, log_backend_flash_clear(), "Clear failed.");
+	zassert_equal(0, log_backend_flash_read(read_cb, &read),
+		      "Read failed.");
+	zassert_equal(0, read.len, "Unexpected amount of stored data.");
+}
+
+/*
+ * Messages pending at panic are written to flash right away, so they are
+ * still there once the backend is opened again, e.g. after a reset.
+ * Panic mode cannot be left, so this test runs last.
+ */
+static void test_log_backend_flash_panic(void)
+{
+	struct read_ctx read = { 0 };
+
+	log_setup();
+
+	for (int i = 0; i < 5; i++) {
+		LOG_INF(fmt, i);
+	}
+
+	log_panic();
+
+	/* Logged in place from now on */
+	LOG_INF(fmt, 5);
+
+	zassert_equal(0, log_backend_flash_init(), "Init failed.");
+	zassert_equal(0, log_backend_flash_read(read_cb, &read),
+		      "Read failed.");
+	zassert_equal(6 * packet_len, read.len,
+		      "Unexpected amount of stored data.");
+	check_last_packet(&read, 5);
+}
+
+/*test case main entry*/
+void test_main(void)
+{
+	ztest_test_suite(test_log_backend_flash,
+			 ztest_unit_test(test_log_backend_flash_store),
+			 ztest_unit_test(test_log_backend_flash_rotate),
+			 ztest_unit_test(test_log_backend_flash_clear),
+			 ztest_unit_test(test_log_backend_flash_panic));
+	ztest_run_test_suite(test_log_backend_flash);
+}
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Test lock-free logger buffers and drop accounting
+ *
+ */
+
+
+#include <tc_util.h>
+#include <stdbool.h>
+#include <zephyr.h>
+#include <ztest.h>
+#include <irq_offload.h>
+#include <logging/log_backend.h>
+#include <logging/log_ctrl.h>
+
+#define LOG_MODULE_NAME test
+#include "logging/log.h"
+LOG_MODULE_REGISTER();
+
+#define MSGS_IN_BUF (CONFIG_LOG_BUFFER_SIZE / sizeof(union log_msg_chunk))
+
+struct backend_cb {
+	size_t counter;
+	u32_t last_timestamp;
+	bool order_error;
+	u32_t last_level;
+	u32_t last_arg;
+};
+
+static void put(struct log_backend const *const backend,
+		struct log_msg *msg)
+{
+	struct backend_cb *cb = (struct backend_cb *)backend->cb->ctx;
+
+	log_msg_get(msg);
+
+	if (cb->counter > 0 &&
+	    (s32_t)(log_msg_timestamp_get(msg) - cb->last_timestamp) <= 0) {
+		cb->order_error = true;
+	}
+
+	cb->last_timestamp = log_msg_timestamp_get(msg);
+	cb->last_level = log_msg_level_get(msg);
+	cb->last_arg = log_msg_nargs_get(msg) > 0 ? log_msg_arg_get(msg, 0) : 0;
+	cb->counter++;
+
+	log_msg_put(msg);
+}
+
+static void panic(struct log_backend const *const backend)
+{
+}
+
+const struct log_backend_api log_backend_test_api = {
+	.put = put,
+	.panic = panic,
+};
+
+LOG_BACKEND_DEFINE(backend1, log_backend_test_api);
+struct backend_cb backend1_cb;
+
+static u32_t stamp;
+
+static u32_t test_source_id;
+
+static u32_t timestamp_get(void)
+{
+	return stamp++;
+}
+
+static int log_source_id_get(const char *name)
+{
+
+	for (int i = 0; i < log_src_cnt_get(CONFIG_LOG_DOMAIN_ID); i++) {
+		if (strcmp(log_source_name_get(CONFIG_LOG_DOMAIN_ID, i), name)
+		    == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+static void log_setup(void)
+{
+	stamp = 0;
+
+	log_init();
+
+	zassert_equal(0, log_set_timestamp_func(timestamp_get, 0),
+		      "Expects successful timestamp function setting.");
+
+	memset(&backend1_cb, 0, sizeof(backend1_cb));
+
+	log_backend_enable(&backend1, &backend1_cb, LOG_LEVEL_DBG);
+
+	test_source_id = log_source_id_get(STRINGIFY(LOG_MODULE_NAME));
+}
+
+static void offload_function(void *param)
+{
+	LOG_INF("isr %d", 1);
+	LOG_INF("isr %d", 2);
+}
+
+/*
+ * Messages logged from the thread and from an interrupt are delivered to the
+ * backend in the order they were created.
+ */
+static void test_log_lockless_order(void)
+{
+	log_setup();
+
+	LOG_INF("thread %d", 1);
+	irq_offload(offload_function, NULL);
+	LOG_INF("thread %d", 2);
+
+	while (log_process(false)) {
+	}
+
+	zassert_equal(4, backend1_cb.counter,
+		      "Unexpected amount of messages received by the backend.");
+	zassert_false(backend1_cb.order_error,
+		      "Messages received out of order.");
+}
+
+/*
+ * When the buffer is full, new messages are dropped and counted. Once
+ * messages are processed, a warning with the number of dropped messages
+ * is logged on behalf of the source.
+ */
+static void test_log_lockless_drop(void)
+{
+	u32_t dropped;
+
+	log_setup();
+
+	dropped = log_source_dropped_get(CONFIG_LOG_DOMAIN_ID, test_source_id);
+
+	for (int i = 0; i < MSGS_IN_BUF + 5; i++) {
+		LOG_INF("test %d", i);
+	}
+
+	zassert_equal(dropped + 5,
+		      log_source_dropped_get(CONFIG_LOG_DOMAIN_ID,
+					     test_source_id),
+		      "Unexpected amount of dropped messages.");
+
+	while (log_process(false)) {
+	}
+
+	zassert_equal(MSGS_IN_BUF + 1, backend1_cb.counter,
+		      "Unexpected amount of messages received by the backend.");
+	zassert_equal(LOG_LEVEL_WRN, backend1_cb.last_level,
+		      "Expected warning about dropped messages.");
+	zassert_equal(5, backend1_cb.last_arg,
+		      "Unexpected amount of dropped messages reported.");
+}
+
+/*
+ * All chunks are returned to the pool once messages are processed, so the
+ * whole buffer can be filled again without drops.
+ */
+static void test_log_lockless_reuse(void)
+{
+	u32_t dropped;
+
+	log_setup();
+
+	dropped = log_source_dropped_get(CONFIG_LOG_DOMAIN_ID, test_source_id);
+
+	for (int i = 0; i < MSGS_IN_BUF; i++) {
+		LOG_INF("test %d", i);
+	}
+
+	while (log_process(false)) {
+	}
+
+	zassert_equal(dropped,
+		      log_source_dropped_get(CONFIG_LOG_DOMAIN_ID,
+					     test_source_id),
+		      "Unexpected dropped messages.");
+	zassert_equal(MSGS_IN_BUF, backend1_cb.counter,
+		      "Unexpected amount of messages received by the backend.");
+}
+
+/*test case main entry*/
+void test_main(void)
+{
+	ztest_test_suite(test_log_lockless,
+			 ztest_unit_test(test_log_lockless_order),
+			 ztest_unit_test(test_log_lockless_drop),
+			 ztest_unit_test(test_log_lockless_reuse));
+	ztest_run_test_suite(test_log_lockless);
+}
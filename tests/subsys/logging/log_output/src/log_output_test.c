@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Test binary dictionary log output
+ */
+
+#include <logging/log_msg.h>
+#include <logging/log_output.h>
+#include <logging/log.h>
+
+#include <tc_util.h>
+#include <stdbool.h>
+#include <zephyr.h>
+#include <ztest.h>
+
+static const char my_string[] = "test_string %d %d %d %d";
+
+static u8_t out_buf[128];
+static size_t out_len;
+static u32_t out_calls;
+
+static u8_t ctx_buf[8];
+
+static int out_func(u8_t *data, size_t length, void *ctx)
+{
+	zassert_true(out_len + length <= sizeof(out_buf), "Output too long");
+
+	memcpy(&out_buf[out_len], data, length);
+	out_len += length;
+	out_calls++;
+
+	return length;
+}
+
+static struct log_output_ctx ctx = {
+	.func = out_func,
+	.data = ctx_buf,
+	.length = sizeof(ctx_buf),
+};
+
+static void out_reset(void)
+{
+	out_len = 0;
+	out_calls = 0;
+}
+
+static size_t uleb128(u8_t *buf, u32_t value)
+{
+	size_t len = 0;
+
+	while (value > 0x7f) {
+		buf[len++] = (value & 0x7f) | 0x80;
+		value >>= 7;
+	}
+	buf[len++] = value;
+
+	return len;
+}
+
+static void msg_ids_set(struct log_msg *msg, u32_t level, u32_t domain_id,
+			u32_t source_id, u32_t timestamp)
+{
+	msg->hdr.ids.level = level;
+	msg->hdr.ids.domain_id = domain_id;
+	msg->hdr.ids.source_id = source_id;
+	msg->hdr.timestamp = timestamp;
+}
+
+void test_log_output_dict_std(void)
+{
+	u32_t args[] = {1, 127, 128, 0xffffffff};
+	u8_t exp[32];
+	size_t len = 0;
+	struct log_msg *msg;
+
+	msg = log_msg_create_n(my_string, args, ARRAY_SIZE(args));
+	zassert_not_null(msg, "Allocation failed");
+	msg_ids_set(msg, LOG_LEVEL_INF, 1, 300, 0x12345);
+
+	exp[len++] = LOG_OUTPUT_DICT_SYNC;
+	exp[len++] = LOG_OUTPUT_DICT_TYPE_STD | (LOG_LEVEL_INF << 2) | (1 << 5);
+	exp[len++] = 0xac;
+	exp[len++] = 0x02;
+	exp[len++] = 0xc5;
+	exp[len++] = 0xc6;
+	exp[len++] = 0x04;
+	len += uleb128(&exp[len], (u32_t)(uintptr_t)my_string);
+	exp[len++] = ARRAY_SIZE(args);
+	exp[len++] = 0x01;
+	exp[len++] = 0x7f;
+	exp[len++] = 0x80;
+	exp[len++] = 0x01;
+	exp[len++] = 0xff;
+	exp[len++] = 0xff;
+	exp[len++] = 0xff;
+	exp[len++] = 0xff;
+	exp[len++] = 0x0f;
+
+	out_reset();
+	log_output_msg_dict_process(msg, &ctx);
+	log_msg_put(msg);
+
+	zassert_equal(out_len, len, "Unexpected packet length");
+	zassert_true(memcmp(out_buf, exp, len) == 0, "Unexpected packet");
+}
+
+void test_log_output_dict_hexdump(void)
+{
+	u8_t data[20];
+	struct log_msg *msg;
+	int i;
+
+	for (i = 0; i < sizeof(data); i++) {
+		data[i] = i;
+	}
+
+	msg = log_msg_hexdump_create(data, sizeof(data));
+	zassert_not_null(msg, "Allocation failed");
+	msg_ids_set(msg, LOG_LEVEL_DBG, 0, 2, 5);
+
+	out_reset();
+	log_output_msg_dict_process(msg, &ctx);
+	log_msg_put(msg);
+
+	zassert_equal(out_len, 5 + sizeof(data), "Unexpected packet length");
+	zassert_equal(out_buf[0], LOG_OUTPUT_DICT_SYNC, NULL);
+	zassert_equal(out_buf[1],
+		      LOG_OUTPUT_DICT_TYPE_HEXDUMP | (LOG_LEVEL_DBG << 2), NULL);
+	zassert_equal(out_buf[2], 2, "Unexpected source ID");
+	zassert_equal(out_buf[3], 5, "Unexpected timestamp");
+	zassert_equal(out_buf[4], sizeof(data), "Unexpected length");
+	zassert_true(memcmp(&out_buf[5], data, sizeof(data)) == 0,
+		     "Unexpected data");
+
+	/* Output buffer is flushed whenever full */
+	zassert_equal(out_calls, (5 + sizeof(data) + sizeof(ctx_buf) - 1) /
+		      sizeof(ctx_buf), "Unexpected number of flushes");
+}
+
+void test_log_output_dict_raw_string(void)
+{
+	static const char str[] = "raw\r\n";
+	struct log_msg *msg;
+
+	msg = log_msg_hexdump_create((u8_t *)str, strlen(str));
+	zassert_not_null(msg, "Allocation failed");
+	msg->hdr.params.hexdump.raw_string = 1;
+	msg_ids_set(msg, 0, 0, 0, 0);
+
+	out_reset();
+	log_output_msg_dict_process(msg, &ctx);
+	log_msg_put(msg);
+
+	zassert_equal(out_len, 5 + strlen(str), "Unexpected packet length");
+	zassert_equal(out_buf[1], LOG_OUTPUT_DICT_TYPE_RAW_STRING, NULL);
+	zassert_equal(out_buf[4], strlen(str), "Unexpected length");
+	zassert_true(memcmp(&out_buf[5], str, strlen(str)) == 0,
+		     "Unexpected data");
+}
+
+/*test case main entry*/
+void test_main(void)
+{
+	ztest_test_suite(test_log_output,
+			 ztest_unit_test(test_log_output_dict_std),
+			 ztest_unit_test(test_log_output_dict_hexdump),
+			 ztest_unit_test(test_log_output_dict_raw_string));
+	ztest_run_test_suite(test_log_output);
+}
@@ -109,6 +109,42 @@ void test_crc8_ccitt(void)
 			   sizeof(test2)) == 0xFB, "pass", "fail");
 }
 
+/*
+ * Longer than a slice, and not a multiple of it, so that the table and
+ * slicing implementations go through both their main and tail loops.
+ */
+void test_crc_long(void)
+{
+	u8_t data[61];
+	u16_t crc;
+	int i, split;
+
+	for (i = 0; i < sizeof(data); i++) {
+		data[i] = i * 7 + 3;
+	}
+
+	zassert_equal(crc32_ieee(data, sizeof(data)), 0x3da84f19, NULL);
+	zassert_equal(crc16_ccitt(0, data, sizeof(data)), 0x828f, NULL);
+	zassert_equal(crc16_ansi(data, sizeof(data)), 0x6329, NULL);
+	zassert_equal(crc16(data, sizeof(data), 0x8005, 0xffff, true),
+		      0x6329, NULL);
+	zassert_equal(crc8_ccitt(CRC8_CCITT_INITIAL_VALUE, data,
+				 sizeof(data)), 0x16, NULL);
+
+	/* Chained updates match a single pass wherever the data is split */
+	for (split = 0; split <= sizeof(data); split++) {
+		zassert_equal(crc32_ieee_update(crc32_ieee(data, split),
+						data + split,
+						sizeof(data) - split),
+			      0x3da84f19, "split %d", split);
+
+		crc = crc16_ccitt(0, data, split);
+		zassert_equal(crc16_ccitt(crc, data + split,
+					  sizeof(data) - split),
+			      0x828f, "split %d", split);
+	}
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_crc,
@@ -118,6 +154,7 @@ void test_main(void)
 			 ztest_unit_test(test_crc16_ccitt),
 			 ztest_unit_test(test_crc16_ccitt_for_ppp),
 			 ztest_unit_test(test_crc16_itu_t),
-			 ztest_unit_test(test_crc8_ccitt));
+			 ztest_unit_test(test_crc8_ccitt),
+			 ztest_unit_test(test_crc_long));
 	ztest_run_test_suite(test_crc);
 }